@@ -12,10 +12,37 @@ bool ASM::SetState(const AnimationState& state)
 {
 	if (!CanPlayAnimation(state)) return false; // Can't change state, we're locked in to this animation
 
+	const AnimationState* lastState = currentState;
+
 	beginTime = glfwGetTime();
 	currentState = &state;
-	animComp->speed = state.speed;
+	animComp->GetLayer(0).speed = state.speed;
 	animComp->SetAnimation(state.anim);
+
+	for (const AnimationLayerState& layerState : state.layers)
+	{
+		SkeletalAnimationComponent::Layer& layer = animComp->GetLayer(layerState.layer);
+		layer.speed = layerState.speed;
+		layer.additive = layerState.additive;
+		layer.mask = layerState.mask;
+		animComp->SetLayerAnimation(layerState.layer, layerState.anim);
+		animComp->SetLayerWeight(layerState.layer, layerState.weight);
+	}
+
+	if (lastState)
+	{
+		for (const AnimationLayerState& lastLayerState : lastState->layers)
+		{
+			bool stillUsed = false;
+			for (const AnimationLayerState& layerState : state.layers)
+			{
+				stillUsed |= layerState.layer == lastLayerState.layer;
+			}
+
+			if (!stillUsed) animComp->SetLayerWeight(lastLayerState.layer, 0.0f);
+		}
+	}
+
 	return true;
 }
 
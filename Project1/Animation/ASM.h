@@ -3,13 +3,27 @@
 #include "Animation.h"
 #include "SkeletalAnimationComponent.h"
 
-struct AnimationState
+#include <vector>
+
+// A clip an AnimationState plays on one of the component's layers above the base one, e.g. an upper body overlay
+struct AnimationLayerState
 {
+	unsigned int layer = 1;
 	Animation* anim = nullptr;
+	float weight = 1.0f;
+	float speed = 1.0f;
+	bool additive = false;
+	const BoneMask* mask = nullptr; // nullptr applies the layer to every joint
+};
+
+struct AnimationState
+{
+	Animation* anim = nullptr; // Played on the base layer
 	float duration = 0.0f;
 	bool cancellable = true;
 	float speed = 1.0f;
 	int priority = 0;
+	std::vector<AnimationLayerState> layers; // Fade in with the state, layers the next state doesn't use fade out
 };
 
 class ASM
@@ -0,0 +1,16 @@
+#pragma once
+
+#include "AnimationEvents.h"
+#include "Span.h"
+
+class SkeletalAnimationComponent;
+
+// Registered on a SkeletalAnimationComponent, told about the events its clips cross once per update
+class IAnimationEventListener
+{
+public:
+	virtual ~IAnimationEventListener() = default;
+
+	// Every event crossed this update, layer by layer in the order they were crossed. events is only valid during the call, listeners can't be added or removed from inside it
+	virtual void OnAnimationEvents(SkeletalAnimationComponent* animComp, Span<const AnimationEventRecord> events) = 0;
+};
\ No newline at end of file
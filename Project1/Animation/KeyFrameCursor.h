@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vector>
+
+// Remembers which key frame a track was sampled at last. Playing forward only ever moves it by a key or two per frame,
+// anything else (seeks, loop wraps, playing backwards) falls back to a binary search. One cursor per track per playing instance
+struct KeyFrameCursor
+{
+	static const unsigned int MAX_STEPS = 2; // Keys walked forward before giving up & binary searching
+
+	unsigned int index = 0;
+
+	// Last key frame whose time is <= time (0 if time comes before the second key frame), the same key frame a linear scan from the front finds.
+	// timeMember points at the key frame's time, keyFrames has to be sorted by it & can't be empty
+	template<typename T>
+	unsigned int Seek(const std::vector<T>& keyFrames, float T::* timeMember, float time)
+	{
+		return Seek((unsigned int)keyFrames.size(), [&keyFrames, timeMember](unsigned int i) { return keyFrames[i].*timeMember; }, time);
+	}
+
+	// Same as above for tracks that keep their key frame times in an array of their own
+	template<typename T>
+	unsigned int Seek(const std::vector<T>& times, float time)
+	{
+		return Seek((unsigned int)times.size(), [&times](unsigned int i) { return (float)times[i]; }, time);
+	}
+
+private:
+	template<typename GetTime>
+	unsigned int Seek(unsigned int count, GetTime getTime, float time)
+	{
+		if (index >= count) index = 0; // The track changed under us
+
+		for (unsigned int step = 0; step <= MAX_STEPS; step++)
+		{
+			bool afterCurrent = index == 0 || getTime(index) <= time;
+			bool beforeNext = index + 1 == count || getTime(index + 1) > time;
+			if (afterCurrent && beforeNext) return index;
+			if (!afterCurrent) break; // Went backwards
+
+			index++;
+		}
+
+		// First key frame after time, the one before it is the one we want
+		unsigned int low = 1;
+		unsigned int high = count;
+		while (low < high)
+		{
+			unsigned int middle = (low + high) / 2;
+			if (getTime(middle) > time) high = middle;
+			else low = middle + 1;
+		}
+
+		index = low - 1;
+		return index;
+	}
+};
\ No newline at end of file
@@ -0,0 +1,406 @@
+#include "AssetLoader.h"
+#include "MeshManager.h"
+#include "TextureManager.h"
+#include "Profiler.h"
+
+#include <stb/stb_image.h>
+
+#include <algorithm>
+#include <iostream>
+
+std::vector<std::thread> AssetLoader::workers;
+std::mutex AssetLoader::loadMutex;
+std::condition_variable AssetLoader::loadCondition;
+std::deque<std::function<void()>> AssetLoader::loadQueue;
+bool AssetLoader::running = false;
+
+std::mutex AssetLoader::uploadMutex;
+std::condition_variable AssetLoader::uploadCondition;
+std::deque<std::function<void()>> AssetLoader::uploadQueue;
+
+std::unordered_map<std::string, std::shared_ptr<AssetState<Mesh>>> AssetLoader::pendingMeshes;
+std::unordered_map<std::string, std::shared_ptr<AssetState<AnimatedMesh>>> AssetLoader::pendingAnimatedMeshes;
+std::unordered_map<std::string, std::shared_ptr<AssetState<Animation>>> AssetLoader::pendingAnimations;
+std::unordered_map<std::string, std::shared_ptr<AssetState<Texture2D>>> AssetLoader::pendingTextures;
+std::unordered_map<std::string, Texture2D*> AssetLoader::textures;
+std::unordered_map<const ITexture*, std::string> AssetLoader::texturePaths;
+
+std::mutex AssetLoader::statsMutex;
+AssetLoadStats AssetLoader::stats;
+AssetLoader::Clock::time_point AssetLoader::firstRequest;
+AssetLoader::Clock::time_point AssetLoader::lastCompletion;
+
+static double MillisecondsSince(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+void AssetLoader::Initialize(unsigned int workerCount)
+{
+	if (running) return;
+
+	if (workerCount == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+	}
+
+	running = true;
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		workers.emplace_back(WorkerLoop);
+	}
+}
+
+void AssetLoader::CleanUp()
+{
+	{
+		std::lock_guard<std::mutex> lock(loadMutex);
+		running = false;
+		loadQueue.clear();
+	}
+	loadCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+
+	std::lock_guard<std::mutex> lock(uploadMutex);
+	uploadQueue.clear();
+}
+
+void AssetLoader::WorkerLoop()
+{
+	Profiler::SetThreadName("Asset Loader");
+
+	while (true)
+	{
+		std::function<void()> task;
+		{
+			std::unique_lock<std::mutex> lock(loadMutex);
+			loadCondition.wait(lock, [] { return !running || !loadQueue.empty(); });
+			if (!running) return;
+
+			task = std::move(loadQueue.front());
+			loadQueue.pop_front();
+		}
+
+		Clock::time_point start = Clock::now();
+		task();
+		double milliseconds = MillisecondsSince(start);
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.workerMilliseconds += milliseconds;
+	}
+}
+
+void AssetLoader::QueueLoad(const std::function<void()>& task)
+{
+	if (workers.empty()) // Never initialized, load on the calling thread instead
+	{
+		Clock::time_point start = Clock::now();
+		task();
+		double milliseconds = MillisecondsSince(start);
+
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats.workerMilliseconds += milliseconds;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(loadMutex);
+		loadQueue.push_back(task);
+	}
+	loadCondition.notify_one();
+}
+
+void AssetLoader::QueueUpload(const std::function<void()>& task)
+{
+	{
+		std::lock_guard<std::mutex> lock(uploadMutex);
+		uploadQueue.push_back(task);
+	}
+	uploadCondition.notify_one();
+}
+
+bool AssetLoader::RunUpload()
+{
+	std::function<void()> task;
+	{
+		std::lock_guard<std::mutex> lock(uploadMutex);
+		if (uploadQueue.empty()) return false;
+
+		task = std::move(uploadQueue.front());
+		uploadQueue.pop_front();
+	}
+
+	Clock::time_point start = Clock::now();
+	task();
+	double milliseconds = MillisecondsSince(start);
+
+	stats.uploadMilliseconds += milliseconds;
+	stats.longestUploadMilliseconds = std::max(stats.longestUploadMilliseconds, milliseconds);
+	return true;
+}
+
+void AssetLoader::WaitForUpload()
+{
+	std::unique_lock<std::mutex> lock(uploadMutex);
+	uploadCondition.wait_for(lock, std::chrono::milliseconds(5), [] { return !uploadQueue.empty(); });
+}
+
+void AssetLoader::ProcessUploads(float budgetMilliseconds)
+{
+	PROFILE_ZONE("AssetUploads");
+
+	Clock::time_point start = Clock::now();
+	bool uploaded = false;
+	while (MillisecondsSince(start) < budgetMilliseconds || !uploaded)
+	{
+		if (!RunUpload()) break;
+		uploaded = true;
+	}
+
+	if (uploaded) RecordStall(start);
+}
+
+void AssetLoader::Wait(const std::string& path)
+{
+	PROFILE_ZONE("AssetWait");
+
+	Clock::time_point start = Clock::now();
+	while (IsLoading(path))
+	{
+		if (!RunUpload()) WaitForUpload();
+	}
+	RecordStall(start);
+}
+
+void AssetLoader::WaitForAll()
+{
+	PROFILE_ZONE("AssetWait");
+
+	Clock::time_point start = Clock::now();
+	while (GetPendingCount() > 0)
+	{
+		if (!RunUpload()) WaitForUpload();
+	}
+	RecordStall(start);
+}
+
+bool AssetLoader::IsLoading(const std::string& path)
+{
+	return pendingMeshes.find(path) != pendingMeshes.end()
+		|| pendingAnimatedMeshes.find(path) != pendingAnimatedMeshes.end()
+		|| pendingAnimations.find(path) != pendingAnimations.end()
+		|| pendingTextures.find(path) != pendingTextures.end();
+}
+
+unsigned int AssetLoader::GetPendingCount()
+{
+	return (unsigned int)(pendingMeshes.size() + pendingAnimatedMeshes.size() + pendingAnimations.size() + pendingTextures.size());
+}
+
+template<typename T>
+AssetHandle<T> AssetLoader::MakeReadyHandle(T* asset)
+{
+	std::shared_ptr<AssetState<T>> state = std::make_shared<AssetState<T>>();
+	state->asset = asset;
+	state->ready.store(true, std::memory_order_release);
+	return AssetHandle<T>(state);
+}
+
+AssetHandle<Mesh> AssetLoader::LoadMesh(const std::string& path)
+{
+	std::unordered_map<std::string, Mesh*>::iterator loaded = MeshManager::meshes.find(path);
+	if (loaded != MeshManager::meshes.end()) return MakeReadyHandle(loaded->second);
+
+	std::unordered_map<std::string, std::shared_ptr<AssetState<Mesh>>>::iterator it = pendingMeshes.find(path);
+	if (it != pendingMeshes.end()) return AssetHandle<Mesh>(it->second);
+
+	std::shared_ptr<AssetState<Mesh>> state = std::make_shared<AssetState<Mesh>>();
+	pendingMeshes.insert({ path, state });
+	RecordRequest();
+
+	MeshLODSettings lodSettings = MeshManager::GetLODSettings(); // Copied, the worker shouldn't read it while the main thread might change it
+	QueueLoad([state, path, lodSettings]()
+	{
+		PROFILE_ZONE("LoadMesh");
+		Mesh* mesh = new Mesh(path, false);
+		mesh->GenerateLODs(lodSettings);
+
+		QueueUpload([state, path, mesh]()
+		{
+			mesh->Upload();
+			MeshManager::meshes.insert({ path, mesh });
+
+			state->asset = mesh;
+			state->ready.store(true, std::memory_order_release);
+			pendingMeshes.erase(path);
+			RecordCompletion(mesh->GetSubmeshes().empty());
+		});
+	});
+
+	return AssetHandle<Mesh>(state);
+}
+
+AssetHandle<AnimatedMesh> AssetLoader::LoadAnimatedMesh(const std::string& path)
+{
+	std::unordered_map<std::string, AnimatedMesh*>::iterator loaded = MeshManager::animatedMeshes.find(path);
+	if (loaded != MeshManager::animatedMeshes.end()) return MakeReadyHandle(loaded->second);
+
+	std::unordered_map<std::string, std::shared_ptr<AssetState<AnimatedMesh>>>::iterator it = pendingAnimatedMeshes.find(path);
+	if (it != pendingAnimatedMeshes.end()) return AssetHandle<AnimatedMesh>(it->second);
+
+	std::shared_ptr<AssetState<AnimatedMesh>> state = std::make_shared<AssetState<AnimatedMesh>>();
+	pendingAnimatedMeshes.insert({ path, state });
+	RecordRequest();
+
+	MeshLODSettings lodSettings = MeshManager::GetLODSettings(); // Copied, the worker shouldn't read it while the main thread might change it
+	QueueLoad([state, path, lodSettings]()
+	{
+		PROFILE_ZONE("LoadAnimatedMesh");
+		AnimatedMesh* mesh = new AnimatedMesh(path, false);
+		mesh->GenerateLODs(lodSettings);
+
+		QueueUpload([state, path, mesh]()
+		{
+			mesh->Upload();
+			MeshManager::animatedMeshes.insert({ path, mesh });
+
+			state->asset = mesh;
+			state->ready.store(true, std::memory_order_release);
+			pendingAnimatedMeshes.erase(path);
+			RecordCompletion(mesh->GetSubmeshes().empty());
+		});
+	});
+
+	return AssetHandle<AnimatedMesh>(state);
+}
+
+AssetHandle<Animation> AssetLoader::LoadAnimation(const std::string& path)
+{
+	std::unordered_map<std::string, Animation*>::iterator loaded = MeshManager::animations.find(path);
+	if (loaded != MeshManager::animations.end()) return MakeReadyHandle(loaded->second);
+
+	std::unordered_map<std::string, std::shared_ptr<AssetState<Animation>>>::iterator it = pendingAnimations.find(path);
+	if (it != pendingAnimations.end()) return AssetHandle<Animation>(it->second);
+
+	std::shared_ptr<AssetState<Animation>> state = std::make_shared<AssetState<Animation>>();
+	pendingAnimations.insert({ path, state });
+	RecordRequest();
+
+	float sampleRate = MeshManager::GetAnimationSampleRate();
+	AnimationCompressionSettings compressionSettings = MeshManager::GetAnimationCompressionSettings(); // Copied, the worker shouldn't read it while the main thread might change it
+	QueueLoad([state, path, sampleRate, compressionSettings]()
+	{
+		PROFILE_ZONE("LoadAnimation");
+		Animation* animation = new Animation(path);
+		animation->Resample(sampleRate);
+		animation->Compress(compressionSettings);
+
+		// Nothing to upload, this only hands the animation over to the main thread so the MeshManager is never touched from a worker
+		QueueUpload([state, path, animation]()
+		{
+			MeshManager::animations.insert({ path, animation });
+
+			state->asset = animation;
+			state->ready.store(true, std::memory_order_release);
+			pendingAnimations.erase(path);
+			RecordCompletion(false);
+		});
+	});
+
+	return AssetHandle<Animation>(state);
+}
+
+AssetHandle<Texture2D> AssetLoader::LoadTexture2D(const std::string& path, TextureFilterType filterType, TextureWrapType wrapType)
+{
+	std::unordered_map<std::string, Texture2D*>::iterator loaded = textures.find(path);
+	if (loaded != textures.end()) return MakeReadyHandle(loaded->second);
+
+	std::unordered_map<std::string, std::shared_ptr<AssetState<Texture2D>>>::iterator it = pendingTextures.find(path);
+	if (it != pendingTextures.end()) return AssetHandle<Texture2D>(it->second);
+
+	std::shared_ptr<AssetState<Texture2D>> state = std::make_shared<AssetState<Texture2D>>();
+	pendingTextures.insert({ path, state });
+	RecordRequest();
+
+	QueueLoad([state, path, filterType, wrapType]()
+	{
+		PROFILE_ZONE("LoadTexture2D");
+		int width = 0;
+		int height = 0;
+		int channels = 0;
+		unsigned char* pixels = stbi_load(path.c_str(), &width, &height, &channels, 4);
+
+		QueueUpload([state, path, filterType, wrapType, pixels, width, height]()
+		{
+			Texture2D* texture = nullptr;
+			if (pixels)
+			{
+				texture = TextureManager::CreateTexture2D(pixels, GL_RGBA8, GL_RGBA, GL_UNSIGNED_BYTE, width, height, filterType, wrapType);
+				stbi_image_free(pixels);
+				textures.insert({ path, texture });
+				texturePaths.insert({ texture, path });
+			}
+			else
+			{
+				std::cout << "Failed to load texture " << path << ": " << stbi_failure_reason() << std::endl;
+			}
+
+			state->asset = texture;
+			state->ready.store(true, std::memory_order_release);
+			pendingTextures.erase(path);
+			RecordCompletion(texture == nullptr);
+		});
+	});
+
+	return AssetHandle<Texture2D>(state);
+}
+
+std::string AssetLoader::GetTexturePath(const ITexture* texture)
+{
+	std::string path = texture->GetPath();
+	if (!path.empty()) return path;
+
+	std::unordered_map<const ITexture*, std::string>::iterator it = texturePaths.find(texture);
+	return it != texturePaths.end() ? it->second : path;
+}
+
+void AssetLoader::RecordRequest()
+{
+	if (stats.requested == 0) firstRequest = Clock::now();
+	stats.requested++;
+}
+
+void AssetLoader::RecordCompletion(bool failed)
+{
+	stats.completed++;
+	if (failed) stats.failed++;
+	lastCompletion = Clock::now();
+}
+
+void AssetLoader::RecordStall(Clock::time_point start)
+{
+	stats.longestStallMilliseconds = std::max(stats.longestStallMilliseconds, MillisecondsSince(start));
+}
+
+AssetLoadStats AssetLoader::GetStats()
+{
+	std::lock_guard<std::mutex> lock(statsMutex);
+	return stats;
+}
+
+void AssetLoader::PrintReport(const std::string& label)
+{
+	AssetLoadStats report = GetStats();
+	double loadMilliseconds = report.completed > 0 ? std::chrono::duration<double, std::milli>(lastCompletion - firstRequest).count() : 0.0;
+
+	std::cout << label << ": " << report.completed << "/" << report.requested << " assets (" << report.failed << " failed) in " << loadMilliseconds << "ms"
+		<< " | worker time " << report.workerMilliseconds << "ms on " << std::max((size_t)1, workers.size()) << " thread(s)"
+		<< " | uploads " << report.uploadMilliseconds << "ms, longest " << report.longestUploadMilliseconds << "ms"
+		<< " | longest main thread stall " << report.longestStallMilliseconds << "ms" << std::endl;
+}
\ No newline at end of file
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "Mesh.h"
+#include "AnimatedMesh.h"
+#include "Animation.h"
+#include "Texture2D.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+template<typename T>
+struct AssetState
+{
+	std::atomic<bool> ready{ false };
+	T* asset = nullptr; // Stays nullptr if loading failed
+};
+
+// Refers to an asset that might still be loading. Converts to the raw pointer so it can be dropped in wherever the pointer was used, it's nullptr until the asset is ready
+template<typename T>
+class AssetHandle
+{
+public:
+	AssetHandle() {}
+
+	bool IsValid() const { return state != nullptr; }
+	bool IsReady() const { return state && state->ready.load(std::memory_order_acquire); }
+	T* Get() const { return IsReady() ? state->asset : nullptr; }
+
+	operator T*() const { return Get(); }
+	T* operator->() const { return Get(); }
+
+private:
+	friend class AssetLoader;
+
+	explicit AssetHandle(const std::shared_ptr<AssetState<T>>& state) : state(state) {}
+
+	std::shared_ptr<AssetState<T>> state;
+};
+
+struct AssetLoadStats
+{
+	unsigned int requested = 0;
+	unsigned int completed = 0;
+	unsigned int failed = 0;
+	double workerMilliseconds = 0.0; // File I/O, Assimp & image decoding, summed over every worker
+	double uploadMilliseconds = 0.0; // GL uploads on the main thread
+	double longestUploadMilliseconds = 0.0; // Longest single upload, the smallest stall the upload budget can't split up
+	double longestStallMilliseconds = 0.0; // Longest the main thread spent in ProcessUploads or waiting on the loader in one go
+};
+
+// Loads meshes, animations & textures on a few background threads. File I/O, the Assimp import and image decoding happen on the workers,
+// whatever has to touch GL is queued back to the main thread and run by ProcessUploads within a time budget.
+// Loaded meshes & animations are registered with the MeshManager, so MeshManager::Get*() returns them afterwards (and waits for them if they're still loading)
+class AssetLoader
+{
+public:
+	static void Initialize(unsigned int workerCount = 0); // 0 = one worker per hardware thread, minus the main thread
+	static void CleanUp(); // Waits for the workers to finish what they're doing, anything still queued is dropped
+
+	static AssetHandle<Mesh> LoadMesh(const std::string& path);
+	static AssetHandle<AnimatedMesh> LoadAnimatedMesh(const std::string& path);
+	static AssetHandle<Animation> LoadAnimation(const std::string& path);
+
+	// Decoded on a worker & uploaded as RGBA8. The texture itself doesn't know its path, GetTexturePath does
+	static AssetHandle<Texture2D> LoadTexture2D(const std::string& path, TextureFilterType filterType, TextureWrapType wrapType);
+
+	// What the serializers should save for a texture, its own path or the one LoadTexture2D loaded it from
+	static std::string GetTexturePath(const ITexture* texture);
+
+	static void ProcessUploads(float budgetMilliseconds); // Main thread only. Always runs at least one upload if there is one
+	static void Wait(const std::string& path); // Main thread only. Blocks until path is ready, running uploads in the meantime
+	static void WaitForAll(); // Main thread only
+
+	static bool IsLoading(const std::string& path);
+	static unsigned int GetPendingCount();
+
+	static AssetLoadStats GetStats();
+	static void PrintReport(const std::string& label); // Load time since the first request plus the stats above
+
+private:
+	typedef std::chrono::steady_clock Clock;
+
+	static void WorkerLoop();
+	static void QueueLoad(const std::function<void()>& task);
+	static void QueueUpload(const std::function<void()>& task); // Called from the workers
+	static bool RunUpload(); // false if there was nothing to upload
+	static void WaitForUpload(); // Sleeps until a worker queues an upload
+
+	template<typename T>
+	static AssetHandle<T> MakeReadyHandle(T* asset);
+
+	static void RecordRequest();
+	static void RecordCompletion(bool failed); // Main thread, once an asset is ready
+	static void RecordStall(Clock::time_point start);
+
+	static std::vector<std::thread> workers;
+	static std::mutex loadMutex;
+	static std::condition_variable loadCondition;
+	static std::deque<std::function<void()>> loadQueue;
+	static bool running;
+
+	static std::mutex uploadMutex;
+	static std::condition_variable uploadCondition;
+	static std::deque<std::function<void()>> uploadQueue;
+
+	// Assets that were requested but aren't ready yet, so asking for them again hands out the same state. Only touched on the main thread
+	static std::unordered_map<std::string, std::shared_ptr<AssetState<Mesh>>> pendingMeshes;
+	static std::unordered_map<std::string, std::shared_ptr<AssetState<AnimatedMesh>>> pendingAnimatedMeshes;
+	static std::unordered_map<std::string, std::shared_ptr<AssetState<Animation>>> pendingAnimations;
+	static std::unordered_map<std::string, std::shared_ptr<AssetState<Texture2D>>> pendingTextures;
+	static std::unordered_map<std::string, Texture2D*> textures;
+	static std::unordered_map<const ITexture*, std::string> texturePaths; // The other way around, for GetTexturePath
+
+	static std::mutex statsMutex; // Workers add their time to stats.workerMilliseconds, everything else is only written on the main thread
+	static AssetLoadStats stats;
+	static Clock::time_point firstRequest;
+	static Clock::time_point lastCompletion;
+};
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "GameEngine.h"
+#include "GLState.h"
+#include "NullRenderDevice.h"
 
 #include "PhysicsWorld.h"
 #include "ShaderLibrary.h"
@@ -9,6 +11,8 @@
 #include "Profiler.h"
 #include "MeshManager.h"
 #include "PhysicsFactory.h"
+#include "JobSystem.h"
+#include "AssetLoader.h"
 
 #include "PositionComponent.h"
 #include "ScaleComponent.h"
@@ -21,6 +25,8 @@
 #include "vendor/imgui/imgui_impl_opengl3.h"
 #include "vendor/imgui/imgui_impl_glfw.h"
 
+static const float ASSET_UPLOAD_BUDGET_MS = 2.0f; // Main thread time per frame for finishing assets the loader streamed in
+
 static void ErrorCallback(int error, const char* description)
 {
     fprintf(stderr, "[ERROR] %d: %s\n", error, description);
@@ -31,9 +37,12 @@ GameEngine::GameEngine(const WindowSpecs& windowSpecs, bool editorMode)
     windowSpecs(windowSpecs),
     physicsFactory(new PhysicsFactory()),
     physicsWorld(physicsFactory->CreateWorld()),
-    debugMode(false)
+    debugMode(false),
+    headless(windowSpecs.window == nullptr)
 {
 	// Initialize systems
+    Profiler::SetThreadName("Main");
+    JobSystem::Initialize();
     InputManager::Initialize(windowSpecs.window);
     TextureManager::Initialize();
 	Renderer::Initialize(camera, &this->windowSpecs);
@@ -52,7 +61,10 @@ GameEngine::~GameEngine()
     SoundManager::CleanUp();
     Entity::CleanComponentListeners();
     TextureManager::CleanUp(); // This should be last, to give other things time if they want to remove textures
+    AssetLoader::CleanUp();
     MeshManager::CleanUp();
+    JobSystem::CleanUp();
+    Profiler::CleanUp(); // After the job system, its workers record zones too
 }
 
 void GameEngine::Render()
@@ -65,21 +77,27 @@ void GameEngine::Render()
     }
 
     // Render ImGui
-    if (editorMode)
+    if (editorMode && !headless)
     {
         ImGui::Render();
         ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
     }
+    else if (headless)
+    {
+        ImGui::EndFrame(); // Nothing to draw it to
+    }
 }
 
 void GameEngine::SubmitEntitiesToRender(VertexArrayObject* lineVAO, VertexBuffer* lineVBO, IndexBuffer* lineEBO)
 {
-    Profiler::BeginProfile("EntitySubmission");
+    PROFILE_ZONE("EntitySubmission");
 
     const std::vector<Entity*>& entities = entityManager.GetEntities();
     std::vector<LineRenderComponent*> lines;
 
     const Frustum& viewFrustum = Renderer::viewFrustum;
+    const MeshLODSelection& lodSelection = Renderer::lodSelection;
+    float lodProjectionScale = MeshLODUtils::GetProjectionScale(Renderer::projection, (float)Renderer::windowDetails->height);
 
     for (Entity* entity : entities)
     {
@@ -115,17 +133,56 @@ void GameEngine::SubmitEntitiesToRender(VertexArrayObject* lineVAO, VertexBuffer
         {
             SkeletalAnimationComponent* animComp = entity->GetComponent<SkeletalAnimationComponent>();
 
-            if (renderComponent->mesh->GetBoundingBox()->IsOnFrustum(viewFrustum, transform)) // Can we see this mesh?
+            // Animated meshes are culled with the box around their current pose, limbs can leave the bind pose box
+            bool hasPoseBounds = animComp && animComp->HasBounds();
+            AABB poseBounds(hasPoseBounds ? animComp->GetBoundsMin() : glm::vec3(0.0f), hasPoseBounds ? animComp->GetBoundsMax() : glm::vec3(0.0f), false);
+            const AABB* cullingBounds = hasPoseBounds ? &poseBounds : renderComponent->mesh->GetBoundingBox();
+
+            // Read by the SkeletalAnimationLayer next frame to pick the character's animation LOD
+            const AABB* bounds = renderComponent->mesh->GetBoundingBox();
+            if (animComp)
+            {
+                animComp->visible = false;
+                animComp->shadowVisible = false;
+                if (cullingBounds)
+                {
+                    float maxScale = glm::max(glm::abs(scaleComponent->value.x), glm::max(glm::abs(scaleComponent->value.y), glm::abs(scaleComponent->value.z)));
+                    glm::vec3 boundsCenter = glm::vec3(transform * glm::vec4(cullingBounds->GetCenter(), 1.0f));
+                    animComp->screenSize = cullingBounds->GetBoundingRadius() * maxScale * lodProjectionScale / glm::max(glm::length(Renderer::cameraPos - boundsCenter), Renderer::nearPlane);
+                }
+            }
+
+            // Pick the coarsest LOD whose error stays below a pixel or so, measured from the closest point of the mesh's bounding sphere
+            const std::vector<float>& lodErrors = renderComponent->mesh->GetLODErrors();
+            unsigned int shadowLOD = 0;
+            if (bounds && lodErrors.size() > 1)
+            {
+                float maxScale = glm::max(glm::abs(scaleComponent->value.x), glm::max(glm::abs(scaleComponent->value.y), glm::abs(scaleComponent->value.z)));
+                glm::vec3 boundsCenter = glm::vec3(transform * glm::vec4(bounds->GetCenter(), 1.0f));
+                float distance = glm::length(Renderer::cameraPos - boundsCenter) - bounds->GetBoundingRadius() * maxScale;
+
+                renderComponent->lod = MeshLODUtils::SelectLOD(lodErrors, maxScale, glm::max(distance, Renderer::nearPlane), lodProjectionScale, renderComponent->lod, lodSelection);
+                shadowLOD = glm::min(renderComponent->lod + lodSelection.shadowBias, (unsigned int)lodErrors.size() - 1); // Shadow maps are lower res than the screen, they get away with less
+            }
+            else
+            {
+                renderComponent->lod = 0;
+            }
+
+            if (cullingBounds->IsOnFrustum(viewFrustum, transform)) // Can we see this mesh?
             {
                 // Tell the renderer to render this entity
                 RenderSubmission submission(renderComponent, posComponent->value, scaleComponent->value, rotComponent->value, transform);
+                submission.lod = renderComponent->lod;
 
                 // Submit the entity to be rendered!
                 if (animComp) // We are animated
                 {
+                    animComp->visible = true;
+
                     // Apply bone data to submission if the entity is animated
-                    submission.boneMatrices = animComp->boneMatrices.data();
-                    submission.boneMatricesLength = animComp->boneMatrices.size();
+                    submission.boneMatrices = animComp->GetBoneMatrices();
+                    submission.boneMatricesLength = animComp->GetBoneCount();
 
                     Renderer::culledAnimatedSubmissions.push_back(submission);
                 }
@@ -151,15 +208,26 @@ void GameEngine::SubmitEntitiesToRender(VertexArrayObject* lineVAO, VertexBuffer
                 }
             }
 
+            // Animated meshes measure from the closest point of their pose's bounding sphere, so a reaching limb inside the radius still casts
+            float shadowDistance = glm::length(Renderer::cameraPos - posComponent->value);
+            if (hasPoseBounds)
+            {
+                float maxScale = glm::max(glm::abs(scaleComponent->value.x), glm::max(glm::abs(scaleComponent->value.y), glm::abs(scaleComponent->value.z)));
+                glm::vec3 boundsCenter = glm::vec3(transform * glm::vec4(poseBounds.GetCenter(), 1.0f));
+                shadowDistance = glm::length(Renderer::cameraPos - boundsCenter) - poseBounds.GetBoundingRadius() * maxScale;
+            }
+
             // Add to shadow submission
-            if (renderComponent->castShadows && glm::length(Renderer::cameraPos - posComponent->value) <= Renderer::shadowCullRadius) // We should cast shadows!
+            if (renderComponent->castShadows && shadowDistance <= Renderer::shadowCullRadius) // We should cast shadows!
             {
                 RenderSubmission submission(renderComponent, posComponent->value, scaleComponent->value, rotComponent->value, transform);
+                submission.lod = shadowLOD;
 
                 if (animComp)
                 {
-                    submission.boneMatrices = animComp->boneMatrices.data();
-                    submission.boneMatricesLength = animComp->boneMatrices.size();
+                    animComp->shadowVisible = true;
+                    submission.boneMatrices = animComp->GetBoneMatrices();
+                    submission.boneMatricesLength = animComp->GetBoneCount();
                     Renderer::culledAnimatedShadowSubmissions.push_back(submission);
                 }
                 else
@@ -215,23 +283,23 @@ void GameEngine::SubmitEntitiesToRender(VertexArrayObject* lineVAO, VertexBuffer
     lineSubmission.transform = glm::mat4(1.0f);
 
     Renderer::lineSubmissions.push_back(lineSubmission);
-
-    Profiler::EndProfile("EntitySubmission");
 }
 
-void GameEngine::Run()
+void GameEngine::Run(unsigned int frameCount)
 {
     this->running = true;
 
-    float lastFrameTime = glfwGetTime();
+    unsigned int frame = 0;
+    float startTime = glfwGetTime();
+    float lastFrameTime = startTime;
     float deltaTime = 0.0f;
-    while (running)
+    while (running && (frameCount == 0 || frame < frameCount))
     {
         float currentFrameTime = glfwGetTime();
         deltaTime = std::min(currentFrameTime - lastFrameTime, 0.1f);
         lastFrameTime = currentFrameTime;
 
-        glfwPollEvents();
+        if (windowSpecs.window) glfwPollEvents();
 
         // Update 3D listener
         ListenerInfo listenerInfo;
@@ -244,10 +312,20 @@ void GameEngine::Run()
         // Update camera
         camera.Update(deltaTime);
 
-        physicsWorld->Update(deltaTime);
+        {
+            PROFILE_ZONE("Physics");
+            physicsWorld->Update(deltaTime);
+        }
 
-        // Start ImGui frame
-        if (editorMode)
+        // Start ImGui frame. Headless runs need one as well since some passes build their debug UI every frame
+        if (headless)
+        {
+            ImGuiIO& io = ImGui::GetIO();
+            io.DisplaySize = ImVec2((float)windowSpecs.width, (float)windowSpecs.height);
+            io.DeltaTime = deltaTime > 0.0f ? deltaTime : 1.0f / 60.0f;
+            ImGui::NewFrame();
+        }
+        else if (editorMode)
         {
             ImGui_ImplOpenGL3_NewFrame();
             ImGui_ImplGlfw_NewFrame();
@@ -256,9 +334,14 @@ void GameEngine::Run()
 
         Renderer::BeginFrame(camera);
 
-        for (ApplicationLayer* layer : this->layerManager) 
+        AssetLoader::ProcessUploads(ASSET_UPLOAD_BUDGET_MS);
+
         {
-            layer->OnUpdate(deltaTime);
+            PROFILE_ZONE("Layers");
+            for (ApplicationLayer* layer : this->layerManager) 
+            {
+                layer->OnUpdate(deltaTime);
+            }
         }
 
         InputManager::ClearState();
@@ -274,6 +357,7 @@ void GameEngine::Run()
         Render();
 
         Renderer::EndFrame();
+        Profiler::EndFrame();
 
         if (lineVAO)
         {
@@ -281,9 +365,27 @@ void GameEngine::Run()
             delete lineVBO;
             delete lineEBO;
         }
+
+        frame++;
     }
 
-    if (editorMode)
+    if (NullRenderDevice::IsActive())
+    {
+        const NullRenderDeviceStats& stats = NullRenderDevice::GetTotalStats();
+        float elapsed = glfwGetTime() - startTime;
+
+        std::cout << "Headless run finished: " << frame << " frames in " << elapsed << "s (" << (frame > 0 ? elapsed * 1000.0f / frame : 0.0f) << "ms per frame)\n";
+        std::cout << "Draw calls: " << stats.drawCalls << ", vertices: " << stats.vertices << ", dispatches: " << stats.dispatches << "\n";
+        std::cout << "Buffer uploads: " << stats.bufferUploads << " (" << stats.bufferBytesUploaded / 1024 << "KB), allocated " << stats.bufferBytesAllocated / 1024 << "KB\n";
+        std::cout << "Texture uploads: " << stats.textureUploads << " (" << stats.textureBytesUploaded / 1024 << "KB), allocated " << stats.textureBytesAllocated / 1024 << "KB\n";
+        std::cout << "Objects created: " << stats.objectsCreated << ", other calls: " << stats.otherCalls << std::endl;
+    }
+
+    if (headless)
+    {
+        ImGui::DestroyContext();
+    }
+    else if (editorMode)
     {
         ImGui_ImplOpenGL3_Shutdown();
         ImGui_ImplGlfw_Shutdown();
@@ -291,6 +393,18 @@ void GameEngine::Run()
     }
 }
 
+void GameEngine::InitializeGLState()
+{
+    GLState::Enable(GL_DEPTH_TEST);
+    glDepthFunc(GL_LEQUAL);  // Set depth function to less than AND equal for skybox depth trick.
+    GLState::Enable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
+
+    GLState::Enable(GL_CULL_FACE);
+    GLState::CullFace(GL_BACK);
+
+    GLState::Enable(GL_TEXTURE_3D);
+}
+
 WindowSpecs GameEngine::InitializeGLFW(bool initImGui)
 {
     WindowSpecs windowSpecs;
@@ -334,14 +448,8 @@ WindowSpecs GameEngine::InitializeGLFW(bool initImGui)
     }
     glfwSwapInterval(1);
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LEQUAL);  // Set depth function to less than AND equal for skybox depth trick.
-    glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
-
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-
-    glEnable(GL_TEXTURE_3D);
+    InitializeGLState();
+    AssetLoader::Initialize(); // Assets get requested before the engine is constructed
 
     // Assign callbacks
     glfwSetKeyCallback(window, InputManager::KeyCallback);
@@ -394,4 +502,48 @@ void GameEngine::RemoveLayer(ApplicationLayer* layer)
 void GameEngine::RemoveOverlay(ApplicationLayer* layer)
 {
     this->layerManager.RemoveOverlay(layer, true);
+}
+
+WindowSpecs GameEngine::InitializeHeadless(int width, int height)
+{
+    WindowSpecs windowSpecs;
+    windowSpecs.window = nullptr;
+    windowSpecs.width = 0;
+    windowSpecs.height = 0;
+
+    // No window is created, GLFW is only initialized for its timer
+    if (!glfwInit())
+    {
+        std::cout << "Error initializing GLFW!\n";
+        return windowSpecs;
+    }
+
+    glfwSetErrorCallback(ErrorCallback);
+
+    if (!NullRenderDevice::Load())
+    {
+        return windowSpecs;
+    }
+
+    InitializeGLState();
+    AssetLoader::Initialize(); // Assets get requested before the engine is constructed
+
+    // ImGui without a platform or renderer backend, frames are built and thrown away
+    IMGUI_CHECKVERSION();
+    ImGui::CreateContext();
+    ImGuiIO& io = ImGui::GetIO();
+    io.IniFilename = nullptr; // Don't overwrite the editor's layout
+    unsigned char* fontPixels = nullptr;
+    int fontWidth = 0;
+    int fontHeight = 0;
+    io.Fonts->GetTexDataAsRGBA32(&fontPixels, &fontWidth, &fontHeight); // NewFrame() needs the font atlas to be built
+
+    // The renderer still sizes its targets off the window, they just never get drawn to
+    windowSpecs.width = width;
+    windowSpecs.height = height;
+
+    std::cout << "Running headless on the null render device (" << width << "x" << height << ")\n";
+    std::cout << "=================================================================================\n\n";
+
+    return windowSpecs;
 }
\ No newline at end of file
@@ -15,7 +15,7 @@ public:
 	GameEngine(const WindowSpecs& windowSpecs, bool editorMode);
 	~GameEngine();
 
-	void Run();
+	void Run(unsigned int frameCount = 0); // Runs until stopped, or for frameCount frames if it isn't 0
 	void Stop() { running = false; }
 
 	void Render();
@@ -35,10 +35,13 @@ public:
 	Physics::IPhysicsWorld* physicsWorld;
 
 	static WindowSpecs InitializeGLFW(bool initImGui);
+	static WindowSpecs InitializeHeadless(int width, int height); // No window, GL calls go to the null render device. Layers, physics, animation & render submission still run every frame
 
 	bool debugMode;
 
 private:
+	static void InitializeGLState();
+
 	void SubmitEntitiesToRender(VertexArrayObject* lineVAO, VertexBuffer* lineVBO, IndexBuffer* lineEBO);
 
 	ApplicationLayerManager layerManager;
@@ -47,6 +50,7 @@ private:
 	WindowSpecs windowSpecs;
 
 	bool editorMode;
+	bool headless; // No window, see InitializeHeadless
 
 	bool running;
 };
\ No newline at end of file
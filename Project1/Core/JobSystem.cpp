@@ -0,0 +1,130 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+std::vector<std::thread> JobSystem::workers;
+std::mutex JobSystem::mutex;
+std::mutex JobSystem::parallelForMutex;
+std::condition_variable JobSystem::wakeCondition;
+std::condition_variable JobSystem::doneCondition;
+
+const std::function<void(unsigned int, unsigned int)>* JobSystem::currentJob = nullptr;
+unsigned int JobSystem::jobCount = 0;
+unsigned int JobSystem::jobBatchSize = 1;
+std::atomic<unsigned int> JobSystem::nextIndex(0);
+std::atomic<unsigned int> JobSystem::completedCount(0);
+unsigned int JobSystem::generation = 0;
+unsigned int JobSystem::activeWorkers = 0;
+bool JobSystem::running = false;
+
+void JobSystem::Initialize(unsigned int workerCount)
+{
+	if (running) return; // Already initialized
+
+	if (workerCount == 0)
+	{
+		unsigned int hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0; // Leave a thread for the main loop
+	}
+
+	running = true;
+	for (unsigned int i = 0; i < workerCount; i++)
+	{
+		workers.push_back(std::thread(&JobSystem::WorkerLoop));
+	}
+
+	std::cout << "Job system started with " << workerCount << " worker threads" << std::endl;
+}
+
+void JobSystem::CleanUp()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		running = false;
+	}
+	wakeCondition.notify_all();
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+	workers.clear();
+}
+
+void JobSystem::ParallelFor(unsigned int count, unsigned int batchSize, const std::function<void(unsigned int, unsigned int)>& job)
+{
+	if (count == 0) return;
+	if (batchSize == 0) batchSize = 1;
+
+	if (workers.empty() || count <= batchSize) // Not worth waking anyone up
+	{
+		job(0, count);
+		return;
+	}
+
+	PROFILE_ZONE("ParallelFor");
+	std::lock_guard<std::mutex> parallelForLock(parallelForMutex);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		currentJob = &job;
+		jobCount = count;
+		jobBatchSize = batchSize;
+		nextIndex = 0;
+		completedCount = 0;
+		generation++;
+	}
+	wakeCondition.notify_all();
+
+	RunBatches(); // Help out instead of sitting idle
+
+	// Wait for the last batches to finish, and for every worker to let go of the job before it goes out of scope
+	std::unique_lock<std::mutex> lock(mutex);
+	doneCondition.wait(lock, [] { return completedCount >= jobCount && activeWorkers == 0; });
+	currentJob = nullptr;
+}
+
+void JobSystem::WorkerLoop()
+{
+	Profiler::SetThreadName("Job Worker");
+
+	unsigned int lastGeneration = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			wakeCondition.wait(lock, [&lastGeneration] { return !running || (generation != lastGeneration && currentJob); });
+			if (!running) return;
+
+			lastGeneration = generation;
+			activeWorkers++;
+		}
+
+		{
+			PROFILE_ZONE("Jobs");
+			RunBatches();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			activeWorkers--;
+		}
+		doneCondition.notify_one();
+	}
+}
+
+void JobSystem::RunBatches()
+{
+	while (true)
+	{
+		unsigned int start = nextIndex.fetch_add(jobBatchSize);
+		if (start >= jobCount) return;
+
+		unsigned int end = std::min(start + jobBatchSize, jobCount);
+		(*currentJob)(start, end);
+
+		completedCount += end - start;
+	}
+}
\ No newline at end of file
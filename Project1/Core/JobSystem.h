@@ -0,0 +1,41 @@
+#pragma once
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <vector>
+
+// A small fixed pool of worker threads for splitting per-frame CPU work (light binning, animation, etc.) across cores.
+// ParallelFor blocks until every batch is done and the calling thread helps out, so callers can treat it like a regular loop.
+class JobSystem
+{
+public:
+	static void Initialize(unsigned int workerCount = 0); // 0 = one worker per hardware thread, minus the main thread
+	static void CleanUp();
+
+	// Calls job(start, end) over [0, count) in batches of batchSize. Only one ParallelFor can run at a time
+	static void ParallelFor(unsigned int count, unsigned int batchSize, const std::function<void(unsigned int, unsigned int)>& job);
+
+	static unsigned int GetWorkerCount() { return (unsigned int)workers.size(); }
+
+private:
+	static void WorkerLoop();
+	static void RunBatches();
+
+	static std::vector<std::thread> workers;
+	static std::mutex mutex;
+	static std::mutex parallelForMutex;
+	static std::condition_variable wakeCondition;
+	static std::condition_variable doneCondition;
+
+	static const std::function<void(unsigned int, unsigned int)>* currentJob;
+	static unsigned int jobCount;
+	static unsigned int jobBatchSize;
+	static std::atomic<unsigned int> nextIndex;
+	static std::atomic<unsigned int> completedCount;
+	static unsigned int generation; // Bumped every ParallelFor so sleeping workers know there is new work
+	static unsigned int activeWorkers;
+	static bool running;
+};
\ No newline at end of file
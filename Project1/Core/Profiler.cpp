@@ -1,46 +1,485 @@
 #include "Profiler.h"
 
-#include <GLFW/glfw3.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
 
 #include "vendor/imgui/imgui.h"
 
-std::unordered_map<std::string, float> Profiler::startTimes;
-std::unordered_map<std::string, float> Profiler::results;
+static const uint32_t RING_SIZE = 1 << 14; // Events per thread between two EndFrame() calls, has to be a power of two
+static const uint32_t RING_MASK = RING_SIZE - 1;
+static const unsigned int NO_PARENT = 0xFFFFFFFF;
 
-void Profiler::BeginProfile(const std::string& key)
+struct ProfilerEvent
 {
-	startTimes.insert({ key, glfwGetTime() });
+	const char* name; // nullptr for end events
+	uint64_t time;
+};
+
+// A zone in the call tree, the same name under a different parent is a different node
+struct ProfilerNode
+{
+	const char* name;
+	unsigned int parent;
+	std::vector<unsigned int> children;
+
+	uint64_t frameTime; // Accumulated while draining, moved into the history at the end of the frame
+	unsigned int frameCalls;
+
+	float lastTime; // ms
+	unsigned int lastCalls;
+	float history[Profiler::HISTORY_SIZE];
+	unsigned int historyCount;
+	unsigned int historyHead;
+};
+
+struct ProfilerOpenZone
+{
+	unsigned int node;
+	uint64_t start;
+};
+
+struct ProfilerThread
+{
+	// Single producer (the owning thread) single consumer (EndFrame on the main thread) ring buffer
+	ProfilerEvent events[RING_SIZE];
+	std::atomic<uint32_t> head; // Written by the producer
+	std::atomic<uint32_t> tail; // Written by the consumer
+	uint32_t openZones; // Producer only, every open zone keeps a slot free for its end event so a full buffer never drops half a zone
+	std::atomic<unsigned int> droppedZones;
+
+	std::atomic<const char*> name;
+	unsigned int index;
+
+	// Consumer only
+	std::vector<ProfilerNode> nodes; // nodes[0] is the root
+	std::vector<ProfilerOpenZone> openStack;
+};
+
+struct ProfilerTraceEvent
+{
+	const char* name;
+	unsigned int thread;
+	uint64_t start;
+	uint64_t duration;
+};
+
+struct ProfilerStats
+{
+	float min;
+	float avg;
+	float max;
+	float p95;
+};
+
+std::mutex Profiler::threadsMutex;
+std::vector<ProfilerThread*> Profiler::threads;
+
+uint64_t Profiler::lastFrameEnd = 0;
+float Profiler::frameHistory[Profiler::HISTORY_SIZE];
+unsigned int Profiler::frameHistoryCount = 0;
+unsigned int Profiler::frameHistoryHead = 0;
+
+std::string Profiler::tracePath;
+unsigned int Profiler::traceFramesLeft = 0;
+
+std::map<std::string, unsigned int> Profiler::counters;
+
+static thread_local ProfilerThread* currentThread = nullptr;
+static std::vector<ProfilerTraceEvent> traceEvents;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+static uint64_t Now() // Nanoseconds since start up
+{
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+static unsigned int AddNode(ProfilerThread* thread, const char* name, unsigned int parent)
+{
+	ProfilerNode node;
+	node.name = name;
+	node.parent = parent;
+	node.frameTime = 0;
+	node.frameCalls = 0;
+	node.lastTime = 0.0f;
+	node.lastCalls = 0;
+	node.historyCount = 0;
+	node.historyHead = 0;
+	thread->nodes.push_back(node);
+
+	unsigned int index = (unsigned int)thread->nodes.size() - 1;
+	if (parent != NO_PARENT) thread->nodes[parent].children.push_back(index);
+	return index;
 }
 
-void Profiler::EndProfile(const std::string& key)
+static unsigned int FindOrAddChild(ProfilerThread* thread, unsigned int parent, const char* name)
 {
-	float currentTime = glfwGetTime();
-	if (results.find(key) != results.end()) return;
-	if (startTimes.find(key) == startTimes.end()) return;
+	for (unsigned int child : thread->nodes[parent].children)
+	{
+		const char* childName = thread->nodes[child].name;
+		if (childName == name || strcmp(childName, name) == 0) return child; // The same literal can have a different address in each translation unit
+	}
 
-	float timePassed = currentTime - startTimes.at(key);
-	results.insert({key, timePassed});
+	return AddNode(thread, name, parent);
 }
 
-std::unordered_map<std::string, float> Profiler::Results()
+static void PushHistory(float* history, unsigned int& count, unsigned int& head, float value)
 {
-	return results;
+	history[head] = value;
+	head = (head + 1) % Profiler::HISTORY_SIZE;
+	if (count < Profiler::HISTORY_SIZE) count++;
+}
+
+static ProfilerStats ComputeStats(const float* history, unsigned int count)
+{
+	ProfilerStats stats = { 0.0f, 0.0f, 0.0f, 0.0f };
+	if (count == 0) return stats;
+
+	float samples[Profiler::HISTORY_SIZE];
+	std::copy(history, history + count, samples);
+
+	stats.min = samples[0];
+	stats.max = samples[0];
+	float sum = 0.0f;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		stats.min = std::min(stats.min, samples[i]);
+		stats.max = std::max(stats.max, samples[i]);
+		sum += samples[i];
+	}
+	stats.avg = sum / count;
+
+	unsigned int percentileIndex = std::min((count * 95) / 100, count - 1);
+	std::nth_element(samples, samples + percentileIndex, samples + count);
+	stats.p95 = samples[percentileIndex];
+
+	return stats;
+}
+
+ProfilerThread* Profiler::GetThreadState()
+{
+	if (currentThread) return currentThread;
+
+	ProfilerThread* thread = new ProfilerThread();
+	thread->head = 0;
+	thread->tail = 0;
+	thread->openZones = 0;
+	thread->droppedZones = 0;
+	thread->name = nullptr;
+	AddNode(thread, "Root", NO_PARENT);
+
+	std::lock_guard<std::mutex> lock(threadsMutex);
+	thread->index = (unsigned int)threads.size();
+	threads.push_back(thread);
+
+	currentThread = thread;
+	return thread;
+}
+
+bool Profiler::BeginZone(const char* name)
+{
+	ProfilerThread* thread = GetThreadState();
+
+	uint32_t head = thread->head.load(std::memory_order_relaxed);
+	uint32_t tail = thread->tail.load(std::memory_order_acquire);
+	if (RING_SIZE - (head - tail) < thread->openZones + 2) // Room for this zone's begin & end plus the end of every zone that's still open
+	{
+		thread->droppedZones.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	thread->events[head & RING_MASK] = { name, Now() };
+	thread->head.store(head + 1, std::memory_order_release);
+	thread->openZones++;
+	return true;
+}
+
+void Profiler::EndZone()
+{
+	ProfilerThread* thread = currentThread; // Only called after BeginZone succeeded on this thread
+
+	uint32_t head = thread->head.load(std::memory_order_relaxed);
+	thread->events[head & RING_MASK] = { nullptr, Now() };
+	thread->head.store(head + 1, std::memory_order_release);
+	thread->openZones--;
+}
+
+void Profiler::SetThreadName(const char* name)
+{
+	GetThreadState()->name = name;
+}
+
+void Profiler::DrainThread(ProfilerThread* thread)
+{
+	uint32_t head = thread->head.load(std::memory_order_acquire);
+	uint32_t tail = thread->tail.load(std::memory_order_relaxed);
+
+	for (; tail != head; tail++)
+	{
+		const ProfilerEvent& event = thread->events[tail & RING_MASK];
+		if (event.name)
+		{
+			unsigned int parent = thread->openStack.empty() ? 0 : thread->openStack.back().node;
+			thread->openStack.push_back({ FindOrAddChild(thread, parent, event.name), event.time });
+			continue;
+		}
+
+		if (thread->openStack.empty()) continue;
+
+		ProfilerOpenZone zone = thread->openStack.back();
+		thread->openStack.pop_back();
+
+		ProfilerNode& node = thread->nodes[zone.node];
+		node.frameTime += event.time - zone.start;
+		node.frameCalls++;
+
+		if (traceFramesLeft > 0)
+		{
+			traceEvents.push_back({ node.name, thread->index, zone.start, event.time - zone.start });
+		}
+	}
+
+	thread->tail.store(tail, std::memory_order_release);
+
+	// Zones still open (e.g. a worker in the middle of a job) are counted in the frame they end in
+	for (ProfilerNode& node : thread->nodes)
+	{
+		node.lastTime = node.frameTime / 1000000.0f;
+		node.lastCalls = node.frameCalls;
+		if (node.frameCalls > 0) PushHistory(node.history, node.historyCount, node.historyHead, node.lastTime);
+
+		node.frameTime = 0;
+		node.frameCalls = 0;
+	}
+}
+
+void Profiler::EndFrame()
+{
+	uint64_t now = Now();
+	if (lastFrameEnd != 0) PushHistory(frameHistory, frameHistoryCount, frameHistoryHead, (now - lastFrameEnd) / 1000000.0f);
+	lastFrameEnd = now;
+
+	std::vector<ProfilerThread*> threadsToDrain;
+	{
+		std::lock_guard<std::mutex> lock(threadsMutex);
+		threadsToDrain = threads;
+	}
+
+	for (ProfilerThread* thread : threadsToDrain)
+	{
+		DrainThread(thread);
+	}
+
+	if (traceFramesLeft > 0)
+	{
+		traceFramesLeft--;
+		if (traceFramesLeft == 0) WriteTrace();
+	}
+}
+
+void Profiler::CaptureTrace(const std::string& path, unsigned int frameCount)
+{
+	if (traceFramesLeft > 0) return; // Already capturing
+
+	tracePath = path;
+	traceFramesLeft = frameCount;
+	traceEvents.clear();
+}
+
+static void WriteJsonString(std::ofstream& file, const char* value)
+{
+	file << '"';
+	for (const char* c = value; *c; c++)
+	{
+		if (*c == '"' || *c == '\\') file << '\\';
+		file << *c;
+	}
+	file << '"';
+}
+
+static void WriteThreadName(std::ofstream& file, const ProfilerThread* thread)
+{
+	const char* name = thread->name.load();
+	if (name)
+	{
+		WriteJsonString(file, name);
+	}
+	else
+	{
+		file << "\"Thread " << thread->index << "\"";
+	}
+}
+
+void Profiler::WriteTrace()
+{
+	std::ofstream file(tracePath);
+	if (!file.is_open())
+	{
+		std::cout << "Could not write profiler trace to " << tracePath << std::endl;
+		traceEvents.clear();
+		return;
+	}
+
+	// Complete ("X") events, timestamps are in microseconds
+	file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	bool first = true;
+	{
+		std::lock_guard<std::mutex> lock(threadsMutex);
+		for (const ProfilerThread* thread : threads)
+		{
+			if (!first) file << ",";
+			first = false;
+
+			file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << thread->index << ",\"args\":{\"name\":";
+			WriteThreadName(file, thread);
+			file << "}}";
+		}
+	}
+
+	for (const ProfilerTraceEvent& event : traceEvents)
+	{
+		if (!first) file << ",";
+		first = false;
+
+		file << "{\"name\":";
+		WriteJsonString(file, event.name);
+		file << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << event.thread << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0 << "}";
+	}
+
+	file << "]}";
+
+	std::cout << "Wrote " << traceEvents.size() << " profiler zones to " << tracePath << std::endl;
+	traceEvents.clear();
+}
+
+static void DrawNode(const ProfilerThread* thread, unsigned int index)
+{
+	const ProfilerNode& node = thread->nodes[index];
+	ProfilerStats stats = ComputeStats(node.history, node.historyCount);
+
+	ImGui::TableNextRow();
+	ImGui::TableNextColumn();
+
+	ImGuiTreeNodeFlags flags = ImGuiTreeNodeFlags_SpanFullWidth | ImGuiTreeNodeFlags_DefaultOpen;
+	if (node.children.empty()) flags |= ImGuiTreeNodeFlags_Leaf | ImGuiTreeNodeFlags_NoTreePushOnOpen;
+
+	ImGui::PushID((int)index);
+	bool open = ImGui::TreeNodeEx(node.name, flags);
+	ImGui::PopID();
+
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f", node.lastTime);
+	ImGui::TableNextColumn();
+	ImGui::Text("%u", node.lastCalls);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f", stats.min);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f", stats.avg);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f", stats.max);
+	ImGui::TableNextColumn();
+	ImGui::Text("%.3f", stats.p95);
+
+	if (open && !node.children.empty())
+	{
+		for (unsigned int child : node.children)
+		{
+			DrawNode(thread, child);
+		}
+		ImGui::TreePop();
+	}
 }
 
 void Profiler::DrawResults()
 {
 	ImGui::Begin("CPU Profiler");
 
-	std::unordered_map<std::string, float>::iterator it = results.begin();
-	while (it != results.end())
+	ProfilerStats frameStats = ComputeStats(frameHistory, frameHistoryCount);
+	ImGui::Text("Frame: %.3fms avg, %.3fms min, %.3fms max, %.3fms p95 (last %u frames)", frameStats.avg, frameStats.min, frameStats.max, frameStats.p95, frameHistoryCount);
+
+	if (traceFramesLeft > 0)
 	{
-		std::string v = it->first + ": " + std::to_string(it->second * 1000.0f) + "ms";
-		ImGui::Text(v.c_str());
-		it++;
+		ImGui::Text("Capturing trace, %u frames left...", traceFramesLeft);
+	}
+	else if (ImGui::Button("Capture Trace"))
+	{
+		CaptureTrace("profiler_trace.json", 120);
+	}
+
+	std::vector<ProfilerThread*> threadsToDraw;
+	{
+		std::lock_guard<std::mutex> lock(threadsMutex);
+		threadsToDraw = threads;
+	}
+
+	for (const ProfilerThread* thread : threadsToDraw)
+	{
+		const ProfilerNode& root = thread->nodes[0];
+		if (root.children.empty()) continue;
+
+		const char* name = thread->name.load();
+		std::string label = name ? std::string(name) : "Thread " + std::to_string(thread->index);
+		unsigned int dropped = thread->droppedZones.load(std::memory_order_relaxed);
+		if (dropped > 0) label += " (" + std::to_string(dropped) + " zones dropped)";
+
+		ImGui::PushID((int)thread->index);
+		if (ImGui::CollapsingHeader(label.c_str(), ImGuiTreeNodeFlags_DefaultOpen))
+		{
+			ImGuiTableFlags tableFlags = ImGuiTableFlags_BordersV | ImGuiTableFlags_BordersOuterH | ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable;
+			if (ImGui::BeginTable("Zones", 7, tableFlags))
+			{
+				ImGui::TableSetupColumn("Zone", ImGuiTableColumnFlags_WidthStretch);
+				ImGui::TableSetupColumn("ms", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableSetupColumn("Calls", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableSetupColumn("Min", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableSetupColumn("Avg", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableSetupColumn("P95", ImGuiTableColumnFlags_WidthFixed);
+				ImGui::TableHeadersRow();
+
+				for (unsigned int child : root.children)
+				{
+					DrawNode(thread, child);
+				}
+
+				ImGui::EndTable();
+			}
+		}
+		ImGui::PopID();
+	}
+
+	if (!counters.empty())
+	{
+		ImGui::Separator();
+		std::map<std::string, unsigned int>::iterator counterIt = counters.begin();
+		while (counterIt != counters.end())
+		{
+			std::string v = counterIt->first + ": " + std::to_string(counterIt->second);
+			ImGui::Text(v.c_str());
+			counterIt++;
+		}
 	}
 
 	ImGui::End();
+}
 
-	startTimes.clear();
-	results.clear();
+void Profiler::CleanUp()
+{
+	std::lock_guard<std::mutex> lock(threadsMutex);
+	for (ProfilerThread* thread : threads)
+	{
+		delete thread;
+	}
+	threads.clear();
+	currentThread = nullptr; // Only resets the calling thread, the others are expected to be gone
+}
+
+void Profiler::SetCounter(const std::string& key, unsigned int value)
+{
+	counters[key] = value;
 }
\ No newline at end of file
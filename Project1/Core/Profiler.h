@@ -1,17 +1,67 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
+struct ProfilerThread;
+
+// Hierarchical CPU profiler. Zones are opened with PROFILE_ZONE("Name") and closed when the scope ends, they nest and can be used from any thread.
+// Recording a zone only pushes a begin & end event into a ring buffer owned by the calling thread, no locks or allocations. Once a frame EndFrame() drains
+// every thread's events into a call tree, keeps a few seconds of history per zone and, while a capture is running, collects the zones for a Chrome trace (chrome://tracing or Perfetto).
+// Zone names have to outlive the profiler, use string literals
 class Profiler
 {
 public:
+	static const unsigned int HISTORY_SIZE = 240; // Frames of history kept per zone
 
-	static void BeginProfile(const std::string& key);
-	static void EndProfile(const std::string& key);
-	static std::unordered_map<std::string, float> Results();
+	static void EndFrame(); // Call once per frame on the main thread, outside of any zone
 	static void DrawResults();
+	static void CleanUp(); // Only once every other thread that recorded zones has stopped
+
+	static void SetThreadName(const char* name); // Shown in the profiler & the trace instead of "Thread N"
+	static void CaptureTrace(const std::string& path, unsigned int frameCount); // Records the next frameCount frames and writes them to path as Chrome trace JSON
+
+	static void SetCounter(const std::string& key, unsigned int value); // Counters are shown under the timings and keep their value until they're set again
+
+	// Used by ProfileZone, returns false if the zone wasn't recorded because the thread's ring buffer is full
+	static bool BeginZone(const char* name);
+	static void EndZone();
+
+private:
+	static ProfilerThread* GetThreadState();
+	static void DrainThread(ProfilerThread* thread);
+	static void WriteTrace();
+
+	static std::mutex threadsMutex; // Only taken when a thread records its first zone and once per frame
+	static std::vector<ProfilerThread*> threads;
+
+	static uint64_t lastFrameEnd;
+	static float frameHistory[HISTORY_SIZE];
+	static unsigned int frameHistoryCount;
+	static unsigned int frameHistoryHead;
+
+	static std::string tracePath;
+	static unsigned int traceFramesLeft;
+
+	static std::map<std::string, unsigned int> counters;
+};
+
+class ProfileZone
+{
+public:
+	explicit ProfileZone(const char* name) : recorded(Profiler::BeginZone(name)) {}
+	~ProfileZone() { if (recorded) Profiler::EndZone(); }
+
+	ProfileZone(const ProfileZone&) = delete;
+	ProfileZone& operator=(const ProfileZone&) = delete;
+
 private:
-	static std::unordered_map<std::string, float> startTimes;
-	static std::unordered_map<std::string, float> results;
-};
\ No newline at end of file
+	bool recorded;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Non-owning view over contiguous elements. Only valid while the storage it was created from is alive and isn't resized
+template<typename T>
+class Span
+{
+public:
+	Span() : data(nullptr), size(0) {}
+	Span(T* data, size_t size) : data(data), size(size) {}
+
+	T* Data() const { return data; }
+	size_t Size() const { return size; }
+	size_t SizeBytes() const { return size * sizeof(T); }
+	bool Empty() const { return size == 0; }
+
+	T& operator[](size_t index) const { return data[index]; }
+
+	T* begin() const { return data; }
+	T* end() const { return data + size; }
+
+private:
+	T* data;
+	size_t size;
+};
+
+// Non-owning view over one attribute of an interleaved array, e.g. the positions inside an array of vertices
+template<typename T>
+class StridedSpan
+{
+public:
+	StridedSpan() : data(nullptr), size(0), stride(sizeof(T)) {}
+	StridedSpan(T* data, size_t size, size_t stride) : data(data), size(size), stride(stride) {}
+
+	size_t Size() const { return size; }
+	size_t Stride() const { return stride; }
+	bool Empty() const { return size == 0; }
+
+	T& operator[](size_t index) const
+	{
+		typedef typename std::conditional<std::is_const<T>::value, const uint8_t, uint8_t>::type Byte;
+		return *reinterpret_cast<T*>(reinterpret_cast<Byte*>(data) + index * stride);
+	}
+
+private:
+	T* data;
+	size_t size;
+	size_t stride; // Bytes between consecutive elements
+};
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Component.h"
+#include "KeyFrameCursor.h"
 
 #include <glm/gtx/quaternion.hpp>
 #include <vector>
@@ -74,4 +75,9 @@ struct AnimationComponent : Component
 	std::vector<KeyFramePositionComponent> keyFramePositions;
 	std::vector<KeyFrameScaleComponent> keyFrameScales;
 	std::vector<KeyFrameRotationComponent> keyFrameRotations;
+
+	// Where the AnimationLayer found the active key frames last frame
+	KeyFrameCursor positionCursor;
+	KeyFrameCursor scaleCursor;
+	KeyFrameCursor rotationCursor;
 };
\ No newline at end of file
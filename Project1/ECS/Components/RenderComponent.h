@@ -5,9 +5,13 @@
 #include "ITexture.h"
 #include "ReflectRefract.h"
 #include "Shader.h"
+#include "GLState.h"
+#include "VertexCompression.h"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+
 enum class FaceCullType
 {
 	None,
@@ -74,7 +78,8 @@ struct RenderComponent : public Component
 		surfaceShadowSoftness(1.0f),
 		castingShadownSoftness(0.75f),
 		reflectRefractMapPriority(ReflectRefractMapPriorityType::High),
-		faceCullType(FaceCullType::Back)
+		faceCullType(FaceCullType::Back),
+		lod(0)
 	{}
 
 	RenderComponent(const RenderInfo& renderInfo)
@@ -99,7 +104,8 @@ struct RenderComponent : public Component
 		castingShadownSoftness(renderInfo.castingShadownSoftness),
 		reflectRefractData(renderInfo.reflectRefractType, renderInfo.reflectRefractMapType, renderInfo.reflectRefractCustomMap, renderInfo.reflectRefractStrength, renderInfo.refractRatio),
 		reflectRefractMapPriority(renderInfo.reflectRefractMapPriority),
-		faceCullType(renderInfo.faceCullType)
+		faceCullType(renderInfo.faceCullType),
+		lod(0)
 	{}
 
 	bool HasMaterialTextures() const
@@ -107,22 +113,42 @@ struct RenderComponent : public Component
 		return ormTexture;
 	}
 
-	void Draw(const Shader* shader, const glm::mat4& transform)
+	// skinnedVertexArray draws vertices the SkinningPass already skinned instead of the mesh's own, starting at skinnedVertexStart. Their positions are plain floats
+	void Draw(const Shader* shader, UniformHandle modelUniform, const glm::mat4& transform, unsigned int drawLOD = 0, VertexArrayObject* skinnedVertexArray = nullptr, unsigned int skinnedVertexStart = 0)
 	{
-		if (isWireframe)
+		GLState::PolygonMode(isWireframe ? GL_LINE : GL_FILL);
+
+		if (modelUniform.IsValid()) // Passes that stream a uDrawData block have already written the model matrix
 		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+			shader->SetMat4(modelUniform, transform); // Same for every submesh
 		}
-		else
+
+		if (skinnedVertexArray) // Nothing to decode, every submesh shares the same identity bounds
 		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+			glVertexAttrib3f(POSITION_OFFSET_ATTRIBUTE_LOCATION, 0.0f, 0.0f, 0.0f);
+			glVertexAttrib3f(POSITION_SCALE_ATTRIBUTE_LOCATION, 1.0f, 1.0f, 1.0f);
 		}
 
-		mesh->GetVertexArray()->Bind();
+		(skinnedVertexArray ? skinnedVertexArray : mesh->GetVertexArray())->Bind();
 		for (Submesh& submesh : mesh->GetSubmeshes())
 		{
-			shader->SetMat4("uMatModel", transform);
-			glDrawElementsBaseVertex(GL_TRIANGLES, submesh.indexCount, GL_UNSIGNED_INT, (void*)(sizeof(int) * submesh.indexStart), submesh.vertexStart);
+			unsigned int indexStart = submesh.indexStart;
+			unsigned int indexCount = submesh.indexCount;
+			if (drawLOD > 0 && !submesh.lods.empty()) // Submeshes with fewer LODs draw their coarsest one
+			{
+				const SubmeshLOD& submeshLOD = submesh.lods[std::min(drawLOD, (unsigned int)submesh.lods.size()) - 1];
+				indexStart = submeshLOD.indexStart;
+				indexCount = submeshLOD.indexCount;
+			}
+
+			if (!skinnedVertexArray) // Bounds the submesh's positions were quantized to
+			{
+				glm::vec3 positionScale = submesh.maxVertex - submesh.minVertex;
+				glVertexAttrib3f(POSITION_OFFSET_ATTRIBUTE_LOCATION, submesh.minVertex.x, submesh.minVertex.y, submesh.minVertex.z);
+				glVertexAttrib3f(POSITION_SCALE_ATTRIBUTE_LOCATION, positionScale.x, positionScale.y, positionScale.z);
+			}
+
+			glDrawElementsBaseVertex(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, (void*)(sizeof(int) * indexStart), skinnedVertexStart + submesh.vertexStart);
 		}
 	
 		mesh->GetVertexArray()->Unbind();
@@ -163,4 +189,6 @@ struct RenderComponent : public Component
 	ReflectRefractMapPriorityType reflectRefractMapPriority;
 
 	FaceCullType faceCullType;
+
+	unsigned int lod; // LOD the camera picked last frame, selection needs it for hysteresis
 };
\ No newline at end of file
@@ -2,62 +2,136 @@
 
 #include "Component.h"
 #include "Animation.h"
+#include "Pose.h"
+#include "AnimationLOD.h"
+#include "IAnimationEventListener.h"
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <cfloat>
 #include <vector>
 
 class SkeletalAnimationComponent : public Component
 {
 public:
+	// A clip playing on a layer. Clips being faded out keep playing until the one after them has fully faded in
+	struct PlayingClip
+	{
+		Animation* anim = nullptr;
+		float time = 0.0f;
+		float fade = 1.0f; // How much of the clips before this one it has replaced
+		const std::vector<int>* binding = nullptr; // Joints to anim's channels, resolved by the SkeletalAnimationLayer
+		std::vector<ChannelCursor> cursors; // One per channel of anim, sized by the SkeletalAnimationLayer
+		unsigned int eventCursor = 0; // How many of anim's events are before time (see AnimationEventUtils::CollectEvents)
+		Pose reference; // anim's first frame, only sampled for additive layers
+	};
+
+	// Layers are applied in order. Layer 0 is the base pose, the ones above it blend over it by weight & mask, or add their clip's difference from its first frame when additive
+	struct Layer
+	{
+		float weight = 1.0f;
+		float targetWeight = 1.0f; // weight moves towards this at lerpSpeed
+		float speed = 1.0f;
+		bool repeat = true;
+		bool additive = false;
+		const BoneMask* mask = nullptr; // nullptr applies the layer to every joint
+
+		std::vector<PlayingClip> clips; // The current clip is last, use SetLayerAnimation() to change it
+	};
+
 	SkeletalAnimationComponent()
-		: anim(nullptr),
-		lastAnim(nullptr),
-		currentTime(0.0f),
-		lastTime(0.0f),
-		speed(1.0f),
-		repeat(true),
-		lerping(false),
+		: speed(1.0f),
 		lerpSpeed(5.0f),
-		allowRootMotion(false)
+		allowRootMotion(false),
+		baked(false),
+		bakedInterpolation(true),
+		layers(1),
+		bakedPalette(nullptr),
+		hasBounds(false),
+		visible(true),
+		shadowVisible(false),
+		screenSize(FLT_MAX),
+		lodTier(AnimationLODTier::Full),
+		timeSinceEvaluation(0.0f)
 	{
-		boneMatrices.reserve(Animation::MAX_BONES); // It's likely that the amount of bones is generally high, might as well avoid some re-allocations
 
-		for (int i = 0; i < 100; i++) boneMatrices.push_back(glm::mat4(1.0f)); // Default to identity matrix
 	}
 
-	void SetAnimation(Animation* animation, bool lerp = true)
+	void SetAnimation(Animation* animation, bool lerp = true) { SetLayerAnimation(0, animation, lerp); }
+
+	// Fades animation in over whatever the layer is playing when lerp is set, nullptr stops the layer straight away
+	void SetLayerAnimation(unsigned int layer, Animation* animation, bool lerp = true)
 	{
-		if (animation == anim) return;
+		std::vector<PlayingClip>& clips = GetLayer(layer).clips;
+		if (!clips.empty() && clips.back().anim == animation) return;
+
+		if (!lerp || !animation) clips.clear();
+		if (!animation) return;
 
-		lastAnim = anim;
-		anim = animation;
+		clips.emplace_back();
+		clips.back().anim = animation;
+		clips.back().fade = clips.size() > 1 ? 0.0f : 1.0f; // We want to interpolate between the animations
+	}
 
-		if (lerp && lastAnim) // We want to interpolate between the 2 animations
-		{
-			lastTime = currentTime;
-			lerping = true;
-			lerpTime = 0.0f;
-		}
+	void SetLayerWeight(unsigned int layer, float weight, bool lerp = true)
+	{
+		Layer& l = GetLayer(layer);
+		l.targetWeight = weight;
+		if (!lerp) l.weight = weight;
+	}
 
-		currentTime = 0.0f;
+	Layer& GetLayer(unsigned int layer)
+	{
+		if (layer >= layers.size()) layers.resize(layer + 1);
+		return layers[layer];
 	}
 
-	float speed;
-	bool repeat;
+	unsigned int GetLayerCount() const { return (unsigned int)layers.size(); }
+
+	// The palette to skin with this frame, either boneMatrices or a frame of a baked animation
+	const glm::mat4* GetBoneMatrices() const { return bakedPalette ? bakedPalette : boneMatrices.data(); }
+	unsigned int GetBoneCount() const { return (unsigned int)boneMatrices.size(); }
+
+	// Listeners get the events the playing clips cross, whether the character can be seen or not. Not owned
+	void AddEventListener(IAnimationEventListener* listener) { eventListeners.push_back(listener); }
+	void RemoveEventListener(IAnimationEventListener* listener) { eventListeners.erase(std::remove(eventListeners.begin(), eventListeners.end(), listener), eventListeners.end()); }
+
+	bool HasBounds() const { return hasBounds; }
+	const glm::vec3& GetBoundsMin() const { return boundsMin; }
+	const glm::vec3& GetBoundsMax() const { return boundsMax; }
+
+	float speed; // Scales the speed of every layer
 	float lerpSpeed;
 	bool allowRootMotion;
 
+	// Plays from a palette table baked for the mesh & clip (see BakedAnimation) while the base layer plays a single clip on its own.
+	// Anything a table can't hold (fades, other layers, root motion) falls back to evaluating live until it's over, so it can stay on for crowds
+	bool baked;
+	bool bakedInterpolation; // Blend the 2 baked frames around the current time, otherwise the nearest frame is used as is without copying it
+
 private:
 	friend class SkeletalAnimationLayer;
 	friend class GameEngine;
+	friend class SkeletalAnimationComponentListener;
+
+	std::vector<Layer> layers;
+	std::vector<IAnimationEventListener*> eventListeners;
+	std::vector<glm::mat4> boneMatrices; // Sized to the mesh's bone count when it is tied to an animated mesh
+	const glm::mat4* bakedPalette; // Set while playing the nearest frame of a baked table, nullptr when boneMatrices holds the palette
+
+	// Box around the mesh skinned with the current palette in mesh space, culling uses it instead of the mesh's bind pose box once the palette has been set
+	bool hasBounds;
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
 
-	Animation* anim;
-	Animation* lastAnim;
-	float currentTime;
-	float lastTime;
-	std::vector<glm::mat4> boneMatrices;
+	// Written by the GameEngine's culling, the SkeletalAnimationLayer picks the animation LOD tier from them the frame after
+	bool visible;
+	bool shadowVisible;
+	float screenSize; // Radius of the pose's bounding sphere on screen in pixels
 
-	float lerpTime;
-	bool lerping;
+	AnimationLODTier lodTier;
+	float timeSinceEvaluation; // Seconds
+	std::vector<glm::mat4> evaluatedBoneMatrices; // boneMatrices of the last evaluation, throttled tiers extrapolate from these until the next one
+	std::vector<glm::mat4> boneMatrixVelocities; // Change per second between the last 2 evaluations
 };
\ No newline at end of file
@@ -22,7 +22,8 @@ public:
 	void Resize(const glm::vec3& min, const glm::vec3 max);
 
 	const glm::vec3& GetCenter() const { return center; }
-	const glm::vec3& GetSize() const { return size; }
+	const glm::vec3& GetSize() const { return size; } // Half extents, center to max corner
+	float GetBoundingRadius() const { return glm::length(size); } // Radius of the sphere around the box, unscaled
 
 	glm::vec3 GetMin() const;
 	glm::vec3 GetMax() const;
@@ -31,9 +32,10 @@ public:
 
 	VertexArrayObject* GetVertexArray() const { return vao; }
 	unsigned int GetIndexCount() const { return 24; }
+
+	void SetupVertices(); // Debug draw geometry, needs GL so AABBs built off the main thread call this later
 	
 private:
-	void SetupVertices();
 
 	glm::vec3 center;
 	glm::vec3 size;
@@ -0,0 +1,220 @@
+#include "GLState.h"
+#include "ITexture.h"
+#include "Profiler.h"
+
+std::unordered_map<GLenum, bool> GLState::capabilities;
+GLenum GLState::cullFaceMode = GLState::UNKNOWN;
+GLenum GLState::polygonMode = GLState::UNKNOWN;
+GLuint GLState::program = GLState::UNKNOWN;
+GLuint GLState::vertexArray = GLState::UNKNOWN;
+GLuint GLState::readFramebuffer = GLState::UNKNOWN;
+GLuint GLState::drawFramebuffer = GLState::UNKNOWN;
+
+GLuint GLState::activeTextureSlot = GLState::UNKNOWN;
+GLuint GLState::textureSlots[GLState::MAX_TEXTURE_SLOTS];
+GLenum GLState::textureTargets[GLState::MAX_TEXTURE_SLOTS];
+
+unsigned int GLState::issuedCalls[(int)GLStateCall::Count] = {};
+unsigned int GLState::skippedCalls[(int)GLStateCall::Count] = {};
+
+// Built once, SubmitCounters runs every frame
+static const std::string issuedCounterKeys[(int)GLStateCall::Count] = { "GL Capability Issued", "GL CullFace Issued", "GL PolygonMode Issued", "GL Program Issued", "GL VertexArray Issued", "GL Texture Issued", "GL Framebuffer Issued" };
+static const std::string skippedCounterKeys[(int)GLStateCall::Count] = { "GL Capability Skipped", "GL CullFace Skipped", "GL PolygonMode Skipped", "GL Program Skipped", "GL VertexArray Skipped", "GL Texture Skipped", "GL Framebuffer Skipped" };
+static const std::string totalIssuedKey = "GL Total Issued";
+static const std::string totalSkippedKey = "GL Total Skipped";
+
+bool GLState::ShouldIssue(GLStateCall call, bool changed)
+{
+	if (changed)
+	{
+		issuedCalls[(int)call]++;
+	}
+	else
+	{
+		skippedCalls[(int)call]++;
+	}
+
+	return changed;
+}
+
+void GLState::Enable(GLenum capability)
+{
+	SetEnabled(capability, true);
+}
+
+void GLState::Disable(GLenum capability)
+{
+	SetEnabled(capability, false);
+}
+
+void GLState::SetEnabled(GLenum capability, bool enabled)
+{
+	std::unordered_map<GLenum, bool>::iterator it = capabilities.find(capability);
+	if (!ShouldIssue(GLStateCall::Capability, it == capabilities.end() || it->second != enabled)) return;
+
+	capabilities[capability] = enabled;
+	if (enabled)
+	{
+		glEnable(capability);
+	}
+	else
+	{
+		glDisable(capability);
+	}
+}
+
+void GLState::CullFace(GLenum mode)
+{
+	if (!ShouldIssue(GLStateCall::CullFace, cullFaceMode != mode)) return;
+
+	cullFaceMode = mode;
+	glCullFace(mode);
+}
+
+void GLState::PolygonMode(GLenum mode)
+{
+	if (!ShouldIssue(GLStateCall::PolygonMode, polygonMode != mode)) return;
+
+	polygonMode = mode;
+	glPolygonMode(GL_FRONT_AND_BACK, mode);
+}
+
+void GLState::UseProgram(GLuint program)
+{
+	if (!ShouldIssue(GLStateCall::Program, GLState::program != program)) return;
+
+	GLState::program = program;
+	glUseProgram(program);
+}
+
+void GLState::BindVertexArray(GLuint vertexArray)
+{
+	if (!ShouldIssue(GLStateCall::VertexArray, GLState::vertexArray != vertexArray)) return;
+
+	GLState::vertexArray = vertexArray;
+	glBindVertexArray(vertexArray);
+}
+
+void GLState::BindFramebuffer(GLenum target, GLuint framebuffer)
+{
+	bool changed;
+	if (target == GL_READ_FRAMEBUFFER)
+	{
+		changed = readFramebuffer != framebuffer;
+		readFramebuffer = framebuffer;
+	}
+	else if (target == GL_DRAW_FRAMEBUFFER)
+	{
+		changed = drawFramebuffer != framebuffer;
+		drawFramebuffer = framebuffer;
+	}
+	else // GL_FRAMEBUFFER binds both
+	{
+		changed = readFramebuffer != framebuffer || drawFramebuffer != framebuffer;
+		readFramebuffer = framebuffer;
+		drawFramebuffer = framebuffer;
+	}
+
+	if (!ShouldIssue(GLStateCall::Framebuffer, changed)) return;
+
+	glBindFramebuffer(target, framebuffer);
+}
+
+void GLState::BindTexture(unsigned int slot, GLenum target, GLuint texture)
+{
+	bool cached = slot < MAX_TEXTURE_SLOTS;
+	if (!ShouldIssue(GLStateCall::Texture, !cached || textureSlots[slot] != texture || textureTargets[slot] != target)) return;
+
+	if (activeTextureSlot != slot)
+	{
+		activeTextureSlot = slot;
+		glActiveTexture(GL_TEXTURE0 + slot);
+	}
+
+	glBindTexture(target, texture);
+
+	if (cached)
+	{
+		textureSlots[slot] = texture;
+		textureTargets[slot] = target;
+	}
+}
+
+void GLState::BindTexture(unsigned int slot, const ITexture* texture)
+{
+	GLenum target;
+	switch (texture->GetType())
+	{
+	case TextureType::CUBE_MAP:
+		target = GL_TEXTURE_CUBE_MAP;
+		break;
+	case TextureType::TEXTURE_2D_ARRAY:
+		target = GL_TEXTURE_2D_ARRAY;
+		break;
+	case TextureType::TEXTURE_3D:
+		target = GL_TEXTURE_3D;
+		break;
+	default:
+		target = GL_TEXTURE_2D;
+		break;
+	}
+
+	BindTexture(slot, target, texture->GetID());
+}
+
+void GLState::InvalidateTextures()
+{
+	activeTextureSlot = UNKNOWN;
+	for (unsigned int i = 0; i < MAX_TEXTURE_SLOTS; i++)
+	{
+		textureSlots[i] = UNKNOWN;
+		textureTargets[i] = UNKNOWN;
+	}
+}
+
+void GLState::OnProgramDeleted(GLuint program)
+{
+	if (GLState::program == program) GLState::program = UNKNOWN;
+}
+
+void GLState::OnVertexArrayDeleted(GLuint vertexArray)
+{
+	if (GLState::vertexArray == vertexArray) GLState::vertexArray = UNKNOWN;
+}
+
+void GLState::OnFramebufferDeleted(GLuint framebuffer)
+{
+	if (readFramebuffer == framebuffer) readFramebuffer = UNKNOWN;
+	if (drawFramebuffer == framebuffer) drawFramebuffer = UNKNOWN;
+}
+
+void GLState::Invalidate()
+{
+	capabilities.clear();
+	cullFaceMode = UNKNOWN;
+	polygonMode = UNKNOWN;
+	program = UNKNOWN;
+	vertexArray = UNKNOWN;
+	readFramebuffer = UNKNOWN;
+	drawFramebuffer = UNKNOWN;
+	InvalidateTextures();
+}
+
+void GLState::SubmitCounters()
+{
+	unsigned int totalIssued = 0;
+	unsigned int totalSkipped = 0;
+	for (int i = 0; i < (int)GLStateCall::Count; i++)
+	{
+		Profiler::SetCounter(issuedCounterKeys[i], issuedCalls[i]);
+		Profiler::SetCounter(skippedCounterKeys[i], skippedCalls[i]);
+
+		totalIssued += issuedCalls[i];
+		totalSkipped += skippedCalls[i];
+		issuedCalls[i] = 0;
+		skippedCalls[i] = 0;
+	}
+
+	Profiler::SetCounter(totalIssuedKey, totalIssued);
+	Profiler::SetCounter(totalSkippedKey, totalSkipped);
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "GLCommon.h"
+
+#include <unordered_map>
+
+class ITexture;
+
+// The kinds of calls GLState filters, used for the issued/skipped counters
+enum class GLStateCall
+{
+	Capability = 0,
+	CullFace,
+	PolygonMode,
+	Program,
+	VertexArray,
+	Texture,
+	Framebuffer,
+	Count
+};
+
+// Thin cache in front of the GL state we change most often. Calls that wouldn't change anything are skipped,
+// so passes can set the state they need per draw without worrying about redundant driver calls.
+// Anything that changes this state has to go through here, otherwise call Invalidate() so the cache doesn't go stale.
+class GLState
+{
+public:
+	static void Enable(GLenum capability);
+	static void Disable(GLenum capability);
+	static void SetEnabled(GLenum capability, bool enabled);
+
+	static void CullFace(GLenum mode);
+	static void PolygonMode(GLenum mode); // Always GL_FRONT_AND_BACK
+
+	static void UseProgram(GLuint program);
+	static void BindVertexArray(GLuint vertexArray);
+	static void BindFramebuffer(GLenum target, GLuint framebuffer);
+
+	// Texture classes bind through their own Bind/BindToSlot, so texture slots are only trusted until InvalidateTextures() is called.
+	// Passes that bind a lot of textures per draw should invalidate at the start of the pass and then bind through here
+	static void BindTexture(unsigned int slot, GLenum target, GLuint texture);
+	static void BindTexture(unsigned int slot, const ITexture* texture);
+	static void InvalidateTextures();
+
+	// Deleting a bound object silently rebinds 0 (or keeps a dead program current), forget about it so the next bind isn't skipped
+	static void OnProgramDeleted(GLuint program);
+	static void OnVertexArrayDeleted(GLuint vertexArray);
+	static void OnFramebufferDeleted(GLuint framebuffer);
+
+	static void Invalidate(); // Forget everything, for when something outside of our code (e.g. ImGui) may have changed the state
+
+	static unsigned int GetIssuedCalls(GLStateCall call) { return issuedCalls[(int)call]; }
+	static unsigned int GetSkippedCalls(GLStateCall call) { return skippedCalls[(int)call]; }
+	static void SubmitCounters(); // Sends this frame's counters to the profiler and resets them
+
+private:
+	static const GLuint UNKNOWN = 0xFFFFFFFF; // Nothing can be bound with this ID so the next call is always issued
+	static const unsigned int MAX_TEXTURE_SLOTS = 32;
+
+	static bool ShouldIssue(GLStateCall call, bool changed);
+
+	static std::unordered_map<GLenum, bool> capabilities;
+	static GLenum cullFaceMode;
+	static GLenum polygonMode;
+	static GLuint program;
+	static GLuint vertexArray;
+	static GLuint readFramebuffer;
+	static GLuint drawFramebuffer;
+
+	static GLuint activeTextureSlot;
+	static GLuint textureSlots[MAX_TEXTURE_SLOTS];
+	static GLenum textureTargets[MAX_TEXTURE_SLOTS];
+
+	static unsigned int issuedCalls[(int)GLStateCall::Count];
+	static unsigned int skippedCalls[(int)GLStateCall::Count];
+};
\ No newline at end of file
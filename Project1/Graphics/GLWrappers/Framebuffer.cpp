@@ -1,6 +1,7 @@
 #include "FrameBuffer.h"
 #include "Texture2D.h"
 #include "CubeMap.h"
+#include "GLState.h"
 
 #include <iostream>
 
@@ -13,6 +14,7 @@ FrameBuffer::FrameBuffer()
 
 FrameBuffer::~FrameBuffer()
 {
+	GLState::OnFramebufferDeleted(ID);
 	glDeleteFramebuffers(1, &ID);
 
 	if(attachments) delete[] attachments;
@@ -20,32 +22,32 @@ FrameBuffer::~FrameBuffer()
 
 void FrameBuffer::Bind() const
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, ID);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, ID);
 }
 
 void FrameBuffer::BindRead() const
 {
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, ID);
+	GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, ID);
 }
 
 void FrameBuffer::BindWrite() const
 {
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, ID);
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, ID);
 }
 
 void FrameBuffer::Unbind() const
 {
-	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(GL_FRAMEBUFFER, 0);
 }
 
 void FrameBuffer::UnbindRead() const
 {
-	glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(GL_READ_FRAMEBUFFER, 0);
 }
 
 void FrameBuffer::UnbindWrite() const
 {
-	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+	GLState::BindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 }
 
 void FrameBuffer::SetColorBufferWrite(ColorBufferType type) const
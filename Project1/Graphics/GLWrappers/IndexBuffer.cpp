@@ -1,6 +1,6 @@
 #include "IndexBuffer.h"
 
-IndexBuffer::IndexBuffer(uint32_t* indices, uint32_t count)
+IndexBuffer::IndexBuffer(const uint32_t* indices, uint32_t count)
 	: count(count)
 {
 	// WARNING: A valid VAO needs to be bound before using GL_ELEMENT_ARRAY_BUFFER
@@ -7,7 +7,7 @@
 class IndexBuffer
 {
 public:
-	IndexBuffer(uint32_t* indices, uint32_t count);
+	IndexBuffer(const uint32_t* indices, uint32_t count);
 	virtual ~IndexBuffer();
 
 	void Bind() const;;
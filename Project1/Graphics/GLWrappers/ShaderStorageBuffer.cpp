@@ -0,0 +1,48 @@
+#include "ShaderStorageBuffer.h"
+
+ShaderStorageBuffer::ShaderStorageBuffer(unsigned int size, GLenum usage)
+	: ID(0),
+	usage(usage),
+	size(size)
+{
+	glGenBuffers(1, &ID);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, usage);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+ShaderStorageBuffer::~ShaderStorageBuffer()
+{
+	glDeleteBuffers(1, &ID);
+}
+
+void ShaderStorageBuffer::Bind() const
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+}
+
+void ShaderStorageBuffer::Unbind() const
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void ShaderStorageBuffer::BindToIndex(unsigned int index) const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, ID);
+}
+
+void ShaderStorageBuffer::SubData(unsigned int offset, unsigned int size, const void* data) const
+{
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, size, data);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+void ShaderStorageBuffer::Resize(unsigned int size)
+{
+	this->size = size;
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, size, nullptr, usage);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
\ No newline at end of file
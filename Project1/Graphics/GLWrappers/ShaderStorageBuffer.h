@@ -0,0 +1,26 @@
+#pragma once
+
+#include "GLCommon.h"
+
+// A shader storage buffer that can grow. Used for data that outlives a frame and is too large for a uniform block (e.g. the light list)
+class ShaderStorageBuffer
+{
+public:
+	ShaderStorageBuffer(unsigned int size, GLenum usage);
+	virtual ~ShaderStorageBuffer();
+
+	GLuint GetID() const { return ID; }
+	unsigned int GetSize() const { return size; }
+
+	void Bind() const;
+	void Unbind() const;
+	void BindToIndex(unsigned int index) const;
+	void SubData(unsigned int offset, unsigned int size, const void* data) const;
+
+	void Resize(unsigned int size); // Reallocates the buffer, previous contents are lost
+
+private:
+	GLuint ID;
+	GLenum usage;
+	unsigned int size;
+};
\ No newline at end of file
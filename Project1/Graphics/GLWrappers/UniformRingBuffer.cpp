@@ -0,0 +1,190 @@
+#include "UniformRingBuffer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <cstring>
+
+constexpr GLuint64 fenceTimeout = 1000000000; // 1 second in nanoseconds
+
+UniformRingBuffer::UniformRingBuffer(unsigned int regionSize, unsigned int regionCount, GLenum target)
+	: ID(0),
+	target(target),
+	regionSize(0),
+	regionCount(regionCount),
+	alignment(256),
+	currentRegion(0),
+	head(0),
+	requiredRegionSize(0),
+	mappedData(nullptr),
+	fences(regionCount, nullptr)
+{
+	GLint offsetAlignment = 0;
+	glGetIntegerv(target == GL_SHADER_STORAGE_BUFFER ? GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT : GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	if (offsetAlignment > 0)
+	{
+		alignment = (unsigned int)offsetAlignment;
+	}
+
+	// Every region has to start on an aligned offset so it can be bound with glBindBufferRange
+	this->regionSize = ((regionSize + alignment - 1) / alignment) * alignment;
+	Allocate();
+
+	if (!mappedData)
+	{
+		std::cout << "Uniform ring buffer is not persistently mapped, falling back to glBufferSubData" << std::endl;
+	}
+}
+
+void UniformRingBuffer::Allocate()
+{
+	const GLsizeiptr totalSize = (GLsizeiptr)regionSize * regionCount;
+
+	glGenBuffers(1, &ID);
+	glBindBuffer(target, ID);
+
+	if (glBufferStorage) // GL 4.4 / ARB_buffer_storage
+	{
+		const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		glBufferStorage(target, totalSize, nullptr, flags | GL_DYNAMIC_STORAGE_BIT);
+		mappedData = (char*)glMapBufferRange(target, 0, totalSize, flags);
+	}
+	else
+	{
+		glBufferData(target, totalSize, nullptr, GL_STREAM_DRAW);
+	}
+
+	glBindBuffer(target, 0);
+}
+
+void UniformRingBuffer::Grow(unsigned int requiredSize)
+{
+	// Buffer storage is immutable, so every region has to be free before the buffer can be replaced
+	for (GLsync& fence : fences)
+	{
+		WaitForFence(fence);
+	}
+
+	if (mappedData)
+	{
+		glBindBuffer(target, ID);
+		glUnmapBuffer(target);
+		glBindBuffer(target, 0);
+		mappedData = nullptr;
+	}
+	glDeleteBuffers(1, &ID);
+
+	// Double it so a crowd that keeps growing doesn't reallocate every frame
+	unsigned int newSize = std::max(regionSize * 2, requiredSize);
+	regionSize = ((newSize + alignment - 1) / alignment) * alignment;
+	Allocate();
+
+	std::cout << "Ring buffer region grew to " << regionSize << " bytes" << std::endl;
+}
+
+void UniformRingBuffer::WaitForFence(GLsync& fence)
+{
+	if (!fence) return; // Region was never used
+
+	GLenum result = glClientWaitSync(fence, 0, 0);
+	while (result == GL_TIMEOUT_EXPIRED)
+	{
+		result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, fenceTimeout);
+	}
+
+	if (result == GL_WAIT_FAILED)
+	{
+		std::cout << "Failed to wait on uniform ring buffer fence" << std::endl;
+	}
+
+	glDeleteSync(fence);
+	fence = nullptr;
+}
+
+UniformRingBuffer::~UniformRingBuffer()
+{
+	for (GLsync& fence : fences)
+	{
+		if (fence) glDeleteSync(fence);
+	}
+
+	if (mappedData)
+	{
+		glBindBuffer(target, ID);
+		glUnmapBuffer(target);
+		glBindBuffer(target, 0);
+	}
+
+	glDeleteBuffers(1, &ID);
+}
+
+void UniformRingBuffer::Bind() const
+{
+	glBindBuffer(target, ID);
+}
+
+void UniformRingBuffer::Unbind() const
+{
+	glBindBuffer(target, 0);
+}
+
+void UniformRingBuffer::BindToIndex(unsigned int index) const
+{
+	glBindBufferRange(target, index, ID, currentRegion * regionSize, regionSize);
+}
+
+void UniformRingBuffer::SubData(unsigned int offset, unsigned int size, const void* data) const
+{
+	if (mappedData)
+	{
+		memcpy(mappedData + offset, data, size);
+	}
+	else
+	{
+		glBindBuffer(target, ID);
+		glBufferSubData(target, offset, size, data);
+		glBindBuffer(target, 0);
+	}
+}
+
+void UniformRingBuffer::BeginFrame()
+{
+	if (requiredRegionSize > regionSize) Grow(requiredRegionSize); // Last frame ran out of space & skipped what didn't fit
+
+	currentRegion = (currentRegion + 1) % regionCount;
+	head = GetRegionOffset();
+	requiredRegionSize = 0;
+
+	// Wait until the GPU is done reading the data we wrote into this region N frames ago
+	WaitForFence(fences[currentRegion]);
+}
+
+void UniformRingBuffer::EndFrame()
+{
+	GLsync& fence = fences[currentRegion];
+	if (fence) glDeleteSync(fence);
+	fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+unsigned int UniformRingBuffer::Push(const void* data, unsigned int size)
+{
+	const unsigned int regionEnd = (currentRegion + 1) * regionSize;
+	if (head + size > regionEnd)
+	{
+		if (requiredRegionSize <= regionSize) std::cout << "Ring buffer region is full (" << regionSize << " bytes), skipping what doesn't fit this frame" << std::endl;
+
+		// Everything that didn't fit counts towards the size the region grows to, the start of the region is already in use & the next one may still be read by the GPU
+		requiredRegionSize = std::max(requiredRegionSize, head - GetRegionOffset()) + size + alignment;
+		return INVALID_OFFSET;
+	}
+
+	const unsigned int offset = head;
+	SubData(offset, size, data);
+
+	head = ((head + size + alignment - 1) / alignment) * alignment; // Next allocation has to start on an aligned offset
+	return offset;
+}
+
+void UniformRingBuffer::BindRange(unsigned int index, unsigned int offset, unsigned int size) const
+{
+	glBindBufferRange(target, index, ID, offset, size);
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "IUniformBuffer.h"
+
+#include <vector>
+
+// A uniform buffer split into N regions (one per frame in flight) that are written to sequentially and bound by offset.
+// When persistent mapping is supported the whole buffer is mapped once and written to directly, otherwise each push falls back to glBufferSubData.
+// A fence is placed at the end of every frame so the CPU never writes into a region the GPU may still be reading from.
+// The target can also be GL_SHADER_STORAGE_BUFFER to stream data that doesn't fit the uniform block size limits (e.g. bone palettes), or GL_DRAW_INDIRECT_BUFFER for indirect draw commands.
+class UniformRingBuffer : public IUniformBuffer
+{
+public:
+	UniformRingBuffer(unsigned int regionSize, unsigned int regionCount = 3, GLenum target = GL_UNIFORM_BUFFER);
+	virtual ~UniformRingBuffer();
+
+	virtual GLuint GetID() const override { return ID; }
+	virtual void Bind() const override;
+	virtual void Unbind() const override;
+	virtual void BindToIndex(unsigned int index) const override; // Binds the region currently being written to
+	virtual void SubData(unsigned int offset, unsigned int size, const void* data) const override;
+
+	void BeginFrame(); // Moves to the next region, waits on its fence if the GPU hasn't finished with it yet
+	void EndFrame(); // Fences the region that was written to this frame
+
+	// Copies the data into the current region and returns its offset in the buffer. Returns INVALID_OFFSET without writing anything when the region is full,
+	// callers have to skip whatever would have read it. The next BeginFrame() grows the regions to fit what the frame tried to push
+	unsigned int Push(const void* data, unsigned int size);
+	void BindRange(unsigned int index, unsigned int offset, unsigned int size) const;
+
+	template<typename T>
+	unsigned int Push(const T& data) { return Push(&data, sizeof(T)); }
+
+	static const unsigned int INVALID_OFFSET = 0xFFFFFFFF;
+
+	unsigned int GetRegionSize() const { return regionSize; }
+	unsigned int GetRegionOffset() const { return currentRegion * regionSize; }
+	unsigned int GetBytesUsed() const { return head - (currentRegion * regionSize); }
+	bool IsPersistentlyMapped() const { return mappedData != nullptr; }
+
+private:
+	void Allocate(); // Creates & maps storage for regionCount regions of regionSize
+	void Grow(unsigned int requiredSize); // Waits for the GPU to finish with every region & reallocates them at least requiredSize big
+	static void WaitForFence(GLsync& fence);
+
+	GLuint ID;
+	GLenum target;
+
+	unsigned int regionSize;
+	unsigned int regionCount;
+	unsigned int alignment;
+
+	unsigned int currentRegion;
+	unsigned int head;
+	unsigned int requiredRegionSize; // What the frame tried to push, more than regionSize when it ran out of space
+
+	char* mappedData;
+	std::vector<GLsync> fences;
+};
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include "VertexArrayObject.h"
+#include "GLState.h"
 
 VertexArrayObject::VertexArrayObject()
 	: VBOIndex(0),
@@ -17,17 +18,18 @@ VertexArrayObject::VertexArrayObject(GLuint ID)
 
 VertexArrayObject::~VertexArrayObject()
 {
+	GLState::OnVertexArrayDeleted(this->ID);
 	glDeleteVertexArrays(1, &this->ID);
 }
 
 void VertexArrayObject::Bind() const
 {
-	glBindVertexArray(this->ID);
+	GLState::BindVertexArray(this->ID);
 }
 
 void VertexArrayObject::Unbind() const
 {
-	glBindVertexArray(0);
+	GLState::BindVertexArray(0);
 }
 
 void VertexArrayObject::AddVertexBuffer(VertexBuffer* vertexBuffer)
@@ -78,6 +80,31 @@ void VertexArrayObject::AddVertexBuffer(VertexBuffer* vertexBuffer)
 			this->VBOIndex++;
 			break;
 		}
+		case ShaderDataType::UByte4:
+		case ShaderDataType::UShort4:
+		case ShaderDataType::Short2:
+		{
+			GLenum type = element.shaderDataType == ShaderDataType::UByte4 ? GL_UNSIGNED_BYTE : (element.shaderDataType == ShaderDataType::UShort4 ? GL_UNSIGNED_SHORT : GL_SHORT);
+
+			glEnableVertexAttribArray(this->VBOIndex);
+			if (element.normalized) // The shader reads floats, [0, 1] for unsigned types and [-1, 1] for signed ones
+			{
+				glVertexAttribPointer(this->VBOIndex, element.NumberOfComponents(), type, GL_TRUE, layout.GetStride(), (GLvoid*)element.offset);
+			}
+			else // The shader reads integers (uvec/ivec)
+			{
+				glVertexAttribIPointer(this->VBOIndex, element.NumberOfComponents(), type, layout.GetStride(), (GLvoid*)element.offset);
+			}
+			this->VBOIndex++;
+			break;
+		}
+		case ShaderDataType::Half2:
+		{
+			glEnableVertexAttribArray(this->VBOIndex);
+			glVertexAttribPointer(this->VBOIndex, element.NumberOfComponents(), GL_HALF_FLOAT, GL_FALSE, layout.GetStride(), (GLvoid*)element.offset);
+			this->VBOIndex++;
+			break;
+		}
 		case ShaderDataType::Mat3x3:
 		case ShaderDataType::Mat4x4:
 		{
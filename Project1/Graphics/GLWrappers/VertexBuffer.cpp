@@ -1,19 +1,21 @@
 #include "VertexBuffer.h"
 
-VertexBuffer::VertexBuffer(float* vertices, uint32_t size)
-	: size(size)
+VertexBuffer::VertexBuffer(const void* vertices, uint32_t size)
+	: usage(GL_STATIC_DRAW),
+	size(size)
 {
 	glCreateBuffers(1, &this->ID);
 	glBindBuffer(GL_ARRAY_BUFFER, this->ID);
-	glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, size, vertices, usage);
 }
 
-VertexBuffer::VertexBuffer(uint32_t size)
-	: size(size)
+VertexBuffer::VertexBuffer(uint32_t size, GLenum usage)
+	: usage(usage),
+	size(size)
 {
 	glCreateBuffers(1, &this->ID);
 	glBindBuffer(GL_ARRAY_BUFFER, this->ID);
-	glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_STATIC_DRAW);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage);
 }
 
 VertexBuffer::~VertexBuffer()
@@ -41,4 +43,12 @@ void VertexBuffer::SetData(const void* data, uint32_t size)
 
 	glBindBuffer(GL_ARRAY_BUFFER, this->ID);
 	glBufferSubData(GL_ARRAY_BUFFER, 0, size, data); // Redefines the data in the VBO
+}
+
+void VertexBuffer::Resize(uint32_t size)
+{
+	this->size = size;
+
+	glBindBuffer(GL_ARRAY_BUFFER, this->ID);
+	glBufferData(GL_ARRAY_BUFFER, size, nullptr, usage);
 }
\ No newline at end of file
@@ -7,14 +7,18 @@
 class VertexBuffer
 {
 public:
-	VertexBuffer(float* vertices, uint32_t size);
-	VertexBuffer(uint32_t size);
+	VertexBuffer(const void* vertices, uint32_t size);
+	VertexBuffer(uint32_t size, GLenum usage = GL_STATIC_DRAW); // Contents come later, e.g. GL_DYNAMIC_COPY for buffers a compute shader rewrites every frame
 	virtual ~VertexBuffer();
 
 	void Bind() const;
 	void Unbind() const;
 
 	void SetData(const void* data, uint32_t size);
+	void Resize(uint32_t size); // Reallocates the buffer, previous contents are lost
+
+	GLuint GetID() const { return ID; }
+	uint32_t GetSize() const { return size; }
 
 	inline const BufferLayout& GetLayout() const { return this->layout; }
 	inline void SetLayout(const BufferLayout& layout) { this->layout = layout; }
@@ -22,5 +26,6 @@ public:
 private:
 	GLuint ID;
 	BufferLayout layout;
+	GLenum usage;
 	uint32_t size;
 };
\ No newline at end of file
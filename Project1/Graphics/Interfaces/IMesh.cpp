@@ -1,6 +1,4 @@
 #include "IMesh.h"
-#include "Vertex.h"
-#include "AnimatedVertex.h"
 
 #include <assimp/LogStream.hpp>
 #include <assimp/DefaultLogger.hpp>
@@ -37,67 +35,4 @@ glm::mat4 MeshUtils::ConvertToGLMMat4(const aiMatrix4x4& matrix)
 	glmMat[2][3] = matrix.d3;
 	glmMat[3][3] = matrix.d4;
 	return glmMat;
-}
-
-float* MeshUtils::ConvertVerticesToArray(const std::vector<IVertex*>& vertices)
-{
-	float* vertexBuffer = new float[vertices.size() * Vertex::Length()];
-
-	unsigned int bufferIndex = 0;
-	for (int i = 0; i < vertices.size(); i++) // Convert data into contiguous float array 
-	{
-		IVertex* vertex = vertices[i];
-		float* data = vertex->Data();
-
-		for (unsigned int j = 0; j < Vertex::Length(); j++)
-		{
-			int writeIndex = bufferIndex + j;
-			vertexBuffer[writeIndex] = data[j];
-		}
-
-		bufferIndex += Vertex::Length();
-	}
-
-	return vertexBuffer;
-}
-
-float* MeshUtils::ConvertAnimatedVerticesToArray(const std::vector<IVertex*>& vertices)
-{
-	float* vertexBuffer = new float[vertices.size() * AnimatedVertex::Length()];
-
-	unsigned int bufferIndex = 0;
-	for (int i = 0; i < vertices.size(); i++) // Convert data into contiguous float array 
-	{
-		IVertex* vertex = vertices[i];
-		float* data = vertex->Data();
-
-		for (unsigned int j = 0; j < AnimatedVertex::Length(); j++)
-		{
-			int writeIndex = bufferIndex + j;
-			vertexBuffer[writeIndex] = data[j];
-		}
-
-		bufferIndex += AnimatedVertex::Length();
-	}
-
-	return vertexBuffer;
-}
-
-
-uint32_t* MeshUtils::ConvertIndicesToArray(const std::vector<Face>& faces)
-{
-	uint32_t indexBufferSize = (uint32_t)(faces.size() * sizeof(Face));
-	uint32_t* indexBuffer = new uint32_t[indexBufferSize];
-	uint32_t bufferIndex = 0;
-	for (int i = 0; i < faces.size(); i++) // Convert data into contiguous int array 
-	{
-		const Face& face = faces[i];
-		indexBuffer[bufferIndex] = face.v1;
-		indexBuffer[bufferIndex + 1] = face.v2;
-		indexBuffer[bufferIndex + 2] = face.v3;
-
-		bufferIndex += 3;
-	}
-
-	return indexBuffer;
-}
+}
\ No newline at end of file
@@ -1,10 +1,19 @@
 #pragma once
 
-#include "IVertex.h"
+#include "Span.h"
 #include "VertexArrayObject.h"
 #include "AABB.h"
 
 #include <string>
+#include <vector>
+
+// A simplified version of a submesh. Its indices come after the full detail ones in the same index buffer & index the same vertices
+struct SubmeshLOD
+{
+	unsigned int indexStart;
+	unsigned int indexCount;
+	float error; // Estimate of how far (in mesh space) the surface moved from the full detail submesh
+};
 
 struct Submesh
 {
@@ -23,6 +32,8 @@ struct Submesh
 	glm::vec3 maxVertex;
 
 	glm::mat4 localTransform;
+
+	std::vector<SubmeshLOD> lods; // lods[i] is LOD i + 1, empty if the submesh wasn't simplified
 };
 
 class IMesh
@@ -37,8 +48,13 @@ public:
 	virtual IndexBuffer* GetIndexBuffer() = 0;
 	virtual const BufferLayout& GetVertexBufferLayout() const = 0;
 
-	virtual const std::vector<IVertex*>& GetVertices() const = 0;
-	virtual const std::vector<Face>& GetFaces() const = 0;
+	// CPU copies of the geometry, empty once ReleaseCPUData() was called
+	virtual StridedSpan<const glm::vec3> GetPositions() const = 0;
+	virtual Span<const Face> GetFaces() const = 0; // Full detail faces only
+	virtual bool HasCPUData() const = 0;
+	virtual void ReleaseCPUData() = 0; // For meshes that are only ever drawn, the GPU buffers keep working
+
+	virtual const std::vector<float>& GetLODErrors() const = 0; // Mesh space error of every LOD, [0] is the full detail mesh
 
 	virtual const AABB* GetBoundingBox() const = 0;
 	virtual std::string GetPath() const = 0;
@@ -51,9 +67,4 @@ public:
 	static const uint32_t ASSIMP_FLAGS;
 
 	static glm::mat4 ConvertToGLMMat4(const aiMatrix4x4& matrix);
-
-	static float* ConvertVerticesToArray(const std::vector<IVertex*>& vertices);
-	static float* ConvertAnimatedVerticesToArray(const std::vector<IVertex*>& vertices);
-
-	static uint32_t* ConvertIndicesToArray(const std::vector<Face>& faces);
 };
\ No newline at end of file
@@ -1,11 +0,0 @@
-#pragma once
-
-#include <glm/glm.hpp>
-
-class IVertex
-{
-public:
-	virtual ~IVertex() {}
-
-	virtual float* Data() = 0;
-};
\ No newline at end of file
@@ -1,7 +1,5 @@
 #pragma once
 
-#include "Shader.h"
-
 #include <glm/glm.hpp>
 
 #include <vector>
@@ -60,7 +58,7 @@ public:
 	void UpdateAttenuationMode(AttenuationMode attenMode);
 	void UpdateLightType(LightType lightType);
 	void UpdateCastShadows(bool castShadows);
-	void SendToShader() const;
+	void SendToShader() const; // Pushes the current values to the light buffer, for when the public members are edited directly
 
 	const glm::vec3& GetPosition() const { return position; }
 	const glm::vec3& GetDirection() const { return direction; }
@@ -74,14 +72,7 @@ public:
 	int GetIndex() const { return lightIndex; }
 	float GetIntensity() const { return intensity; }
 
-	static const int MAX_LIGHTS = 100;
-
-	int lightIndex;
-	std::string positionLoc;
-	std::string directionLoc;
-	std::string colorLoc;
-	std::string param1Loc;
-	std::string castShadowsLoc;
+	int lightIndex; // Slot in LightManager's light buffer
 
 	glm::vec3 position;
 	glm::vec3 direction;
@@ -92,7 +83,4 @@ public:
 	AttenuationMode attenuationMode;
 	LightType lightType;
 	bool castShadows;
-
-	static int currentLightIndex;
-	static std::vector<int> removedLights;
 };
\ No newline at end of file
@@ -0,0 +1,232 @@
+#include "LightManager.h"
+#include "Light.h"
+#include "JobSystem.h"
+#include "UniformBlocks.h"
+
+#include <algorithm>
+#include <cmath>
+
+std::vector<Light*> LightManager::lights;
+std::vector<int> LightManager::freeIndices;
+std::vector<PackedLight> LightManager::packedLights;
+unsigned int LightManager::dirtyStart = 0;
+unsigned int LightManager::dirtyEnd = 0;
+
+ShaderStorageBuffer* LightManager::lightBuffer = nullptr;
+
+std::vector<LightManager::ClusterBounds> LightManager::lightBounds;
+std::vector<std::vector<unsigned int>> LightManager::clusterLights;
+std::vector<glm::uvec2> LightManager::clusterRanges;
+std::vector<unsigned int> LightManager::lightIndices;
+
+glm::vec4 LightManager::clusterParams(0.0f);
+
+constexpr unsigned int initialLightCapacity = 256;
+
+void LightManager::Initialize()
+{
+	lightBuffer = new ShaderStorageBuffer(sizeof(PackedLight) * std::max((unsigned int)packedLights.size(), initialLightCapacity), GL_DYNAMIC_DRAW);
+
+	// Lights may have been created before the buffer existed
+	dirtyStart = 0;
+	dirtyEnd = packedLights.size();
+
+	clusterLights.resize(CLUSTER_COUNT);
+	clusterRanges.resize(CLUSTER_COUNT);
+}
+
+void LightManager::CleanUp()
+{
+	delete lightBuffer;
+	lightBuffer = nullptr;
+}
+
+int LightManager::AddLight(Light* light)
+{
+	int index;
+	if (!freeIndices.empty())
+	{
+		index = freeIndices.back();
+		freeIndices.pop_back();
+		lights[index] = light;
+	}
+	else
+	{
+		index = (int)lights.size();
+		lights.push_back(light);
+		packedLights.push_back(PackedLight());
+	}
+
+	return index;
+}
+
+void LightManager::RemoveLight(Light* light)
+{
+	int index = light->GetIndex();
+	if (index < 0 || (size_t)index >= lights.size() || lights[index] != light) return;
+
+	lights[index] = nullptr;
+	freeIndices.push_back(index);
+
+	packedLights[index].param1.z = 0.0f; // Turn the slot off so it's skipped until it's reused
+	MarkDirty(index);
+}
+
+void LightManager::UpdateLight(const Light* light)
+{
+	int index = light->GetIndex();
+	if (index < 0 || (size_t)index >= lights.size()) return;
+
+	PackedLight& packed = packedLights[index];
+	packed.position = glm::vec4(light->position, 1.0f);
+	packed.direction = glm::vec4(light->direction, light->castShadows ? 1.0f : 0.0f);
+	packed.color = glm::vec4(light->color, light->intensity);
+	packed.param1 = glm::vec4((GLfloat)light->lightType, light->radius, (GLfloat)light->on, (GLfloat)light->attenuationMode);
+	MarkDirty(index);
+}
+
+void LightManager::MarkDirty(unsigned int index)
+{
+	if (dirtyStart >= dirtyEnd) // Nothing was dirty
+	{
+		dirtyStart = index;
+		dirtyEnd = index + 1;
+	}
+	else
+	{
+		dirtyStart = std::min(dirtyStart, index);
+		dirtyEnd = std::max(dirtyEnd, index + 1);
+	}
+}
+
+void LightManager::BuildClusters(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane, const WindowSpecs* windowSpecs, UniformRingBuffer* storageRing)
+{
+	// Upload the lights that changed since last frame
+	if (packedLights.size() * sizeof(PackedLight) > lightBuffer->GetSize())
+	{
+		lightBuffer->Resize(packedLights.capacity() * sizeof(PackedLight));
+		dirtyStart = 0;
+		dirtyEnd = packedLights.size();
+	}
+
+	if (dirtyStart < dirtyEnd)
+	{
+		lightBuffer->SubData(dirtyStart * sizeof(PackedLight), (dirtyEnd - dirtyStart) * sizeof(PackedLight), &packedLights[dirtyStart]);
+		dirtyStart = dirtyEnd = 0;
+	}
+	lightBuffer->BindToIndex(LIGHT_STORAGE_BINDING);
+
+	// Depth slices are exponential so they stay roughly cube shaped: slice = log(depth) * scale + bias
+	float logFarNear = std::log(farPlane / nearPlane);
+	clusterParams.x = (float)CLUSTER_Z / logFarNear;
+	clusterParams.y = -((float)CLUSTER_Z * std::log(nearPlane)) / logFarNear;
+	clusterParams.z = (float)windowSpecs->width / (float)CLUSTER_X;
+	clusterParams.w = (float)windowSpecs->height / (float)CLUSTER_Y;
+
+	// Find the range of clusters each light touches
+	lightBounds.resize(packedLights.size());
+	JobSystem::ParallelFor(packedLights.size(), 64, [&](unsigned int start, unsigned int end)
+	{
+		for (unsigned int i = start; i < end; i++)
+		{
+			lightBounds[i] = ComputeClusterBounds(packedLights[i], view, projection, nearPlane, farPlane);
+		}
+	});
+
+	// Bin the lights, every job owns whole depth slices so no two threads ever write to the same cluster
+	JobSystem::ParallelFor(CLUSTER_Z, 1, [&](unsigned int start, unsigned int end)
+	{
+		for (unsigned int z = start; z < end; z++)
+		{
+			unsigned int sliceStart = z * CLUSTER_X * CLUSTER_Y;
+			for (unsigned int i = 0; i < CLUSTER_X * CLUSTER_Y; i++)
+			{
+				clusterLights[sliceStart + i].clear();
+			}
+
+			for (unsigned int lightIndex = 0; lightIndex < lightBounds.size(); lightIndex++)
+			{
+				const ClusterBounds& bounds = lightBounds[lightIndex];
+				if ((int)z < bounds.minZ || (int)z > bounds.maxZ) continue;
+
+				for (int y = bounds.minY; y <= bounds.maxY; y++)
+				{
+					for (int x = bounds.minX; x <= bounds.maxX; x++)
+					{
+						clusterLights[sliceStart + y * CLUSTER_X + x].push_back(lightIndex);
+					}
+				}
+			}
+		}
+	});
+
+	// Flatten into one index list, each cluster points to its range in it
+	lightIndices.clear();
+	for (unsigned int i = 0; i < CLUSTER_COUNT; i++)
+	{
+		clusterRanges[i] = glm::uvec2(lightIndices.size(), clusterLights[i].size());
+		lightIndices.insert(lightIndices.end(), clusterLights[i].begin(), clusterLights[i].end());
+	}
+
+	if (lightIndices.empty()) lightIndices.push_back(0); // Can't bind an empty range
+
+	unsigned int rangesOffset = storageRing->Push(clusterRanges.data(), sizeof(glm::uvec2) * clusterRanges.size());
+	unsigned int indicesOffset = storageRing->Push(lightIndices.data(), sizeof(unsigned int) * lightIndices.size());
+	if (rangesOffset == UniformRingBuffer::INVALID_OFFSET || indicesOffset == UniformRingBuffer::INVALID_OFFSET) return; // Only when the clusters alone don't fit, the ring grows for the next frame
+
+	storageRing->BindRange(LIGHT_CLUSTER_STORAGE_BINDING, rangesOffset, sizeof(glm::uvec2) * clusterRanges.size());
+	storageRing->BindRange(LIGHT_INDEX_STORAGE_BINDING, indicesOffset, sizeof(unsigned int) * lightIndices.size());
+}
+
+LightManager::ClusterBounds LightManager::ComputeClusterBounds(const PackedLight& light, const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane)
+{
+	ClusterBounds culled = { 0, -1, 0, -1, 0, -1 };
+	ClusterBounds everything = { 0, CLUSTER_X - 1, 0, CLUSTER_Y - 1, 0, CLUSTER_Z - 1 };
+
+	if (light.param1.z == 0.0f) return culled; // Light is off
+
+	LightType type = (LightType)(int)light.param1.x;
+	if (type == LightType::Directional) return everything; // Directional lights reach every cluster
+	if (type != LightType::Point) return culled; // Nothing else is shaded per light
+
+	float radius = light.param1.y;
+	glm::vec3 viewPos = glm::vec3(view * light.position);
+	float depth = -viewPos.z; // Camera looks down -z
+
+	if (depth + radius < nearPlane || depth - radius > farPlane) return culled; // Completely in front of or behind the frustum
+
+	ClusterBounds bounds = everything;
+	bounds.minZ = GetDepthSlice(std::max(depth - radius, nearPlane));
+	bounds.maxZ = GetDepthSlice(std::min(depth + radius, farPlane));
+
+	if (depth - radius <= nearPlane) return bounds; // Sphere crosses the near plane, it can cover any tile
+
+	// Project the corners of the light's view space bounding box to get the tiles it covers (conservative for a sphere)
+	glm::vec2 ndcMin(1.0f);
+	glm::vec2 ndcMax(-1.0f);
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner = viewPos + glm::vec3(i & 1 ? radius : -radius, i & 2 ? radius : -radius, i & 4 ? radius : -radius);
+		glm::vec4 clip = projection * glm::vec4(corner, 1.0f);
+		glm::vec2 ndc = glm::vec2(clip) / clip.w;
+		ndcMin = glm::min(ndcMin, ndc);
+		ndcMax = glm::max(ndcMax, ndc);
+	}
+
+	if (ndcMax.x < -1.0f || ndcMin.x > 1.0f || ndcMax.y < -1.0f || ndcMin.y > 1.0f) return culled; // Off screen
+
+	ndcMin = glm::clamp(ndcMin * 0.5f + 0.5f, 0.0f, 1.0f);
+	ndcMax = glm::clamp(ndcMax * 0.5f + 0.5f, 0.0f, 1.0f);
+	bounds.minX = std::min((int)(ndcMin.x * CLUSTER_X), (int)CLUSTER_X - 1);
+	bounds.maxX = std::min((int)(ndcMax.x * CLUSTER_X), (int)CLUSTER_X - 1);
+	bounds.minY = std::min((int)(ndcMin.y * CLUSTER_Y), (int)CLUSTER_Y - 1);
+	bounds.maxY = std::min((int)(ndcMax.y * CLUSTER_Y), (int)CLUSTER_Y - 1);
+
+	return bounds;
+}
+
+int LightManager::GetDepthSlice(float depth)
+{
+	int slice = (int)std::floor(std::log(depth) * clusterParams.x + clusterParams.y);
+	return std::max(0, std::min(slice, (int)CLUSTER_Z - 1));
+}
\ No newline at end of file
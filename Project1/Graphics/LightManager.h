@@ -0,0 +1,73 @@
+#pragma once
+
+#include "ShaderStorageBuffer.h"
+#include "UniformRingBuffer.h"
+#include "Window.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+class Light;
+
+// CPU mirror of the LightInfo struct in brdfLighting.glsl & forward.glsl (std430)
+struct PackedLight
+{
+	glm::vec4 position;
+	glm::vec4 direction; // w = cast shadows
+	glm::vec4 color; // a = intensity
+	glm::vec4 param1; // x = light type, y = radius, z = on/off, w = attenuation mode
+};
+
+// Keeps every light packed in one shader storage buffer and bins them into a froxel grid (screen tiles x exponential depth slices) each frame.
+// Shaders look up the cluster a fragment is in and only loop over the lights that can reach it.
+class LightManager
+{
+public:
+	static void Initialize();
+	static void CleanUp();
+
+	static int AddLight(Light* light); // Returns the slot the light was given in the light buffer
+	static void RemoveLight(Light* light);
+	static void UpdateLight(const Light* light); // Repacks the light and marks its slot for upload
+
+	// Uploads changed lights and rebuilds the clusters for this camera. Has to run before any pass that shades lights
+	static void BuildClusters(const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane, const WindowSpecs* windowSpecs, UniformRingBuffer* storageRing);
+
+	static const glm::vec4& GetClusterParams() { return clusterParams; } // x = depth slice scale, y = depth slice bias, z = tile width, w = tile height (pixels)
+	static unsigned int GetLightCount() { return (unsigned int)(lights.size() - freeIndices.size()); }
+	static unsigned int GetClusteredLightIndexCount() { return (unsigned int)lightIndices.size(); }
+
+	static const unsigned int CLUSTER_X = 16; // These have to match CLUSTER_GRID in brdfLighting.glsl & forward.glsl
+	static const unsigned int CLUSTER_Y = 9;
+	static const unsigned int CLUSTER_Z = 24;
+	static const unsigned int CLUSTER_COUNT = CLUSTER_X * CLUSTER_Y * CLUSTER_Z;
+
+private:
+	// Inclusive range of clusters a light touches. minZ > maxZ means the light doesn't reach any cluster
+	struct ClusterBounds
+	{
+		int minX, maxX;
+		int minY, maxY;
+		int minZ, maxZ;
+	};
+
+	static ClusterBounds ComputeClusterBounds(const PackedLight& light, const glm::mat4& view, const glm::mat4& projection, float nearPlane, float farPlane);
+	static int GetDepthSlice(float depth);
+	static void MarkDirty(unsigned int index);
+
+	static std::vector<Light*> lights; // Indexed by light slot, nullptr for slots that are free
+	static std::vector<int> freeIndices;
+	static std::vector<PackedLight> packedLights;
+	static unsigned int dirtyStart;
+	static unsigned int dirtyEnd;
+
+	static ShaderStorageBuffer* lightBuffer;
+
+	static std::vector<ClusterBounds> lightBounds;
+	static std::vector<std::vector<unsigned int>> clusterLights; // Light indices per cluster, filled on worker threads
+	static std::vector<glm::uvec2> clusterRanges; // x = offset into lightIndices, y = count
+	static std::vector<unsigned int> lightIndices;
+
+	static glm::vec4 clusterParams;
+};
\ No newline at end of file
@@ -1,6 +1,6 @@
 #include "AnimatedMesh.h"
-#include "Vertex.h"
-#include "AnimatedVertex.h"
+#include "Animation.h"
+#include "VertexCompression.h"
 #include "Mesh.h"
 
 #include <assimp/Importer.hpp>
@@ -26,12 +26,14 @@ struct AssimpLogger : public Assimp::LogStream
 	}
 };
 
-AnimatedMesh::AnimatedMesh(const std::string& filePath)
+AnimatedMesh::AnimatedMesh(const std::string& filePath, bool upload)
 	: vertexArray(nullptr),
 	vertexBuffer(nullptr),
 	indexBuffer(nullptr),
 	filePath(filePath), 
 	boundingBox(nullptr),
+	fullDetailFaceCount(0),
+	lodErrors(1, 0.0f),
 	boneCount(0)
 {
 	//AssimpLogger::Initialize();
@@ -58,6 +60,7 @@ AnimatedMesh::AnimatedMesh(const std::string& filePath)
 		submeshes[i].vertexStart = vertexCount;
 		submeshes[i].indexStart = indexCount;
 
+		submeshes[i].vertexCount = scene->mMeshes[i]->mNumVertices;
 		submeshes[i].indexCount = scene->mMeshes[i]->mNumFaces * 3;
 
 		vertexCount += scene->mMeshes[i]->mNumVertices;
@@ -78,6 +81,7 @@ AnimatedMesh::AnimatedMesh(const std::string& filePath)
 	inverseTransform = MeshUtils::ConvertToGLMMat4(scene->mRootNode->mTransformation.Inverse());
 	ParseNodes(scene->mRootNode);
 	CreateBoneHierarchy(scene->mRootNode, rootBone, glm::mat4(1.0f));
+	skeleton = Skeleton::Flatten(rootBone, inverseTransform);
 
 	// Configure parent's bounding box based off of the submeshes we just added
 	glm::vec3 parentMin = glm::vec3(FLT_MAX, FLT_MAX, FLT_MAX);
@@ -96,18 +100,42 @@ AnimatedMesh::AnimatedMesh(const std::string& filePath)
 		parentMax.z = glm::max(parentMax.z, max.z);
 	}
 
-	this->boundingBox = new AABB(parentMin, parentMax, true);
+	this->boundingBox = new AABB(parentMin, parentMax, false);
+
+	// Positions are quantized to 16 bits inside their submesh's bounds when uploaded, a step of the whole mesh's bounds is more than any of them moves
+	glm::vec3 size = parentMax - parentMin;
+	float quantizationStep = glm::max(size.x, glm::max(size.y, size.z)) / 65535.0f;
+	boneBounds = SkinnedBoundsUtils::ComputeBoneBounds(GetVertices(), boneCount, quantizationStep);
+
+	fullDetailFaceCount = indices.size();
+
+	if (upload) Upload();
+}
+
+void AnimatedMesh::GenerateLODs(const MeshLODSettings& settings)
+{
+	if (vertexArray || vertices.empty()) return; // Index buffer was already uploaded, or the file failed to load
+
+	indices.resize(fullDetailFaceCount); // Drops the LODs from an earlier call
+	MeshLODUtils::GenerateLODs(GetPositions(), indices, submeshes, settings, lodErrors);
+}
+
+void AnimatedMesh::Upload()
+{
+	if (vertexArray || !boundingBox) return; // Already uploaded, or the file failed to load
+
+	boundingBox->SetupVertices();
 
 	// Define vertex layout
 	BufferLayout bufferLayout;
 	if (MAX_BONE_INFLUENCE <= 4)
 	{
 		bufferLayout = {
-			{ ShaderDataType::Float3, "vPosition" },
-			{ ShaderDataType::Float3, "vNormal" },
-			{ ShaderDataType::Float2, "vTextureCoordinates" },
-			{ ShaderDataType::Float4, "vBoneIDs" },
-			{ ShaderDataType::Float4, "vBoneWeights" }
+			{ ShaderDataType::UShort4, "vPosition", true },
+			{ ShaderDataType::Short2, "vNormal", true },
+			{ ShaderDataType::Half2, "vTextureCoordinates" },
+			{ ShaderDataType::UByte4, "vBoneIDs" },
+			{ ShaderDataType::UByte4, "vBoneWeights", true }
 		};
 	}
 	else
@@ -116,26 +144,38 @@ AnimatedMesh::AnimatedMesh(const std::string& filePath)
 		return;
 	}
 
-	this->vertexArray = new VertexArrayObject();
+	// Positions are quantized to the bounds of their submesh, RenderComponent::Draw hands those bounds to the shaders to decode them.
+	// The CPU copy stays uncompressed for physics & LOD generation
+	std::vector<CompressedAnimatedVertex> compressedVertices(this->vertices.size());
+	bool bonesFit = true;
+	for (const Submesh& submesh : this->submeshes)
+	{
+		size_t end = std::min((size_t)submesh.vertexStart + submesh.vertexCount, this->vertices.size());
+		for (size_t i = submesh.vertexStart; i < end; i++)
+		{
+			bool vertexBonesFit = true;
+			compressedVertices[i] = VertexCompressionUtils::Compress(this->vertices[i], submesh.minVertex, submesh.maxVertex, &vertexBonesFit);
+			bonesFit = bonesFit && vertexBonesFit;
+		}
+	}
 
-	int s = AnimatedVertex::Size();
-	uint32_t vertexBufferSize = (uint32_t)(this->vertices.size() * AnimatedVertex::Size());
-	float* vertexBuffer = MeshUtils::ConvertAnimatedVerticesToArray(this->vertices);
+	if (!bonesFit)
+	{
+		std::cout << filePath << " has more than " << VertexCompressionUtils::MAX_BONE_ID + 1 << " bones, influences of the bones past that were dropped!" << std::endl;
+	}
+
+	this->vertexArray = new VertexArrayObject();
 
-	this->vertexBuffer = new VertexBuffer(vertexBuffer, vertexBufferSize);
+	this->vertexBuffer = new VertexBuffer(compressedVertices.data(), (uint32_t)(compressedVertices.size() * sizeof(CompressedAnimatedVertex)));
 	this->vertexBuffer->SetLayout(bufferLayout);
 
-	uint32_t indexBufferSize = (uint32_t)(this->indices.size() * sizeof(Face));
-	uint32_t* indexBuffer = MeshUtils::ConvertIndicesToArray(this->indices);
+	std::cout << "Compressed " << filePath << " vertices: " << this->vertices.size() * sizeof(AnimatedVertex) / 1024 << "KB -> " << compressedVertices.size() * sizeof(CompressedAnimatedVertex) / 1024 << "KB" << std::endl;
 
 	this->vertexArray->Bind();
-	this->indexBuffer = new IndexBuffer(indexBuffer, indexBufferSize);
+	this->indexBuffer = new IndexBuffer(reinterpret_cast<const uint32_t*>(this->indices.data()), (uint32_t)(this->indices.size() * 3));
 
 	this->vertexArray->AddVertexBuffer(this->vertexBuffer);
 	this->vertexArray->SetIndexBuffer(this->indexBuffer);
-
-	delete[] vertexBuffer;
-	delete[] indexBuffer;
 }
 
 AnimatedMesh::~AnimatedMesh()
@@ -144,11 +184,15 @@ AnimatedMesh::~AnimatedMesh()
 	delete vertexBuffer;
 	delete indexBuffer;
 
-	for (IVertex* v : vertices) delete v;
-
 	delete boundingBox;
 }
 
+void AnimatedMesh::ReleaseCPUData()
+{
+	std::vector<AnimatedVertex>().swap(vertices); // clear() would keep the memory around
+	std::vector<Face>().swap(indices);
+}
+
 void AnimatedMesh::ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh)
 {
 	if (!assimpMesh->HasPositions())
@@ -168,19 +212,13 @@ void AnimatedMesh::ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh)
 		std::cout << filePath << " does not have texture coords!" << std::endl;
 	}
 
-	int32_t defaultBoneIDs[MAX_BONE_INFLUENCE];
-	for (unsigned int j = 0; j < MAX_BONE_INFLUENCE; j++) defaultBoneIDs[j] = -1;
-
-	float defaultBoneWeights[MAX_BONE_INFLUENCE];
-	for (unsigned int j = 0; j < MAX_BONE_INFLUENCE; j++) defaultBoneWeights[j] = 0.0f;
-
 	glm::vec3 minVertex = glm::vec3(FLT_MAX, FLT_MAX, FLT_MAX);
 	glm::vec3 maxVertex = glm::vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX);
 	for (unsigned int i = 0; i < assimpMesh->mNumVertices; i++)
 	{
 		glm::vec3 pos = glm::vec3(assimpMesh->mVertices[i].x, assimpMesh->mVertices[i].y, assimpMesh->mVertices[i].z);
 		glm::vec3 normal = glm::vec3(assimpMesh->mNormals[i].x, assimpMesh->mNormals[i].y, assimpMesh->mNormals[i].z);
-		glm::vec3 texCoords(0.0f);
+		glm::vec2 texCoords(0.0f);
 		if (assimpMesh->HasTextureCoords(0))
 		{
 			texCoords.x = assimpMesh->mTextureCoords[0][i].x;
@@ -195,7 +233,7 @@ void AnimatedMesh::ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh)
 		maxVertex.y = glm::max(maxVertex.y, pos.y);
 		maxVertex.z = glm::max(maxVertex.z, pos.z);
 
-		vertices.push_back(new AnimatedVertex(pos, normal, texCoords, defaultBoneIDs, defaultBoneWeights));
+		vertices.push_back(AnimatedVertex(pos, normal, texCoords));
 	}
 
 	submeshes[meshIndex].minVertex = minVertex;
@@ -248,7 +286,7 @@ void AnimatedMesh::ParseBones(unsigned int meshIndex, const aiMesh* assimpMesh)
 		{
 			unsigned int vertexID = submeshes[meshIndex].vertexStart + assimpBone->mWeights[j].mVertexId;
 			float weight = assimpBone->mWeights[j].mWeight;
-			dynamic_cast<AnimatedVertex*>(vertices[vertexID])->AddBoneData(boneIndex, weight);
+			vertices[vertexID].AddBoneData(boneIndex, weight);
 		}
 	}
 }
@@ -282,6 +320,40 @@ const BoneInfo* AnimatedMesh::GetBoneInfo(const std::string& boneName) const
 	return &it->second;
 }
 
+const std::vector<int>& AnimatedMesh::GetAnimationBinding(const Animation* animation, bool skipDetailJoints)
+{
+	if (skipDetailJoints)
+	{
+		std::unordered_map<const Animation*, std::vector<int>>::iterator it = reducedAnimationBindings.find(animation);
+		if (it != reducedAnimationBindings.end()) return it->second;
+
+		std::vector<int>& binding = reducedAnimationBindings[animation];
+		binding = GetAnimationBinding(animation);
+		for (unsigned int i = 0; i < skeleton.GetJointCount(); i++)
+		{
+			if (skeleton.detailJoints[i]) binding[i] = -1;
+		}
+
+		return binding;
+	}
+
+	std::unordered_map<const Animation*, std::vector<int>>::iterator it = animationBindings.find(animation);
+	if (it != animationBindings.end()) return it->second;
+
+	std::vector<int>& binding = animationBindings[animation];
+	binding.resize(skeleton.GetJointCount());
+	for (unsigned int i = 0; i < skeleton.GetJointCount(); i++)
+	{
+		binding[i] = animation->FindChannel(skeleton.names[i], skeleton.nameHashes[i]);
+		if (binding[i] == -1)
+		{
+			std::cout << "Bone '" << skeleton.names[i] << "' does not exist in animation " << animation->GetPath() << ", it will stay in its rest pose.\n";
+		}
+	}
+
+	return binding;
+}
+
 void AnimatedMesh::CreateBoneHierarchy(aiNode* node, Bone& parentBone, const glm::mat4& parentTransform)
 {
 	std::string nodeName = node->mName.C_Str();
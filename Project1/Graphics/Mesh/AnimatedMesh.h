@@ -5,20 +5,28 @@
 #include "ITexture.h"
 #include "ReflectRefract.h"
 #include "Bone.h"
-#include "IVertex.h"
+#include "AnimatedVertex.h"
 #include "BoneInfo.h"
+#include "Skeleton.h"
+#include "MeshLOD.h"
+#include "SkinnedBounds.h"
 
 #include <assimp/scene.h>
 
+#include <algorithm>
 #include <map>
 #include <unordered_map>
 
+class Animation;
 class AnimatedMesh : public IMesh
 {
 public:
-	AnimatedMesh(const std::string& filePath);
+	AnimatedMesh(const std::string& filePath, bool upload = true); // upload = false only parses the file, so it can run off the main thread
 	virtual ~AnimatedMesh();
 
+	void GenerateLODs(const MeshLODSettings& settings); // Before Upload(), the LODs go into the same index buffer
+	void Upload(); // Creates the GL buffers, main thread only
+
 	virtual std::vector<Submesh>& GetSubmeshes() override { return submeshes; }
 
 	virtual VertexArrayObject* GetVertexArray() override { return this->vertexArray; }
@@ -27,8 +35,14 @@ public:
 
 	virtual const BufferLayout& GetVertexBufferLayout() const override { return this->vertexBuffer->GetLayout(); }
 
-	virtual const std::vector<IVertex*>& GetVertices() const override { return this->vertices; }
-	virtual const std::vector<Face>& GetFaces() const override { return this->indices; }
+	virtual StridedSpan<const glm::vec3> GetPositions() const override { return StridedSpan<const glm::vec3>(vertices.empty() ? nullptr : &vertices[0].position, vertices.size(), sizeof(AnimatedVertex)); }
+	virtual Span<const Face> GetFaces() const override { return Span<const Face>(indices.data(), std::min(fullDetailFaceCount, indices.size())); }
+	virtual bool HasCPUData() const override { return !vertices.empty(); }
+	virtual void ReleaseCPUData() override;
+
+	virtual const std::vector<float>& GetLODErrors() const override { return lodErrors; }
+
+	Span<const AnimatedVertex> GetVertices() const { return Span<const AnimatedVertex>(vertices.data(), vertices.size()); }
 
 	virtual const AABB* GetBoundingBox() const override { return this->boundingBox; }
 	virtual std::string GetPath() const override { return filePath; }
@@ -36,7 +50,13 @@ public:
 	const BoneInfo* GetBoneInfo(const std::string& boneName) const;
 	unsigned int GetBoneCount() const { return boneCount; }
 	const Bone& GetRootBone() const { return rootBone; }
+	const Skeleton& GetSkeleton() const { return skeleton; }
 	const glm::mat4& GetInverseTransform() const { return inverseTransform; }
+	const std::vector<BoneBounds>& GetBoneBounds() const { return boneBounds; } // Indexed by bone ID, see SkinnedBoundsUtils::ComputeSkinnedBounds
+
+	// Channel index in animation for every joint of the skeleton (-1 if the animation doesn't move that joint). Bound the first time it's asked for, main thread only.
+	// skipDetailJoints leaves Skeleton::detailJoints unbound too, for characters at a lower animation LOD
+	const std::vector<int>& GetAnimationBinding(const Animation* animation, bool skipDetailJoints = false);
 
 private:
 	friend class Animation;
@@ -52,9 +72,12 @@ private:
 	VertexBuffer* vertexBuffer;
 	IndexBuffer* indexBuffer;
 
-	std::vector<IVertex*> vertices;
+	std::vector<AnimatedVertex> vertices;
 	std::vector<Face> indices;
 
+	size_t fullDetailFaceCount; // The LODs' faces come after these
+	std::vector<float> lodErrors;
+
 	std::vector<Submesh> submeshes;
 	AABB* boundingBox;
 	std::string filePath;
@@ -62,5 +85,10 @@ private:
 	std::unordered_map<std::string, BoneInfo> boneMap;
 	unsigned int boneCount;
 	Bone rootBone;
+	Skeleton skeleton;
 	glm::mat4 inverseTransform;
+	std::vector<BoneBounds> boneBounds;
+
+	std::unordered_map<const Animation*, std::vector<int>> animationBindings;
+	std::unordered_map<const Animation*, std::vector<int>> reducedAnimationBindings; // Without the detail joints
 };
\ No newline at end of file
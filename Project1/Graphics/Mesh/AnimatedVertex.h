@@ -1,26 +1,43 @@
 #pragma once
 
-#include "IVertex.h"
+#include <glm/glm.hpp>
 
 static const unsigned int MAX_BONE_INFLUENCE = 4; // WARNING: WHEN CHANGING THIS VALUE, MAKE SURE THAT THE BUFFER LAYOUT REFLECTS THE CHANGES (AnimatedMesh.cpp & in animated shader)
-static const unsigned int BONE_ID_START_INDEX = 8; // Bone IDs start at index 8
-static const unsigned int BONE_WEIGHT_START_INDEX = 8 + MAX_BONE_INFLUENCE; // Bone weights start at index 16
 
-class AnimatedVertex : public IVertex
+// Matches the animated mesh buffer layout, bone IDs are stored as floats because that's how the shader reads them (vBoneIDs is a vec4)
+struct AnimatedVertex
 {
-public:
-	AnimatedVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoord, int32_t* boneIDs, float* boneWeights);
-	virtual ~AnimatedVertex();
+	AnimatedVertex() = default;
+	AnimatedVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoord)
+		: position(position),
+		normal(normal),
+		texCoord(texCoord)
+	{
+		for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+		{
+			boneIDs[i] = -1.0f;
+			boneWeights[i] = 0.0f;
+		}
+	}
 
-	virtual float* Data() override { return data; }
+	void AddBoneData(int32_t boneID, float weight)
+	{
+		for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+		{
+			if (boneIDs[i] == -1.0f) // First free influence
+			{
+				boneIDs[i] = (float)boneID;
+				boneWeights[i] = weight;
+				return;
+			}
+		}
+	}
 
-	void AddBoneData(int32_t boneID, float weight);
-	void SetBoneIDs(int32_t* boneIDs);
-	void SetBoneWeights(float* boneWeights);
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec2 texCoord;
+	float boneIDs[MAX_BONE_INFLUENCE];
+	float boneWeights[MAX_BONE_INFLUENCE];
+};
 
-	static unsigned int Length() { return 8 + MAX_BONE_INFLUENCE * 2; }
-	static unsigned int Size() { return (sizeof(float) * 8) + (sizeof(int32_t) * MAX_BONE_INFLUENCE) + (sizeof(float) * MAX_BONE_INFLUENCE); } // 8 floats (position, normal, texcoords), 4 int32_t (4 bone IDs), 4 floats (4 bone weights)
-
-private:
-	float data[8 + MAX_BONE_INFLUENCE * 2];
-};
\ No newline at end of file
+static_assert(sizeof(AnimatedVertex) == sizeof(float) * (8 + MAX_BONE_INFLUENCE * 2), "AnimatedVertex has to be tightly packed to be uploaded as is");
\ No newline at end of file
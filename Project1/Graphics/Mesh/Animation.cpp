@@ -1,156 +1,307 @@
 #include "Animation.h"
-#include "IMesh.h"
-#include "AnimatedMesh.h"
-
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
 
+#include <algorithm>
+#include <cmath>
+#include <functional>
 #include <iostream>
 
-const unsigned int Animation::MAX_BONES = 100;
+Animation::Animation(const std::string& name, int ticksPerSecond, float duration)
+	: duration(duration),
+	ticksPerSecond(ticksPerSecond),
+	sampleInterval(0.0f),
+	compressedTimeScale(1.0f),
+	filePath(name)
+{
+
+}
 
-Animation::Animation(const std::string& path)
-	: filePath(path),
-	duration(0),
-	ticksPerSecond(0)
+void Animation::AddChannel(const std::string& boneName, KeyFrames keyFrames)
 {
-	Assimp::Importer importer;
-	const aiScene* assimpScene = importer.ReadFile(path, MeshUtils::ASSIMP_FLAGS);
-	if (!assimpScene || !assimpScene->mRootNode)
+	if (IsCompressed()) return;
+
+	size_t nameHash = std::hash<std::string>()(boneName);
+	int channel = FindChannel(boneName, nameHash);
+	if (channel == -1)
 	{
-		std::cout << "Failed to load animation file: " << path << std::endl;
-		return;
+		channel = (int)channels.size();
+		channels.push_back(KeyFrames());
+		channelNames.push_back(boneName);
+		channelNameHashes.push_back(nameHash);
 	}
 
-	aiAnimation* assimpAnim = assimpScene->mAnimations[0];
+	// Fill in missing key frames with the identity once here, so sampling never has to check for them
+	if (keyFrames.positions.empty())
+	{
+		std::cout << "Bone '" << boneName << "' does not have any position key frames! File:" << filePath << ".\n";
+		keyFrames.positions.push_back({ glm::vec3(0.0f, 0.0f, 0.0f), 0.0f });
+	}
 
-	ticksPerSecond = assimpAnim->mTicksPerSecond;
-	duration = assimpAnim->mDuration;
+	if (keyFrames.rotations.empty())
+	{
+		std::cout << "Bone '" << boneName << "' does not have any rotation key frames! File:" << filePath << ".\n";
+		keyFrames.rotations.push_back({ glm::quat(1.0f, 0.0f, 0.0f, 0.0f), 0.0f });
+	}
 
-	for (unsigned int j = 0; j < assimpAnim->mNumChannels; j++)
+	if (keyFrames.scales.empty())
 	{
-		aiNodeAnim* assimpNode = assimpAnim->mChannels[j];
-		std::string boneName = assimpNode->mNodeName.C_Str();
+		std::cout << "Bone '" << boneName << "' does not have any scale key frames! File:" << filePath << ".\n";
+		keyFrames.scales.push_back({ glm::vec3(1.0f, 1.0f, 1.0f), 0.0f });
+	}
 
-		// Setup position key frames
-		keyFrameMap[boneName].positions.resize(assimpNode->mNumPositionKeys);
-		for (unsigned int i = 0; i < assimpNode->mNumPositionKeys; i++)
-		{
-			aiVector3D assimpPos = assimpNode->mPositionKeys[i].mValue;
+	channels[channel] = std::move(keyFrames);
+}
 
-			// Make new position Key Frame
-			KeyFramePosition frame;
-			frame.position = glm::vec3(assimpPos.x, assimpPos.y, assimpPos.z);
-			frame.timeStamp = assimpNode->mPositionKeys[i].mTime;
-			keyFrameMap[boneName].positions[i] = frame;
-		}
+void Animation::Resample(float sampleRate)
+{
+	if (sampleRate <= 0.0f || ticksPerSecond <= 0 || duration <= 0.0f || IsCompressed()) return;
 
-		// Setup rotation key frames
-		keyFrameMap[boneName].rotations.resize(assimpNode->mNumRotationKeys);
-		for (unsigned int i = 0; i < assimpNode->mNumRotationKeys; i++)
-		{
-			aiQuaternion assimpRot = assimpNode->mRotationKeys[i].mValue;
+	float interval = ticksPerSecond / sampleRate;
+	for (KeyFrames& keyFrames : channels)
+	{
+		KeyFrameUtils::ResampleTrack(keyFrames.positions, interval, duration);
+		KeyFrameUtils::ResampleTrack(keyFrames.rotations, interval, duration);
+		KeyFrameUtils::ResampleTrack(keyFrames.scales, interval, duration);
+	}
 
-			// Make new rotation Key Frame
-			KeyFrameRotation frame;
-			frame.rotation = glm::quat(assimpRot.w, assimpRot.x, assimpRot.y, assimpRot.z);
-			frame.timeStamp = assimpNode->mRotationKeys[i].mTime;
-			keyFrameMap[boneName].rotations[i] = frame;
+	sampleInterval = interval;
+}
+
+template<typename T>
+static float GetEndTime(const std::vector<T>& keyFrames, bool& integralTimes)
+{
+	for (const T& keyFrame : keyFrames)
+	{
+		integralTimes = integralTimes && keyFrame.timeStamp == std::floor(keyFrame.timeStamp);
+	}
+
+	return keyFrames.back().timeStamp;
+}
+
+void Animation::Compress(const AnimationCompressionSettings& settings)
+{
+	if (!settings.enabled || channels.empty()) return;
+
+	// Key frame times are stored in 16 bits. Files that put every key frame on a whole tick (most of them) keep their exact times, anything else is spread over the 16 bits
+	float endTime = duration;
+	bool integralTimes = true;
+	for (const KeyFrames& keyFrames : channels)
+	{
+		endTime = std::max(endTime, GetEndTime(keyFrames.positions, integralTimes));
+		endTime = std::max(endTime, GetEndTime(keyFrames.rotations, integralTimes));
+		endTime = std::max(endTime, GetEndTime(keyFrames.scales, integralTimes));
+	}
+	compressedTimeScale = (integralTimes && endTime <= AnimationCompressionUtils::MAX_TIME) || endTime <= 0.0f ? 1.0f : AnimationCompressionUtils::MAX_TIME / endTime;
+
+	compressionStats = AnimationCompressionStats();
+	compressedChannels.resize(channels.size());
+
+	std::vector<float> times;
+	std::vector<glm::vec3> vectors;
+	std::vector<glm::quat> rotations;
+	bool keepKeyFrames = sampleInterval > 0.0f; // Removing key frames from a resampled animation would lose the even spacing that lets sampling skip the search
+	for (unsigned int i = 0; i < channels.size(); i++)
+	{
+		const KeyFrames& keyFrames = channels[i];
+		CompressedKeyFrames& compressed = compressedChannels[i];
+		float error;
+
+		times.clear();
+		vectors.clear();
+		for (const KeyFramePosition& keyFrame : keyFrames.positions)
+		{
+			times.push_back(keyFrame.timeStamp * compressedTimeScale);
+			vectors.push_back(keyFrame.position);
 		}
+		compressed.positions = AnimationCompressionUtils::CompressTrack(times, vectors, settings.maxPositionError, &error, keepKeyFrames);
+		compressionStats.maxPositionError = std::max(compressionStats.maxPositionError, error);
 
-		// Setup scale key frames
-		keyFrameMap[boneName].scales.resize(assimpNode->mNumScalingKeys);
-		for (unsigned int i = 0; i < assimpNode->mNumScalingKeys; i++)
+		times.clear();
+		rotations.clear();
+		for (const KeyFrameRotation& keyFrame : keyFrames.rotations)
 		{
-			aiVector3D assimpScale = assimpNode->mScalingKeys[i].mValue;
+			times.push_back(keyFrame.timeStamp * compressedTimeScale);
+			rotations.push_back(keyFrame.rotation);
+		}
+		compressed.rotations = AnimationCompressionUtils::CompressTrack(times, rotations, settings.maxRotationError, &error, keepKeyFrames);
+		compressionStats.maxRotationError = std::max(compressionStats.maxRotationError, error);
 
-			// Make new scale Key Frame
-			KeyFrameScale frame;
-			frame.scale = glm::vec3(assimpScale.x, assimpScale.y, assimpScale.z);
-			frame.timeStamp = assimpNode->mScalingKeys[i].mTime;
-			keyFrameMap[boneName].scales[i] = frame;
+		times.clear();
+		vectors.clear();
+		for (const KeyFrameScale& keyFrame : keyFrames.scales)
+		{
+			times.push_back(keyFrame.timeStamp * compressedTimeScale);
+			vectors.push_back(keyFrame.scale);
 		}
+		compressed.scales = AnimationCompressionUtils::CompressTrack(times, vectors, settings.maxScaleError, &error, keepKeyFrames);
+		compressionStats.maxScaleError = std::max(compressionStats.maxScaleError, error);
+
+		compressionStats.originalBytes += keyFrames.positions.size() * sizeof(KeyFramePosition) + keyFrames.rotations.size() * sizeof(KeyFrameRotation) + keyFrames.scales.size() * sizeof(KeyFrameScale);
+		compressionStats.compressedBytes += compressed.positions.GetByteSize() + compressed.rotations.GetByteSize() + compressed.scales.GetByteSize();
 	}
+
+	std::vector<KeyFrames>().swap(channels);
+
+	std::cout << "Compressed animation " << filePath << ": " << compressionStats.originalBytes / 1024 << "KB -> " << compressionStats.compressedBytes / 1024 << "KB ("
+		<< (float)compressionStats.originalBytes / std::max(compressionStats.compressedBytes, (size_t)1) << "x), max error " << compressionStats.maxPositionError << " position, "
+		<< glm::degrees(compressionStats.maxRotationError) << " degrees, " << compressionStats.maxScaleError << " scale" << std::endl;
 }
 
-bool Animation::GetFrameData(const std::string& boneName, float time, glm::vec3& lerpedPos, glm::quat& lerpedRot, glm::vec3& lerpedScale)
+// How far time is between track.times[frame] & the key frame after it
+static float GetCompressedLerpTime(const CompressedTrack& track, unsigned int frame, float time)
 {
-	std::unordered_map<std::string, KeyFrames>::iterator it = keyFrameMap.find(boneName);
-	if (it == keyFrameMap.end())
-	{
-		std::cout << "Bone '" << boneName << "' does not exist in animation " << filePath << ".\n";
-		return false;
-	}
-		
-	KeyFrames& keyFrames = it->second;
+	if (frame + 1 == track.times.size()) return 0.0f;
 
-	if (keyFrames.positions.empty())
+	float length = (float)track.times[frame + 1] - (float)track.times[frame];
+	return length > 0.0f ? glm::clamp((time - track.times[frame]) / length, 0.0f, 1.0f) : 0.0f;
+}
+
+static void DecodeKeyFrame(const CompressedTrack& track, unsigned int frame, glm::vec3& value)
+{
+	value = AnimationCompressionUtils::DecodeVector(track, frame);
+}
+
+static void DecodeKeyFrame(const CompressedTrack& track, unsigned int frame, glm::quat& value)
+{
+	value = AnimationCompressionUtils::DecodeRotation(track, frame);
+}
+
+// Decodes track's key frame frame & the one after it into values. Past the last key frame it is held
+template<typename T>
+static void GetCompressedKeyFrames(const CompressedTrack& track, unsigned int frame, T* values)
+{
+	DecodeKeyFrame(track, frame, values[0]);
+	if (frame + 1 == track.times.size())
 	{
-		std::cout << "Bone '" << boneName << "' does not have any position key frames! File:" << filePath << ".\n";
-		return false;
+		values[1] = values[0];
+		return;
 	}
 
-	if (keyFrames.rotations.empty())
+	DecodeKeyFrame(track, frame + 1, values[1]);
+}
+
+// Same as GetCompressedKeyFrames() for uncompressed tracks, value picks the member to copy out of the key frames
+template<typename T, typename V>
+static void GetKeyFrames(const std::vector<T>& keyFrames, unsigned int index, float time, V T::*value, V* values, float& lerp)
+{
+	const T& frame = keyFrames[index];
+	values[0] = frame.*value;
+	if (index + 1 == keyFrames.size())
 	{
-		std::cout << "Bone '" << boneName << "' does not have any rotation key frames! File:" << filePath << ".\n";
-		return false;
+		values[1] = values[0];
+		lerp = 0.0f;
+		return;
 	}
 
-	if (keyFrames.scales.empty())
+	const T& nextFrame = keyFrames[index + 1];
+	values[1] = nextFrame.*value;
+	lerp = KeyFrameUtils::GetLerpTime(frame, nextFrame, time);
+}
+
+int Animation::FindChannel(const std::string& boneName, size_t nameHash) const
+{
+	for (unsigned int i = 0; i < channelNameHashes.size(); i++)
 	{
-		std::cout << "Bone '" << boneName << "' does not have any scale key frames! File:" << filePath << ".\n";
-		return false;
+		if (channelNameHashes[i] == nameHash && channelNames[i] == boneName) return (int)i;
 	}
 
-	// Get positions
-	KeyFramePosition positionFrame = keyFrames.positions[0];
-	KeyFramePosition nextPositionFrame = keyFrames.positions[0];
-	for (unsigned int i = 0; i < keyFrames.positions.size() - 1; i++)
+	return -1;
+}
+
+void Animation::GetChannelFrameData(unsigned int channel, float time, glm::vec3& lerpedPos, glm::quat& lerpedRot, glm::vec3& lerpedScale, ChannelCursor* cursor) const
+{
+	ChannelKeyFrames keyFrames;
+	GetChannelKeyFrames(channel, time, keyFrames, cursor);
+
+	lerpedPos = glm::mix(keyFrames.positions[0], keyFrames.positions[1], keyFrames.positionLerp);
+	lerpedRot = KeyFrameUtils::Nlerp(keyFrames.rotations[0], keyFrames.rotations[1], keyFrames.rotationLerp);
+	lerpedScale = glm::mix(keyFrames.scales[0], keyFrames.scales[1], keyFrames.scaleLerp);
+}
+
+void Animation::GetChannelKeyFrames(unsigned int channel, float time, ChannelKeyFrames& keyFrames, ChannelCursor* cursor) const
+{
+	ChannelCursor searchCursor;
+	if (!cursor) cursor = &searchCursor;
+
+	if (IsCompressed())
 	{
-		int index = i + 1;
-		if (time < keyFrames.positions[index].timeStamp)
+		const CompressedKeyFrames& compressed = compressedChannels[channel];
+		if (sampleInterval > 0.0f) // Compress() kept the resampled grid, the key frames can still be computed
 		{
-			positionFrame = keyFrames.positions[i];
-			nextPositionFrame = keyFrames.positions[index];
-			break;
+			unsigned int positionFrame = KeyFrameUtils::GetUniformKeyFrame(compressed.positions.times.size(), time, sampleInterval);
+			unsigned int rotationFrame = KeyFrameUtils::GetUniformKeyFrame(compressed.rotations.times.size(), time, sampleInterval);
+			unsigned int scaleFrame = KeyFrameUtils::GetUniformKeyFrame(compressed.scales.times.size(), time, sampleInterval);
+
+			GetCompressedKeyFrames(compressed.positions, positionFrame, keyFrames.positions);
+			GetCompressedKeyFrames(compressed.rotations, rotationFrame, keyFrames.rotations);
+			GetCompressedKeyFrames(compressed.scales, scaleFrame, keyFrames.scales);
+			keyFrames.positionLerp = KeyFrameUtils::GetUniformLerpTime(positionFrame, time, sampleInterval); // Held key frames have the same value on both sides, the lerp doesn't matter there
+			keyFrames.rotationLerp = KeyFrameUtils::GetUniformLerpTime(rotationFrame, time, sampleInterval);
+			keyFrames.scaleLerp = KeyFrameUtils::GetUniformLerpTime(scaleFrame, time, sampleInterval);
+			return;
 		}
+
+		float compressedTime = time * compressedTimeScale;
+		unsigned int positionFrame = cursor->position.Seek(compressed.positions.times, compressedTime);
+		unsigned int rotationFrame = cursor->rotation.Seek(compressed.rotations.times, compressedTime);
+		unsigned int scaleFrame = cursor->scale.Seek(compressed.scales.times, compressedTime);
+
+		GetCompressedKeyFrames(compressed.positions, positionFrame, keyFrames.positions);
+		GetCompressedKeyFrames(compressed.rotations, rotationFrame, keyFrames.rotations);
+		GetCompressedKeyFrames(compressed.scales, scaleFrame, keyFrames.scales);
+		keyFrames.positionLerp = GetCompressedLerpTime(compressed.positions, positionFrame, compressedTime);
+		keyFrames.rotationLerp = GetCompressedLerpTime(compressed.rotations, rotationFrame, compressedTime);
+		keyFrames.scaleLerp = GetCompressedLerpTime(compressed.scales, scaleFrame, compressedTime);
+		return;
 	}
 
-	// Get rotations
-	KeyFrameRotation rotationFrame = keyFrames.rotations[0];
-	KeyFrameRotation nextRotationFrame = keyFrames.rotations[0];
-	for (unsigned int i = 0; i < keyFrames.rotations.size() - 1; i++)
+	const KeyFrames& channelKeyFrames = channels[channel];
+
+	unsigned int positionIndex;
+	unsigned int rotationIndex;
+	unsigned int scaleIndex;
+	if (sampleInterval > 0.0f)
 	{
-		int index = i + 1;
-		if (time < keyFrames.rotations[index].timeStamp)
-		{
-			rotationFrame = keyFrames.rotations[i];
-			nextRotationFrame = keyFrames.rotations[index];
-			break;
-		}
+		positionIndex = KeyFrameUtils::GetUniformKeyFrame(channelKeyFrames.positions.size(), time, sampleInterval);
+		rotationIndex = KeyFrameUtils::GetUniformKeyFrame(channelKeyFrames.rotations.size(), time, sampleInterval);
+		scaleIndex = KeyFrameUtils::GetUniformKeyFrame(channelKeyFrames.scales.size(), time, sampleInterval);
 	}
-
-	// Get scales
-	KeyFrameScale scaleFrame = keyFrames.scales[0];
-	KeyFrameScale nextScaleFrame = keyFrames.scales[0];
-	for (unsigned int i = 0; i < keyFrames.scales.size() - 1; i++)
+	else
 	{
-		int index = i + 1;
-		if (time < keyFrames.scales[index].timeStamp)
-		{
-			scaleFrame = keyFrames.scales[i];
-			nextScaleFrame = keyFrames.scales[index];
-			break;
-		}
+		positionIndex = cursor->position.Seek(channelKeyFrames.positions, &KeyFramePosition::timeStamp, time);
+		rotationIndex = cursor->rotation.Seek(channelKeyFrames.rotations, &KeyFrameRotation::timeStamp, time);
+		scaleIndex = cursor->scale.Seek(channelKeyFrames.scales, &KeyFrameScale::timeStamp, time);
 	}
 
-	float positionLerpTime = (time - positionFrame.timeStamp) / (nextPositionFrame.timeStamp - positionFrame.timeStamp);
-	float rotationLerpTime = (time - rotationFrame.timeStamp) / (nextRotationFrame.timeStamp - rotationFrame.timeStamp);
-	float scaleLerpTime = (time - scaleFrame.timeStamp) / (nextScaleFrame.timeStamp - scaleFrame.timeStamp);
+	GetKeyFrames(channelKeyFrames.positions, positionIndex, time, &KeyFramePosition::position, keyFrames.positions, keyFrames.positionLerp);
+	GetKeyFrames(channelKeyFrames.rotations, rotationIndex, time, &KeyFrameRotation::rotation, keyFrames.rotations, keyFrames.rotationLerp);
+	GetKeyFrames(channelKeyFrames.scales, scaleIndex, time, &KeyFrameScale::scale, keyFrames.scales, keyFrames.scaleLerp);
+}
 
-	lerpedPos = glm::mix(positionFrame.position, nextPositionFrame.position, positionLerpTime);
-	lerpedRot = glm::slerp(rotationFrame.rotation, nextRotationFrame.rotation, rotationLerpTime);
-	lerpedScale = glm::mix(scaleFrame.scale, nextScaleFrame.scale, scaleLerpTime);
+bool Animation::GetFrameData(const std::string& boneName, float time, glm::vec3& lerpedPos, glm::quat& lerpedRot, glm::vec3& lerpedScale) const
+{
+	int channel = FindChannel(boneName, std::hash<std::string>()(boneName));
+	if (channel == -1)
+	{
+		std::cout << "Bone '" << boneName << "' does not exist in animation " << filePath << ".\n";
+		return false;
+	}
 
+	GetChannelFrameData(channel, time, lerpedPos, lerpedRot, lerpedScale);
 	return true;
+}
+
+bool Animation::HasEvent(size_t nameHash) const
+{
+	for (const AnimationEvent& event : events)
+	{
+		if (event.nameHash == nameHash) return true;
+	}
+
+	return false;
+}
+
+void Animation::SetEvents(const std::vector<AnimationEvent>& events)
+{
+	this->events = events;
+	AnimationEventUtils::SortEvents(this->events);
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "BoneInfo.h"
 #include "Bone.h"
 #include "AnimatedVertex.h"
+#include "KeyFrames.h"
+#include "AnimationCompression.h"
+#include "AnimationEvents.h"
 
 #include <assimp/scene.h>
 #include <assimp/anim.h>
@@ -10,31 +13,27 @@
 #include <glm/glm.hpp>
 #include <glm/gtx/quaternion.hpp>
 
+#include <string>
 #include <unordered_map>
+#include <vector>
 
-struct KeyFramePosition
+// Where a playing instance was in each track of a channel last time it was sampled
+struct ChannelCursor
 {
-	glm::vec3 position;
-	float timeStamp;
+	KeyFrameCursor position;
+	KeyFrameCursor rotation;
+	KeyFrameCursor scale;
 };
 
-struct KeyFrameRotation
+// The key frames on either side of a time in every track of a channel & how far the time is between them (0 to 1)
+struct ChannelKeyFrames
 {
-	glm::quat rotation;
-	float timeStamp;
-};
-
-struct KeyFrameScale
-{
-	glm::vec3 scale;
-	float timeStamp;
-};
-
-struct KeyFrames
-{
-	std::vector<KeyFramePosition> positions;
-	std::vector<KeyFrameRotation> rotations;
-	std::vector<KeyFrameScale> scales;
+	glm::vec3 positions[2];
+	glm::quat rotations[2];
+	glm::vec3 scales[2];
+	float positionLerp;
+	float rotationLerp;
+	float scaleLerp;
 };
 
 class AnimatedMesh;
@@ -42,19 +41,56 @@ class Animation
 {
 public:
 	Animation(const std::string& path);
+	Animation(const std::string& name, int ticksPerSecond, float duration); // No channels, add them with AddChannel() for clips that aren't loaded from a file
+
+	// Replaces the bone's channel if it already has one. Missing key frames get the identity. Before Resample() & Compress()
+	void AddChannel(const std::string& boneName, KeyFrames keyFrames);
 
 	const float& GetDuration() const { return duration; }
 	const int& GetTicksPerSecond() const { return ticksPerSecond; }
 
-	bool GetFrameData(const std::string& boneName, float time, glm::vec3& lerpedPos, glm::quat& lerpedRot, glm::vec3& lerpedScale);
+	// Replaces every track that has more than one key frame with key frames sampleRate times a second, so sampling can compute which key frames to use instead of searching.
+	// Call it before the animation is used. The curves only stay exactly the same if every original key frame lands on a sample
+	void Resample(float sampleRate);
+	float GetSampleInterval() const { return sampleInterval; } // Ticks between key frames after Resample() (compressed or not), 0 if the key frames are the ones from the file
+
+	// Drops constant tracks, removes every key frame that can be interpolated within the settings' error budget and quantizes the rest (see AnimationCompression.h).
+	// Resampled animations only get quantized so their key frames stay evenly spaced & sampling still skips the search.
+	// Call it after Resample() & before the animation is used. The full precision key frames are freed, sampling reads the compressed ones from then on
+	void Compress(const AnimationCompressionSettings& settings);
+	bool IsCompressed() const { return !compressedChannels.empty(); }
+	const AnimationCompressionStats& GetCompressionStats() const { return compressionStats; }
+
+	bool GetFrameData(const std::string& boneName, float time, glm::vec3& lerpedPos, glm::quat& lerpedRot, glm::vec3& lerpedScale) const;
 
-	static const unsigned int MAX_BONES;
+	// Channels are the animated bones, bind them to a skeleton's joints once (see AnimatedMesh::GetAnimationBinding) and sample them by index afterwards
+	unsigned int GetChannelCount() const { return (unsigned int)channelNames.size(); }
+	int FindChannel(const std::string& boneName, size_t nameHash) const; // -1 if the bone isn't animated, nameHash is std::hash of boneName
+	// cursor is the instance's cursor for this channel, nullptr binary searches every track instead
+	void GetChannelFrameData(unsigned int channel, float time, glm::vec3& lerpedPos, glm::quat& lerpedRot, glm::vec3& lerpedScale, ChannelCursor* cursor = nullptr) const;
+	// The same lookup without interpolating, PoseUtils::SamplePose gathers every joint's key frames first & interpolates 4 joints at a time
+	void GetChannelKeyFrames(unsigned int channel, float time, ChannelKeyFrames& keyFrames, ChannelCursor* cursor = nullptr) const;
+
+	// Sorted by time, loaded from the clip's events file (see AnimationEventUtils::LoadEvents). The SkeletalAnimationLayer hands the ones a playing clip crosses to the component's listeners
+	const std::vector<AnimationEvent>& GetEvents() const { return events; }
+	bool HasEvent(size_t nameHash) const;
+	void SetEvents(const std::vector<AnimationEvent>& events); // Replaces the events from the file, sorts them. Not while the animation is playing, clips keep indices into them
+
+	const std::string& GetPath() const { return filePath; }
 
 private:
-	std::unordered_map<std::string, KeyFrames> keyFrameMap;
+	std::vector<KeyFrames> channels; // Every channel has at least one key frame of each type. Empty once compressed
+	std::vector<CompressedKeyFrames> compressedChannels;
+	std::vector<std::string> channelNames;
+	std::vector<size_t> channelNameHashes;
 
 	float duration;
 	int ticksPerSecond;
+	float sampleInterval;
+	float compressedTimeScale; // Ticks to compressed time units
+	AnimationCompressionStats compressionStats;
+
+	std::vector<AnimationEvent> events;
 
 	std::string filePath;
 };
\ No newline at end of file
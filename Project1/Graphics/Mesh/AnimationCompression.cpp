@@ -0,0 +1,256 @@
+#include "AnimationCompression.h"
+#include "KeyFrames.h"
+
+#include <algorithm>
+#include <cmath>
+
+static const float SMALLEST_THREE_RANGE = 0.70710678f; // None of the 3 smallest components of a unit quaternion can be larger than 1/sqrt(2)
+static const float SMALLEST_THREE_STEPS = 32767.0f;
+static const float VECTOR_STEPS = 65535.0f;
+
+static glm::vec3 Interpolate(const glm::vec3& a, const glm::vec3& b, float t)
+{
+	return glm::mix(a, b, t);
+}
+
+static glm::quat Interpolate(const glm::quat& a, const glm::quat& b, float t)
+{
+	return KeyFrameUtils::Nlerp(a, b, t);
+}
+
+static float Distance(const glm::vec3& a, const glm::vec3& b)
+{
+	return glm::length(a - b);
+}
+
+static float Distance(const glm::quat& a, const glm::quat& b)
+{
+	return AnimationCompressionUtils::GetAngle(a, b);
+}
+
+static uint16_t QuantizeTime(float time)
+{
+	return (uint16_t)glm::clamp(std::round(time), 0.0f, AnimationCompressionUtils::MAX_TIME);
+}
+
+// Value of the track made out of the kept key frames at time, the same thing sampling the compressed track does
+template<typename T>
+static T SampleKept(const std::vector<unsigned int>& kept, const std::vector<uint16_t>& quantizedTimes, const std::vector<T>& decoded, unsigned int keptIndex, float time)
+{
+	unsigned int frame = kept[keptIndex];
+	if (keptIndex + 1 == kept.size()) return decoded[frame];
+
+	unsigned int nextFrame = kept[keptIndex + 1];
+	float length = (float)quantizedTimes[nextFrame] - (float)quantizedTimes[frame];
+	float t = length > 0.0f ? glm::clamp((time - quantizedTimes[frame]) / length, 0.0f, 1.0f) : 0.0f;
+	return Interpolate(decoded[frame], decoded[nextFrame], t);
+}
+
+// Greedily extends every segment as far as it can go while the original key frames it skips stay within maxError. keepKeyFrames only drops constant tracks
+template<typename T>
+static std::vector<unsigned int> ReduceKeyFrames(const std::vector<float>& times, const std::vector<T>& values, const std::vector<uint16_t>& quantizedTimes, const std::vector<T>& decoded, float maxError, bool keepKeyFrames)
+{
+	unsigned int count = (unsigned int)values.size();
+
+	bool constant = true;
+	for (unsigned int i = 0; i < count && constant; i++)
+	{
+		constant = Distance(decoded[0], values[i]) <= maxError;
+	}
+	if (constant) return std::vector<unsigned int>(1, 0);
+
+	std::vector<unsigned int> kept(1, 0);
+	if (keepKeyFrames)
+	{
+		for (unsigned int i = 1; i < count; i++) kept.push_back(i);
+		return kept;
+	}
+
+	std::vector<unsigned int> segment(2);
+	unsigned int anchor = 0;
+	while (anchor + 1 < count)
+	{
+		unsigned int end = anchor + 1;
+		while (end + 1 < count)
+		{
+			segment[0] = anchor;
+			segment[1] = end + 1;
+
+			bool fits = true;
+			for (unsigned int i = anchor + 1; i <= end && fits; i++)
+			{
+				fits = Distance(SampleKept(segment, quantizedTimes, decoded, 0, times[i]), values[i]) <= maxError;
+			}
+			if (!fits) break;
+
+			end++;
+		}
+
+		kept.push_back(end);
+		anchor = end;
+	}
+
+	return kept;
+}
+
+// Fills in the track's times with the kept key frames & measures the error left at every original key frame
+template<typename T>
+static float FinishTrack(const std::vector<float>& times, const std::vector<T>& values, const std::vector<uint16_t>& quantizedTimes, const std::vector<T>& decoded, const std::vector<unsigned int>& kept, CompressedTrack& track)
+{
+	track.times.resize(kept.size());
+	for (unsigned int i = 0; i < kept.size(); i++)
+	{
+		track.times[i] = kept.size() == 1 ? 0 : quantizedTimes[kept[i]];
+	}
+
+	float error = 0.0f;
+	unsigned int keptIndex = 0;
+	for (unsigned int i = 0; i < values.size(); i++)
+	{
+		while (keptIndex + 1 < kept.size() && (float)quantizedTimes[kept[keptIndex + 1]] <= times[i]) keptIndex++;
+		error = std::max(error, Distance(SampleKept(kept, quantizedTimes, decoded, keptIndex, times[i]), values[i]));
+	}
+
+	return error;
+}
+
+namespace AnimationCompressionUtils
+{
+	void EncodeQuaternion(const glm::quat& rotation, uint16_t* encoded)
+	{
+		glm::quat q = glm::normalize(rotation);
+		float components[4] = { q.x, q.y, q.z, q.w };
+
+		unsigned int largest = 0;
+		for (unsigned int i = 1; i < 4; i++)
+		{
+			if (std::abs(components[i]) > std::abs(components[largest])) largest = i;
+		}
+
+		float sign = components[largest] < 0.0f ? -1.0f : 1.0f; // q & -q are the same rotation, flip it so the dropped component is positive
+
+		unsigned int slot = 0;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			if (i == largest) continue;
+
+			float value = glm::clamp(components[i] * sign / SMALLEST_THREE_RANGE, -1.0f, 1.0f) * 0.5f + 0.5f;
+			encoded[slot++] = (uint16_t)std::round(value * SMALLEST_THREE_STEPS);
+		}
+
+		encoded[0] |= (uint16_t)((largest & 1) << 15);
+		encoded[1] |= (uint16_t)((largest >> 1) << 15);
+	}
+
+	glm::quat DecodeQuaternion(const uint16_t* encoded)
+	{
+		unsigned int largest = (encoded[0] >> 15) | ((encoded[1] >> 15) << 1);
+
+		float components[4];
+		float sum = 0.0f;
+		unsigned int slot = 0;
+		for (unsigned int i = 0; i < 4; i++)
+		{
+			if (i == largest) continue;
+
+			float value = (encoded[slot++] & 0x7FFF) / SMALLEST_THREE_STEPS;
+			components[i] = (value * 2.0f - 1.0f) * SMALLEST_THREE_RANGE;
+			sum += components[i] * components[i];
+		}
+		components[largest] = std::sqrt(std::max(1.0f - sum, 0.0f));
+
+		return glm::normalize(glm::quat(components[3], components[0], components[1], components[2]));
+	}
+
+	float GetAngle(const glm::quat& a, const glm::quat& b)
+	{
+		glm::quat difference = glm::conjugate(a) * b;
+		return 2.0f * std::atan2(glm::length(glm::vec3(difference.x, difference.y, difference.z)), std::abs(difference.w));
+	}
+
+	CompressedTrack CompressTrack(const std::vector<float>& times, const std::vector<glm::vec3>& values, float maxError, float* error, bool keepKeyFrames)
+	{
+		CompressedTrack track;
+
+		glm::vec3 rangeMax = values[0];
+		track.rangeMin = values[0];
+		for (const glm::vec3& value : values)
+		{
+			track.rangeMin = glm::min(track.rangeMin, value);
+			rangeMax = glm::max(rangeMax, value);
+		}
+		track.rangeExtent = rangeMax - track.rangeMin;
+
+		// Quantize first so the reduction sees the values sampling will actually get
+		std::vector<uint16_t> quantizedTimes(values.size());
+		std::vector<uint16_t> encoded(values.size() * 3);
+		std::vector<glm::vec3> decoded(values.size());
+		for (unsigned int i = 0; i < values.size(); i++)
+		{
+			quantizedTimes[i] = QuantizeTime(times[i]);
+			for (int j = 0; j < 3; j++)
+			{
+				float t = track.rangeExtent[j] > 0.0f ? (values[i][j] - track.rangeMin[j]) / track.rangeExtent[j] : 0.0f;
+				encoded[i * 3 + j] = (uint16_t)std::round(glm::clamp(t, 0.0f, 1.0f) * VECTOR_STEPS);
+			}
+			decoded[i] = track.rangeMin + glm::vec3(encoded[i * 3], encoded[i * 3 + 1], encoded[i * 3 + 2]) / VECTOR_STEPS * track.rangeExtent;
+		}
+
+		std::vector<unsigned int> kept = ReduceKeyFrames(times, values, quantizedTimes, decoded, maxError, keepKeyFrames);
+		if (kept.size() == 1) // Constant, store the first key frame exactly
+		{
+			track.rangeMin = values[0];
+			track.rangeExtent = glm::vec3(0.0f);
+			decoded[0] = values[0];
+			encoded[0] = encoded[1] = encoded[2] = 0;
+		}
+
+		track.values.reserve(kept.size() * 3);
+		for (unsigned int frame : kept)
+		{
+			track.values.insert(track.values.end(), &encoded[frame * 3], &encoded[frame * 3] + 3);
+		}
+
+		float trackError = FinishTrack(times, values, quantizedTimes, decoded, kept, track);
+		if (error) *error = trackError;
+		return track;
+	}
+
+	CompressedTrack CompressTrack(const std::vector<float>& times, const std::vector<glm::quat>& values, float maxError, float* error, bool keepKeyFrames)
+	{
+		CompressedTrack track;
+
+		std::vector<uint16_t> quantizedTimes(values.size());
+		std::vector<uint16_t> encoded(values.size() * 3);
+		std::vector<glm::quat> decoded(values.size());
+		for (unsigned int i = 0; i < values.size(); i++)
+		{
+			quantizedTimes[i] = QuantizeTime(times[i]);
+			EncodeQuaternion(values[i], &encoded[i * 3]);
+			decoded[i] = DecodeQuaternion(&encoded[i * 3]);
+		}
+
+		std::vector<unsigned int> kept = ReduceKeyFrames(times, values, quantizedTimes, decoded, maxError, keepKeyFrames);
+
+		track.values.reserve(kept.size() * 3);
+		for (unsigned int frame : kept)
+		{
+			track.values.insert(track.values.end(), &encoded[frame * 3], &encoded[frame * 3] + 3);
+		}
+
+		float trackError = FinishTrack(times, values, quantizedTimes, decoded, kept, track);
+		if (error) *error = trackError;
+		return track;
+	}
+
+	glm::vec3 DecodeVector(const CompressedTrack& track, unsigned int keyFrame)
+	{
+		const uint16_t* encoded = &track.values[keyFrame * 3];
+		return track.rangeMin + glm::vec3(encoded[0], encoded[1], encoded[2]) / VECTOR_STEPS * track.rangeExtent;
+	}
+
+	glm::quat DecodeRotation(const CompressedTrack& track, unsigned int keyFrame)
+	{
+		return DecodeQuaternion(&track.values[keyFrame * 3]);
+	}
+}
\ No newline at end of file
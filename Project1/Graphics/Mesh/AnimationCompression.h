@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <cstdint>
+#include <vector>
+
+struct AnimationCompressionSettings
+{
+	bool enabled = true;
+	float maxPositionError = 0.01f; // In the animation's units, Mixamo exports use centimeters
+	float maxRotationError = 0.0005f; // Radians
+	float maxScaleError = 0.0005f;
+};
+
+struct AnimationCompressionStats
+{
+	size_t originalBytes = 0;
+	size_t compressedBytes = 0;
+	float maxPositionError = 0.0f; // Largest error measured at any of the original key frames
+	float maxRotationError = 0.0f;
+	float maxScaleError = 0.0f;
+};
+
+// A position, rotation or scale track after compression. Rotations take 48 bits per key frame (smallest three), positions & scales 16 bits per component inside the track's range
+struct CompressedTrack
+{
+	std::vector<uint16_t> times; // Key frame times in the animation's compressed time units, a single key frame means the track is constant
+	std::vector<uint16_t> values; // 3 per key frame
+	glm::vec3 rangeMin = glm::vec3(0.0f);
+	glm::vec3 rangeExtent = glm::vec3(0.0f);
+
+	size_t GetByteSize() const { return (times.size() + values.size()) * sizeof(uint16_t) + sizeof(rangeMin) + sizeof(rangeExtent); }
+};
+
+struct CompressedKeyFrames
+{
+	CompressedTrack positions;
+	CompressedTrack rotations;
+	CompressedTrack scales;
+};
+
+// Everything here is CPU only so the encodings & key frame reduction can be checked without loading a file
+namespace AnimationCompressionUtils
+{
+	static const float MAX_TIME = 65535.0f;
+
+	void EncodeQuaternion(const glm::quat& rotation, uint16_t* encoded); // Drops the largest component & stores the other 3 in 15 bits each, the 2 bit index goes in the spare bits
+	glm::quat DecodeQuaternion(const uint16_t* encoded);
+	float GetAngle(const glm::quat& a, const glm::quat& b); // Radians between 2 rotations
+
+	// Quantizes the track, then keeps the fewest key frames it can while interpolating between the kept ones stays within maxError of every original key frame.
+	// times are in compressed time units already. error is set to the largest error left at any original key frame.
+	// keepKeyFrames only quantizes (constant tracks still collapse to one key frame), resampled tracks stay evenly spaced that way so KeyFrameUtils::GetUniformKeyFrame() still finds their key frames
+	CompressedTrack CompressTrack(const std::vector<float>& times, const std::vector<glm::vec3>& values, float maxError, float* error, bool keepKeyFrames = false);
+	CompressedTrack CompressTrack(const std::vector<float>& times, const std::vector<glm::quat>& values, float maxError, float* error, bool keepKeyFrames = false);
+
+	glm::vec3 DecodeVector(const CompressedTrack& track, unsigned int keyFrame);
+	glm::quat DecodeRotation(const CompressedTrack& track, unsigned int keyFrame);
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "AnimationEvents.h"
+
+#include <yaml-cpp/yaml.h>
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+namespace AnimationEventUtils
+{
+	size_t HashName(const std::string& name)
+	{
+		return std::hash<std::string>()(name);
+	}
+
+	std::vector<AnimationEvent> LoadEvents(const std::string& clipPath, float ticksPerSecond, float duration)
+	{
+		std::vector<AnimationEvent> events;
+
+		std::string path = clipPath + ".events.yaml";
+		std::ifstream ifs(path);
+		if (!ifs.is_open()) return events; // Most clips don't have any
+
+		std::stringstream ss;
+		ss << ifs.rdbuf();
+		YAML::Node root = YAML::Load(ss.str());
+
+		const YAML::Node& eventNodes = root["Events"];
+		if (!eventNodes || !eventNodes.IsSequence())
+		{
+			std::cout << "Animation events file " << path << " has no 'Events' list.\n";
+			return events;
+		}
+
+		YAML::const_iterator it;
+		for (it = eventNodes.begin(); it != eventNodes.end(); it++)
+		{
+			const YAML::Node& eventNode = *it;
+			if (!eventNode["Name"] || !eventNode["Time"])
+			{
+				std::cout << "Animation event without a name or time in " << path << ".\n";
+				continue;
+			}
+
+			AnimationEvent event;
+			event.name = eventNode["Name"].as<std::string>();
+			event.nameHash = HashName(event.name);
+			event.time = std::min(std::max(eventNode["Time"].as<float>() * ticksPerSecond, 0.0f), duration);
+			if (eventNode["Parameter"]) event.parameter = eventNode["Parameter"].as<std::string>();
+			events.push_back(event);
+		}
+
+		SortEvents(events);
+		return events;
+	}
+
+	void SortEvents(std::vector<AnimationEvent>& events)
+	{
+		std::stable_sort(events.begin(), events.end(), [](const AnimationEvent& a, const AnimationEvent& b) { return a.time < b.time; });
+	}
+
+	unsigned int FindCursor(const std::vector<AnimationEvent>& events, float time)
+	{
+		std::vector<AnimationEvent>::const_iterator it = std::lower_bound(events.begin(), events.end(), time, [](const AnimationEvent& event, float time) { return event.time < time; });
+		return (unsigned int)(it - events.begin());
+	}
+
+	float WrapTime(float time, float duration, bool repeat)
+	{
+		if (duration <= 0.0f) return 0.0f;
+		if (!repeat) return std::min(std::max(time, 0.0f), duration);
+
+		time = std::fmod(time, duration);
+		if (time < 0.0f) time += duration;
+		return time < duration ? time : 0.0f; // Adding the duration to a tiny negative time can round up to it
+	}
+
+	void CollectEvents(const std::vector<AnimationEvent>& events, float time, float advance, float duration, bool repeat, unsigned int& cursor, const AnimationEventRecord& record,
+		std::vector<AnimationEventRecord>& batch)
+	{
+		unsigned int count = (unsigned int)events.size();
+		if (count == 0 || advance == 0.0f || duration <= 0.0f) return;
+		if (!repeat && (advance > 0.0f ? time >= duration : time <= 0.0f)) return; // Stopped at the end it's heading for, the events there went off when it got there
+
+		// Only out of date when the clip's time was changed from outside
+		if (cursor > count || (cursor > 0 && events[cursor - 1].time >= time) || (cursor < count && events[cursor].time < time))
+		{
+			cursor = FindCursor(events, time);
+		}
+
+		// The batch's storage is reused every update, so this only allocates until it has grown to the most events an update has crossed
+		auto cross = [&](unsigned int index)
+		{
+			batch.push_back(record);
+			batch.back().event = &events[index];
+		};
+
+		float end = time + advance;
+		unsigned int start = cursor;
+		if (advance > 0.0f)
+		{
+			if (end < duration)
+			{
+				for (; cursor < count && events[cursor].time < end; cursor++) cross(cursor);
+				return;
+			}
+
+			for (; cursor < count; cursor++) cross(cursor); // Up to & including the end of the clip
+			if (!repeat) return;
+
+			// Carries on from the start, the events from start onwards were already crossed before the loop
+			float wrappedTime = WrapTime(end, duration, true);
+			bool wholeLoop = advance >= duration;
+			for (cursor = 0; cursor < start && (wholeLoop || events[cursor].time < wrappedTime); cursor++) cross(cursor);
+			if (wholeLoop) cursor = FindCursor(events, wrappedTime);
+			return;
+		}
+
+		if (end >= 0.0f)
+		{
+			for (; cursor > 0 && events[cursor - 1].time >= end; cursor--) cross(cursor - 1);
+			return;
+		}
+
+		for (; cursor > 0; cursor--) cross(cursor - 1); // Back to & including the start of the clip
+		if (!repeat) return;
+
+		float wrappedTime = WrapTime(end, duration, true);
+		bool wholeLoop = -advance >= duration;
+		for (cursor = count; cursor > start && (wholeLoop || events[cursor - 1].time >= wrappedTime); cursor--) cross(cursor - 1);
+		if (wholeLoop) cursor = FindCursor(events, wrappedTime);
+	}
+}
\ No newline at end of file
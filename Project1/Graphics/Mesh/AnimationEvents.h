@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// A named moment in a clip, e.g. a foot hitting the ground or an attack's hit window opening
+struct AnimationEvent
+{
+	float time; // Ticks
+	std::string name;
+	size_t nameHash; // std::hash of name, listeners compare these instead of the names
+	std::string parameter; // Free form, e.g. the sound a footstep plays
+};
+
+class Animation;
+
+// An event a playing clip crossed, handed to IAnimationEventListeners in batches
+struct AnimationEventRecord
+{
+	const AnimationEvent* event;
+	const Animation* animation;
+	unsigned int layer;
+	float weight; // Layer weight * clip fade, e.g. to only play the footsteps of the clip that is mostly visible during a fade
+};
+
+namespace AnimationEventUtils
+{
+	size_t HashName(const std::string& name);
+
+	// Events of the clip at clipPath come from "<clipPath>.events.yaml" when there is one, times in the file are in seconds:
+	// Events:
+	//   - Name: Footstep
+	//     Time: 0.4
+	//     Parameter: footstepDirt
+	// Returns them sorted by time in ticks & clamped to the clip, empty without a file
+	std::vector<AnimationEvent> LoadEvents(const std::string& clipPath, float ticksPerSecond, float duration);
+
+	void SortEvents(std::vector<AnimationEvent>& events); // Stable, events at the same time keep their order
+
+	unsigned int FindCursor(const std::vector<AnimationEvent>& events, float time); // How many events are before time
+
+	// Where a clip is after moving advance ticks from time (negative plays it backwards). Repeating clips wrap into [0, duration), the others stop at either end
+	float WrapTime(float time, float duration, bool repeat);
+
+	// Appends a copy of record for every event crossed moving advance ticks from time (see WrapTime), in the order they were crossed. Events at time are crossed going forwards,
+	// the ones at the end of the clip when it loops or finishes. An update longer than a whole loop crosses every event once rather than once per loop, so a hitch doesn't replay
+	// a footstep many times over. cursor is the clip's FindCursor(events, time) from the last call, kept up to date so this doesn't search, anything else is searched again
+	void CollectEvents(const std::vector<AnimationEvent>& events, float time, float advance, float duration, bool repeat, unsigned int& cursor, const AnimationEventRecord& record,
+		std::vector<AnimationEventRecord>& batch);
+}
\ No newline at end of file
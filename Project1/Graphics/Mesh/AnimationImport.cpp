@@ -0,0 +1,82 @@
+#include "Animation.h"
+#include "IMesh.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+
+#include <iostream>
+
+// Loading lives apart from Animation.cpp so sampling & compression build without Assimp, the test project links them on their own
+Animation::Animation(const std::string& path)
+	: filePath(path),
+	duration(0),
+	ticksPerSecond(0),
+	sampleInterval(0.0f),
+	compressedTimeScale(1.0f)
+{
+	Assimp::Importer importer;
+	const aiScene* assimpScene = importer.ReadFile(path, MeshUtils::ASSIMP_FLAGS);
+	if (!assimpScene || !assimpScene->mRootNode)
+	{
+		std::cout << "Failed to load animation file: " << path << std::endl;
+		return;
+	}
+
+	aiAnimation* assimpAnim = assimpScene->mAnimations[0];
+
+	ticksPerSecond = assimpAnim->mTicksPerSecond;
+	duration = assimpAnim->mDuration;
+
+	channels.reserve(assimpAnim->mNumChannels);
+	channelNames.reserve(assimpAnim->mNumChannels);
+	channelNameHashes.reserve(assimpAnim->mNumChannels);
+
+	for (unsigned int j = 0; j < assimpAnim->mNumChannels; j++)
+	{
+		aiNodeAnim* assimpNode = assimpAnim->mChannels[j];
+		KeyFrames keyFrames;
+
+		// Setup position key frames
+		keyFrames.positions.resize(assimpNode->mNumPositionKeys);
+		for (unsigned int i = 0; i < assimpNode->mNumPositionKeys; i++)
+		{
+			aiVector3D assimpPos = assimpNode->mPositionKeys[i].mValue;
+
+			// Make new position Key Frame
+			KeyFramePosition frame;
+			frame.position = glm::vec3(assimpPos.x, assimpPos.y, assimpPos.z);
+			frame.timeStamp = assimpNode->mPositionKeys[i].mTime;
+			keyFrames.positions[i] = frame;
+		}
+
+		// Setup rotation key frames
+		keyFrames.rotations.resize(assimpNode->mNumRotationKeys);
+		for (unsigned int i = 0; i < assimpNode->mNumRotationKeys; i++)
+		{
+			aiQuaternion assimpRot = assimpNode->mRotationKeys[i].mValue;
+
+			// Make new rotation Key Frame
+			KeyFrameRotation frame;
+			frame.rotation = glm::quat(assimpRot.w, assimpRot.x, assimpRot.y, assimpRot.z);
+			frame.timeStamp = assimpNode->mRotationKeys[i].mTime;
+			keyFrames.rotations[i] = frame;
+		}
+
+		// Setup scale key frames
+		keyFrames.scales.resize(assimpNode->mNumScalingKeys);
+		for (unsigned int i = 0; i < assimpNode->mNumScalingKeys; i++)
+		{
+			aiVector3D assimpScale = assimpNode->mScalingKeys[i].mValue;
+
+			// Make new scale Key Frame
+			KeyFrameScale frame;
+			frame.scale = glm::vec3(assimpScale.x, assimpScale.y, assimpScale.z);
+			frame.timeStamp = assimpNode->mScalingKeys[i].mTime;
+			keyFrames.scales[i] = frame;
+		}
+
+		AddChannel(assimpNode->mNodeName.C_Str(), std::move(keyFrames)); // Same bone animated twice, the last channel wins
+	}
+
+	events = AnimationEventUtils::LoadEvents(path, (float)ticksPerSecond, duration);
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "KeyFrameCursor.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+struct KeyFramePosition
+{
+	glm::vec3 position;
+	float timeStamp;
+};
+
+struct KeyFrameRotation
+{
+	glm::quat rotation;
+	float timeStamp;
+};
+
+struct KeyFrameScale
+{
+	glm::vec3 scale;
+	float timeStamp;
+};
+
+struct KeyFrames
+{
+	std::vector<KeyFramePosition> positions;
+	std::vector<KeyFrameRotation> rotations;
+	std::vector<KeyFrameScale> scales;
+};
+
+// Sampling & resampling of a single uncompressed track, kept apart from Animation so it doesn't need Assimp
+namespace KeyFrameUtils
+{
+	// Normalized lerp the shorter way around. Barely differs from slerp over the small steps between key frames & vectorizes, so every rotation sampled or blended for a pose uses it
+	inline glm::quat Nlerp(const glm::quat& a, const glm::quat& b, float t)
+	{
+		float sign = glm::dot(a, b) < 0.0f ? -1.0f : 1.0f;
+		return glm::normalize(a * (1.0f - t) + b * (t * sign));
+	}
+
+	inline KeyFramePosition Interpolate(const KeyFramePosition& frame, const KeyFramePosition& nextFrame, float t)
+	{
+		return { glm::mix(frame.position, nextFrame.position, t), glm::mix(frame.timeStamp, nextFrame.timeStamp, t) };
+	}
+
+	inline KeyFrameRotation Interpolate(const KeyFrameRotation& frame, const KeyFrameRotation& nextFrame, float t)
+	{
+		return { Nlerp(frame.rotation, nextFrame.rotation, t), glm::mix(frame.timeStamp, nextFrame.timeStamp, t) };
+	}
+
+	inline KeyFrameScale Interpolate(const KeyFrameScale& frame, const KeyFrameScale& nextFrame, float t)
+	{
+		return { glm::mix(frame.scale, nextFrame.scale, t), glm::mix(frame.timeStamp, nextFrame.timeStamp, t) };
+	}
+
+	// How far time is from frame to nextFrame, 0 to 1
+	template<typename T>
+	float GetLerpTime(const T& frame, const T& nextFrame, float time)
+	{
+		float length = nextFrame.timeStamp - frame.timeStamp;
+		return length > 0.0f ? glm::clamp((time - frame.timeStamp) / length, 0.0f, 1.0f) : 0.0f;
+	}
+
+	// Interpolates between keyFrames[index] and the key frame after it. Past the last key frame (or with only one) the last key frame is held
+	template<typename T>
+	T SampleTrack(const std::vector<T>& keyFrames, unsigned int index, float time)
+	{
+		const T& frame = keyFrames[index];
+		if (index + 1 == keyFrames.size()) return frame;
+
+		const T& nextFrame = keyFrames[index + 1];
+		return Interpolate(frame, nextFrame, GetLerpTime(frame, nextFrame, time));
+	}
+
+	// Same key frame KeyFrameCursor::Seek() finds, computed directly since resampled key frames are interval apart
+	inline unsigned int GetUniformKeyFrame(size_t keyFrameCount, float time, float interval)
+	{
+		float sample = time / interval;
+		if (keyFrameCount == 1 || sample <= 0.0f) return 0;
+
+		return (unsigned int)std::min((size_t)sample, keyFrameCount - 1);
+	}
+
+	// How far time is from the uniform key frame frame to the one after it, 0 to 1
+	inline float GetUniformLerpTime(unsigned int frame, float time, float interval)
+	{
+		return glm::clamp(time / interval - frame, 0.0f, 1.0f);
+	}
+
+	// Replaces the track with key frames interval apart, from 0 to at least duration. Tracks with a single key frame are left alone
+	template<typename T>
+	void ResampleTrack(std::vector<T>& keyFrames, float interval, float duration)
+	{
+		if (keyFrames.size() < 2) return; // Constant, nothing to look up
+
+		// The last sample is at or after the end of the animation (or the last key frame, if that comes later)
+		float end = std::max(duration, keyFrames.back().timeStamp);
+		unsigned int sampleCount = (unsigned int)std::ceil(end / interval) + 1;
+
+		std::vector<T> samples(sampleCount);
+		KeyFrameCursor cursor;
+		for (unsigned int i = 0; i < sampleCount; i++)
+		{
+			float time = i * interval;
+			samples[i] = SampleTrack(keyFrames, cursor.Seek(keyFrames, &T::timeStamp, time), time);
+			samples[i].timeStamp = time;
+		}
+
+		keyFrames.swap(samples);
+	}
+}
\ No newline at end of file
@@ -1,5 +1,5 @@
 #include "Mesh.h"
-#include "Vertex.h"
+#include "VertexCompression.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
@@ -26,12 +26,14 @@ struct AssimpLogger : public Assimp::LogStream
 	}
 };
 
-Mesh::Mesh(const std::string& filePath)
+Mesh::Mesh(const std::string& filePath, bool upload)
 	: vertexArray(nullptr),
 	vertexBuffer(nullptr),
 	indexBuffer(nullptr),
 	filePath(filePath),
-	boundingBox(nullptr)
+	boundingBox(nullptr),
+	fullDetailFaceCount(0),
+	lodErrors(1, 0.0f)
 {
 	//AssimpLogger::Initialize();
 
@@ -57,6 +59,7 @@ Mesh::Mesh(const std::string& filePath)
 		submeshes[i].vertexStart = vertexCount;
 		submeshes[i].indexStart = indexCount;
 
+		submeshes[i].vertexCount = scene->mMeshes[i]->mNumVertices;
 		submeshes[i].indexCount = scene->mMeshes[i]->mNumFaces * 3;
 
 		vertexCount += scene->mMeshes[i]->mNumVertices;
@@ -96,33 +99,57 @@ Mesh::Mesh(const std::string& filePath)
 		parentMax.z = glm::max(parentMax.z, max.z);
 	}
 
-	this->boundingBox = new AABB(parentMin, parentMax, true);
+	this->boundingBox = new AABB(parentMin, parentMax, false);
+
+	fullDetailFaceCount = indices.size();
+
+	if (upload) Upload();
+}
+
+void Mesh::GenerateLODs(const MeshLODSettings& settings)
+{
+	if (vertexArray || vertices.empty()) return; // Index buffer was already uploaded, or the file failed to load
+
+	indices.resize(fullDetailFaceCount); // Drops the LODs from an earlier call
+	MeshLODUtils::GenerateLODs(GetPositions(), indices, submeshes, settings, lodErrors);
+}
+
+void Mesh::Upload()
+{
+	if (vertexArray || !boundingBox) return; // Already uploaded, or the file failed to load
+
+	boundingBox->SetupVertices();
 
 	BufferLayout bufferLayout = {
-		{ ShaderDataType::Float3, "vPosition" },
-		{ ShaderDataType::Float3, "vNormal" },
-		{ ShaderDataType::Float2, "vTextureCoordinates" }
+		{ ShaderDataType::UShort4, "vPosition", true },
+		{ ShaderDataType::Short2, "vNormal", true },
+		{ ShaderDataType::Half2, "vTextureCoordinates" }
 	};
 
-	this->vertexArray = new VertexArrayObject();
+	// Positions are quantized to the bounds of their submesh, RenderComponent::Draw hands those bounds to the shaders to decode them.
+	// The CPU copy stays uncompressed for physics & LOD generation
+	std::vector<CompressedVertex> compressedVertices(this->vertices.size());
+	for (const Submesh& submesh : this->submeshes)
+	{
+		size_t end = std::min((size_t)submesh.vertexStart + submesh.vertexCount, this->vertices.size());
+		for (size_t i = submesh.vertexStart; i < end; i++)
+		{
+			compressedVertices[i] = VertexCompressionUtils::Compress(this->vertices[i], submesh.minVertex, submesh.maxVertex);
+		}
+	}
 
-	uint32_t vertexBufferSize = (uint32_t)(this->vertices.size() * Vertex::Size());
-	float* vertexBuffer = MeshUtils::ConvertVerticesToArray(this->vertices);
+	this->vertexArray = new VertexArrayObject();
 
-	this->vertexBuffer = new VertexBuffer(vertexBuffer, vertexBufferSize);
+	this->vertexBuffer = new VertexBuffer(compressedVertices.data(), (uint32_t)(compressedVertices.size() * sizeof(CompressedVertex)));
 	this->vertexBuffer->SetLayout(bufferLayout);
 
-	uint32_t indexBufferSize = (uint32_t)(this->indices.size() * sizeof(Face));
-	uint32_t* indexBuffer = MeshUtils::ConvertIndicesToArray(this->indices);
+	std::cout << "Compressed " << filePath << " vertices: " << this->vertices.size() * sizeof(Vertex) / 1024 << "KB -> " << compressedVertices.size() * sizeof(CompressedVertex) / 1024 << "KB" << std::endl;
 
 	this->vertexArray->Bind();
-	this->indexBuffer = new IndexBuffer(indexBuffer, indexBufferSize);
+	this->indexBuffer = new IndexBuffer(reinterpret_cast<const uint32_t*>(this->indices.data()), (uint32_t)(this->indices.size() * 3));
 
 	this->vertexArray->AddVertexBuffer(this->vertexBuffer);
 	this->vertexArray->SetIndexBuffer(this->indexBuffer);
-
-	delete[] vertexBuffer;
-	delete[] indexBuffer;
 }
 
 Mesh::~Mesh()
@@ -131,11 +158,15 @@ Mesh::~Mesh()
 	delete vertexBuffer;
 	delete indexBuffer;
 
-	for (IVertex* v : vertices) delete v;
-
 	delete boundingBox;
 }
 
+void Mesh::ReleaseCPUData()
+{
+	std::vector<Vertex>().swap(vertices); // clear() would keep the memory around
+	std::vector<Face>().swap(indices);
+}
+
 void Mesh::ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh)
 {
 	if (!assimpMesh->HasPositions())
@@ -161,7 +192,7 @@ void Mesh::ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh)
 	{
 		glm::vec3 pos = glm::vec3(assimpMesh->mVertices[i].x, assimpMesh->mVertices[i].y, assimpMesh->mVertices[i].z);
 		glm::vec3 normal = glm::vec3(assimpMesh->mNormals[i].x, assimpMesh->mNormals[i].y, assimpMesh->mNormals[i].z);
-		glm::vec3 texCoords(0.0f);
+		glm::vec2 texCoords(0.0f);
 		if (assimpMesh->HasTextureCoords(0))
 		{
 			texCoords.x = assimpMesh->mTextureCoords[0][i].x;
@@ -176,7 +207,7 @@ void Mesh::ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh)
 		maxVertex.y = glm::max(maxVertex.y, pos.y);
 		maxVertex.z = glm::max(maxVertex.z, pos.z);
 
-		vertices.push_back(new Vertex(pos, normal, texCoords));
+		vertices.push_back(Vertex(pos, normal, texCoords));
 	}
 
 	submeshes[meshIndex].minVertex = minVertex;
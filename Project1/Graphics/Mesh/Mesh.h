@@ -2,12 +2,14 @@
 
 #include "IMesh.h"
 #include "Vertex.h"
+#include "MeshLOD.h"
 
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -25,16 +27,25 @@ public:
 
 	virtual const BufferLayout& GetVertexBufferLayout() const override { return this->vertexBuffer->GetLayout(); }
 
-	virtual const std::vector<IVertex*>& GetVertices() const override { return this->vertices; }
-	virtual const std::vector<Face>& GetFaces() const override { return this->indices; }
+	virtual StridedSpan<const glm::vec3> GetPositions() const override { return StridedSpan<const glm::vec3>(vertices.empty() ? nullptr : &vertices[0].position, vertices.size(), sizeof(Vertex)); }
+	virtual Span<const Face> GetFaces() const override { return Span<const Face>(indices.data(), std::min(fullDetailFaceCount, indices.size())); }
+	virtual bool HasCPUData() const override { return !vertices.empty(); }
+	virtual void ReleaseCPUData() override;
+
+	virtual const std::vector<float>& GetLODErrors() const override { return lodErrors; }
+
+	Span<const Vertex> GetVertices() const { return Span<const Vertex>(vertices.data(), vertices.size()); }
 
 	virtual AABB* GetBoundingBox() const override { return this->boundingBox; }
 	virtual std::string GetPath() const override { return filePath; }
 
 private:
 	friend class MeshManager;
+	friend class AssetLoader;
 
-	Mesh(const std::string& filePath);
+	Mesh(const std::string& filePath, bool upload = true); // upload = false only parses the file, so it can run off the main thread
+	void GenerateLODs(const MeshLODSettings& settings); // Before Upload(), the LODs go into the same index buffer
+	void Upload(); // Creates the GL buffers, main thread only
 
 	void ParseMesh(unsigned int meshIndex, const aiMesh* assimpMesh);
 	void ParseMaterials(const aiScene* assimpScene);
@@ -44,9 +55,12 @@ private:
 	VertexBuffer* vertexBuffer;
 	IndexBuffer* indexBuffer;
 
-	std::vector<IVertex*> vertices;
+	std::vector<Vertex> vertices;
 	std::vector<Face> indices;
 
+	size_t fullDetailFaceCount; // The LODs' faces come after these
+	std::vector<float> lodErrors;
+
 	std::vector<Submesh> submeshes;
 	AABB* boundingBox;
 	std::string filePath;
@@ -0,0 +1,307 @@
+#include "MeshLOD.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+
+// Symmetric 4x4 matrix summing the squared distances to a set of planes, only the upper triangle is stored
+struct Quadric
+{
+	Quadric() { std::fill(m, m + 10, 0.0); }
+
+	Quadric(const glm::dvec3& n, double d)
+	{
+		m[0] = n.x * n.x; m[1] = n.x * n.y; m[2] = n.x * n.z; m[3] = n.x * d;
+		m[4] = n.y * n.y; m[5] = n.y * n.z; m[6] = n.y * d;
+		m[7] = n.z * n.z; m[8] = n.z * d;
+		m[9] = d * d;
+	}
+
+	Quadric& operator+=(const Quadric& other)
+	{
+		for (int i = 0; i < 10; i++) m[i] += other.m[i];
+		return *this;
+	}
+
+	double Evaluate(const glm::vec3& p) const
+	{
+		double x = p.x, y = p.y, z = p.z;
+		double result = m[0] * x * x + 2.0 * m[1] * x * y + 2.0 * m[2] * x * z + 2.0 * m[3] * x
+			+ m[4] * y * y + 2.0 * m[5] * y * z + 2.0 * m[6] * y
+			+ m[7] * z * z + 2.0 * m[8] * z
+			+ m[9];
+		return std::max(result, 0.0); // Rounding can push it slightly below 0
+	}
+
+	double m[10];
+};
+
+struct Collapse
+{
+	unsigned int from;
+	unsigned int to;
+	double cost;
+};
+
+static uint64_t EdgeKey(unsigned int a, unsigned int b)
+{
+	return a < b ? ((uint64_t)a << 32) | b : ((uint64_t)b << 32) | a;
+}
+
+static glm::vec3 TriangleNormal(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c)
+{
+	return glm::cross(b - a, c - a);
+}
+
+// Would moving from onto to flip (or flatten) any of the triangles around from that survive the collapse?
+static bool CollapseFlips(StridedSpan<const glm::vec3> positions, const std::vector<unsigned int>& indices, const std::vector<unsigned int>& adjacencyOffsets,
+	const std::vector<unsigned int>& adjacency, unsigned int from, unsigned int to)
+{
+	for (unsigned int i = adjacencyOffsets[from]; i < adjacencyOffsets[from + 1]; i++)
+	{
+		const unsigned int* triangle = &indices[adjacency[i] * 3];
+		if (triangle[0] == to || triangle[1] == to || triangle[2] == to) continue; // Removed by the collapse
+
+		glm::vec3 before[3];
+		glm::vec3 after[3];
+		for (int j = 0; j < 3; j++)
+		{
+			before[j] = positions[triangle[j]];
+			after[j] = triangle[j] == from ? positions[to] : before[j];
+		}
+
+		glm::vec3 normalBefore = TriangleNormal(before[0], before[1], before[2]);
+		glm::vec3 normalAfter = TriangleNormal(after[0], after[1], after[2]);
+		if (glm::dot(normalBefore, normalAfter) <= 0.0f) return true;
+	}
+
+	return false;
+}
+
+namespace MeshLODUtils
+{
+	std::vector<unsigned int> Simplify(StridedSpan<const glm::vec3> positions, const unsigned int* indices, size_t indexCount, size_t targetIndexCount, float maxError, float* error)
+	{
+		std::vector<unsigned int> result(indices, indices + indexCount);
+		double resultError = 0.0;
+
+		unsigned int vertexCount = 0;
+		for (unsigned int index : result) vertexCount = std::max(vertexCount, index + 1);
+
+		if (vertexCount > positions.Size())
+		{
+			std::cout << "Can't simplify mesh, it indexes past the end of its vertices!" << std::endl;
+			if (error) *error = 0.0f;
+			return result;
+		}
+
+		// Lock every vertex on an edge that isn't shared by exactly 2 triangles. Holes, outlines & UV seams keep their shape that way
+		std::unordered_map<uint64_t, unsigned int> edgeUses;
+		edgeUses.reserve(indexCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			for (int j = 0; j < 3; j++) edgeUses[EdgeKey(result[i + j], result[i + (j + 1) % 3])]++;
+		}
+
+		std::vector<bool> locked(vertexCount, false);
+		for (const std::pair<const uint64_t, unsigned int>& edge : edgeUses)
+		{
+			if (edge.second == 2) continue;
+			locked[(unsigned int)(edge.first >> 32)] = true;
+			locked[(unsigned int)(edge.first & 0xFFFFFFFF)] = true;
+		}
+
+		// Every vertex starts with the planes of the triangles around it
+		std::vector<Quadric> quadrics(vertexCount);
+		for (size_t i = 0; i < indexCount; i += 3)
+		{
+			glm::dvec3 a = positions[result[i]];
+			glm::dvec3 normal = glm::cross(glm::dvec3(positions[result[i + 1]]) - a, glm::dvec3(positions[result[i + 2]]) - a);
+			double length = glm::length(normal);
+			if (length <= 0.0) continue; // Degenerate, doesn't have a plane
+
+			normal /= length;
+			Quadric quadric(normal, -glm::dot(normal, a));
+			for (int j = 0; j < 3; j++) quadrics[result[i + j]] += quadric;
+		}
+
+		const double maxCost = (double)maxError * maxError;
+
+		std::vector<unsigned int> adjacencyOffsets(vertexCount + 1);
+		std::vector<unsigned int> adjacency;
+		std::vector<Collapse> collapses;
+		std::vector<unsigned int> remap(vertexCount);
+		std::vector<bool> touched(vertexCount);
+
+		// Collapse in passes. Each pass sorts the candidate edges by cost & collapses the cheapest ones that don't touch a vertex another collapse already changed this pass
+		while (result.size() > targetIndexCount)
+		{
+			size_t triangleCount = result.size() / 3;
+
+			// Triangles around every vertex
+			std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+			for (unsigned int index : result) adjacencyOffsets[index + 1]++;
+			for (unsigned int i = 0; i < vertexCount; i++) adjacencyOffsets[i + 1] += adjacencyOffsets[i];
+
+			adjacency.resize(result.size());
+			std::vector<unsigned int> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+			for (size_t i = 0; i < result.size(); i++) adjacency[fill[result[i]]++] = (unsigned int)(i / 3);
+
+			collapses.clear();
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				for (int j = 0; j < 3; j++)
+				{
+					unsigned int a = result[i + j];
+					unsigned int b = result[i + (j + 1) % 3];
+					if (a > b) continue; // Every interior edge shows up twice, once in each direction
+
+					Quadric quadric = quadrics[a];
+					quadric += quadrics[b];
+
+					if (!locked[a]) collapses.push_back({ a, b, quadric.Evaluate(positions[b]) });
+					if (!locked[b]) collapses.push_back({ b, a, quadric.Evaluate(positions[a]) });
+				}
+			}
+
+			std::sort(collapses.begin(), collapses.end(), [](const Collapse& lhs, const Collapse& rhs) { return lhs.cost < rhs.cost; });
+
+			for (unsigned int i = 0; i < vertexCount; i++) remap[i] = i;
+			std::fill(touched.begin(), touched.end(), false);
+
+			size_t collapsed = 0;
+			for (const Collapse& collapse : collapses)
+			{
+				if (collapse.cost > maxCost || triangleCount * 3 <= targetIndexCount) break;
+				if (touched[collapse.from] || touched[collapse.to]) continue;
+				if (CollapseFlips(positions, result, adjacencyOffsets, adjacency, collapse.from, collapse.to)) continue;
+
+				// Every triangle around from changes, so none of their vertices can be part of another collapse this pass
+				for (unsigned int j = adjacencyOffsets[collapse.from]; j < adjacencyOffsets[collapse.from + 1]; j++)
+				{
+					const unsigned int* triangle = &result[adjacency[j] * 3];
+					if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to) triangleCount--;
+
+					touched[triangle[0]] = true;
+					touched[triangle[1]] = true;
+					touched[triangle[2]] = true;
+				}
+
+				remap[collapse.from] = collapse.to;
+				quadrics[collapse.to] += quadrics[collapse.from];
+				resultError = std::max(resultError, collapse.cost);
+				collapsed++;
+			}
+
+			if (collapsed == 0) break; // Everything left is locked, would flip a triangle or costs too much
+
+			// Apply the collapses & drop the triangles that became degenerate
+			size_t writeIndex = 0;
+			for (size_t i = 0; i < result.size(); i += 3)
+			{
+				unsigned int a = remap[result[i]];
+				unsigned int b = remap[result[i + 1]];
+				unsigned int c = remap[result[i + 2]];
+				if (a == b || b == c || a == c) continue;
+
+				result[writeIndex++] = a;
+				result[writeIndex++] = b;
+				result[writeIndex++] = c;
+			}
+			result.resize(writeIndex);
+		}
+
+		// The quadric sums the squared distances to all of the original planes around the vertex, so its root bounds the distance to each of them
+		if (error) *error = (float)std::sqrt(resultError);
+		return result;
+	}
+
+	void GenerateLODs(StridedSpan<const glm::vec3> positions, std::vector<Face>& faces, std::vector<Submesh>& submeshes, const MeshLODSettings& settings, std::vector<float>& lodErrors)
+	{
+		lodErrors.assign(1, 0.0f);
+
+		unsigned int lodCount = 1;
+		for (Submesh& submesh : submeshes)
+		{
+			submesh.lods.clear();
+			if (submesh.indexCount / 3 <= settings.minTriangles || submesh.vertexStart >= positions.Size()) continue;
+
+			// Copied since faces grows below
+			const unsigned int* firstIndex = reinterpret_cast<const unsigned int*>(faces.data()) + submesh.indexStart;
+			std::vector<unsigned int> sourceIndices(firstIndex, firstIndex + submesh.indexCount);
+
+			StridedSpan<const glm::vec3> submeshPositions(&positions[submesh.vertexStart], positions.Size() - submesh.vertexStart, positions.Stride());
+			float maxError = glm::length(submesh.maxVertex - submesh.minVertex) * settings.maxRelativeError;
+
+			size_t previousIndexCount = submesh.indexCount;
+			for (unsigned int lod = 1; lod < settings.maxLODs; lod++)
+			{
+				size_t targetTriangles = (size_t)(previousIndexCount / 3 * settings.reduction);
+				if (targetTriangles < settings.minTriangles) break;
+
+				// Always simplified from the full detail indices, so the error is measured against the mesh the LOD stands in for
+				float error = 0.0f;
+				std::vector<unsigned int> lodIndices = Simplify(submeshPositions, sourceIndices.data(), sourceIndices.size(), targetTriangles * 3, maxError, &error);
+				if (lodIndices.empty() || lodIndices.size() > previousIndexCount * 9 / 10) break; // Ran into the error limit, a LOD that barely saves anything isn't worth the memory
+
+				SubmeshLOD submeshLOD;
+				submeshLOD.indexStart = (unsigned int)faces.size() * 3;
+				submeshLOD.indexCount = (unsigned int)lodIndices.size();
+				submeshLOD.error = error;
+				submesh.lods.push_back(submeshLOD);
+
+				for (size_t i = 0; i < lodIndices.size(); i += 3)
+				{
+					Face face;
+					face.v1 = lodIndices[i];
+					face.v2 = lodIndices[i + 1];
+					face.v3 = lodIndices[i + 2];
+					faces.push_back(face);
+				}
+
+				previousIndexCount = lodIndices.size();
+			}
+
+			lodCount = std::max(lodCount, (unsigned int)submesh.lods.size() + 1);
+		}
+
+		// A mesh LOD is as bad as its worst submesh, submeshes with fewer LODs draw their coarsest one
+		lodErrors.resize(lodCount, 0.0f);
+		for (unsigned int lod = 1; lod < lodCount; lod++)
+		{
+			lodErrors[lod] = lodErrors[lod - 1];
+			for (const Submesh& submesh : submeshes)
+			{
+				if (submesh.lods.empty()) continue;
+				lodErrors[lod] = std::max(lodErrors[lod], submesh.lods[std::min(lod, (unsigned int)submesh.lods.size()) - 1].error);
+			}
+		}
+	}
+
+	float GetProjectionScale(const glm::mat4& projection, float viewportHeight)
+	{
+		return projection[1][1] * viewportHeight * 0.5f;
+	}
+
+	unsigned int SelectLOD(const std::vector<float>& lodErrors, float scale, float distance, float projectionScale, unsigned int currentLOD, const MeshLODSelection& selection)
+	{
+		if (lodErrors.size() <= 1) return 0;
+
+		unsigned int lodCount = (unsigned int)lodErrors.size();
+		float pixelsPerUnit = scale * projectionScale / std::max(distance, 0.0001f);
+		currentLOD = std::min(currentLOD, lodCount - 1);
+
+		unsigned int lod = 0;
+		while (lod + 1 < lodCount && lodErrors[lod + 1] * pixelsPerUnit <= selection.pixelError) lod++;
+
+		if (lod <= currentLOD) return lod; // Going finer happens right away, the current LOD is already too coarse
+
+		// Going coarser needs the error to be clearly below the limit
+		float coarserPixelError = selection.pixelError * (1.0f - selection.hysteresis);
+		lod = currentLOD;
+		while (lod + 1 < lodCount && lodErrors[lod + 1] * pixelsPerUnit <= coarserPixelError) lod++;
+		return lod;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "IMesh.h"
+#include "VertexInformation.h"
+#include "Span.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+struct MeshLODSettings
+{
+	unsigned int maxLODs = 4; // Including the full detail mesh
+	float reduction = 0.5f; // Every LOD aims for this fraction of the previous LOD's triangles
+	unsigned int minTriangles = 64; // Submeshes aren't simplified below this many triangles
+	float maxRelativeError = 0.05f; // Simplification stops before the surface moves by more than this fraction of the submesh's bounding box diagonal
+};
+
+struct MeshLODSelection
+{
+	float pixelError = 1.0f; // Largest error (in pixels) a LOD may have on screen
+	float hysteresis = 0.25f; // A coarser LOD is only picked once its error is this fraction below pixelError, so meshes don't flicker between LODs at the switch distance
+	unsigned int shadowBias = 1; // Shadow cascades draw this many LODs coarser than the camera does
+};
+
+// Everything here is CPU only so the simplification & LOD selection can be run without a GL context
+namespace MeshLODUtils
+{
+	// Quadric error edge collapse that only ever collapses a vertex onto one of its neighbours, so the result indexes the same vertices & can share the vertex buffer.
+	// Vertices on open edges (which includes UV seams, the vertices are split there) never move. Collapses until the result has at most targetIndexCount indices
+	// or the next collapse would move the surface by more than maxError. error is set to an estimate of how far the surface moved
+	std::vector<unsigned int> Simplify(StridedSpan<const glm::vec3> positions, const unsigned int* indices, size_t indexCount, size_t targetIndexCount, float maxError, float* error);
+
+	// Simplifies every submesh into a chain of LODs, appending their indices to faces & their ranges to Submesh::lods.
+	// lodErrors gets the error of every LOD across the whole mesh, [0] is the full detail mesh
+	void GenerateLODs(StridedSpan<const glm::vec3> positions, std::vector<Face>& faces, std::vector<Submesh>& submeshes, const MeshLODSettings& settings, std::vector<float>& lodErrors);
+
+	float GetProjectionScale(const glm::mat4& projection, float viewportHeight); // Pixels covered by one unit at a distance of 1
+
+	// Coarsest LOD whose error stays below selection.pixelError on screen. currentLOD is the LOD picked last frame, see MeshLODSelection::hysteresis
+	unsigned int SelectLOD(const std::vector<float>& lodErrors, float scale, float distance, float projectionScale, unsigned int currentLOD, const MeshLODSelection& selection);
+}
\ No newline at end of file
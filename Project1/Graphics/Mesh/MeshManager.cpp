@@ -1,9 +1,14 @@
 #include "MeshManager.h"
+#include "AssetLoader.h"
 
 std::unordered_map<std::string, Mesh*> MeshManager::meshes;
 std::unordered_map<std::string, AnimatedMesh*> MeshManager::animatedMeshes;
 std::unordered_map<std::string, Animation*> MeshManager::animations;
 
+MeshLODSettings MeshManager::lodSettings;
+float MeshManager::animationSampleRate = 0.0f;
+AnimationCompressionSettings MeshManager::animationCompressionSettings;
+
 void MeshManager::CleanUp()
 {
 	std::unordered_map<std::string, Mesh*>::iterator it = meshes.begin();
@@ -25,30 +30,42 @@ void MeshManager::CleanUp()
 
 Mesh* MeshManager::GetMesh(const std::string& path)
 {
+	if (AssetLoader::IsLoading(path)) AssetLoader::Wait(path);
+
 	std::unordered_map<std::string, Mesh*>::iterator it = meshes.find(path);
 	if (it != meshes.end()) return it->second;
 
-	Mesh* m = new Mesh(path);
+	Mesh* m = new Mesh(path, false);
+	m->GenerateLODs(lodSettings);
+	m->Upload();
 	meshes.insert({ path, m });
 	return m;
 }
 
 AnimatedMesh* MeshManager::GetAnimatedMesh(const std::string& path)
 {
+	if (AssetLoader::IsLoading(path)) AssetLoader::Wait(path);
+
 	std::unordered_map<std::string, AnimatedMesh*>::iterator it = animatedMeshes.find(path);
 	if (it != animatedMeshes.end()) return it->second;
 
-	AnimatedMesh* m = new AnimatedMesh(path);
+	AnimatedMesh* m = new AnimatedMesh(path, false);
+	m->GenerateLODs(lodSettings);
+	m->Upload();
 	animatedMeshes.insert({ path, m });
 	return m;
 }
 
 Animation* MeshManager::GetAnimation(const std::string& path)
 {
+	if (AssetLoader::IsLoading(path)) AssetLoader::Wait(path);
+
 	std::unordered_map<std::string, Animation*>::iterator it = animations.find(path);
 	if (it != animations.end()) return it->second;
 
 	Animation* anim = new Animation(path);
+	anim->Resample(animationSampleRate);
+	anim->Compress(animationCompressionSettings);
 	animations.insert({ path, anim });
 	return anim;
 }
\ No newline at end of file
@@ -12,12 +12,31 @@ class MeshManager
 public:
 	static void CleanUp();
 
+	// Load on the calling thread, unless the AssetLoader is already loading the file. Then they wait for it instead
 	static Mesh* GetMesh(const std::string& path);
 	static AnimatedMesh* GetAnimatedMesh(const std::string& path);
 	static Animation* GetAnimation(const std::string& path);
 
+	// Used for meshes loaded from now on, meshes that are already loaded keep their LODs
+	static void SetLODSettings(const MeshLODSettings& settings) { lodSettings = settings; }
+	static const MeshLODSettings& GetLODSettings() { return lodSettings; }
+
+	// Animations loaded from now on are resampled to this many key frames a second (see Animation::Resample), 0 keeps the key frames from the file
+	static void SetAnimationSampleRate(float sampleRate) { animationSampleRate = sampleRate; }
+	static float GetAnimationSampleRate() { return animationSampleRate; }
+
+	// Used for animations loaded from now on, see Animation::Compress
+	static void SetAnimationCompressionSettings(const AnimationCompressionSettings& settings) { animationCompressionSettings = settings; }
+	static const AnimationCompressionSettings& GetAnimationCompressionSettings() { return animationCompressionSettings; }
+
 private:
+	friend class AssetLoader;
+
 	static std::unordered_map<std::string, Mesh*> meshes;
 	static std::unordered_map<std::string, AnimatedMesh*> animatedMeshes;
 	static std::unordered_map<std::string, Animation*> animations;
+
+	static MeshLODSettings lodSettings;
+	static float animationSampleRate;
+	static AnimationCompressionSettings animationCompressionSettings;
 };
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Skeleton.h"
+
+#include <glm/gtx/matrix_decompose.hpp>
+
+#include <functional>
+
+static void FlattenBone(const Bone& bone, int parent, Skeleton& skeleton)
+{
+	int index = (int)skeleton.parents.size();
+	skeleton.parents.push_back(parent);
+	skeleton.boneIDs.push_back(bone.ID);
+	skeleton.offsetTransforms.push_back(bone.offsetTransform);
+	skeleton.nameHashes.push_back(std::hash<std::string>()(bone.name));
+	skeleton.names.push_back(bone.name);
+
+	for (const Bone& child : bone.children)
+	{
+		FlattenBone(child, index, skeleton);
+	}
+}
+
+static const float DETAIL_JOINT_SIZE = 0.06f; // Of the bind pose's bounding box diagonal
+
+// A joint is detail if it is one of several small branches of its parent (fingers off a hand, face joints off a head), or if its parent is.
+// Single children are never detail, so the ends of long chains (a head without face joints, toes) keep animating
+static void FindDetailJoints(Skeleton& skeleton)
+{
+	unsigned int jointCount = skeleton.GetJointCount();
+	skeleton.detailJoints.assign(jointCount, false);
+	if (jointCount == 0) return;
+
+	// The offset transform inverted is the joint's bind pose in mesh space
+	std::vector<glm::vec3> boundsMin(jointCount);
+	std::vector<glm::vec3> boundsMax(jointCount);
+	std::vector<unsigned int> childCount(jointCount, 0);
+	for (unsigned int i = 0; i < jointCount; i++)
+	{
+		boundsMin[i] = boundsMax[i] = glm::vec3(glm::inverse(skeleton.offsetTransforms[i])[3]);
+		if (skeleton.parents[i] != -1) childCount[skeleton.parents[i]]++;
+	}
+
+	// Children come after their parents, going backwards grows every joint's bounds by its whole subtree
+	for (unsigned int i = jointCount - 1; i > 0; i--)
+	{
+		int parent = skeleton.parents[i];
+		boundsMin[parent] = glm::min(boundsMin[parent], boundsMin[i]);
+		boundsMax[parent] = glm::max(boundsMax[parent], boundsMax[i]);
+	}
+
+	float maxSize = glm::length(boundsMax[0] - boundsMin[0]) * DETAIL_JOINT_SIZE;
+	for (unsigned int i = 1; i < jointCount; i++)
+	{
+		int parent = skeleton.parents[i];
+		skeleton.detailJoints[i] = skeleton.detailJoints[parent] || (childCount[parent] > 1 && glm::length(boundsMax[i] - boundsMin[i]) < maxSize);
+	}
+}
+
+int Skeleton::FindJoint(const std::string& name) const
+{
+	size_t hash = std::hash<std::string>()(name);
+	for (unsigned int i = 0; i < nameHashes.size(); i++)
+	{
+		if (nameHashes[i] == hash && names[i] == name) return (int)i;
+	}
+
+	return -1;
+}
+
+Skeleton Skeleton::Flatten(const Bone& rootBone, const glm::mat4& inverseTransform)
+{
+	Skeleton skeleton;
+	if (rootBone.ID == (unsigned int)-1) return skeleton; // The mesh has no bones
+
+	FlattenBone(rootBone, -1, skeleton);
+
+	// The offset transforms take a vertex from mesh space into the joint's space, so the rest pose of a joint is its parent's offset * its own offset inverted.
+	// The root has no parent and has to undo inverseTransform instead
+	unsigned int jointCount = skeleton.GetJointCount();
+	skeleton.restPositions.resize(jointCount);
+	skeleton.restRotations.resize(jointCount);
+	skeleton.restScales.resize(jointCount);
+	for (unsigned int i = 0; i < jointCount; i++)
+	{
+		int parent = skeleton.parents[i];
+		glm::mat4 parentTransform = parent == -1 ? glm::inverse(inverseTransform) : skeleton.offsetTransforms[parent];
+		glm::mat4 restTransform = parentTransform * glm::inverse(skeleton.offsetTransforms[i]);
+
+		glm::vec3 skew;
+		glm::vec4 perspective;
+		glm::decompose(restTransform, skeleton.restScales[i], skeleton.restRotations[i], skeleton.restPositions[i], skew, perspective);
+	}
+
+	FindDetailJoints(skeleton);
+
+	return skeleton;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Bone.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <string>
+#include <vector>
+
+// A bone hierarchy flattened into parallel arrays. Every joint comes after its parent, so a pose can be evaluated in one pass from the front to the back
+struct Skeleton
+{
+	std::vector<int> parents; // Joint index of the parent, -1 for the root
+	std::vector<unsigned int> boneIDs; // Where the joint's matrix goes in the bone palette
+	std::vector<glm::mat4> offsetTransforms;
+
+	// Local transform of the bind pose, used for joints an animation doesn't move
+	std::vector<glm::vec3> restPositions;
+	std::vector<glm::quat> restRotations;
+	std::vector<glm::vec3> restScales;
+	std::vector<size_t> nameHashes;
+	std::vector<std::string> names; // Only needed to bind animations, pose evaluation never touches these
+
+	std::vector<bool> detailJoints; // Small joints branching off the ends of the hierarchy (fingers, face), animation LOD leaves them in their rest pose
+
+	unsigned int GetJointCount() const { return (unsigned int)parents.size(); }
+	int FindJoint(const std::string& name) const; // -1 if there's no joint with that name
+
+	static Skeleton Flatten(const Bone& rootBone, const glm::mat4& inverseTransform); // Empty if rootBone was never assigned a bone. inverseTransform is the mesh's, see AnimatedMesh
+};
\ No newline at end of file
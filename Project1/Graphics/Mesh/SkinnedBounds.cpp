@@ -0,0 +1,63 @@
+#include "SkinnedBounds.h"
+
+#include <cfloat>
+
+namespace SkinnedBoundsUtils
+{
+	std::vector<BoneBounds> ComputeBoneBounds(Span<const AnimatedVertex> vertices, unsigned int boneCount, float padding)
+	{
+		BoneBounds empty;
+		empty.min = glm::vec3(FLT_MAX);
+		empty.max = glm::vec3(-FLT_MAX);
+		std::vector<BoneBounds> boneBounds(boneCount, empty);
+
+		for (const AnimatedVertex& vertex : vertices)
+		{
+			for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+			{
+				if (vertex.boneIDs[i] < 0.0f || vertex.boneWeights[i] <= 0.0f) continue; // Unused influence
+
+				unsigned int boneID = (unsigned int)vertex.boneIDs[i];
+				if (boneID >= boneCount) continue;
+
+				boneBounds[boneID].min = glm::min(boneBounds[boneID].min, vertex.position);
+				boneBounds[boneID].max = glm::max(boneBounds[boneID].max, vertex.position);
+			}
+		}
+
+		for (BoneBounds& bounds : boneBounds)
+		{
+			if (bounds.IsEmpty()) continue;
+
+			bounds.min -= glm::vec3(padding);
+			bounds.max += glm::vec3(padding);
+		}
+
+		return boneBounds;
+	}
+
+	bool ComputeSkinnedBounds(const std::vector<BoneBounds>& boneBounds, const glm::mat4* boneMatrices, glm::vec3& min, glm::vec3& max)
+	{
+		min = glm::vec3(FLT_MAX);
+		max = glm::vec3(-FLT_MAX);
+
+		bool found = false;
+		for (unsigned int i = 0; i < boneBounds.size(); i++)
+		{
+			const BoneBounds& bounds = boneBounds[i];
+			if (bounds.IsEmpty()) continue;
+
+			// The transformed box's extent along every axis is the absolute matrix applied to the original extent
+			const glm::mat4& matrix = boneMatrices[i];
+			glm::vec3 center = glm::vec3(matrix * glm::vec4((bounds.min + bounds.max) * 0.5f, 1.0f));
+			glm::vec3 extent = (bounds.max - bounds.min) * 0.5f;
+			glm::vec3 transformedExtent = glm::abs(glm::vec3(matrix[0])) * extent.x + glm::abs(glm::vec3(matrix[1])) * extent.y + glm::abs(glm::vec3(matrix[2])) * extent.z;
+
+			min = glm::min(min, center - transformedExtent);
+			max = glm::max(max, center + transformedExtent);
+			found = true;
+		}
+
+		return found;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "AnimatedVertex.h"
+#include "Span.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Box around the vertices one bone influences, in the mesh's bind pose. Bones that don't influence any vertex have min > max
+struct BoneBounds
+{
+	glm::vec3 min;
+	glm::vec3 max;
+
+	bool IsEmpty() const { return min.x > max.x; }
+};
+
+// Everything here is CPU only so the bounds can be checked against skinned vertices without a GL context
+namespace SkinnedBoundsUtils
+{
+	// One BoneBounds per bone ID. padding grows every box, so it also covers the positions the compressed vertex buffer decodes to
+	std::vector<BoneBounds> ComputeBoneBounds(Span<const AnimatedVertex> vertices, unsigned int boneCount, float padding);
+
+	// Box around every vertex skinned with boneMatrices, in the same space the shader skins into. A skinned vertex is a weighted average of its bones' matrices applied to it,
+	// so it can't leave the union of its bones' boxes moved by their matrices. false if no bone influences any vertex
+	bool ComputeSkinnedBounds(const std::vector<BoneBounds>& boneBounds, const glm::mat4* boneMatrices, glm::vec3& min, glm::vec3& max);
+}
\ No newline at end of file
@@ -0,0 +1,46 @@
+#include "Skinning.h"
+
+namespace SkinningUtils
+{
+	SkinnedVertex SkinVertex(const CompressedAnimatedVertex& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4* boneMatrices, unsigned int boneCount)
+	{
+		glm::vec4 position = glm::vec4(VertexCompressionUtils::DecodePosition(vertex.position, boundsMin, boundsMax), 1.0f);
+		glm::vec3 normal = VertexCompressionUtils::DecodeNormal(vertex.normal);
+
+		glm::vec4 skinnedPosition(0.0f);
+		glm::vec3 skinnedNormal(0.0f);
+		for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+		{
+			float weight = VertexCompressionUtils::DecodeBoneWeight(vertex.boneWeights[i]);
+			if (weight == 0.0f) continue; // Unused influence
+
+			unsigned int boneID = vertex.boneIDs[i];
+			if (boneID >= boneCount) // Past the palette, keep the bind pose
+			{
+				skinnedPosition = position;
+				skinnedNormal = normal;
+				break;
+			}
+
+			skinnedPosition += boneMatrices[boneID] * position * weight;
+			skinnedNormal += glm::mat3(boneMatrices[boneID]) * normal * weight;
+		}
+
+		SkinnedVertex skinned;
+		skinned.position[0] = skinnedPosition.x;
+		skinned.position[1] = skinnedPosition.y;
+		skinned.position[2] = skinnedPosition.z;
+		VertexCompressionUtils::EncodeNormal(skinnedNormal, skinned.normal); // The octahedral projection divides by the length anyway, no need to normalize
+		skinned.texCoord[0] = vertex.texCoord[0];
+		skinned.texCoord[1] = vertex.texCoord[1];
+		return skinned;
+	}
+
+	void SkinVertices(Span<const CompressedAnimatedVertex> vertices, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4* boneMatrices, unsigned int boneCount, SkinnedVertex* skinned)
+	{
+		for (size_t i = 0; i < vertices.Size(); i++)
+		{
+			skinned[i] = SkinVertex(vertices[i], boundsMin, boundsMax, boneMatrices, boneCount);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "VertexCompression.h"
+#include "Span.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Matches the buffer the skinning compute shader writes (found in SkinningPass.h), 20 bytes. Positions are plain floats in mesh space
+// so the static mesh shaders can draw it with a vPositionScale of 1 and a vPositionOffset of 0
+struct SkinnedVertex
+{
+	float position[3];
+	int16_t normal[2]; // SNORM16 octahedral encoding
+	uint16_t texCoord[2]; // Half floats, copied as is from the source vertex
+};
+
+static_assert(sizeof(SkinnedVertex) == 20, "SkinnedVertex has to be tightly packed, the skinning shader writes it as 5 uints");
+
+// CPU reference for assets/shaders/skinning.glsl, same math in the same order so what the GPU wrote can be checked against it without a GL context
+namespace SkinningUtils
+{
+	// vertex was quantized to [boundsMin, boundsMax] (its submesh's bounds). A bone ID past boneCount leaves the vertex in its bind pose, like the animated mesh shaders do
+	SkinnedVertex SkinVertex(const CompressedAnimatedVertex& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4* boneMatrices, unsigned int boneCount);
+
+	// skinned has to hold vertices.size() vertices
+	void SkinVertices(Span<const CompressedAnimatedVertex> vertices, const glm::vec3& boundsMin, const glm::vec3& boundsMax, const glm::mat4* boneMatrices, unsigned int boneCount, SkinnedVertex* skinned);
+}
\ No newline at end of file
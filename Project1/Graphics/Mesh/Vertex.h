@@ -1,18 +1,19 @@
 #pragma once
 
-#include "IVertex.h"
+#include <glm/glm.hpp>
 
-class Vertex : public IVertex
+// Matches the static mesh buffer layout (vPosition, vNormal, vTextureCoordinates), meshes store and upload these as one flat array
+struct Vertex
 {
-public:
-	Vertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoord);
-	virtual ~Vertex();
+	Vertex() = default;
+	Vertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec2& texCoord)
+		: position(position),
+		normal(normal),
+		texCoord(texCoord) {}
 
-	virtual float* Data() override { return data; }
+	glm::vec3 position;
+	glm::vec3 normal;
+	glm::vec2 texCoord;
+};
 
-	static unsigned int Length() { return 8; }
-	static unsigned int Size() { return sizeof(float) * 8; }
-
-private:
-	float data[8];
-};
\ No newline at end of file
+static_assert(sizeof(Vertex) == sizeof(float) * 8, "Vertex has to be tightly packed to be uploaded as is");
\ No newline at end of file
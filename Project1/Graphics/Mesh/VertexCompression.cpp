@@ -0,0 +1,139 @@
+#include "VertexCompression.h"
+
+#include <glm/gtc/packing.hpp>
+
+#include <cmath>
+
+static float SignNotZero(float value)
+{
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+namespace VertexCompressionUtils
+{
+	void EncodePosition(const glm::vec3& position, const glm::vec3& boundsMin, const glm::vec3& boundsMax, uint16_t* encoded)
+	{
+		glm::vec3 extent = boundsMax - boundsMin;
+		for (int i = 0; i < 3; i++)
+		{
+			float t = extent[i] > 0.0f ? (position[i] - boundsMin[i]) / extent[i] : 0.0f; // Flat submeshes only have one value on that axis
+			encoded[i] = glm::packUnorm1x16(t);
+		}
+		encoded[3] = 0;
+	}
+
+	glm::vec3 DecodePosition(const uint16_t* encoded, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		glm::vec3 t(glm::unpackUnorm1x16(encoded[0]), glm::unpackUnorm1x16(encoded[1]), glm::unpackUnorm1x16(encoded[2]));
+		return boundsMin + t * (boundsMax - boundsMin);
+	}
+
+	void EncodeNormal(const glm::vec3& normal, int16_t* encoded)
+	{
+		float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+		if (length <= 0.0f) // Broken normal, store +Z rather than NaNs
+		{
+			encoded[0] = 0;
+			encoded[1] = 0;
+			return;
+		}
+
+		// Project onto the octahedron & fold the lower half over the upper one
+		glm::vec2 p = glm::vec2(normal) / length;
+		if (normal.z < 0.0f)
+		{
+			p = glm::vec2((1.0f - std::abs(p.y)) * SignNotZero(p.x), (1.0f - std::abs(p.x)) * SignNotZero(p.y));
+		}
+
+		encoded[0] = (int16_t)glm::packSnorm1x16(p.x);
+		encoded[1] = (int16_t)glm::packSnorm1x16(p.y);
+	}
+
+	glm::vec3 DecodeNormal(const int16_t* encoded)
+	{
+		glm::vec2 p(glm::unpackSnorm1x16((uint16_t)encoded[0]), glm::unpackSnorm1x16((uint16_t)encoded[1]));
+
+		// Same as DecodeOctahedral() in the mesh shaders
+		glm::vec3 normal(p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y));
+		float t = glm::max(-normal.z, 0.0f);
+		normal.x += normal.x >= 0.0f ? -t : t;
+		normal.y += normal.y >= 0.0f ? -t : t;
+		return glm::normalize(normal);
+	}
+
+	void EncodeTexCoord(const glm::vec2& texCoord, uint16_t* encoded)
+	{
+		encoded[0] = glm::packHalf1x16(texCoord.x);
+		encoded[1] = glm::packHalf1x16(texCoord.y);
+	}
+
+	glm::vec2 DecodeTexCoord(const uint16_t* encoded)
+	{
+		return glm::vec2(glm::unpackHalf1x16(encoded[0]), glm::unpackHalf1x16(encoded[1]));
+	}
+
+	bool EncodeBones(const float* boneIDs, const float* boneWeights, uint8_t* encodedIDs, uint8_t* encodedWeights)
+	{
+		bool fits = true;
+		float totalWeight = 0.0f;
+		for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+		{
+			encodedIDs[i] = 0;
+			encodedWeights[i] = 0;
+
+			if (boneIDs[i] < 0.0f || boneWeights[i] <= 0.0f) continue; // Unused influence
+			if (boneIDs[i] > (float)MAX_BONE_ID)
+			{
+				fits = false;
+				continue;
+			}
+
+			totalWeight += boneWeights[i];
+		}
+
+		if (totalWeight <= 0.0f) return fits;
+
+		// Weights are renormalized & rounded so they sum up to exactly 255, the rounding error goes to the largest weight
+		int sum = 0;
+		unsigned int largest = 0;
+		for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+		{
+			if (boneIDs[i] < 0.0f || boneWeights[i] <= 0.0f || boneIDs[i] > (float)MAX_BONE_ID) continue;
+
+			encodedIDs[i] = (uint8_t)boneIDs[i];
+			encodedWeights[i] = (uint8_t)std::round(boneWeights[i] / totalWeight * 255.0f);
+			sum += encodedWeights[i];
+
+			if (boneWeights[i] > boneWeights[largest] || encodedWeights[largest] == 0) largest = i;
+		}
+		encodedWeights[largest] = (uint8_t)(encodedWeights[largest] + 255 - sum);
+
+		return fits;
+	}
+
+	float DecodeBoneWeight(uint8_t encoded)
+	{
+		return glm::unpackUnorm1x8(encoded);
+	}
+
+	CompressedVertex Compress(const Vertex& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsMax)
+	{
+		CompressedVertex compressed;
+		EncodePosition(vertex.position, boundsMin, boundsMax, compressed.position);
+		EncodeNormal(vertex.normal, compressed.normal);
+		EncodeTexCoord(vertex.texCoord, compressed.texCoord);
+		return compressed;
+	}
+
+	CompressedAnimatedVertex Compress(const AnimatedVertex& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsMax, bool* bonesFit)
+	{
+		CompressedAnimatedVertex compressed;
+		EncodePosition(vertex.position, boundsMin, boundsMax, compressed.position);
+		EncodeNormal(vertex.normal, compressed.normal);
+		EncodeTexCoord(vertex.texCoord, compressed.texCoord);
+
+		bool fits = EncodeBones(vertex.boneIDs, vertex.boneWeights, compressed.boneIDs, compressed.boneWeights);
+		if (bonesFit) *bonesFit = fits;
+		return compressed;
+	}
+}
\ No newline at end of file
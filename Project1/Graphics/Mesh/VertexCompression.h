@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Vertex.h"
+#include "AnimatedVertex.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+// Vertex attribute locations that aren't read from the vertex buffer. They're left disabled in the VAO and RenderComponent::Draw sets their constant value
+// before every submesh, mesh shaders rebuild the position with vPosition * vPositionScale + vPositionOffset
+static const unsigned int POSITION_OFFSET_ATTRIBUTE_LOCATION = 5;
+static const unsigned int POSITION_SCALE_ATTRIBUTE_LOCATION = 6;
+
+// Matches the compressed static mesh buffer layout, 16 bytes instead of the 32 a Vertex takes
+struct CompressedVertex
+{
+	uint16_t position[4]; // UNORM16 inside the submesh bounds, w is padding
+	int16_t normal[2]; // SNORM16 octahedral encoding
+	uint16_t texCoord[2]; // Half floats
+};
+
+// Matches the compressed animated mesh buffer layout, 24 bytes instead of the 64 an AnimatedVertex takes
+struct CompressedAnimatedVertex
+{
+	uint16_t position[4];
+	int16_t normal[2];
+	uint16_t texCoord[2];
+	uint8_t boneIDs[MAX_BONE_INFLUENCE]; // Unused influences have a weight of 0
+	uint8_t boneWeights[MAX_BONE_INFLUENCE]; // UNORM8, always sum up to 255 unless the vertex has no bones
+};
+
+static_assert(sizeof(CompressedVertex) == 16, "CompressedVertex has to be tightly packed to be uploaded as is");
+static_assert(sizeof(CompressedAnimatedVertex) == 16 + MAX_BONE_INFLUENCE * 2, "CompressedAnimatedVertex has to be tightly packed to be uploaded as is");
+
+// Everything here is CPU only so the encodings can be checked without a GL context. Every Decode function does what the GPU/shaders do with the encoded value
+namespace VertexCompressionUtils
+{
+	static const unsigned int MAX_BONE_ID = 255;
+
+	void EncodePosition(const glm::vec3& position, const glm::vec3& boundsMin, const glm::vec3& boundsMax, uint16_t* encoded);
+	glm::vec3 DecodePosition(const uint16_t* encoded, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+
+	void EncodeNormal(const glm::vec3& normal, int16_t* encoded); // normal has to be normalized
+	glm::vec3 DecodeNormal(const int16_t* encoded);
+
+	void EncodeTexCoord(const glm::vec2& texCoord, uint16_t* encoded);
+	glm::vec2 DecodeTexCoord(const uint16_t* encoded);
+
+	// Bone IDs above MAX_BONE_ID can't be stored, returns false if the vertex had one (its influence is dropped)
+	bool EncodeBones(const float* boneIDs, const float* boneWeights, uint8_t* encodedIDs, uint8_t* encodedWeights);
+	float DecodeBoneWeight(uint8_t encoded);
+
+	CompressedVertex Compress(const Vertex& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsMax);
+	CompressedAnimatedVertex Compress(const AnimatedVertex& vertex, const glm::vec3& boundsMin, const glm::vec3& boundsMax, bool* bonesFit);
+}
\ No newline at end of file
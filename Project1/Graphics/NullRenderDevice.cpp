@@ -0,0 +1,600 @@
+#include "NullRenderDevice.h"
+#include "GLCommon.h"
+#include "Profiler.h"
+
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+bool NullRenderDevice::active = false;
+unsigned int NullRenderDevice::frameCount = 0;
+
+static NullRenderDeviceStats frameStats = {};
+static NullRenderDeviceStats totalStats = {};
+
+static GLuint nextName = 1; // Every object type shares one counter, names only have to be unique and non-zero
+static GLint nextUniformLocation = 0;
+
+static std::unordered_map<GLenum, GLuint> boundBuffers;
+static std::unordered_map<GLuint, GLsizeiptr> bufferSizes;
+static std::unordered_map<GLuint, std::vector<char>> bufferMemory; // Backs mapped buffers so the engine has somewhere to write
+
+static unsigned int GetComponentCount(GLenum format)
+{
+	switch (format)
+	{
+	case GL_RED:
+	case GL_RED_INTEGER:
+	case GL_DEPTH_COMPONENT:
+		return 1;
+	case GL_RG:
+	case GL_RG_INTEGER:
+	case GL_DEPTH_STENCIL:
+		return 2;
+	case GL_RGB:
+	case GL_BGR:
+	case GL_RGB_INTEGER:
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+static unsigned int GetTypeSize(GLenum type)
+{
+	switch (type)
+	{
+	case GL_UNSIGNED_BYTE:
+	case GL_BYTE:
+		return 1;
+	case GL_UNSIGNED_SHORT:
+	case GL_SHORT:
+	case GL_HALF_FLOAT:
+		return 2;
+	default:
+		return 4;
+	}
+}
+
+static unsigned int GetInternalFormatSize(GLenum internalFormat)
+{
+	switch (internalFormat)
+	{
+	case GL_R8:
+		return 1;
+	case GL_R16F:
+	case GL_RG8:
+		return 2;
+	case GL_RGB8:
+	case GL_SRGB8:
+		return 3;
+	case GL_RG16F:
+	case GL_R32F:
+	case GL_RGBA8:
+	case GL_SRGB8_ALPHA8:
+	case GL_DEPTH_COMPONENT32F:
+	case GL_DEPTH24_STENCIL8:
+		return 4;
+	case GL_RGB16F:
+		return 6;
+	case GL_RGBA16F:
+	case GL_RG32F:
+		return 8;
+	case GL_RGB32F:
+		return 12;
+	case GL_RGBA32F:
+		return 16;
+	default:
+		return 4;
+	}
+}
+
+static GLuint GenerateName()
+{
+	frameStats.objectsCreated++;
+	return nextName++;
+}
+
+static void GenerateNames(GLsizei count, GLuint* names)
+{
+	for (GLsizei i = 0; i < count; i++)
+	{
+		names[i] = GenerateName();
+	}
+}
+
+static void RecordBufferAllocation(GLuint buffer, GLsizeiptr size, const void* data)
+{
+	bufferSizes[buffer] = size;
+	frameStats.bufferBytesAllocated += (uint64_t)size;
+	if (data)
+	{
+		frameStats.bufferUploads++;
+		frameStats.bufferBytesUploaded += (uint64_t)size;
+	}
+}
+
+static void RecordBufferUpload(GLsizeiptr size)
+{
+	frameStats.bufferUploads++;
+	frameStats.bufferBytesUploaded += (uint64_t)size;
+}
+
+static void* MapBuffer(GLuint buffer, GLintptr offset, GLsizeiptr length)
+{
+	std::vector<char>& memory = bufferMemory[buffer];
+	if (memory.size() < (size_t)(offset + length)) memory.resize((size_t)(offset + length));
+	return memory.data() + offset;
+}
+
+static void RecordTextureAllocation(GLenum internalFormat, GLsizei width, GLsizei height, GLsizei depth)
+{
+	frameStats.textureBytesAllocated += (uint64_t)width * height * depth * GetInternalFormatSize(internalFormat);
+}
+
+static void RecordTextureUpload(GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type)
+{
+	frameStats.textureUploads++;
+	frameStats.textureBytesUploaded += (uint64_t)width * height * depth * GetComponentCount(format) * GetTypeSize(type);
+}
+
+// Queries
+
+static const GLubyte* APIENTRY NullGetString(GLenum name)
+{
+	switch (name)
+	{
+	case GL_VERSION:
+		return (const GLubyte*)"4.6.0 Null";
+	case GL_SHADING_LANGUAGE_VERSION:
+		return (const GLubyte*)"4.60";
+	case GL_RENDERER:
+		return (const GLubyte*)"Null Render Device";
+	default:
+		return (const GLubyte*)"";
+	}
+}
+
+static const GLubyte* APIENTRY NullGetStringi(GLenum /*name*/, GLuint /*index*/)
+{
+	return (const GLubyte*)"GL_NULL_render_device"; // glad refuses to load if a 3.0+ context reports no extensions at all
+}
+
+static void APIENTRY NullGetIntegerv(GLenum pname, GLint* data)
+{
+	switch (pname)
+	{
+	case GL_NUM_EXTENSIONS:
+		data[0] = 1;
+		break;
+	case GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT:
+	case GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT:
+		data[0] = 256;
+		break;
+	case GL_MAX_TEXTURE_SIZE:
+	case GL_MAX_3D_TEXTURE_SIZE:
+	case GL_MAX_ARRAY_TEXTURE_LAYERS:
+		data[0] = 16384;
+		break;
+	case GL_VIEWPORT:
+	case GL_SCISSOR_BOX:
+		data[0] = data[1] = data[2] = data[3] = 0;
+		break;
+	default:
+		data[0] = 0;
+		break;
+	}
+}
+
+static void APIENTRY NullGetFloatv(GLenum /*pname*/, GLfloat* data)
+{
+	data[0] = 0.0f;
+}
+
+static void APIENTRY NullGetBooleanv(GLenum /*pname*/, GLboolean* data)
+{
+	data[0] = GL_FALSE;
+}
+
+static GLenum APIENTRY NullGetError()
+{
+	return GL_NO_ERROR;
+}
+
+static GLenum APIENTRY NullCheckFramebufferStatus(GLenum /*target*/)
+{
+	return GL_FRAMEBUFFER_COMPLETE;
+}
+
+// Object creation
+
+static void APIENTRY NullGenNames(GLsizei n, GLuint* names)
+{
+	GenerateNames(n, names);
+}
+
+static GLuint APIENTRY NullCreateShader(GLenum /*type*/)
+{
+	return GenerateName();
+}
+
+static GLuint APIENTRY NullCreateProgram()
+{
+	return GenerateName();
+}
+
+static void APIENTRY NullGetShaderOrProgramiv(GLuint /*object*/, GLenum pname, GLint* params)
+{
+	switch (pname)
+	{
+	case GL_COMPILE_STATUS:
+	case GL_LINK_STATUS:
+	case GL_VALIDATE_STATUS:
+		params[0] = GL_TRUE;
+		break;
+	default:
+		params[0] = 0; // No info log and no active uniforms, the shader resolves its uniforms one by one instead
+		break;
+	}
+}
+
+static GLint APIENTRY NullGetUniformLocation(GLuint /*program*/, const GLchar* /*name*/)
+{
+	return nextUniformLocation++;
+}
+
+static GLint APIENTRY NullGetAttribLocation(GLuint /*program*/, const GLchar* /*name*/)
+{
+	return 0;
+}
+
+// Buffers
+
+static void APIENTRY NullBindBuffer(GLenum target, GLuint buffer)
+{
+	frameStats.otherCalls++;
+	boundBuffers[target] = buffer;
+}
+
+static void APIENTRY NullBindBufferBase(GLenum target, GLuint /*index*/, GLuint buffer)
+{
+	frameStats.otherCalls++;
+	boundBuffers[target] = buffer; // Binding to an indexed target also binds the generic one
+}
+
+static void APIENTRY NullBindBufferRange(GLenum target, GLuint /*index*/, GLuint buffer, GLintptr /*offset*/, GLsizeiptr /*size*/)
+{
+	frameStats.otherCalls++;
+	boundBuffers[target] = buffer;
+}
+
+static void APIENTRY NullDeleteBuffers(GLsizei n, const GLuint* buffers)
+{
+	for (GLsizei i = 0; i < n; i++)
+	{
+		bufferSizes.erase(buffers[i]);
+		bufferMemory.erase(buffers[i]);
+	}
+}
+
+static void APIENTRY NullBufferData(GLenum target, GLsizeiptr size, const void* data, GLenum /*usage*/)
+{
+	RecordBufferAllocation(boundBuffers[target], size, data);
+}
+
+static void APIENTRY NullBufferStorage(GLenum target, GLsizeiptr size, const void* data, GLbitfield /*flags*/)
+{
+	RecordBufferAllocation(boundBuffers[target], size, data);
+}
+
+static void APIENTRY NullNamedBufferData(GLuint buffer, GLsizeiptr size, const void* data, GLenum /*usage*/)
+{
+	RecordBufferAllocation(buffer, size, data);
+}
+
+static void APIENTRY NullNamedBufferStorage(GLuint buffer, GLsizeiptr size, const void* data, GLbitfield /*flags*/)
+{
+	RecordBufferAllocation(buffer, size, data);
+}
+
+static void APIENTRY NullBufferSubData(GLenum /*target*/, GLintptr /*offset*/, GLsizeiptr size, const void* /*data*/)
+{
+	RecordBufferUpload(size);
+}
+
+static void APIENTRY NullNamedBufferSubData(GLuint /*buffer*/, GLintptr /*offset*/, GLsizeiptr size, const void* /*data*/)
+{
+	RecordBufferUpload(size);
+}
+
+static void* APIENTRY NullMapBuffer(GLenum target, GLenum /*access*/)
+{
+	GLuint buffer = boundBuffers[target];
+	return MapBuffer(buffer, 0, bufferSizes[buffer]);
+}
+
+static void* APIENTRY NullMapBufferRange(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield /*access*/)
+{
+	return MapBuffer(boundBuffers[target], offset, length);
+}
+
+static void* APIENTRY NullMapNamedBufferRange(GLuint buffer, GLintptr offset, GLsizeiptr length, GLbitfield /*access*/)
+{
+	return MapBuffer(buffer, offset, length);
+}
+
+static GLboolean APIENTRY NullUnmapBuffer(GLenum /*target*/)
+{
+	return GL_TRUE;
+}
+
+static GLboolean APIENTRY NullUnmapNamedBuffer(GLuint /*buffer*/)
+{
+	return GL_TRUE;
+}
+
+// Sync objects, nothing is ever in flight so every fence is already signaled
+
+static GLsync APIENTRY NullFenceSync(GLenum /*condition*/, GLbitfield /*flags*/)
+{
+	return (GLsync)(uintptr_t)GenerateName();
+}
+
+static GLenum APIENTRY NullClientWaitSync(GLsync /*sync*/, GLbitfield /*flags*/, GLuint64 /*timeout*/)
+{
+	return GL_ALREADY_SIGNALED;
+}
+
+// Textures
+
+static void APIENTRY NullTexImage2D(GLenum /*target*/, GLint /*level*/, GLint internalformat, GLsizei width, GLsizei height, GLint /*border*/, GLenum format, GLenum type, const void* pixels)
+{
+	RecordTextureAllocation((GLenum)internalformat, width, height, 1);
+	if (pixels) RecordTextureUpload(width, height, 1, format, type);
+}
+
+static void APIENTRY NullTexImage3D(GLenum /*target*/, GLint /*level*/, GLint internalformat, GLsizei width, GLsizei height, GLsizei depth, GLint /*border*/, GLenum format, GLenum type, const void* pixels)
+{
+	RecordTextureAllocation((GLenum)internalformat, width, height, depth);
+	if (pixels) RecordTextureUpload(width, height, depth, format, type);
+}
+
+static void APIENTRY NullTexStorage2D(GLenum /*target*/, GLsizei /*levels*/, GLenum internalformat, GLsizei width, GLsizei height)
+{
+	RecordTextureAllocation(internalformat, width, height, 1);
+}
+
+static void APIENTRY NullTexStorage3D(GLenum /*target*/, GLsizei /*levels*/, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth)
+{
+	RecordTextureAllocation(internalformat, width, height, depth);
+}
+
+static void APIENTRY NullTextureStorage2D(GLuint /*texture*/, GLsizei /*levels*/, GLenum internalformat, GLsizei width, GLsizei height)
+{
+	RecordTextureAllocation(internalformat, width, height, 1);
+}
+
+static void APIENTRY NullTextureStorage3D(GLuint /*texture*/, GLsizei /*levels*/, GLenum internalformat, GLsizei width, GLsizei height, GLsizei depth)
+{
+	RecordTextureAllocation(internalformat, width, height, depth);
+}
+
+static void APIENTRY NullTexSubImage2D(GLenum /*target*/, GLint /*level*/, GLint /*xoffset*/, GLint /*yoffset*/, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* /*pixels*/)
+{
+	RecordTextureUpload(width, height, 1, format, type);
+}
+
+static void APIENTRY NullTexSubImage3D(GLenum /*target*/, GLint /*level*/, GLint /*xoffset*/, GLint /*yoffset*/, GLint /*zoffset*/, GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* /*pixels*/)
+{
+	RecordTextureUpload(width, height, depth, format, type);
+}
+
+static void APIENTRY NullTextureSubImage2D(GLuint /*texture*/, GLint /*level*/, GLint /*xoffset*/, GLint /*yoffset*/, GLsizei width, GLsizei height, GLenum format, GLenum type, const void* /*pixels*/)
+{
+	RecordTextureUpload(width, height, 1, format, type);
+}
+
+// Draws & dispatches
+
+static void APIENTRY NullDrawArrays(GLenum /*mode*/, GLint /*first*/, GLsizei count)
+{
+	frameStats.drawCalls++;
+	frameStats.vertices += count;
+}
+
+static void APIENTRY NullDrawArraysInstanced(GLenum /*mode*/, GLint /*first*/, GLsizei count, GLsizei instancecount)
+{
+	frameStats.drawCalls++;
+	frameStats.vertices += (uint64_t)count * instancecount;
+}
+
+static void APIENTRY NullDrawElements(GLenum /*mode*/, GLsizei count, GLenum /*type*/, const void* /*indices*/)
+{
+	frameStats.drawCalls++;
+	frameStats.vertices += count;
+}
+
+static void APIENTRY NullDrawElementsBaseVertex(GLenum /*mode*/, GLsizei count, GLenum /*type*/, const void* /*indices*/, GLint /*basevertex*/)
+{
+	frameStats.drawCalls++;
+	frameStats.vertices += count;
+}
+
+static void APIENTRY NullDrawElementsInstanced(GLenum /*mode*/, GLsizei count, GLenum /*type*/, const void* /*indices*/, GLsizei instancecount)
+{
+	frameStats.drawCalls++;
+	frameStats.vertices += (uint64_t)count * instancecount;
+}
+
+static void APIENTRY NullDrawElementsInstancedBaseVertex(GLenum /*mode*/, GLsizei count, GLenum /*type*/, const void* /*indices*/, GLsizei instancecount, GLint /*basevertex*/)
+{
+	frameStats.drawCalls++;
+	frameStats.vertices += (uint64_t)count * instancecount;
+}
+
+static void APIENTRY NullMultiDrawArraysIndirect(GLenum /*mode*/, const void* /*indirect*/, GLsizei drawcount, GLsizei /*stride*/)
+{
+	frameStats.drawCalls += drawcount; // The vertex counts live in a GPU buffer we never read
+}
+
+static void APIENTRY NullMultiDrawElementsIndirect(GLenum /*mode*/, GLenum /*type*/, const void* /*indirect*/, GLsizei drawcount, GLsizei /*stride*/)
+{
+	frameStats.drawCalls += drawcount;
+}
+
+static void APIENTRY NullDispatchCompute(GLuint /*num_groups_x*/, GLuint /*num_groups_y*/, GLuint /*num_groups_z*/)
+{
+	frameStats.dispatches++;
+}
+
+static void APIENTRY NullDispatchComputeIndirect(GLintptr /*indirect*/)
+{
+	frameStats.dispatches++;
+}
+
+// Every function without a stub of its own ends up here. A single signature for all of them is only safe because the caller cleans up the stack on x64,
+// which is why Load() refuses to run in 32 bit builds where GL functions are __stdcall. Returning 0 covers the handful of unstubbed functions that return a value
+static intptr_t APIENTRY NullNoOp()
+{
+	frameStats.otherCalls++;
+	return 0;
+}
+
+#define NULL_STUB(name, type, stub) { #name, (void*)(type)stub }
+
+static const std::unordered_map<std::string, void*> stubs = {
+	NULL_STUB(glGetString, PFNGLGETSTRINGPROC, NullGetString),
+	NULL_STUB(glGetStringi, PFNGLGETSTRINGIPROC, NullGetStringi),
+	NULL_STUB(glGetIntegerv, PFNGLGETINTEGERVPROC, NullGetIntegerv),
+	NULL_STUB(glGetFloatv, PFNGLGETFLOATVPROC, NullGetFloatv),
+	NULL_STUB(glGetBooleanv, PFNGLGETBOOLEANVPROC, NullGetBooleanv),
+	NULL_STUB(glGetError, PFNGLGETERRORPROC, NullGetError),
+	NULL_STUB(glCheckFramebufferStatus, PFNGLCHECKFRAMEBUFFERSTATUSPROC, NullCheckFramebufferStatus),
+
+	NULL_STUB(glGenBuffers, PFNGLGENBUFFERSPROC, NullGenNames),
+	NULL_STUB(glCreateBuffers, PFNGLCREATEBUFFERSPROC, NullGenNames),
+	NULL_STUB(glGenVertexArrays, PFNGLGENVERTEXARRAYSPROC, NullGenNames),
+	NULL_STUB(glCreateVertexArrays, PFNGLCREATEVERTEXARRAYSPROC, NullGenNames),
+	NULL_STUB(glGenTextures, PFNGLGENTEXTURESPROC, NullGenNames),
+	NULL_STUB(glGenFramebuffers, PFNGLGENFRAMEBUFFERSPROC, NullGenNames),
+	NULL_STUB(glCreateFramebuffers, PFNGLCREATEFRAMEBUFFERSPROC, NullGenNames),
+	NULL_STUB(glGenRenderbuffers, PFNGLGENRENDERBUFFERSPROC, NullGenNames),
+	NULL_STUB(glGenSamplers, PFNGLGENSAMPLERSPROC, NullGenNames),
+	NULL_STUB(glGenQueries, PFNGLGENQUERIESPROC, NullGenNames),
+	NULL_STUB(glCreateShader, PFNGLCREATESHADERPROC, NullCreateShader),
+	NULL_STUB(glCreateProgram, PFNGLCREATEPROGRAMPROC, NullCreateProgram),
+	NULL_STUB(glGetShaderiv, PFNGLGETSHADERIVPROC, NullGetShaderOrProgramiv),
+	NULL_STUB(glGetProgramiv, PFNGLGETPROGRAMIVPROC, NullGetShaderOrProgramiv),
+	NULL_STUB(glGetUniformLocation, PFNGLGETUNIFORMLOCATIONPROC, NullGetUniformLocation),
+	NULL_STUB(glGetAttribLocation, PFNGLGETATTRIBLOCATIONPROC, NullGetAttribLocation),
+
+	NULL_STUB(glBindBuffer, PFNGLBINDBUFFERPROC, NullBindBuffer),
+	NULL_STUB(glBindBufferBase, PFNGLBINDBUFFERBASEPROC, NullBindBufferBase),
+	NULL_STUB(glBindBufferRange, PFNGLBINDBUFFERRANGEPROC, NullBindBufferRange),
+	NULL_STUB(glDeleteBuffers, PFNGLDELETEBUFFERSPROC, NullDeleteBuffers),
+	NULL_STUB(glBufferData, PFNGLBUFFERDATAPROC, NullBufferData),
+	NULL_STUB(glBufferStorage, PFNGLBUFFERSTORAGEPROC, NullBufferStorage),
+	NULL_STUB(glNamedBufferData, PFNGLNAMEDBUFFERDATAPROC, NullNamedBufferData),
+	NULL_STUB(glNamedBufferStorage, PFNGLNAMEDBUFFERSTORAGEPROC, NullNamedBufferStorage),
+	NULL_STUB(glBufferSubData, PFNGLBUFFERSUBDATAPROC, NullBufferSubData),
+	NULL_STUB(glNamedBufferSubData, PFNGLNAMEDBUFFERSUBDATAPROC, NullNamedBufferSubData),
+	NULL_STUB(glMapBuffer, PFNGLMAPBUFFERPROC, NullMapBuffer),
+	NULL_STUB(glMapBufferRange, PFNGLMAPBUFFERRANGEPROC, NullMapBufferRange),
+	NULL_STUB(glMapNamedBufferRange, PFNGLMAPNAMEDBUFFERRANGEPROC, NullMapNamedBufferRange),
+	NULL_STUB(glUnmapBuffer, PFNGLUNMAPBUFFERPROC, NullUnmapBuffer),
+	NULL_STUB(glUnmapNamedBuffer, PFNGLUNMAPNAMEDBUFFERPROC, NullUnmapNamedBuffer),
+
+	NULL_STUB(glFenceSync, PFNGLFENCESYNCPROC, NullFenceSync),
+	NULL_STUB(glClientWaitSync, PFNGLCLIENTWAITSYNCPROC, NullClientWaitSync),
+
+	NULL_STUB(glTexImage2D, PFNGLTEXIMAGE2DPROC, NullTexImage2D),
+	NULL_STUB(glTexImage3D, PFNGLTEXIMAGE3DPROC, NullTexImage3D),
+	NULL_STUB(glTexStorage2D, PFNGLTEXSTORAGE2DPROC, NullTexStorage2D),
+	NULL_STUB(glTexStorage3D, PFNGLTEXSTORAGE3DPROC, NullTexStorage3D),
+	NULL_STUB(glTextureStorage2D, PFNGLTEXTURESTORAGE2DPROC, NullTextureStorage2D),
+	NULL_STUB(glTextureStorage3D, PFNGLTEXTURESTORAGE3DPROC, NullTextureStorage3D),
+	NULL_STUB(glTexSubImage2D, PFNGLTEXSUBIMAGE2DPROC, NullTexSubImage2D),
+	NULL_STUB(glTexSubImage3D, PFNGLTEXSUBIMAGE3DPROC, NullTexSubImage3D),
+	NULL_STUB(glTextureSubImage2D, PFNGLTEXTURESUBIMAGE2DPROC, NullTextureSubImage2D),
+
+	NULL_STUB(glDrawArrays, PFNGLDRAWARRAYSPROC, NullDrawArrays),
+	NULL_STUB(glDrawArraysInstanced, PFNGLDRAWARRAYSINSTANCEDPROC, NullDrawArraysInstanced),
+	NULL_STUB(glDrawElements, PFNGLDRAWELEMENTSPROC, NullDrawElements),
+	NULL_STUB(glDrawElementsBaseVertex, PFNGLDRAWELEMENTSBASEVERTEXPROC, NullDrawElementsBaseVertex),
+	NULL_STUB(glDrawElementsInstanced, PFNGLDRAWELEMENTSINSTANCEDPROC, NullDrawElementsInstanced),
+	NULL_STUB(glDrawElementsInstancedBaseVertex, PFNGLDRAWELEMENTSINSTANCEDBASEVERTEXPROC, NullDrawElementsInstancedBaseVertex),
+	NULL_STUB(glMultiDrawArraysIndirect, PFNGLMULTIDRAWARRAYSINDIRECTPROC, NullMultiDrawArraysIndirect),
+	NULL_STUB(glMultiDrawElementsIndirect, PFNGLMULTIDRAWELEMENTSINDIRECTPROC, NullMultiDrawElementsIndirect),
+	NULL_STUB(glDispatchCompute, PFNGLDISPATCHCOMPUTEPROC, NullDispatchCompute),
+	NULL_STUB(glDispatchComputeIndirect, PFNGLDISPATCHCOMPUTEINDIRECTPROC, NullDispatchComputeIndirect)
+};
+
+#undef NULL_STUB
+
+void* NullRenderDevice::GetProcAddress(const char* name)
+{
+	std::unordered_map<std::string, void*>::const_iterator it = stubs.find(name);
+	if (it != stubs.end()) return it->second;
+
+	return (void*)NullNoOp;
+}
+
+bool NullRenderDevice::Load()
+{
+#if defined(_WIN32) && !defined(_WIN64)
+	std::cout << "The null render device needs a 64 bit build!" << std::endl;
+	return false;
+#else
+	if (!gladLoadGLLoader((GLADloadproc)NullRenderDevice::GetProcAddress))
+	{
+		std::cout << "Failed to load the null render device!" << std::endl;
+		return false;
+	}
+
+	active = true;
+	return true;
+#endif
+}
+
+static void AddStats(NullRenderDeviceStats& total, const NullRenderDeviceStats& frame)
+{
+	total.drawCalls += frame.drawCalls;
+	total.vertices += frame.vertices;
+	total.dispatches += frame.dispatches;
+	total.bufferUploads += frame.bufferUploads;
+	total.bufferBytesAllocated += frame.bufferBytesAllocated;
+	total.bufferBytesUploaded += frame.bufferBytesUploaded;
+	total.textureUploads += frame.textureUploads;
+	total.textureBytesAllocated += frame.textureBytesAllocated;
+	total.textureBytesUploaded += frame.textureBytesUploaded;
+	total.objectsCreated += frame.objectsCreated;
+	total.otherCalls += frame.otherCalls;
+}
+
+void NullRenderDevice::EndFrame()
+{
+	Profiler::SetCounter("Null Draw Calls", frameStats.drawCalls);
+	Profiler::SetCounter("Null Vertices", (unsigned int)frameStats.vertices);
+	Profiler::SetCounter("Null Dispatches", frameStats.dispatches);
+	Profiler::SetCounter("Null Buffer Uploads", frameStats.bufferUploads);
+	Profiler::SetCounter("Null Buffer KB Uploaded", (unsigned int)(frameStats.bufferBytesUploaded / 1024));
+	Profiler::SetCounter("Null Texture Uploads", frameStats.textureUploads);
+	Profiler::SetCounter("Null Texture KB Uploaded", (unsigned int)(frameStats.textureBytesUploaded / 1024));
+	Profiler::SetCounter("Null Objects Created", frameStats.objectsCreated);
+	Profiler::SetCounter("Null Other Calls", frameStats.otherCalls);
+
+	AddStats(totalStats, frameStats);
+	frameStats = {};
+	frameCount++;
+}
+
+const NullRenderDeviceStats& NullRenderDevice::GetFrameStats()
+{
+	return frameStats;
+}
+
+const NullRenderDeviceStats& NullRenderDevice::GetTotalStats()
+{
+	return totalStats;
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+
+// What the engine asked the GPU to do, the null device counts it instead of issuing it
+struct NullRenderDeviceStats
+{
+	unsigned int drawCalls;
+	uint64_t vertices; // Vertices or indices submitted, multiplied by the instance count
+	unsigned int dispatches;
+
+	unsigned int bufferUploads;
+	uint64_t bufferBytesAllocated;
+	uint64_t bufferBytesUploaded;
+
+	unsigned int textureUploads;
+	uint64_t textureBytesAllocated;
+	uint64_t textureBytesUploaded;
+
+	unsigned int objectsCreated; // Buffers, textures, vertex arrays, framebuffers, shaders...
+	unsigned int otherCalls; // State changes, binds, uniforms and everything else
+};
+
+// Stands in for the GL driver when the engine runs without a window (see GameEngine::InitializeHeadless).
+// It's handed to glad as the loader, so every GL function the renderer, the GL wrappers and the passes call ends up in a stub here.
+// Nothing reaches a GPU: queries return values that keep the wrappers happy (shaders compile, framebuffers are complete, buffers map to CPU memory)
+// and draws, dispatches & uploads are counted so a headless run still reports how much work each frame would have submitted
+class NullRenderDevice
+{
+public:
+	static bool Load(); // Loads glad with the null stubs instead of a real context
+	static bool IsActive() { return active; }
+
+	static void EndFrame(); // Sends this frame's counts to the profiler and adds them to the totals
+	static const NullRenderDeviceStats& GetFrameStats();
+	static const NullRenderDeviceStats& GetTotalStats();
+	static unsigned int GetFrameCount() { return frameCount; }
+
+private:
+	static void* GetProcAddress(const char* name);
+
+	static bool active;
+	static unsigned int frameCount;
+};
\ No newline at end of file
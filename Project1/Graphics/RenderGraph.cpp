@@ -0,0 +1,281 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <iostream>
+
+RenderGraph::RenderGraph()
+{
+
+}
+
+void RenderGraph::Clear()
+{
+	passes.clear();
+	resources.clear();
+	executionOrder.clear();
+	physicalTextures.clear();
+}
+
+RenderGraphResource RenderGraph::CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc)
+{
+	ResourceNode resource;
+	resource.name = name;
+	resource.desc = desc;
+	resource.imported = false;
+	resource.firstUse = RENDER_GRAPH_INVALID;
+	resource.lastUse = RENDER_GRAPH_INVALID;
+	resource.physicalIndex = RENDER_GRAPH_INVALID;
+	resources.push_back(resource);
+	return (RenderGraphResource)(resources.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportResource(const std::string& name)
+{
+	RenderGraphTextureDesc desc = {};
+	RenderGraphResource resource = CreateTexture(name, desc);
+	resources[resource].imported = true;
+	return resource;
+}
+
+RenderGraphPass RenderGraph::AddPass(const char* name, const std::function<void()>& execute)
+{
+	PassNode pass;
+	pass.name = name;
+	pass.execute = execute;
+	pass.sideEffect = false;
+	pass.culled = false;
+	passes.push_back(pass);
+	return (RenderGraphPass)(passes.size() - 1);
+}
+
+void RenderGraph::Read(RenderGraphPass pass, RenderGraphResource resource)
+{
+	passes[pass].reads.push_back(resource);
+}
+
+void RenderGraph::Write(RenderGraphPass pass, RenderGraphResource resource)
+{
+	passes[pass].writes.push_back(resource);
+}
+
+void RenderGraph::SetSideEffect(RenderGraphPass pass)
+{
+	passes[pass].sideEffect = true;
+}
+
+bool RenderGraph::Compile()
+{
+	executionOrder.clear();
+	physicalTextures.clear();
+
+	BuildDependencies();
+	CullPasses();
+	SortPasses();
+	if (!ComputeLifetimes()) return false;
+	AssignPhysicalTextures();
+
+	return true;
+}
+
+void RenderGraph::Execute() const
+{
+	for (RenderGraphPass pass : executionOrder)
+	{
+		ExecutePass(pass);
+	}
+}
+
+void RenderGraph::ExecutePass(RenderGraphPass pass) const
+{
+	if (passes[pass].execute) passes[pass].execute();
+}
+
+void RenderGraph::BuildDependencies()
+{
+	std::vector<RenderGraphPass> lastWriter(resources.size(), RENDER_GRAPH_INVALID);
+	std::vector<std::vector<RenderGraphPass>> readersSinceWrite(resources.size());
+
+	for (RenderGraphPass i = 0; i < passes.size(); i++)
+	{
+		PassNode& pass = passes[i];
+		pass.producers.clear();
+		pass.dependencies.clear();
+
+		// Read after write, the latest writer has to run first and is needed for this pass to do anything
+		for (RenderGraphResource resource : pass.reads)
+		{
+			RenderGraphPass writer = lastWriter[resource];
+			if (writer != RENDER_GRAPH_INVALID && writer != i)
+			{
+				pass.producers.push_back(writer);
+				pass.dependencies.push_back(writer);
+			}
+			readersSinceWrite[resource].push_back(i);
+		}
+
+		// Write after write & write after read only constrain the order, they don't keep the other pass alive
+		for (RenderGraphResource resource : pass.writes)
+		{
+			RenderGraphPass writer = lastWriter[resource];
+			if (writer != RENDER_GRAPH_INVALID && writer != i) pass.dependencies.push_back(writer);
+
+			for (RenderGraphPass reader : readersSinceWrite[resource])
+			{
+				if (reader != i) pass.dependencies.push_back(reader);
+			}
+
+			lastWriter[resource] = i;
+			readersSinceWrite[resource].clear();
+		}
+
+		std::sort(pass.dependencies.begin(), pass.dependencies.end());
+		pass.dependencies.erase(std::unique(pass.dependencies.begin(), pass.dependencies.end()), pass.dependencies.end());
+	}
+}
+
+void RenderGraph::CullPasses()
+{
+	// Start from the passes with side effects and walk back through whatever produced their inputs, anything we don't reach is dead
+	std::vector<RenderGraphPass> stack;
+	for (RenderGraphPass i = 0; i < passes.size(); i++)
+	{
+		passes[i].culled = !passes[i].sideEffect;
+		if (passes[i].sideEffect) stack.push_back(i);
+	}
+
+	while (!stack.empty())
+	{
+		RenderGraphPass pass = stack.back();
+		stack.pop_back();
+
+		for (RenderGraphPass producer : passes[pass].producers)
+		{
+			if (!passes[producer].culled) continue; // Already visited
+
+			passes[producer].culled = false;
+			stack.push_back(producer);
+		}
+	}
+}
+
+void RenderGraph::SortPasses()
+{
+	// Kahn's algorithm over the passes that survived culling. When several passes are ready we take the one that was added first,
+	// so independent passes keep the order they were declared in and don't end up running with GL state they didn't expect
+	std::vector<unsigned int> remainingDependencies(passes.size(), 0);
+	std::vector<std::vector<RenderGraphPass>> dependents(passes.size());
+	for (RenderGraphPass i = 0; i < passes.size(); i++)
+	{
+		if (passes[i].culled) continue;
+
+		for (RenderGraphPass dependency : passes[i].dependencies)
+		{
+			if (passes[dependency].culled) continue;
+
+			remainingDependencies[i]++;
+			dependents[dependency].push_back(i);
+		}
+	}
+
+	std::vector<RenderGraphPass> ready;
+	for (RenderGraphPass i = 0; i < passes.size(); i++)
+	{
+		if (!passes[i].culled && remainingDependencies[i] == 0) ready.push_back(i);
+	}
+
+	while (!ready.empty())
+	{
+		std::vector<RenderGraphPass>::iterator first = std::min_element(ready.begin(), ready.end());
+		RenderGraphPass pass = *first;
+		ready.erase(first);
+
+		executionOrder.push_back(pass);
+
+		for (RenderGraphPass dependent : dependents[pass])
+		{
+			remainingDependencies[dependent]--;
+			if (remainingDependencies[dependent] == 0) ready.push_back(dependent);
+		}
+	}
+}
+
+bool RenderGraph::ComputeLifetimes()
+{
+	for (ResourceNode& resource : resources)
+	{
+		resource.firstUse = RENDER_GRAPH_INVALID;
+		resource.lastUse = RENDER_GRAPH_INVALID;
+		resource.physicalIndex = RENDER_GRAPH_INVALID;
+	}
+
+	std::vector<bool> written(resources.size(), false);
+	for (unsigned int order = 0; order < executionOrder.size(); order++)
+	{
+		const PassNode& pass = passes[executionOrder[order]];
+
+		for (RenderGraphResource resource : pass.reads)
+		{
+			if (!resources[resource].imported && !written[resource])
+			{
+				std::cout << "Render graph pass " << pass.name << " reads " << resources[resource].name << " before anything wrote to it!" << std::endl;
+				return false;
+			}
+		}
+
+		for (RenderGraphResource resource : pass.writes)
+		{
+			written[resource] = true;
+		}
+
+		for (int access = 0; access < 2; access++)
+		{
+			const std::vector<RenderGraphResource>& used = access == 0 ? pass.reads : pass.writes;
+			for (RenderGraphResource resource : used)
+			{
+				ResourceNode& node = resources[resource];
+				if (node.firstUse == RENDER_GRAPH_INVALID) node.firstUse = order;
+				node.lastUse = order;
+			}
+		}
+	}
+
+	return true;
+}
+
+void RenderGraph::AssignPhysicalTextures()
+{
+	std::vector<RenderGraphResource> transients;
+	for (RenderGraphResource i = 0; i < resources.size(); i++)
+	{
+		if (!resources[i].imported && resources[i].firstUse != RENDER_GRAPH_INVALID) transients.push_back(i);
+	}
+
+	std::stable_sort(transients.begin(), transients.end(), [this](RenderGraphResource a, RenderGraphResource b) { return resources[a].firstUse < resources[b].firstUse; });
+
+	// Greedy interval packing: reuse the first physical texture with a matching description that is free again by the time this resource is first used
+	std::vector<unsigned int> physicalLastUse;
+	for (RenderGraphResource resource : transients)
+	{
+		ResourceNode& node = resources[resource];
+
+		unsigned int physicalIndex = RENDER_GRAPH_INVALID;
+		for (unsigned int i = 0; i < physicalTextures.size(); i++)
+		{
+			if (physicalTextures[i] == node.desc && physicalLastUse[i] < node.firstUse)
+			{
+				physicalIndex = i;
+				break;
+			}
+		}
+
+		if (physicalIndex == RENDER_GRAPH_INVALID)
+		{
+			physicalIndex = (unsigned int)physicalTextures.size();
+			physicalTextures.push_back(node.desc);
+			physicalLastUse.push_back(node.lastUse);
+		}
+
+		physicalLastUse[physicalIndex] = node.lastUse;
+		node.physicalIndex = physicalIndex;
+	}
+}
\ No newline at end of file
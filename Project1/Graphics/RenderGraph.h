@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+typedef unsigned int RenderGraphResource;
+typedef unsigned int RenderGraphPass;
+
+static const unsigned int RENDER_GRAPH_INVALID = 0xFFFFFFFF;
+
+// Describes a transient texture, two transient textures can only share memory if their descriptions match
+struct RenderGraphTextureDesc
+{
+	uint32_t width;
+	uint32_t height;
+	uint32_t internalFormat; // GL enums are kept as plain integers so the graph compiler doesn't depend on GL
+	uint32_t format;
+	uint32_t dataType;
+	bool repeat; // Repeat wrapping, otherwise there is no wrapping
+
+	bool operator==(const RenderGraphTextureDesc& other) const
+	{
+		return width == other.width && height == other.height && internalFormat == other.internalFormat && format == other.format && dataType == other.dataType && repeat == other.repeat;
+	}
+};
+
+// Passes declare the resources they read & write, Compile() then culls every pass whose output is never used, orders the rest so
+// every write happens before the reads that depend on it, and works out how long each transient texture lives so textures whose lifetimes don't overlap can be backed by the same physical texture.
+// Compiling is CPU only, the renderer is responsible for creating the physical textures (see RenderGraphTexturePool) and running the passes.
+class RenderGraph
+{
+public:
+	RenderGraph();
+
+	void Clear(); // Removes every pass & resource, the graph is rebuilt every frame
+
+	RenderGraphResource CreateTexture(const std::string& name, const RenderGraphTextureDesc& desc); // Transient, only exists while the graph needs it
+	RenderGraphResource ImportResource(const std::string& name); // Owned outside of the graph (e.g. the GBuffer or the default framebuffer), never aliased
+
+	RenderGraphPass AddPass(const char* name, const std::function<void()>& execute); // The name is also the pass's profiler zone, use a string literal
+	void Read(RenderGraphPass pass, RenderGraphResource resource);
+	void Write(RenderGraphPass pass, RenderGraphResource resource);
+	void SetSideEffect(RenderGraphPass pass); // The pass does something visible (e.g. draws to the screen), it's never culled
+
+	// Hazards are resolved in the order passes were added: a read sees the last write added before it, and a write waits for earlier reads & writes of the same resource.
+	// Returns false if a pass reads a transient texture that nothing writes
+	bool Compile();
+	void Execute() const; // Runs the passes that survived compiling, in order
+	void ExecutePass(RenderGraphPass pass) const;
+
+	const std::vector<RenderGraphPass>& GetExecutionOrder() const { return executionOrder; }
+	bool IsPassCulled(RenderGraphPass pass) const { return passes[pass].culled; }
+	const char* GetPassName(RenderGraphPass pass) const { return passes[pass].name; }
+	unsigned int GetPassCount() const { return (unsigned int)passes.size(); }
+
+	const std::string& GetResourceName(RenderGraphResource resource) const { return resources[resource].name; }
+	bool IsTransient(RenderGraphResource resource) const { return !resources[resource].imported; }
+	unsigned int GetFirstUse(RenderGraphResource resource) const { return resources[resource].firstUse; } // Index into the execution order, RENDER_GRAPH_INVALID if unused
+	unsigned int GetLastUse(RenderGraphResource resource) const { return resources[resource].lastUse; }
+	unsigned int GetPhysicalIndex(RenderGraphResource resource) const { return resources[resource].physicalIndex; } // RENDER_GRAPH_INVALID for imported or unused resources
+
+	unsigned int GetPhysicalTextureCount() const { return (unsigned int)physicalTextures.size(); }
+	const RenderGraphTextureDesc& GetPhysicalTextureDesc(unsigned int physicalIndex) const { return physicalTextures[physicalIndex]; }
+
+private:
+	struct PassNode
+	{
+		const char* name;
+		std::function<void()> execute;
+		std::vector<RenderGraphResource> reads;
+		std::vector<RenderGraphResource> writes;
+		std::vector<RenderGraphPass> producers; // Passes that wrote what this pass reads, these are what keep a pass alive
+		std::vector<RenderGraphPass> dependencies; // Everything that has to run before this pass (producers + write/write & read/write hazards)
+		bool sideEffect;
+		bool culled;
+	};
+
+	struct ResourceNode
+	{
+		std::string name;
+		RenderGraphTextureDesc desc;
+		bool imported;
+		unsigned int firstUse;
+		unsigned int lastUse;
+		unsigned int physicalIndex;
+	};
+
+	void BuildDependencies();
+	void CullPasses();
+	void SortPasses();
+	bool ComputeLifetimes();
+	void AssignPhysicalTextures();
+
+	std::vector<PassNode> passes;
+	std::vector<ResourceNode> resources;
+
+	std::vector<RenderGraphPass> executionOrder;
+	std::vector<RenderGraphTextureDesc> physicalTextures;
+};
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "RenderGraphTexturePool.h"
+#include "TextureManager.h"
+
+constexpr unsigned int maxUnusedFrames = 3;
+
+RenderGraphTexturePool::RenderGraphTexturePool()
+{
+
+}
+
+RenderGraphTexturePool::~RenderGraphTexturePool()
+{
+	for (PoolEntry& entry : entries)
+	{
+		TextureManager::DeleteTexture(entry.texture);
+	}
+}
+
+void RenderGraphTexturePool::Realize(const RenderGraph& graph)
+{
+	for (PoolEntry& entry : entries)
+	{
+		entry.claimed = false;
+	}
+
+	physicalTextures.resize(graph.GetPhysicalTextureCount());
+	for (unsigned int i = 0; i < graph.GetPhysicalTextureCount(); i++)
+	{
+		const RenderGraphTextureDesc& desc = graph.GetPhysicalTextureDesc(i);
+
+		PoolEntry* match = nullptr;
+		for (PoolEntry& entry : entries)
+		{
+			if (!entry.claimed && entry.desc == desc)
+			{
+				match = &entry;
+				break;
+			}
+		}
+
+		if (!match)
+		{
+			PoolEntry entry;
+			entry.desc = desc;
+			entry.texture = TextureManager::CreateTexture2D(desc.internalFormat, desc.format, desc.dataType, desc.width, desc.height, TextureFilterType::Linear, desc.repeat ? TextureWrapType::Repeat : TextureWrapType::None);
+			entries.push_back(entry);
+			match = &entries.back();
+		}
+
+		match->claimed = true;
+		match->unusedFrames = 0;
+		physicalTextures[i] = match->texture;
+	}
+
+	// Let go of textures nothing has asked for in a while (feature turned off, window resized...)
+	std::vector<PoolEntry>::iterator it = entries.begin();
+	while (it != entries.end())
+	{
+		if (!it->claimed && ++it->unusedFrames > maxUnusedFrames)
+		{
+			TextureManager::DeleteTexture(it->texture);
+			it = entries.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+}
+
+Texture2D* RenderGraphTexturePool::GetTexture(const RenderGraph& graph, RenderGraphResource resource) const
+{
+	unsigned int physicalIndex = graph.GetPhysicalIndex(resource);
+	if (physicalIndex == RENDER_GRAPH_INVALID || physicalIndex >= physicalTextures.size()) return nullptr;
+	return physicalTextures[physicalIndex];
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "RenderGraph.h"
+#include "Texture2D.h"
+
+#include <vector>
+
+// Backs the physical textures of a compiled RenderGraph with real GL textures. Textures are kept between frames and handed back out
+// to any physical texture with the same description, ones that haven't been needed for a few frames are deleted so features that get turned off don't keep their targets alive.
+class RenderGraphTexturePool
+{
+public:
+	RenderGraphTexturePool();
+	~RenderGraphTexturePool();
+
+	void Realize(const RenderGraph& graph); // Call after RenderGraph::Compile() and before RenderGraph::Execute()
+	Texture2D* GetTexture(const RenderGraph& graph, RenderGraphResource resource) const; // nullptr if the resource was culled
+
+	unsigned int GetTextureCount() const { return (unsigned int)entries.size(); }
+
+private:
+	struct PoolEntry
+	{
+		RenderGraphTextureDesc desc;
+		Texture2D* texture;
+		unsigned int unusedFrames;
+		bool claimed;
+	};
+
+	std::vector<PoolEntry> entries;
+	std::vector<Texture2D*> physicalTextures; // Indexed by the graph's physical index
+};
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "ShaderLibrary.h"
 #include "Animation.h"
 #include "Utils.h"
+#include "GLState.h"
 
 #include <iostream>
 #include <sstream>
@@ -62,16 +63,14 @@ CascadedShadowMapping::CascadedShadowMapping(const CascadedShadowMappingInfo& in
 	lightDepthBuffer->Unbind();
 
 	// Setup shader uniforms
-	depthMappingShader->InitializeUniform("uMatModel");
-	depthMappingShader->InitializeUniform("uShadowSoftness");
+	depthModelUniform = depthMappingShader->GetUniform("uMatModel");
+	depthShadowSoftnessUniform = depthMappingShader->GetUniform("uShadowSoftness");
 
 	// Setup animated shader uniforms
-	depthMappingAnimatedShader->InitializeUniform("uMatModel");
-	depthMappingAnimatedShader->InitializeUniform("uShadowSoftness");
-	for (unsigned int i = 0; i < Animation::MAX_BONES; i++)
-	{
-		depthMappingAnimatedShader->InitializeUniform("uBoneMatrices[" + std::to_string(i) + "]");
-	}
+	animatedDepthModelUniform = depthMappingAnimatedShader->GetUniform("uMatModel");
+	animatedDepthShadowSoftnessUniform = depthMappingAnimatedShader->GetUniform("uShadowSoftness");
+	animatedDepthBoneOffsetUniform = depthMappingAnimatedShader->GetUniform("uBoneOffset");
+	animatedDepthBoneCountUniform = depthMappingAnimatedShader->GetUniform("uBoneCount");
 }
 
 CascadedShadowMapping::~CascadedShadowMapping()
@@ -82,9 +81,9 @@ CascadedShadowMapping::~CascadedShadowMapping()
 
 void CascadedShadowMapping::DoPass(std::vector<RenderSubmission>& submissions, std::vector<RenderSubmission>& animatedSubmissions, const glm::vec3& lightDir, const glm::mat4& projection, const glm::mat4& view, PrimitiveShape& quad)
 {
-	glEnable(GL_DEPTH_TEST);
-	glEnable(GL_CULL_FACE);
-	glCullFace(GL_FRONT); // Fixes peter panning (shadow offsets)
+	GLState::Enable(GL_DEPTH_TEST);
+	GLState::Enable(GL_CULL_FACE);
+	GLState::CullFace(GL_FRONT); // Fixes peter panning (shadow offsets)
 
 	// Update the data in our light matrices UBO
 	lightMatricesUBO->Bind();
@@ -109,25 +108,35 @@ void CascadedShadowMapping::DoPass(std::vector<RenderSubmission>& submissions, s
 	{
 		RenderComponent* renderComponent = submission.renderComponent;
 
-		depthMappingShader->SetFloat("uShadowSoftness", submission.renderComponent->castingShadownSoftness);
+		depthMappingShader->SetFloat(depthShadowSoftnessUniform, submission.renderComponent->castingShadownSoftness);
 
-		renderComponent->Draw(depthMappingShader, submission.transform);
+		renderComponent->Draw(depthMappingShader, depthModelUniform, submission.transform, submission.lod);
+	}
+
+	// Whatever the SkinningPass already skinned draws like a static mesh, every cascade reads the same skinned vertices
+	for (RenderSubmission& submission : animatedSubmissions)
+	{
+		RenderComponent* renderComponent = submission.renderComponent;
+		if (!submission.skinnedVertexArray) continue;
+
+		depthMappingShader->SetFloat(depthShadowSoftnessUniform, submission.renderComponent->castingShadownSoftness);
+
+		renderComponent->Draw(depthMappingShader, depthModelUniform, submission.transform, submission.lod, submission.skinnedVertexArray, submission.skinnedVertexStart);
 	}
 
 	depthMappingAnimatedShader->Bind();
 	for (RenderSubmission& submission : animatedSubmissions)
 	{
 		RenderComponent* renderComponent = submission.renderComponent;
+		if (submission.skinnedVertexArray) continue; // Already drawn above
 
-		for (unsigned int i = 0; i < submission.boneMatricesLength; i++) // Pass bone matrices to shader
-		{
-			glm::mat4& matrix = submission.boneMatrices[i];
-			depthMappingAnimatedShader->SetMat4("uBoneMatrices[" + std::to_string(i) + "]", matrix);
-		}
+		// Bone matrices were already uploaded by Renderer, every cascade reads the same palette
+		depthMappingAnimatedShader->SetInt(animatedDepthBoneOffsetUniform, submission.boneOffset);
+		depthMappingAnimatedShader->SetInt(animatedDepthBoneCountUniform, submission.boneMatricesLength);
 
-		depthMappingShader->SetFloat("uShadowSoftness", submission.renderComponent->castingShadownSoftness);
+		depthMappingAnimatedShader->SetFloat(animatedDepthShadowSoftnessUniform, submission.renderComponent->castingShadownSoftness);
 
-		renderComponent->Draw(depthMappingAnimatedShader, submission.transform);
+		renderComponent->Draw(depthMappingAnimatedShader, animatedDepthModelUniform, submission.transform, submission.lod);
 	}
 
 	lightDepthBuffer->Unbind();
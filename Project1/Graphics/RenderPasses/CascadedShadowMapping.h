@@ -67,6 +67,13 @@ private:
 	Shader* depthMappingShader;
 	Shader* depthMappingAnimatedShader;
 
+	UniformHandle depthModelUniform;
+	UniformHandle depthShadowSoftnessUniform;
+	UniformHandle animatedDepthModelUniform;
+	UniformHandle animatedDepthShadowSoftnessUniform;
+	UniformHandle animatedDepthBoneOffsetUniform;
+	UniformHandle animatedDepthBoneCountUniform;
+
 	// Pulled from Renderer.h, Renderer will always outlast this class so it's okay to hold references to these objects
 	glm::mat4& cameraView;
 	const WindowSpecs* windowSpecs;
@@ -4,6 +4,7 @@
 #include "TextureManager.h"
 #include "Texture2D.h"
 #include "Utils.h"
+#include "GLState.h"
 
 #include "vendor/imgui/imgui.h"
 
@@ -27,12 +28,8 @@ CloudPass::CloudPass(float earthRadius, float innerRadius, float outerRadius, fl
 	cloudTexture(nullptr),
 	worleyTexture(nullptr),
 	weatherTexture(nullptr),
-	colorTexture(TextureManager::CreateTexture2D(GL_RGBA32F, GL_RGBA, GL_FLOAT, cloudResolution, cloudResolution, TextureFilterType::Linear, TextureWrapType::Repeat)),
-	bloomTexture(TextureManager::CreateTexture2D(GL_RGBA32F, GL_RGBA, GL_FLOAT, cloudResolution, cloudResolution, TextureFilterType::Linear, TextureWrapType::Repeat)),
 	postShader(ShaderLibrary::Load(CLOUD_POST_SHADER_KEY, "assets/shaders/cloudPost.glsl")),
 	postFramebuffer(new FrameBuffer()),
-	postDepthAttachment(TextureManager::CreateTexture2D(GL_DEPTH_COMPONENT32, GL_DEPTH_COMPONENT, GL_FLOAT, windowSpecs->width, windowSpecs->height, TextureFilterType::Linear, TextureWrapType::None, false)),
-	postColorAttachment(TextureManager::CreateTexture2D(GL_RGBA32F, GL_RGBA, GL_FLOAT, windowSpecs->width, windowSpecs->height, TextureFilterType::Linear, TextureWrapType::None)),
 	coverage(0.45f),
 	cloudSpeed(earthRadius / 1000.0f),
 	crispiness(40.0f),
@@ -55,54 +52,43 @@ CloudPass::CloudPass(float earthRadius, float innerRadius, float outerRadius, fl
 	weatherSeed(Utils::RandFloat(0.0f, 1000.0f), Utils::RandFloat(0.0f, 1000.0f), Utils::RandFloat(0.0f, 1000.0f)),
 	weatherPerlinFreq(0.8f)
 {
-	cloudShader->InitializeUniform("uCloudTexture");
-	cloudShader->InitializeUniform("uWorleyTexture");
-	cloudShader->InitializeUniform("uWeatherTexture");
-	cloudShader->InitializeUniform("uSkyTexture");
-	cloudShader->InitializeUniform("uResolution");
-	cloudShader->InitializeUniform("uInvProj");
-	cloudShader->InitializeUniform("uInvView");
-	cloudShader->InitializeUniform("uCameraPosition");
-	cloudShader->InitializeUniform("uLightDirection");
-	cloudShader->InitializeUniform("uLightColor");
-	cloudShader->InitializeUniform("uCrispiness");
-	cloudShader->InitializeUniform("uDensityFactor");
-	cloudShader->InitializeUniform("uCloudCoverageMult");
-	cloudShader->InitializeUniform("uDetail");
-	cloudShader->InitializeUniform("uAbsorptionToLight");
-	cloudShader->InitializeUniform("uCloudColorTop");
-	cloudShader->InitializeUniform("uCloudColorBottom");
-	cloudShader->InitializeUniform("uTime");
-	cloudShader->InitializeUniform("uCloudSpeed");
-	cloudShader->InitializeUniform("uWindDirection");
-	cloudShader->InitializeUniform("uNoiseKernel");
-	cloudShader->InitializeUniform("uBayerFilter");
-	cloudShader->InitializeUniform("uEarthRadius");
-	cloudShader->InitializeUniform("uSphereInnerRadius");
-	cloudShader->InitializeUniform("uSphereOuterRadius");
-	cloudShader->InitializeUniform("uCloudDarknessMult");
-	cloudShader->InitializeUniform("uCloudCutoffFactor");
-	cloudShader->InitializeUniform("uPositionBuffer");
-
-	weatherShader->InitializeUniform("uResolution");
-	weatherShader->InitializeUniform("uSeed");
-	weatherShader->InitializeUniform("uPerlinScale");
-	weatherShader->InitializeUniform("uPerlinFrequency");
-	weatherShader->InitializeUniform("uPerlinAmplitude");
-
-	postShader->InitializeUniform("uCloudsTexture");
-	postShader->InitializeUniform("uEmissionTexture");
-	postShader->InitializeUniform("uEnableGodRays");
-	postShader->InitializeUniform("uLightPosition");
-	postShader->InitializeUniform("uLightDotCameraDir");
-	postShader->InitializeUniform("uCloudResolution");
-	postShader->InitializeUniform("uRadialBlurParams");
-
-	// Setup post processing fbo
-	postFramebuffer->Bind();
-	postFramebuffer->AddColorAttachment2D("color", postColorAttachment, 0);
-	postFramebuffer->SetDepthAttachment(postDepthAttachment);
-	postFramebuffer->Unbind();
+	cloudUniforms.resolution = cloudShader->GetUniform("uResolution");
+	cloudUniforms.time = cloudShader->GetUniform("uTime");
+	cloudUniforms.invProj = cloudShader->GetUniform("uInvProj");
+	cloudUniforms.invView = cloudShader->GetUniform("uInvView");
+	cloudUniforms.cameraPosition = cloudShader->GetUniform("uCameraPosition");
+	cloudUniforms.lightDirection = cloudShader->GetUniform("uLightDirection");
+	cloudUniforms.lightColor = cloudShader->GetUniform("uLightColor");
+	cloudUniforms.cloudCoverageMult = cloudShader->GetUniform("uCloudCoverageMult");
+	cloudUniforms.cloudSpeed = cloudShader->GetUniform("uCloudSpeed");
+	cloudUniforms.crispiness = cloudShader->GetUniform("uCrispiness");
+	cloudUniforms.detail = cloudShader->GetUniform("uDetail");
+	cloudUniforms.absorptionToLight = cloudShader->GetUniform("uAbsorptionToLight");
+	cloudUniforms.densityFactor = cloudShader->GetUniform("uDensityFactor");
+	cloudUniforms.cloudDarknessMult = cloudShader->GetUniform("uCloudDarknessMult");
+	cloudUniforms.cloudCutoffFactor = cloudShader->GetUniform("uCloudCutoffFactor");
+	cloudUniforms.earthRadius = cloudShader->GetUniform("uEarthRadius");
+	cloudUniforms.sphereInnerRadius = cloudShader->GetUniform("uSphereInnerRadius");
+	cloudUniforms.sphereOuterRadius = cloudShader->GetUniform("uSphereOuterRadius");
+	cloudUniforms.cloudColorTop = cloudShader->GetUniform("uCloudColorTop");
+	cloudUniforms.cloudColorBottom = cloudShader->GetUniform("uCloudColorBottom");
+	cloudUniforms.cloudTexture = cloudShader->GetUniform("uCloudTexture");
+	cloudUniforms.worleyTexture = cloudShader->GetUniform("uWorleyTexture");
+	cloudUniforms.weatherTexture = cloudShader->GetUniform("uWeatherTexture");
+	cloudUniforms.skyTexture = cloudShader->GetUniform("uSkyTexture");
+	cloudUniforms.positionBuffer = cloudShader->GetUniform("uPositionBuffer");
+
+	weatherUniforms.resolution = weatherShader->GetUniform("uResolution");
+	weatherUniforms.seed = weatherShader->GetUniform("uSeed");
+	weatherUniforms.perlinFrequency = weatherShader->GetUniform("uPerlinFrequency");
+
+	postUniforms.cloudsTexture = postShader->GetUniform("uCloudsTexture");
+	postUniforms.emissionTexture = postShader->GetUniform("uEmissionTexture");
+	postUniforms.enableGodRays = postShader->GetUniform("uEnableGodRays");
+	postUniforms.lightPosition = postShader->GetUniform("uLightPosition");
+	postUniforms.lightDotCameraDir = postShader->GetUniform("uLightDotCameraDir");
+	postUniforms.cloudResolution = postShader->GetUniform("uCloudResolution");
+	postUniforms.radialBlurParams = postShader->GetUniform("uRadialBlurParams");
 
 	GenerateTextures(glm::ivec3(128, 128, 128), glm::ivec3(32, 32, 32), glm::ivec2(1024, 1024));
 }
@@ -112,7 +98,19 @@ CloudPass::~CloudPass()
 	delete postFramebuffer;
 }
 
-void CloudPass::DoPass(ITexture* skyTexture, ITexture* positionBuffer, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPos, const glm::vec3& lightDir, const glm::vec3& lightColor, const glm::vec3& cameraDir,
+RenderGraphTextureDesc CloudPass::GetCloudTargetDesc()
+{
+	RenderGraphTextureDesc desc = { cloudResolution, cloudResolution, GL_RGBA32F, GL_RGBA, GL_FLOAT, true };
+	return desc;
+}
+
+RenderGraphTextureDesc CloudPass::GetSkyTargetDesc(const WindowSpecs* windowSpecs)
+{
+	RenderGraphTextureDesc desc = { (uint32_t)windowSpecs->width, (uint32_t)windowSpecs->height, GL_RGBA32F, GL_RGBA, GL_FLOAT, false };
+	return desc;
+}
+
+void CloudPass::DoPass(ITexture* skyTexture, ITexture* positionBuffer, Texture2D* colorTarget, Texture2D* bloomTarget, Texture2D* skyTarget, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPos, const glm::vec3& lightDir, const glm::vec3& lightColor, const glm::vec3& cameraDir,
 	const WindowSpecs* windowSpecs, PrimitiveShape* quad)
 {
 	ImGui::Begin("Clouds");
@@ -141,82 +139,86 @@ void CloudPass::DoPass(ITexture* skyTexture, ITexture* positionBuffer, const glm
 	cloudShader->Bind();
 
 	// Bind textures for writing so the compute shader can write to them
-	glBindImageTexture(0, colorTexture->GetID(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
-	glBindImageTexture(1, bloomTexture->GetID(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+	glBindImageTexture(0, colorTarget->GetID(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
+	glBindImageTexture(1, bloomTarget->GetID(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
 
 	glm::vec3 lightPos = -lightDir * earthRadius;
 	glm::vec3 cameraToLightDir = glm::normalize(lightPos - cameraPos);
 	glm::vec2 cloudRes(cloudResolution, cloudResolution);
 
-	cloudShader->SetFloat2("uResolution", cloudRes);
-	cloudShader->SetFloat("uTime", glfwGetTime());
-	cloudShader->SetMat4("uInvProj", glm::inverse(projection));
-	cloudShader->SetMat4("uInvView", glm::inverse(view));
-	cloudShader->SetFloat3("uCameraPosition", cameraPos);
-	cloudShader->SetFloat3("uLightDirection", cameraToLightDir);
-	cloudShader->SetFloat3("uLightColor", lightColor);
-
-	cloudShader->SetFloat("uCloudCoverageMult", coverage);
-	cloudShader->SetFloat("uCloudSpeed", cloudSpeed);
-	cloudShader->SetFloat("uCrispiness", crispiness);
-	cloudShader->SetFloat("uDetail", detail);
-	cloudShader->SetFloat("uAbsorptionToLight", absorptionToLight * 0.01f);
-	cloudShader->SetFloat("uDensityFactor", density);
-	cloudShader->SetFloat("uCloudDarknessMult", cloudDarkness);
-	cloudShader->SetFloat("uCloudCutoffFactor", cloudCutoffFactor);
-
-	cloudShader->SetFloat("uEarthRadius", earthRadius);
-	cloudShader->SetFloat("uSphereInnerRadius", sphereInnerRadius);
-	cloudShader->SetFloat("uSphereOuterRadius", sphereOuterRadius);
-
-	cloudShader->SetFloat3("uCloudColorTop", cloudColorTop);
-	cloudShader->SetFloat3("uCloudColorBottom", cloudColorBottom);
+	cloudShader->SetFloat2(cloudUniforms.resolution, cloudRes);
+	cloudShader->SetFloat(cloudUniforms.time, glfwGetTime());
+	cloudShader->SetMat4(cloudUniforms.invProj, glm::inverse(projection));
+	cloudShader->SetMat4(cloudUniforms.invView, glm::inverse(view));
+	cloudShader->SetFloat3(cloudUniforms.cameraPosition, cameraPos);
+	cloudShader->SetFloat3(cloudUniforms.lightDirection, cameraToLightDir);
+	cloudShader->SetFloat3(cloudUniforms.lightColor, lightColor);
+
+	cloudShader->SetFloat(cloudUniforms.cloudCoverageMult, coverage);
+	cloudShader->SetFloat(cloudUniforms.cloudSpeed, cloudSpeed);
+	cloudShader->SetFloat(cloudUniforms.crispiness, crispiness);
+	cloudShader->SetFloat(cloudUniforms.detail, detail);
+	cloudShader->SetFloat(cloudUniforms.absorptionToLight, absorptionToLight * 0.01f);
+	cloudShader->SetFloat(cloudUniforms.densityFactor, density);
+	cloudShader->SetFloat(cloudUniforms.cloudDarknessMult, cloudDarkness);
+	cloudShader->SetFloat(cloudUniforms.cloudCutoffFactor, cloudCutoffFactor);
+
+	cloudShader->SetFloat(cloudUniforms.earthRadius, earthRadius);
+	cloudShader->SetFloat(cloudUniforms.sphereInnerRadius, sphereInnerRadius);
+	cloudShader->SetFloat(cloudUniforms.sphereOuterRadius, sphereOuterRadius);
+
+	cloudShader->SetFloat3(cloudUniforms.cloudColorTop, cloudColorTop);
+	cloudShader->SetFloat3(cloudUniforms.cloudColorBottom, cloudColorBottom);
 
 	cloudTexture->BindToSlot(0);
-	cloudShader->SetInt("uCloudTexture", 0);
+	cloudShader->SetInt(cloudUniforms.cloudTexture, 0);
 
 	worleyTexture->BindToSlot(1);
-	cloudShader->SetInt("uWorleyTexture", 1);
+	cloudShader->SetInt(cloudUniforms.worleyTexture, 1);
 
 	weatherTexture->BindToSlot(2);
-	cloudShader->SetInt("uWeatherTexture", 2);
+	cloudShader->SetInt(cloudUniforms.weatherTexture, 2);
 
 	skyTexture->BindToSlot(3);
-	cloudShader->SetInt("uSkyTexture", 3);
+	cloudShader->SetInt(cloudUniforms.skyTexture, 3);
 
 	positionBuffer->BindToSlot(4);
-	cloudShader->SetInt("uPositionBuffer", 4);
+	cloudShader->SetInt(cloudUniforms.positionBuffer, 4);
 
 	glDispatchCompute((int)ceil((float)cloudResolution / (float)cloudWorkGroupSize), (int)ceil((float)cloudResolution / (float)cloudWorkGroupSize), 1);
 	glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT); // Ensures that anything after this line will get the updated data from the compute shader
 
 	// Cloud post processing (helps make clouds less pixelated by using gaussian blur and godrays)
-	glDisable(GL_DEPTH_TEST);
-	glDisable(GL_CULL_FACE);
+	GLState::Disable(GL_DEPTH_TEST);
+	GLState::Disable(GL_CULL_FACE);
 
+	// The render graph's pool can delete a texture & hand out a new one at the same address (or GL name), so reattach every frame rather than compare.
+	// No depth attachment, the post pass is a single full screen quad with depth testing off
 	postFramebuffer->Bind();
+	postFramebuffer->AddColorAttachment2D("color", skyTarget, 0);
+
 	postShader->Bind();
 
-	colorTexture->BindToSlot(0);
-	postShader->SetInt("uCloudsTexture", 0);
+	colorTarget->BindToSlot(0);
+	postShader->SetInt(postUniforms.cloudsTexture, 0);
 
-	bloomTexture->BindToSlot(1);
-	postShader->SetInt("uEmissionTexture", 1);
+	bloomTarget->BindToSlot(1);
+	postShader->SetInt(postUniforms.emissionTexture, 1);
 
-	postShader->SetInt("uEnableGodRays", (GLboolean) enableGodRays);
+	postShader->SetInt(postUniforms.enableGodRays, (GLboolean) enableGodRays);
 	
 	// Convert light position to screen space
 	glm::mat4 lightMat = glm::translate(glm::mat4(1.0f), lightPos);
 	glm::vec4 lightScreenPos = (projection * view) * lightMat * glm::vec4(0.0f, 60.0f, 0.0f, 1.0f);
 	lightScreenPos /= lightScreenPos.w;
 	lightScreenPos = lightScreenPos * 0.5f + 0.5f;
-	postShader->SetFloat3("uLightPosition", glm::vec3(lightScreenPos));
+	postShader->SetFloat3(postUniforms.lightPosition, glm::vec3(lightScreenPos));
 
 	float lightDotCameraFront = glm::dot(cameraToLightDir, glm::normalize(cameraDir));
-	postShader->SetFloat("uLightDotCameraDir", lightDotCameraFront);
+	postShader->SetFloat(postUniforms.lightDotCameraDir, lightDotCameraFront);
 
-	postShader->SetFloat2("uCloudResolution", cloudRes);
-	postShader->SetFloat4("uRadialBlurParams", glm::vec4(godRayDecay, godRayDensity, godRayWeight, godRayExposure));
+	postShader->SetFloat2(postUniforms.cloudResolution, cloudRes);
+	postShader->SetFloat4(postUniforms.radialBlurParams, glm::vec4(godRayDecay, godRayDensity, godRayWeight, godRayExposure));
 
 	quad->Draw();
 
@@ -253,9 +255,9 @@ void CloudPass::GenerateTextures(const glm::ivec3& perlinWorleyDimensions, const
 	{
 		weatherTexture = TextureManager::CreateTexture2D(GL_RGBA32F, GL_RGBA, GL_FLOAT, weatherDimensions.x, weatherDimensions.y, TextureFilterType::Linear, TextureWrapType::Repeat, true);
 		weatherShader->Bind();
-		weatherShader->SetFloat2("uResolution", glm::vec2(weatherDimensions));
-		weatherShader->SetFloat3("uSeed", weatherSeed);
-		weatherShader->SetFloat("uPerlinFrequency", weatherPerlinFreq);
+		weatherShader->SetFloat2(weatherUniforms.resolution, glm::vec2(weatherDimensions));
+		weatherShader->SetFloat3(weatherUniforms.seed, weatherSeed);
+		weatherShader->SetFloat(weatherUniforms.perlinFrequency, weatherPerlinFreq);
 		glBindImageTexture(0, weatherTexture->GetID(), 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_RGBA32F);
 		glDispatchCompute((int)ceil((float)weatherDimensions.x / weatherGenWorkerSize), (int)ceil((float)weatherDimensions.y / weatherGenWorkerSize), 1);
 		glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT); // Ensures that anything after this line will get the update data from the compute shader
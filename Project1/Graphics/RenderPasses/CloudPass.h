@@ -7,6 +7,7 @@
 #include "PrimitiveShape.h"
 #include "Light.h"
 #include "ComputeShader.h"
+#include "RenderGraph.h"
 
 #include <glm/glm.hpp>
 
@@ -18,10 +19,12 @@ public:
 	CloudPass(float earthRadius, float innerRadius, float outerRadius, float cutoffFactor, const WindowSpecs* windowSpecs);
 	~CloudPass();
 
-	void DoPass(ITexture* skyTexture, ITexture* positionBuffer, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPos, const glm::vec3& lightDir, const glm::vec3& lightColor, const glm::vec3& cameraDir,
+	// The cloud targets and the sky output are transient render graph textures, see GetCloudTargetDesc() & GetSkyTargetDesc()
+	void DoPass(ITexture* skyTexture, ITexture* positionBuffer, Texture2D* colorTarget, Texture2D* bloomTarget, Texture2D* skyTarget, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPos, const glm::vec3& lightDir, const glm::vec3& lightColor, const glm::vec3& cameraDir,
 		const WindowSpecs* windowSpecs, PrimitiveShape* quad);
 
-	Texture2D* GetSkyTexture() { return postColorAttachment; }
+	static RenderGraphTextureDesc GetCloudTargetDesc(); // Raymarched clouds & their emission, written by the compute shader
+	static RenderGraphTextureDesc GetSkyTargetDesc(const WindowSpecs* windowSpecs); // Sky with post processed clouds composited on top
 
 	static const std::string CLOUD_SHADER_KEY;
 	static const std::string WEATHER_SHADER_KEY;
@@ -69,12 +72,54 @@ private:
 	ComputeShader* perlinWorleyShader;
 	ComputeShader* worleyShader;
 
-	// Written to by compute shader
-	Texture2D* colorTexture;
-	Texture2D* bloomTexture;
+	struct CloudUniforms
+	{
+		UniformHandle resolution;
+		UniformHandle time;
+		UniformHandle invProj;
+		UniformHandle invView;
+		UniformHandle cameraPosition;
+		UniformHandle lightDirection;
+		UniformHandle lightColor;
+		UniformHandle cloudCoverageMult;
+		UniformHandle cloudSpeed;
+		UniformHandle crispiness;
+		UniformHandle detail;
+		UniformHandle absorptionToLight;
+		UniformHandle densityFactor;
+		UniformHandle cloudDarknessMult;
+		UniformHandle cloudCutoffFactor;
+		UniformHandle earthRadius;
+		UniformHandle sphereInnerRadius;
+		UniformHandle sphereOuterRadius;
+		UniformHandle cloudColorTop;
+		UniformHandle cloudColorBottom;
+		UniformHandle cloudTexture;
+		UniformHandle worleyTexture;
+		UniformHandle weatherTexture;
+		UniformHandle skyTexture;
+		UniformHandle positionBuffer;
+	} cloudUniforms;
+
+	struct WeatherUniforms
+	{
+		UniformHandle resolution;
+		UniformHandle seed;
+		UniformHandle perlinFrequency;
+	} weatherUniforms;
 
 	Shader* postShader;
+
+	struct PostUniforms
+	{
+		UniformHandle cloudsTexture;
+		UniformHandle emissionTexture;
+		UniformHandle enableGodRays;
+		UniformHandle lightPosition;
+		UniformHandle lightDotCameraDir;
+		UniformHandle cloudResolution;
+		UniformHandle radialBlurParams;
+	} postUniforms;
+
 	IFrameBuffer* postFramebuffer;
-	Texture2D* postDepthAttachment;
-	Texture2D* postColorAttachment;
 };
\ No newline at end of file
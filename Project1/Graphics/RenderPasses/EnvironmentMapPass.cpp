@@ -5,6 +5,7 @@
 #include "ShaderLibrary.h"
 #include "RenderBuffer.h"
 #include "Renderer.h"
+#include "GLState.h"
 
 const std::string EnvironmentMapPass::CUBE_MAP_DRAW_SHADER_KEY = "drawEnvShader";
 
@@ -20,20 +21,20 @@ EnvironmentMapPass::EnvironmentMapPass(const WindowSpecs* windowSpecs)
 	environmentBuffer->Unbind();
 
 	// Setup shader uniforms
-	shader->InitializeUniform("uProjection");
-	shader->InitializeUniform("uView");
-	shader->InitializeUniform("uEnvMap1");
-	shader->InitializeUniform("uEnvMap2");
-	shader->InitializeUniform("uResolution");
-	shader->InitializeUniform("uLightDirection");
-	shader->InitializeUniform("uLightColor");
-	shader->InitializeUniform("uInvProj");
-	shader->InitializeUniform("uInvView");
-	shader->InitializeUniform("uMixFactors");
+	uniforms.envMap1 = shader->GetUniform("uEnvMap1");
+	uniforms.envMap2 = shader->GetUniform("uEnvMap2");
+	uniforms.projection = shader->GetUniform("uProjection");
+	uniforms.view = shader->GetUniform("uView");
+	uniforms.invProj = shader->GetUniform("uInvProj");
+	uniforms.invView = shader->GetUniform("uInvView");
+	uniforms.resolution = shader->GetUniform("uResolution");
+	uniforms.lightColor = shader->GetUniform("uLightColor");
+	uniforms.lightDirection = shader->GetUniform("uLightDirection");
+	uniforms.mixFactors = shader->GetUniform("uMixFactors");
 
 	shader->Bind();
-	shader->SetInt("uEnvMap1", 0);
-	shader->SetInt("uEnvMap2", 1);
+	shader->SetInt(uniforms.envMap1, 0);
+	shader->SetInt(uniforms.envMap2, 1);
 	shader->Unbind();
 }
 
@@ -44,46 +45,46 @@ EnvironmentMapPass::~EnvironmentMapPass()
 
 void EnvironmentMapPass::DoPass(CubeMap* cubeMap1, CubeMap* cubeMap2, const glm::vec4& mixFactors, const glm::mat4& projection, const glm::mat4& view, bool sun, const glm::vec3& cameraPos, const glm::vec3& lightDir, const glm::vec3& lightColor, PrimitiveShape* cube)
 {
-	glDisable(GL_CULL_FACE); // Make sure none of our cubes faces get culled
+	GLState::Disable(GL_CULL_FACE); // Make sure none of our cubes faces get culled
 
 	environmentBuffer->Bind();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	shader->Bind();
 
-	shader->SetMat4("uProjection", projection);
-	shader->SetMat4("uView", view);
-	shader->SetMat4("uInvProj", glm::inverse(projection));
-	shader->SetMat4("uInvView", glm::inverse(view));
+	shader->SetMat4(uniforms.projection, projection);
+	shader->SetMat4(uniforms.view, view);
+	shader->SetMat4(uniforms.invProj, glm::inverse(projection));
+	shader->SetMat4(uniforms.invView, glm::inverse(view));
 
-	shader->SetFloat2("uResolution", glm::vec2(envMapTexture->GetWidth(), envMapTexture->GetHeight()));
+	shader->SetFloat2(uniforms.resolution, glm::vec2(envMapTexture->GetWidth(), envMapTexture->GetHeight()));
 
 	if (sun)
 	{
 		glm::vec3 lightPos = -lightDir * 600000.0f;
-		shader->SetFloat3("uLightColor", lightColor);
-		shader->SetFloat4("uLightDirection", glm::vec4(glm::normalize(lightPos - cameraPos), 1.0f));
+		shader->SetFloat3(uniforms.lightColor, lightColor);
+		shader->SetFloat4(uniforms.lightDirection, glm::vec4(glm::normalize(lightPos - cameraPos), 1.0f));
 	}
 	else
 	{
-		shader->SetFloat4("uLightDirection", glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		shader->SetFloat4(uniforms.lightDirection, glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
 	}
 	
-	shader->SetFloat4("uMixFactors", mixFactors);
+	shader->SetFloat4(uniforms.mixFactors, mixFactors);
 
 	cubeMap1->BindToSlot(0);
-	shader->SetInt("uEnvMap1", 0);
+	shader->SetInt(uniforms.envMap1, 0);
 
 	if (cubeMap2)
 	{
 		cubeMap2->BindToSlot(1);
 	}
 
-	shader->SetInt("uEnvMap2", 1);
+	shader->SetInt(uniforms.envMap2, 1);
 
 	cube->Draw();
 
 	environmentBuffer->Unbind();
 
-	glEnable(GL_CULL_FACE); // Re-enable face culling
+	GLState::Enable(GL_CULL_FACE); // Re-enable face culling
 }
\ No newline at end of file
@@ -26,6 +26,21 @@ public:
 private:
 	IFrameBuffer* environmentBuffer;
 	Shader* shader;
+
+	struct ShaderUniforms
+	{
+		UniformHandle envMap1;
+		UniformHandle envMap2;
+		UniformHandle projection;
+		UniformHandle view;
+		UniformHandle invProj;
+		UniformHandle invView;
+		UniformHandle resolution;
+		UniformHandle lightColor;
+		UniformHandle lightDirection;
+		UniformHandle mixFactors;
+	} uniforms;
+
 	ITexture* envMapTexture;
 
 	const WindowSpecs* windowSpecs;
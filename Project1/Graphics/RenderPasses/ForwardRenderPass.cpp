@@ -1,65 +1,32 @@
 #include "ForwardRenderPass.h"
 #include "ShaderLibrary.h"
-#include "Light.h"
+#include "LightManager.h"
 #include "Renderer.h"
+#include "UniformBlocks.h"
+#include "GLState.h"
 
-#include <sstream>
-
-ForwardRenderPass::ForwardRenderPass(IFrameBuffer* geometryBuffer)
+ForwardRenderPass::ForwardRenderPass(IFrameBuffer* geometryBuffer, UniformRingBuffer* uniformRing)
 	: geometryBuffer(geometryBuffer),
-	shader(ShaderLibrary::Load(Renderer::FORWARD_SHADER_KEY, "assets/shaders/forward.glsl"))
+	shader(ShaderLibrary::Load(Renderer::FORWARD_SHADER_KEY, "assets/shaders/forward.glsl")),
+	uniformRing(uniformRing)
 {
-	// Setup shader uniforms
-	shader->InitializeUniform("uMatModel");
-	shader->InitializeUniform("uMatView");
-	shader->InitializeUniform("uMatProjection");
-	shader->InitializeUniform("uMatModelInverseTranspose");
-	shader->InitializeUniform("uColorOverride");
-	shader->InitializeUniform("uAlbedoTexture1");
-	shader->InitializeUniform("uAlbedoTexture2");
-	shader->InitializeUniform("uAlbedoTexture3");
-	shader->InitializeUniform("uAlbedoTexture4");
-	shader->InitializeUniform("uAlbedoRatios");
-	shader->InitializeUniform("uHasNormalTexture");
-	shader->InitializeUniform("uNormalTexture");
-	shader->InitializeUniform("uORMTexture");
-	shader->InitializeUniform("uMaterialOverrides");
-	shader->InitializeUniform("uAlphaTransparency");
-	shader->InitializeUniform("uIgnoreLighting");
-
-	shader->SetInt("uAlbedoTexture1", 0);
-	shader->SetInt("uAlbedoTexture2", 1);
-	shader->SetInt("uAlbedoTexture3", 2);
-	shader->SetInt("uAlbedoTexture4", 3);
-	shader->SetInt("uNormalTexture", 4);
-	//shader->SetInt("uRoughnessTexture", 5);
-	//shader->SetInt("uMetalnessTexture", 6);
-	//shader->SetInt("uAmbientOcculsionTexture", 7);
-	shader->InitializeUniform("uLightAmount");
-
-	for (int i = 0; i < Light::MAX_LIGHTS; i++)
+	// Setup shader uniforms. Lights are read from the buffers bound by LightManager
+	for (int i = 0; i < 4; i++)
 	{
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].position";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].direction";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].color";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].param1";
-			shader->InitializeUniform(ss.str());
-		}
+		albedoTextureUniforms[i] = shader->GetUniform("uAlbedoTexture" + std::to_string(i + 1));
 	}
+	normalTextureUniform = shader->GetUniform("uNormalTexture");
+	ormTextureUniform = shader->GetUniform("uORMTexture");
+	clusterParamsUniform = shader->GetUniform("uClusterParams");
+
+	shader->Bind();
+	for (int i = 0; i < 4; i++)
+	{
+		shader->SetInt(albedoTextureUniforms[i], i);
+	}
+	shader->SetInt(normalTextureUniform, 4);
+	shader->SetInt(ormTextureUniform, 5);
+	shader->Unbind();
 }
 
 ForwardRenderPass::~ForwardRenderPass()
@@ -69,6 +36,8 @@ ForwardRenderPass::~ForwardRenderPass()
 
 void ForwardRenderPass::DoPass(std::vector<RenderSubmission>& submissions, const glm::mat4& projection, const glm::mat4& view, const WindowSpecs* windowSpecs)
 {
+	GLState::InvalidateTextures(); // Other passes bind textures behind the cache's back
+
 	geometryBuffer->BindRead(); // Bind for read only
 	geometryBuffer->UnbindWrite();
 
@@ -76,75 +45,70 @@ void ForwardRenderPass::DoPass(std::vector<RenderSubmission>& submissions, const
 	glBlitFramebuffer(0, 0, windowSpecs->width, windowSpecs->height, 0, 0, windowSpecs->width, windowSpecs->height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
 	geometryBuffer->Unbind();
 
-	shader->Bind();
-
-	// Pass camera related data
-	shader->SetMat4("uMatView", view);
-	shader->SetMat4("uMatProjection", projection);
+	shader->Bind(); // Camera data comes from the per-frame block bound by Renderer
+	shader->SetFloat4(clusterParamsUniform, LightManager::GetClusterParams());
 
 	// Draw geometry
 	for (RenderSubmission& submission : submissions)
 	{
 		RenderComponent* renderComponent = submission.renderComponent;
 
-		//shader->SetMat4("uMatModel", submission->transform);
-		//shader->SetMat4("uMatModelInverseTranspose", glm::inverse(submission->transform));
+		DrawUniformData drawData;
+		drawData.model = submission.transform;
+		drawData.projViewModel = projection * view * submission.transform;
+		drawData.prevProjViewModel = drawData.projViewModel;
+		drawData.rrInfo = glm::vec4(0.0f);
+		drawData.uvOffset = renderComponent->uvOffset;
+		drawData.shadowSoftness = 0.0f;
+		drawData.boneOffset = 0;
+		drawData.boneCount = 0;
 
 		// Color
+		drawData.albedoRatios = glm::vec4(0.0f);
 		if (renderComponent->isColorOverride)
 		{
-			shader->SetFloat4("uColorOverride", glm::vec4(renderComponent->colorOverride.x, renderComponent->colorOverride.y, renderComponent->colorOverride.z, 1.0f));
+			drawData.colorOverride = glm::vec4(renderComponent->colorOverride.x, renderComponent->colorOverride.y, renderComponent->colorOverride.z, 1.0f);
 		}
 		else // Bind diffuse textures
 		{
-			shader->SetFloat4("uColorOverride", glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+			drawData.colorOverride = glm::vec4(0.0f);
 
-			float ratios[4];
-			for (int i = 0; i < 4; i++)
+			for (int i = 0; i < 4 && i < renderComponent->albedoTextures.size(); i++)
 			{
-				if (i < renderComponent->albedoTextures.size())
-				{
-					renderComponent->albedoTextures[i].first->BindToSlot(i);
-					shader->SetInt(std::string("uAlbedoTexture" + std::to_string(i + 1)), i);
-					ratios[i] = renderComponent->albedoTextures[i].second;
-				}
-				else
-				{
-					ratios[i] = 0.0f;
-				}
+				GLState::BindTexture(i, renderComponent->albedoTextures[i].first);
+				drawData.albedoRatios[i] = renderComponent->albedoTextures[i].second;
 			}
-			shader->SetFloat4("uAlbedoRatios", glm::vec4(ratios[0], ratios[1], ratios[2], ratios[3]));
 		}
 
 		// Normal
 		if (renderComponent->normalTexture)
 		{
-			shader->SetInt("uHasNormalTexture", GL_TRUE);
-			renderComponent->normalTexture->BindToSlot(4);
-			shader->SetInt("uNormalTexture", 4);
+			drawData.hasNormalTexture = GL_TRUE;
+			GLState::BindTexture(4, renderComponent->normalTexture);
 		}
 		else
 		{
-			shader->SetInt("uHasNormalTexture", GL_FALSE);
+			drawData.hasNormalTexture = GL_FALSE;
 		}
 
 		// Materials
 		if (renderComponent->HasMaterialTextures())
 		{
-			shader->SetFloat4("uMaterialOverrides", glm::vec4(0.0f));
-
-			renderComponent->ormTexture->BindToSlot(5);
-			shader->SetInt("uORMTexture", 5);
+			drawData.materialOverrides = glm::vec4(0.0f);
+			GLState::BindTexture(5, renderComponent->ormTexture);
 		}
 		else // We have no material textures
 		{
-			shader->SetFloat4("uMaterialOverrides", glm::vec4(renderComponent->roughness, renderComponent->metalness, renderComponent->ao, 1.0f));
+			drawData.materialOverrides = glm::vec4(renderComponent->roughness, renderComponent->metalness, renderComponent->ao, 1.0f);
 		}
 
-		shader->SetInt("uIgnoreLighting", renderComponent->isIgnoreLighting ? GL_TRUE : GL_FALSE);
+		drawData.ignoreLighting = renderComponent->isIgnoreLighting ? GL_TRUE : GL_FALSE;
+		drawData.alphaTransparency = renderComponent->alphaTransparency;
 
-		shader->SetFloat("uAlphaTransparency", renderComponent->alphaTransparency);
+		unsigned int drawOffset = uniformRing->Push(drawData);
+		if (drawOffset == UniformRingBuffer::INVALID_OFFSET) continue; // Out of space this frame, skip the draw rather than read another draw's block
+		uniformRing->BindRange(DRAW_UNIFORM_BLOCK_BINDING, drawOffset, sizeof(DrawUniformData));
 
-		renderComponent->Draw(shader, submission.transform);
+		renderComponent->Draw(shader, UniformHandle(), submission.transform, submission.lod);
 	}
 }
\ No newline at end of file
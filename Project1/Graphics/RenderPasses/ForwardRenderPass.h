@@ -5,11 +5,12 @@
 #include "Shader.h"
 #include "Window.h"
 #include "SimpleFastVector.h"
+#include "UniformRingBuffer.h"
 
 class ForwardRenderPass
 {
 public:
-	ForwardRenderPass(IFrameBuffer* geometryBuffer);
+	ForwardRenderPass(IFrameBuffer* geometryBuffer, UniformRingBuffer* uniformRing);
 	virtual ~ForwardRenderPass();
 
 	void DoPass(std::vector<RenderSubmission>& submissions, const glm::mat4& projection, const glm::mat4& view, const WindowSpecs* windowSpecs);
@@ -17,4 +18,11 @@ public:
 private:
 	IFrameBuffer* geometryBuffer;
 	Shader* shader;
+	UniformRingBuffer* uniformRing;
+
+	// Per draw values live in the uDrawData block, only the samplers are plain uniforms
+	UniformHandle albedoTextureUniforms[4];
+	UniformHandle normalTextureUniform;
+	UniformHandle ormTextureUniform;
+	UniformHandle clusterParamsUniform;
 };
\ No newline at end of file
@@ -6,11 +6,13 @@
 #include "ShaderLibrary.h"
 #include "Renderer.h"
 #include "Animation.h"
+#include "UniformBlocks.h"
+#include "GLState.h"
 
 const std::string GeometryPass::G_SHADER_KEY = "gShader";
 const std::string GeometryPass::ANIM_SHADER_KEY = "animShader";
 
-GeometryPass::GeometryPass(const WindowSpecs* windowSpecs)
+GeometryPass::GeometryPass(const WindowSpecs* windowSpecs, UniformRingBuffer* uniformRing)
 	: geometryBuffer(new FrameBuffer()),
 	geometryRenderBuffer(new RenderBuffer(GL_DEPTH_COMPONENT, windowSpecs->width, windowSpecs->height)),
 	positionBuffer(TextureManager::CreateTexture2D(GL_RGBA16F, GL_RGBA, GL_FLOAT, windowSpecs->width, windowSpecs->height, TextureFilterType::Nearest, TextureWrapType::ClampToEdge)),
@@ -19,6 +21,7 @@ GeometryPass::GeometryPass(const WindowSpecs* windowSpecs)
 	effectsBuffer(TextureManager::CreateTexture2D(GL_RGBA16F, GL_RGBA, GL_FLOAT, windowSpecs->width, windowSpecs->height, TextureFilterType::Nearest, TextureWrapType::None)),
 	shader(ShaderLibrary::Load(G_SHADER_KEY, "assets/shaders/geometryBuffer.glsl")),
 	animatedShader(ShaderLibrary::Load(ANIM_SHADER_KEY, "assets/shaders/animatedGeometryBuffer.glsl")),
+	uniformRing(uniformRing),
 	windowSpecs(windowSpecs)
 {
 	// Setup frame buffer color attachments
@@ -34,59 +37,9 @@ GeometryPass::GeometryPass(const WindowSpecs* windowSpecs)
 	geometryBuffer->SetRenderBuffer(geometryRenderBuffer, GL_DEPTH_ATTACHMENT);
 	geometryBuffer->Unbind();
 
-	// Initialize geometry shader uniforms
-	shader->Bind();
-	shader->InitializeUniform("uMatModel");
-	shader->InitializeUniform("uMatModelInverseTranspose");
-	shader->InitializeUniform("uMatView");
-	shader->InitializeUniform("uMatProjection");
-	shader->InitializeUniform("uMatProjViewModel");
-	shader->InitializeUniform("uMatPrevProjViewModel");
-	shader->InitializeUniform("uAlbedoTexture1");
-	shader->InitializeUniform("uAlbedoTexture2");
-	shader->InitializeUniform("uAlbedoTexture3");
-	shader->InitializeUniform("uAlbedoTexture4");
-	shader->InitializeUniform("uAlbedoRatios");
-	shader->InitializeUniform("uColorOverride");
-	shader->InitializeUniform("uHasNormalTexture");
-	shader->InitializeUniform("uNormalTexture");
-	shader->InitializeUniform("uORMTexture");
-	shader->InitializeUniform("uMaterialOverrides");
-	shader->InitializeUniform("uShadowSoftness");
-	shader->InitializeUniform("uRRMap");
-	shader->InitializeUniform("uRRInfo");
-	shader->InitializeUniform("uCameraPosition");
-	shader->InitializeUniform("uUVOffset");
-	shader->Unbind();
-
-	// Initialize animated shader uniforms
-	animatedShader->Bind();
-	animatedShader->InitializeUniform("uMatModel");
-	animatedShader->InitializeUniform("uMatModelInverseTranspose");
-	animatedShader->InitializeUniform("uMatView");
-	animatedShader->InitializeUniform("uMatProjection");
-	animatedShader->InitializeUniform("uMatProjViewModel");
-	animatedShader->InitializeUniform("uMatPrevProjViewModel");
-	animatedShader->InitializeUniform("uAlbedoTexture1");
-	animatedShader->InitializeUniform("uAlbedoTexture2");
-	animatedShader->InitializeUniform("uAlbedoTexture3");
-	animatedShader->InitializeUniform("uAlbedoTexture4");
-	animatedShader->InitializeUniform("uAlbedoRatios");
-	animatedShader->InitializeUniform("uColorOverride");
-	animatedShader->InitializeUniform("uHasNormalTexture");
-	animatedShader->InitializeUniform("uNormalTexture");
-	animatedShader->InitializeUniform("uORMTexture");
-	animatedShader->InitializeUniform("uMaterialOverrides");
-	animatedShader->InitializeUniform("uShadowSoftness");
-	animatedShader->InitializeUniform("uRRMap");
-	animatedShader->InitializeUniform("uRRInfo");
-	animatedShader->InitializeUniform("uCameraPosition");
-	animatedShader->InitializeUniform("uUVOffset");
-	for (unsigned int i = 0; i < Animation::MAX_BONES; i++)
-	{
-		animatedShader->InitializeUniform("uBoneMatrices[" + std::to_string(i) + "]");
-	}
-	animatedShader->Unbind();
+	// Uniform locations are resolved when the shaders are linked, just grab the handles we need and point the samplers at their slots
+	ResolveUniforms(shader, shaderUniforms);
+	ResolveUniforms(animatedShader, animatedShaderUniforms);
 }
 
 GeometryPass::~GeometryPass()
@@ -97,18 +50,15 @@ GeometryPass::~GeometryPass()
 
 void GeometryPass::DoPass(std::vector<RenderSubmission>& submissions, std::vector<RenderSubmission>& animatedSubmissions, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPosition)
 {
-	glDisable(GL_BLEND); // No blend for deffered rendering
-	glEnable(GL_DEPTH_TEST); // Enable depth testing for scene render
-	glEnable(GL_MULTISAMPLE); // AA
+	GLState::Disable(GL_BLEND); // No blend for deffered rendering
+	GLState::Enable(GL_DEPTH_TEST); // Enable depth testing for scene render
+	GLState::Enable(GL_MULTISAMPLE); // AA
+	GLState::InvalidateTextures(); // Other passes bind textures behind the cache's back
 
 	geometryBuffer->Bind();
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-	shader->Bind();
-
-	shader->SetMat4("uMatProjection", projection);
-	shader->SetMat4("uMatView", view);
-	shader->SetFloat3("uCameraPosition", cameraPosition);
+	shader->Bind(); // Projection, view & camera position come from the per-frame block bound by Renderer
 
 	// Draw static meshes
 	for (RenderSubmission& submission : submissions)
@@ -117,144 +67,142 @@ void GeometryPass::DoPass(std::vector<RenderSubmission>& submissions, std::vecto
 
 		if (renderComponent->faceCullType == FaceCullType::None)
 		{
-			glDisable(GL_CULL_FACE);
+			GLState::Disable(GL_CULL_FACE);
 		}
 		else
 		{
-			glEnable(GL_CULL_FACE);
-			glCullFace(renderComponent->faceCullType == FaceCullType::Front ? GL_FRONT : GL_BACK);
+			GLState::Enable(GL_CULL_FACE);
+			GLState::CullFace(renderComponent->faceCullType == FaceCullType::Front ? GL_FRONT : GL_BACK);
 		}
 		
-		PassSharedData(shader, submission, projection, view);
+		if (!PassSharedData(submission, projection, view)) continue;
 
-		renderComponent->Draw(shader, submission.transform);
+		renderComponent->Draw(shader, UniformHandle(), submission.transform, submission.lod);
 	}
 
-	// Draw animated meshes
-	animatedShader->Bind();
-
-	animatedShader->SetMat4("uMatProjection", projection);
-	animatedShader->SetMat4("uMatView", view);
-	animatedShader->SetFloat3("uCameraPosition", cameraPosition);
-
+	// Draw animated meshes. The ones the SkinningPass already skinned are ordinary static geometry now, the rest are skinned here
 	for (RenderSubmission& submission : animatedSubmissions)
 	{
 		RenderComponent* renderComponent = submission.renderComponent;
+		Shader* drawShader = submission.skinnedVertexArray ? shader : animatedShader;
+		drawShader->Bind(); // Redundant binds are skipped by GLState
 
 		if (renderComponent->faceCullType == FaceCullType::None)
 		{
-			glDisable(GL_CULL_FACE);
+			GLState::Disable(GL_CULL_FACE);
 		}
 		else
 		{
-			glEnable(GL_CULL_FACE);
-			glCullFace(renderComponent->faceCullType == FaceCullType::Front ? GL_FRONT : GL_BACK);
+			GLState::Enable(GL_CULL_FACE);
+			GLState::CullFace(renderComponent->faceCullType == FaceCullType::Front ? GL_FRONT : GL_BACK);
 		}
 
-		PassSharedData(animatedShader, submission, projection, view);
+		if (!PassSharedData(submission, projection, view)) continue; // Bone matrices were already uploaded by Renderer, we just pass the offset
 
-		for (unsigned int i = 0; i < submission.boneMatricesLength; i++) // Pass bone matrices to shader
-		{
-			glm::mat4& matrix = submission.boneMatrices[i];
-			animatedShader->SetMat4("uBoneMatrices[" + std::to_string(i) + "]", matrix);
-		}
-
-		renderComponent->Draw(animatedShader, submission.transform);
+		renderComponent->Draw(drawShader, UniformHandle(), submission.transform, submission.lod, submission.skinnedVertexArray, submission.skinnedVertexStart);
 	}
 
 	geometryBuffer->Unbind();
 
-	glDisable(GL_MULTISAMPLE);
+	GLState::Disable(GL_MULTISAMPLE);
 }
 
-void GeometryPass::PassSharedData(Shader* shader, RenderSubmission& submission, const glm::mat4& projection, const glm::mat4& view)
+void GeometryPass::ResolveUniforms(Shader* shader, GeometryPassUniforms& uniforms)
 {
-	RenderComponent* renderComponent = submission.renderComponent;
-
-	glm::mat4 projViewModel = projection * view * submission.transform;
-	glm::mat4& prevProjViewModel = renderComponent->hasPrevProjViewModel ? renderComponent->projViewModel : projViewModel;
-	renderComponent->projViewModel = projViewModel;
-
-	//shader->SetMat4("uMatModel", submission->transform);
-	//shader->SetMat4("uMatModelInverseTranspose", glm::inverse(submission->transform));
-	shader->SetMat4("uMatProjViewModel", projViewModel);
-	shader->SetMat4("uMatPrevProjViewModel", prevProjViewModel);
-
-	shader->SetFloat2("uUVOffset", renderComponent->uvOffset);
-
-	if (renderComponent->castShadowsOn)
+	for (int i = 0; i < 4; i++)
 	{
-		shader->SetFloat("uShadowSoftness", renderComponent->surfaceShadowSoftness);
+		uniforms.albedoTextures[i] = shader->GetUniform("uAlbedoTexture" + std::to_string(i + 1));
 	}
-	else // No shadows
+	uniforms.normalTexture = shader->GetUniform("uNormalTexture");
+	uniforms.ormTexture = shader->GetUniform("uORMTexture");
+	uniforms.rrMap = shader->GetUniform("uRRMap");
+
+	// Texture slots never change, so the samplers only need to be set once
+	shader->Bind();
+	for (int i = 0; i < 4; i++)
 	{
-		shader->SetFloat("uShadowSoftness", 0.0f);
+		shader->SetInt(uniforms.albedoTextures[i], i);
 	}
+	shader->SetInt(uniforms.normalTexture, 4);
+	shader->SetInt(uniforms.ormTexture, 5);
+	shader->SetInt(uniforms.rrMap, 8); // This has to be set even if we don't use it, sampling from a cube map that hasn't been set stops everything from rendering
+	shader->Unbind();
+}
+
+bool GeometryPass::PassSharedData(RenderSubmission& submission, const glm::mat4& projection, const glm::mat4& view)
+{
+	RenderComponent* renderComponent = submission.renderComponent;
+
+	DrawUniformData drawData;
+	drawData.model = submission.transform;
+	drawData.projViewModel = projection * view * submission.transform;
+	drawData.prevProjViewModel = renderComponent->hasPrevProjViewModel ? renderComponent->projViewModel : drawData.projViewModel;
+
+	drawData.uvOffset = renderComponent->uvOffset;
+	drawData.shadowSoftness = renderComponent->castShadowsOn ? renderComponent->surfaceShadowSoftness : 0.0f; // 0 = no shadows
+	drawData.alphaTransparency = 1.0f;
+	drawData.ignoreLighting = GL_FALSE;
+	drawData.boneOffset = submission.skinnedVertexArray ? 0 : submission.boneOffset; // Already skinned, the static shader doesn't read the palette
+	drawData.boneCount = submission.skinnedVertexArray ? 0 : submission.boneMatricesLength;
 
 	// Color
+	drawData.albedoRatios = glm::vec4(0.0f);
 	if (renderComponent->isColorOverride)
 	{
-		shader->SetFloat4("uColorOverride", glm::vec4(renderComponent->colorOverride.x, renderComponent->colorOverride.y, renderComponent->colorOverride.z, 1.0f));
+		drawData.colorOverride = glm::vec4(renderComponent->colorOverride.x, renderComponent->colorOverride.y, renderComponent->colorOverride.z, 1.0f);
 	}
 	else // Bind diffuse textures
 	{
-		shader->SetFloat4("uColorOverride", glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+		drawData.colorOverride = glm::vec4(0.0f);
 
-		float ratios[4];
-		for (int i = 0; i < 4; i++)
+		for (int i = 0; i < 4 && i < renderComponent->albedoTextures.size(); i++)
 		{
-			if (i < renderComponent->albedoTextures.size())
-			{
-				renderComponent->albedoTextures[i].first->BindToSlot(i);
-				shader->SetInt(std::string("uAlbedoTexture" + std::to_string(i + 1)), i);
-				ratios[i] = renderComponent->albedoTextures[i].second;
-			}
-			else
-			{
-				ratios[i] = 0.0f;
-			}
+			GLState::BindTexture(i, renderComponent->albedoTextures[i].first);
+			drawData.albedoRatios[i] = renderComponent->albedoTextures[i].second;
 		}
-		shader->SetFloat4("uAlbedoRatios", glm::vec4(ratios[0], ratios[1], ratios[2], ratios[3]));
 	}
 
 	if (renderComponent->normalTexture)
 	{
-		shader->SetInt("uHasNormalTexture", GL_TRUE);
-		renderComponent->normalTexture->BindToSlot(4);
-		shader->SetInt("uNormalTexture", 4);
+		drawData.hasNormalTexture = GL_TRUE;
+		GLState::BindTexture(4, renderComponent->normalTexture);
 	}
 	else
 	{
-		shader->SetInt("uHasNormalTexture", GL_FALSE);
+		drawData.hasNormalTexture = GL_FALSE;
 	}
 
 	if (renderComponent->HasMaterialTextures())
 	{
-		shader->SetFloat4("uMaterialOverrides", glm::vec4(0.0f));
-
-		renderComponent->ormTexture->BindToSlot(5);
-		shader->SetInt("uORMTexture", 5);
+		drawData.materialOverrides = glm::vec4(0.0f);
+		GLState::BindTexture(5, renderComponent->ormTexture);
 	}
 	else // We have no material textures
 	{
-		shader->SetFloat4("uMaterialOverrides", glm::vec4(renderComponent->roughness, renderComponent->metalness, renderComponent->ao, 1.0f));
+		drawData.materialOverrides = glm::vec4(renderComponent->roughness, renderComponent->metalness, renderComponent->ao, 1.0f);
 	}
 
 	ReflectRefractData& rrData = renderComponent->reflectRefractData;
 	float rrType = rrData.type == ReflectRefractType::Reflect ? 1.0f : rrData.type == ReflectRefractType::Refract ? 2.0f : 0.0f;
-	shader->SetFloat4("uRRInfo", glm::vec4(rrType, rrData.strength, renderComponent->reflectRefractData.refractRatio, 0.0f));
+	drawData.rrInfo = glm::vec4(rrType, rrData.strength, rrData.refractRatio, 0.0f);
 
 	if (rrData.type != ReflectRefractType::None)
 	{
 		if (rrData.mapType == ReflectRefractMapType::Environment)
 		{
-			Renderer::envMap1->BindToSlot(8);
+			GLState::BindTexture(8, Renderer::envMap1);
 		}
 		else
 		{
-			rrData.customMap->BindToSlot(8);
+			GLState::BindTexture(8, rrData.customMap);
 		}
 	}
 
-	shader->SetInt("uRRMap", 8); // This has to be outside of the if because for some strange reason sampling from a cube map that hasn't been set stops everything from rendering, even if the code isn't run
+	// Suballocate this draw's block from the ring and bind it by offset
+	unsigned int drawOffset = uniformRing->Push(drawData);
+	if (drawOffset == UniformRingBuffer::INVALID_OFFSET) return false; // Dropped, keep the last matrix that was drawn so next frame's motion vectors start from it
+
+	renderComponent->projViewModel = drawData.projViewModel;
+	uniformRing->BindRange(DRAW_UNIFORM_BLOCK_BINDING, drawOffset, sizeof(DrawUniformData));
+	return true;
 }
\ No newline at end of file
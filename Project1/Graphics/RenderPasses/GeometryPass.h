@@ -6,15 +6,25 @@
 #include "Window.h"
 #include "Shader.h"
 #include "SimpleFastVector.h"
+#include "UniformRingBuffer.h"
 
 #include <glm/glm.hpp>
 
 #include <string>
 
+// Uniform handles shared by the static and animated geometry shaders. Everything else per draw lives in the uDrawData block
+struct GeometryPassUniforms
+{
+	UniformHandle albedoTextures[4];
+	UniformHandle normalTexture;
+	UniformHandle ormTexture;
+	UniformHandle rrMap;
+};
+
 class GeometryPass
 {
 public:
-	GeometryPass(const WindowSpecs* windowSpecs);
+	GeometryPass(const WindowSpecs* windowSpecs, UniformRingBuffer* uniformRing);
 	virtual ~GeometryPass();
 
 	void DoPass(std::vector<RenderSubmission>& submissions, std::vector<RenderSubmission>& animatedSubmissions, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPosition);
@@ -30,7 +40,8 @@ public:
 	static const std::string ANIM_SHADER_KEY;
 
 private:
-	void PassSharedData(Shader* shader, RenderSubmission& submission, const glm::mat4& projection, const glm::mat4& view);
+	static void ResolveUniforms(Shader* shader, GeometryPassUniforms& uniforms);
+	bool PassSharedData(RenderSubmission& submission, const glm::mat4& projection, const glm::mat4& view); // false when the draw's uniforms didn't fit in the ring, the draw has to be skipped
 
 	IFrameBuffer* geometryBuffer;
 	IRenderBuffer* geometryRenderBuffer;
@@ -42,6 +53,10 @@ private:
 
 	Shader* shader;
 	Shader* animatedShader;
+	GeometryPassUniforms shaderUniforms;
+	GeometryPassUniforms animatedShaderUniforms;
+
+	UniformRingBuffer* uniformRing;
 
 	const WindowSpecs* windowSpecs;
 };
\ No newline at end of file
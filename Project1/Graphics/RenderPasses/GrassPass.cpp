@@ -2,73 +2,96 @@
 #include "ShaderLibrary.h"
 #include "TextureManager.h"
 #include "Utils.h"
+#include "GLState.h"
+#include "Profiler.h"
 
 #include <vendor/imgui/imgui.h>
 
 const std::string GrassPass::GRASS_SHADER_KEY = "grassShader";
 
+constexpr unsigned int indirectRingRegionSize = 256 * 1024; // Per frame in flight, 16 bytes per command
+constexpr float maxBladeStretch = 4.5f; // The furthest LOD in grass.glsl makes blades 4.5x taller
+
 GrassPass::GrassPass()
-	: shader(ShaderLibrary::Load(GRASS_SHADER_KEY, "assets/shaders/grass.glsl"))
+	: shader(ShaderLibrary::Load(GRASS_SHADER_KEY, "assets/shaders/grass.glsl")),
+	indirectRing(new UniformRingBuffer(indirectRingRegionSize, 3, GL_DRAW_INDIRECT_BUFFER))
 {
-	shader->InitializeUniform("uWidthHeight");
-	shader->InitializeUniform("uLODLevel");
-	shader->InitializeUniform("uAlbedoTexture");
-	shader->InitializeUniform("uHasNormalTexture");
-	shader->InitializeUniform("uNormalTexture");
-	shader->InitializeUniform("uRoughnessTexture");
-	shader->InitializeUniform("uMetalnessTexture");
-	shader->InitializeUniform("uAmbientOcculsionTexture");
-	shader->InitializeUniform("uMaterialOverrides");
-	shader->InitializeUniform("uDiscardTexture");
-	shader->InitializeUniform("uCameraPosition");
-	shader->InitializeUniform("uProjection");
-	shader->InitializeUniform("uView");
-	shader->InitializeUniform("uTime");
-	shader->InitializeUniform("uWindParams");
-	shader->InitializeUniform("uWindDirection");
+	uniforms.windParams = shader->GetUniform("uWindParams");
+	uniforms.windDirection = shader->GetUniform("uWindDirection");
+	uniforms.widthHeight = shader->GetUniform("uWidthHeight");
+	uniforms.hasNormalTexture = shader->GetUniform("uHasNormalTexture");
+	uniforms.discardTexture = shader->GetUniform("uDiscardTexture");
+	uniforms.albedoTexture = shader->GetUniform("uAlbedoTexture");
 }
 
 GrassPass::~GrassPass()
 {
-
+	delete indirectRing;
 }
 
-void GrassPass::DoPass(IFrameBuffer* geometryBuffer, std::vector<GrassCluster>& grassClusters, const glm::vec3& cameraPos, const glm::mat4& proj, const glm::mat4& view)
+void GrassPass::DoPass(IFrameBuffer* geometryBuffer, std::vector<GrassCluster>& grassClusters, const Frustum& viewFrustum, const glm::vec3& cameraPos, const glm::mat4& proj, const glm::mat4& view)
 {
-	glDisable(GL_CULL_FACE); // Don't face cull, we want to render both sides of grass blades
-	glEnable(GL_MULTISAMPLE);
-	glEnable(GL_DEPTH_TEST);
+	indirectRing->BeginFrame();
 
-	geometryBuffer->Bind();
+	GLState::Disable(GL_CULL_FACE); // Don't face cull, we want to render both sides of grass blades
+	GLState::Enable(GL_MULTISAMPLE);
+	GLState::Enable(GL_DEPTH_TEST);
 
-	shader->Bind();
+	geometryBuffer->Bind();
 
-	shader->SetFloat3("uCameraPosition", cameraPos);
-	shader->SetMat4("uProjection", proj);
-	shader->SetMat4("uView", view);
-	shader->SetFloat("uTime", glfwGetTime());
+	shader->Bind(); // Camera data & time come from the per-frame block bound by Renderer
 
+	unsigned int bladesDrawn = 0;
+	unsigned int commandsIssued = 0;
 	for (GrassCluster& grassCluster : grassClusters)
 	{
-		shader->SetFloat3("uWindParams", glm::vec3(grassCluster.oscillationStrength, grassCluster.windForceMult, grassCluster.stiffness));
-		shader->SetFloat2("uWindDirection", glm::normalize(grassCluster.windDirection));
-		shader->SetFloat2("uWidthHeight", grassCluster.dimensions);
-		shader->SetInt("uHasNormalTexture", false);
+		if (grassCluster.chunks.empty() && !grassCluster.grassData.empty())
+		{
+			// Chunking reorders the blades, so the vertex buffer has to be refilled
+			grassCluster.chunks = GrassChunkUtils::BuildChunks(grassCluster.grassData, grassCluster.chunkSize);
+			grassCluster.VBO->SetData(grassCluster.grassData.data(), grassCluster.grassData.size() * sizeof(glm::vec4));
+		}
+
+		GrassLODSettings lodSettings;
+		lodSettings.fullDensityDistance = grassCluster.fullDensityDistance;
+		lodSettings.maxDrawDistance = grassCluster.maxDrawDistance;
+		lodSettings.maxStride = grassCluster.maxLODStride;
+		lodSettings.bladePadding = std::max(grassCluster.dimensions.x, grassCluster.dimensions.y) * maxBladeStretch;
+
+		drawCommands.clear();
+		bladesDrawn += GrassChunkUtils::BuildDrawCommands(grassCluster.chunks, viewFrustum, cameraPos, lodSettings, drawCommands);
+		if (drawCommands.empty()) continue; // Nothing visible
+
+		commandsIssued += (unsigned int)drawCommands.size();
+		unsigned int commandOffset = indirectRing->Push(drawCommands.data(), (unsigned int)(drawCommands.size() * sizeof(GrassDrawCommand)));
+		if (commandOffset == UniformRingBuffer::INVALID_OFFSET) continue; // Out of space this frame
+
+		shader->SetFloat3(uniforms.windParams, glm::vec3(grassCluster.oscillationStrength, grassCluster.windForceMult, grassCluster.stiffness));
+		shader->SetFloat2(uniforms.windDirection, glm::normalize(grassCluster.windDirection));
+		shader->SetFloat2(uniforms.widthHeight, grassCluster.dimensions);
+		shader->SetInt(uniforms.hasNormalTexture, false);
 
 		grassCluster.discardTexture->BindToSlot(0);
-		shader->SetInt("uDiscardTexture", 0);
+		shader->SetInt(uniforms.discardTexture, 0);
 
 		grassCluster.albedoTexture->BindToSlot(1);
-		shader->SetInt("uAlbedoTexture", 1);
+		shader->SetInt(uniforms.albedoTexture, 1);
 
 		//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
 		grassCluster.VAO->Bind();
-		glDrawArrays(GL_POINTS, 0, grassCluster.grassData.size());
+		indirectRing->Bind();
+		glMultiDrawArraysIndirect(GL_POINTS, (const void*)(uintptr_t)commandOffset, (GLsizei)drawCommands.size(), 0);
+		indirectRing->Unbind();
 		grassCluster.VAO->Unbind();
 	}
 
 	geometryBuffer->Unbind();
 
-	glDisable(GL_MULTISAMPLE);
+	GLState::Disable(GL_MULTISAMPLE);
+
+	indirectRing->EndFrame();
+
+	Profiler::SetCounter("Grass Blades Drawn", bladesDrawn);
+	Profiler::SetCounter("Grass Draw Commands", commandsIssued);
 }
\ No newline at end of file
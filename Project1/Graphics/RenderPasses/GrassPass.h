@@ -5,6 +5,8 @@
 #include "Texture2D.h"
 #include "IFrameBuffer.h"
 #include "GrassCluster.h"
+#include "UniformRingBuffer.h"
+#include "Frustum.h"
 
 class GrassPass
 {
@@ -12,10 +14,23 @@ public:
 	GrassPass();
 	~GrassPass();
 
-	void DoPass(IFrameBuffer* geometryBuffer, std::vector<GrassCluster>& grassClusters, const glm::vec3& cameraPos, const glm::mat4& proj, const glm::mat4& view);
+	void DoPass(IFrameBuffer* geometryBuffer, std::vector<GrassCluster>& grassClusters, const Frustum& viewFrustum, const glm::vec3& cameraPos, const glm::mat4& proj, const glm::mat4& view);
 
 	static const std::string GRASS_SHADER_KEY;
 
 private:
 	Shader* shader;
+
+	UniformRingBuffer* indirectRing; // Each cluster's visible chunks are pushed here as indirect draw commands
+	std::vector<GrassDrawCommand> drawCommands;
+
+	struct ShaderUniforms
+	{
+		UniformHandle windParams;
+		UniformHandle windDirection;
+		UniformHandle widthHeight;
+		UniformHandle hasNormalTexture;
+		UniformHandle discardTexture;
+		UniformHandle albedoTexture;
+	} uniforms;
 };
\ No newline at end of file
@@ -3,68 +3,25 @@
 #include "TextureManager.h"
 #include "RenderBuffer.h"
 #include "ShaderLibrary.h"
-#include "Light.h"
+#include "LightManager.h"
 #include "Renderer.h"
 #include "CascadedShadowMapping.h"
-
-#include <sstream>
+#include "GLState.h"
 
 LightingPass::LightingPass(const WindowSpecs* windowSpecs, ITexture* shadowMaps, std::vector<float>& cascadeLevels)
 	: shader(ShaderLibrary::Load(Renderer::LIGHTING_SHADER_KEY, "assets/shaders/brdfLighting.glsl")), 
 	shadowMaps(shadowMaps),
 	cascadeLevels(cascadeLevels)
 {
-	// Setup shader uniforms
-	shader->Bind();
-	shader->InitializeUniform("uInverseView");
-	shader->InitializeUniform("uInverseProjection");
-	shader->InitializeUniform("uView");
-	shader->InitializeUniform("gPosition");
-	shader->InitializeUniform("gAlbedo");
-	shader->InitializeUniform("gNormal");
-	shader->InitializeUniform("gEffects");
-	shader->InitializeUniform("uLightAmount");
-
-	for (int i = 0; i < Light::MAX_LIGHTS; i++)
-	{
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].position";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].direction";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].color";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].param1";
-			shader->InitializeUniform(ss.str());
-		}
-		{
-			std::stringstream ss;
-			ss << "uLightArray[" << i << "].castShadows";
-			shader->InitializeUniform(ss.str());
-		}
-	}
+	// Setup shader uniforms. Lights are read from the buffers bound by LightManager
+	inverseViewUniform = shader->GetUniform("uInverseView");
+	inverseProjectionUniform = shader->GetUniform("uInverseProjection");
+	reflectivityUniform = shader->GetUniform("uReflectivity");
+	cascadeCountUniform = shader->GetUniform("uCascadeCount");
+	cascadePlaneDistancesUniform = shader->GetUniform("uCascadePlaneDistances");
+	clusterParamsUniform = shader->GetUniform("uClusterParams");
 
-	shader->InitializeUniform("uEnvMap");
-	shader->InitializeUniform("uViewType");
-	shader->InitializeUniform("uReflectivity");
-	shader->InitializeUniform("uCameraPosition");
-	shader->InitializeUniform("uShadowMap");
-	for (int i = 0; i < CascadedShadowMapping::MAX_CASCADE_LEVELS; i++)
-	{
-		shader->InitializeUniform(std::string("uCascadePlaneDistances[" + std::to_string(i) + "]"));
-	}
-	shader->InitializeUniform("uCascadeCount");
-	shader->InitializeUniform("uShadowSoftnessTexture");
+	shader->Bind();
 	shader->SetInt("uViewType", 1); // Regular color view by default
 
 	// Set samplers for lighting
@@ -88,8 +45,8 @@ void LightingPass::DoPass(ITexture* positionBuffer, ITexture* albedoBuffer, ITex
 	const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPosition, PrimitiveShape& quad)
 {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT); 
-	glDisable(GL_DEPTH_TEST); // Disable depth buffer so that the quad doesnt get discarded
-	glDisable(GL_CULL_FACE);
+	GLState::Disable(GL_DEPTH_TEST); // Disable depth buffer so that the quad doesnt get discarded
+	GLState::Disable(GL_CULL_FACE);
 
 	shader->Bind();
 
@@ -107,19 +64,16 @@ void LightingPass::DoPass(ITexture* positionBuffer, ITexture* albedoBuffer, ITex
 	shadowSoftness->BindToSlot(6);
 
 	// Shadow mapping details
-	shader->SetInt("uCascadeCount", cascadeLevels.size());
-	for (size_t i = 0; i < cascadeLevels.size(); i++)
-	{
-		shader->SetFloat("uCascadePlaneDistances[" + std::to_string(i) + "]", cascadeLevels[i]);
-	}
+	shader->SetInt(cascadeCountUniform, cascadeLevels.size());
+	shader->SetFloatArray(cascadePlaneDistancesUniform, cascadeLevels.data(), cascadeLevels.size());
+
+	shader->SetMat4(inverseViewUniform, glm::transpose(view));
+	shader->SetMat4(inverseProjectionUniform, glm::inverse(projection));
 
-	shader->SetMat4("uInverseView", glm::transpose(view));
-	shader->SetMat4("uInverseProjection", glm::inverse(projection));
-	shader->SetMat4("uView", view);
-	shader->SetFloat3("uCameraPosition", cameraPosition);
+	shader->SetFloat4(clusterParamsUniform, LightManager::GetClusterParams());
 
 	// TODO: Move these into gBuffer so it can be passed in with the geometry
-	shader->SetFloat3("uReflectivity", glm::vec3(0.04f));
+	shader->SetFloat3(reflectivityUniform, glm::vec3(0.04f));
 
 	quad.Draw();
 }
@@ -25,6 +25,13 @@ public:
 private:
 	Shader* shader;
 
+	UniformHandle inverseViewUniform;
+	UniformHandle inverseProjectionUniform;
+	UniformHandle reflectivityUniform;
+	UniformHandle cascadeCountUniform;
+	UniformHandle cascadePlaneDistancesUniform;
+	UniformHandle clusterParamsUniform;
+
 	// Shadow Mapping
 	ITexture* shadowMaps;
 	std::vector<float>& cascadeLevels;
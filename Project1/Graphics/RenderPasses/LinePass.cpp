@@ -5,10 +5,10 @@ LinePass::LinePass()
 	: shader(ShaderLibrary::Load("lineShader", "assets/shaders/lines.glsl"))
 {
 	shader->Bind();
-	shader->InitializeUniform("uMatModel");
-	shader->InitializeUniform("uMatView");
-	shader->InitializeUniform("uMatProjection");
-	shader->InitializeUniform("uLineColor");
+	uniforms.matModel = shader->GetUniform("uMatModel");
+	uniforms.matView = shader->GetUniform("uMatView");
+	uniforms.matProjection = shader->GetUniform("uMatProjection");
+	uniforms.lineColor = shader->GetUniform("uLineColor");
 	shader->Unbind();
 }
 
@@ -25,10 +25,10 @@ void LinePass::DoPass(std::vector<LineRenderSubmission>& submissions, const glm:
 
 	for (LineRenderSubmission& submission : submissions)
 	{
-		shader->SetMat4("uMatModel", submission.transform);
-		shader->SetMat4("uMatView", view);
-		shader->SetMat4("uMatProjection", projection);
-		shader->SetFloat3("uLineColor", submission.lineColor);
+		shader->SetMat4(uniforms.matModel, submission.transform);
+		shader->SetMat4(uniforms.matView, view);
+		shader->SetMat4(uniforms.matProjection, projection);
+		shader->SetFloat3(uniforms.lineColor, submission.lineColor);
 
 		submission.vao->Bind();
 		glLineWidth(submission.lineWidth); // Set width of line
@@ -16,4 +16,12 @@ public:
 
 private:
 	Shader* shader;
+
+	struct ShaderUniforms
+	{
+		UniformHandle matModel;
+		UniformHandle matView;
+		UniformHandle matProjection;
+		UniformHandle lineColor;
+	} uniforms;
 };
\ No newline at end of file
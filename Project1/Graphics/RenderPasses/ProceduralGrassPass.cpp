@@ -2,6 +2,7 @@
 #include "ShaderLibrary.h"
 #include "TextureManager.h"
 #include "Utils.h"
+#include "GLState.h"
 
 #include <vendor/imgui/imgui.h>
 
@@ -10,25 +11,16 @@ const std::string ProceduralGrassPass::GRASS_SHADER_KEY = "proceduralGrassShader
 ProceduralGrassPass::ProceduralGrassPass()
 	: shader(ShaderLibrary::Load(GRASS_SHADER_KEY, "assets/shaders/proceduralGrass.glsl"))
 {
-	shader->InitializeUniform("uWidthHeight");
-	shader->InitializeUniform("uLODLevel");
-	shader->InitializeUniform("uAlbedoTexture");
-	shader->InitializeUniform("uHasNormalTexture");
-	shader->InitializeUniform("uNormalTexture");
-	shader->InitializeUniform("uRoughnessTexture");
-	shader->InitializeUniform("uMetalnessTexture");
-	shader->InitializeUniform("uAmbientOcculsionTexture");
-	shader->InitializeUniform("uMaterialOverrides");
-	shader->InitializeUniform("uDiscardTexture");
-	shader->InitializeUniform("uCameraPosition");
-	shader->InitializeUniform("uProjection");
-	shader->InitializeUniform("uView");
-	shader->InitializeUniform("uTime");
-	shader->InitializeUniform("uWindParams");
-	shader->InitializeUniform("uWindDirection");
-	shader->InitializeUniform("uSeed");
-	shader->InitializeUniform("uTerrainParams");
-	shader->InitializeUniform("uOctaves");
+	uniforms.seed = shader->GetUniform("uSeed");
+	uniforms.terrainParams = shader->GetUniform("uTerrainParams");
+	uniforms.octaves = shader->GetUniform("uOctaves");
+	uniforms.windParams = shader->GetUniform("uWindParams");
+	uniforms.windDirection = shader->GetUniform("uWindDirection");
+	uniforms.widthHeight = shader->GetUniform("uWidthHeight");
+	uniforms.discardTexture = shader->GetUniform("uDiscardTexture");
+	uniforms.albedoTexture = shader->GetUniform("uAlbedoTexture");
+	uniforms.hasNormalTexture = shader->GetUniform("uHasNormalTexture");
+	uniforms.materialOverrides = shader->GetUniform("uMaterialOverrides");
 }
 
 ProceduralGrassPass::~ProceduralGrassPass()
@@ -50,37 +42,32 @@ void ProceduralGrassPass::DoPass(IFrameBuffer* geometryBuffer, GrassCluster& clu
 	}
 	ImGui::End();
 
-	glDisable(GL_CULL_FACE); // Don't face cull, we want to render both sides of grass blades
-	glEnable(GL_MULTISAMPLE);
-	glEnable(GL_DEPTH_TEST);
+	GLState::Disable(GL_CULL_FACE); // Don't face cull, we want to render both sides of grass blades
+	GLState::Enable(GL_MULTISAMPLE);
+	GLState::Enable(GL_DEPTH_TEST);
 
 	geometryBuffer->Bind();
 
-	shader->Bind();
+	shader->Bind(); // Camera data & time come from the per-frame block bound by Renderer
 
-	shader->SetFloat3("uCameraPosition", cameraPos);
-	shader->SetMat4("uProjection", proj);
-	shader->SetMat4("uView", view);
-	shader->SetFloat("uTime", glfwGetTime());
+	shader->SetFloat2(uniforms.seed, terrainInfo.seed);
+	shader->SetFloat4(uniforms.terrainParams, glm::vec4(terrainInfo.amplitude, terrainInfo.roughness, terrainInfo.persitence, terrainInfo.frequency));
+	shader->SetInt(uniforms.octaves, terrainInfo.octaves);
 
-	shader->SetFloat2("uSeed", terrainInfo.seed);
-	shader->SetFloat4("uTerrainParams", glm::vec4(terrainInfo.amplitude, terrainInfo.roughness, terrainInfo.persitence, terrainInfo.frequency));
-	shader->SetInt("uOctaves", terrainInfo.octaves);
-
-	shader->SetFloat3("uWindParams", glm::vec3(cluster.oscillationStrength, cluster.windForceMult, cluster.stiffness));
-	shader->SetFloat2("uWindDirection", glm::normalize(cluster.windDirection));
-	shader->SetFloat2("uWidthHeight", cluster.dimensions);
+	shader->SetFloat3(uniforms.windParams, glm::vec3(cluster.oscillationStrength, cluster.windForceMult, cluster.stiffness));
+	shader->SetFloat2(uniforms.windDirection, glm::normalize(cluster.windDirection));
+	shader->SetFloat2(uniforms.widthHeight, cluster.dimensions);
 
 	cluster.discardTexture->BindToSlot(0);
-	shader->SetInt("uDiscardTexture", 0);
+	shader->SetInt(uniforms.discardTexture, 0);
 
 	cluster.albedoTexture->BindToSlot(1);
-	shader->SetInt("uAlbedoTexture", 1);
+	shader->SetInt(uniforms.albedoTexture, 1);
 
 	// TODO: Normal texture 
-	shader->SetInt("uHasNormalTexture", false);
+	shader->SetInt(uniforms.hasNormalTexture, false);
 
-	shader->SetFloat4("uMaterialOverrides", glm::vec4(cluster.roughness, cluster.metalness, cluster.ao, 1.0f));
+	shader->SetFloat4(uniforms.materialOverrides, glm::vec4(cluster.roughness, cluster.metalness, cluster.ao, 1.0f));
 	
 
 	//glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -91,5 +78,5 @@ void ProceduralGrassPass::DoPass(IFrameBuffer* geometryBuffer, GrassCluster& clu
 
 	geometryBuffer->Bind();
 
-	glDisable(GL_MULTISAMPLE);
+	GLState::Disable(GL_MULTISAMPLE);
 }
\ No newline at end of file
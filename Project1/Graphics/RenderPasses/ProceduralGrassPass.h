@@ -19,4 +19,18 @@ public:
 
 private:
 	Shader* shader;
+
+	struct ShaderUniforms
+	{
+		UniformHandle seed;
+		UniformHandle terrainParams;
+		UniformHandle octaves;
+		UniformHandle windParams;
+		UniformHandle windDirection;
+		UniformHandle widthHeight;
+		UniformHandle discardTexture;
+		UniformHandle albedoTexture;
+		UniformHandle hasNormalTexture;
+		UniformHandle materialOverrides;
+	} uniforms;
 };
\ No newline at end of file
@@ -0,0 +1,144 @@
+#include "SkinningPass.h"
+#include "ShaderLibrary.h"
+#include "AnimatedMesh.h"
+#include "Skinning.h"
+#include "UniformBlocks.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <map>
+
+const std::string SkinningPass::SKINNING_SHADER_KEY = "skinningShader";
+
+constexpr unsigned int skinningWorkGroupSize = 64; // Has to match local_size_x in skinning.glsl
+
+// One mesh & palette to skin this frame
+struct SkinningJob
+{
+	AnimatedMesh* mesh;
+	unsigned int boneOffset;
+	unsigned int boneCount;
+	unsigned int skinnedStart;
+};
+
+static unsigned int GetVertexCount(AnimatedMesh* mesh)
+{
+	// The CPU copy of the vertices may already be released, the submeshes still know how far the vertex buffer goes
+	unsigned int vertexCount = 0;
+	for (const Submesh& submesh : mesh->GetSubmeshes())
+	{
+		vertexCount = std::max(vertexCount, submesh.vertexStart + submesh.vertexCount);
+	}
+	return vertexCount;
+}
+
+SkinningPass::SkinningPass()
+	: shader(ShaderLibrary::LoadCompute(SKINNING_SHADER_KEY, "assets/shaders/skinning.glsl")),
+	skinnedVertices(new VertexBuffer((uint32_t)sizeof(SkinnedVertex), GL_DYNAMIC_COPY)), // Written by the skinning shader every frame, only read by the GPU
+	enabled(true)
+{
+	// Same attribute locations as the static mesh shaders read
+	skinnedVertices->SetLayout({
+		{ ShaderDataType::Float3, "vPosition" },
+		{ ShaderDataType::Short2, "vNormal", true },
+		{ ShaderDataType::Half2, "vTextureCoordinates" }
+	});
+
+	uniforms.vertexStart = shader->GetUniform("uVertexStart");
+	uniforms.vertexCount = shader->GetUniform("uVertexCount");
+	uniforms.skinnedStart = shader->GetUniform("uSkinnedStart");
+	uniforms.boneOffset = shader->GetUniform("uBoneOffset");
+	uniforms.boneCount = shader->GetUniform("uBoneCount");
+	uniforms.positionOffset = shader->GetUniform("uPositionOffset");
+	uniforms.positionScale = shader->GetUniform("uPositionScale");
+}
+
+SkinningPass::~SkinningPass()
+{
+	std::unordered_map<const AnimatedMesh*, VertexArrayObject*>::iterator it = skinnedVertexArrays.begin();
+	while (it != skinnedVertexArrays.end())
+	{
+		delete it->second;
+		it++;
+	}
+
+	delete skinnedVertices;
+}
+
+void SkinningPass::DoPass(std::vector<RenderSubmission>& animatedSubmissions, std::vector<RenderSubmission>& animatedShadowSubmissions)
+{
+	if (!enabled) return;
+
+	// Lay every mesh & palette out back to back first, the buffer has to be big enough before anything is dispatched
+	std::vector<SkinningJob> jobs;
+	std::map<std::pair<const AnimatedMesh*, const glm::mat4*>, unsigned int> skinnedStarts;
+	unsigned int vertexCount = 0;
+
+	std::vector<RenderSubmission>* submissionLists[2] = { &animatedSubmissions, &animatedShadowSubmissions };
+	for (std::vector<RenderSubmission>* submissions : submissionLists)
+	{
+		for (RenderSubmission& submission : *submissions)
+		{
+			AnimatedMesh* mesh = dynamic_cast<AnimatedMesh*>(submission.renderComponent->mesh);
+			if (!mesh || !mesh->GetVertexBuffer() || submission.boneMatricesLength == 0) continue; // Left to the animated mesh shaders
+
+			std::pair<const AnimatedMesh*, const glm::mat4*> key(mesh, submission.boneMatrices);
+			std::map<std::pair<const AnimatedMesh*, const glm::mat4*>, unsigned int>::iterator it = skinnedStarts.find(key);
+			if (it == skinnedStarts.end())
+			{
+				it = skinnedStarts.insert({ key, vertexCount }).first;
+				jobs.push_back({ mesh, submission.boneOffset, submission.boneMatricesLength, vertexCount });
+				vertexCount += GetVertexCount(mesh);
+			}
+
+			submission.skinnedVertexArray = GetSkinnedVertexArray(mesh);
+			submission.skinnedVertexStart = it->second;
+		}
+	}
+
+	Profiler::SetCounter("Skinned Vertices", vertexCount);
+	if (jobs.empty()) return;
+
+	uint32_t requiredSize = vertexCount * (uint32_t)sizeof(SkinnedVertex);
+	if (requiredSize > skinnedVertices->GetSize())
+	{
+		skinnedVertices->Resize(requiredSize + requiredSize / 2); // Headroom, so a few more characters coming into view don't reallocate it every frame
+	}
+
+	shader->Bind();
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SKINNING_OUTPUT_STORAGE_BINDING, skinnedVertices->GetID());
+
+	for (const SkinningJob& job : jobs)
+	{
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SKINNING_SOURCE_STORAGE_BINDING, job.mesh->GetVertexBuffer()->GetID());
+		shader->SetInt(uniforms.boneOffset, job.boneOffset);
+		shader->SetInt(uniforms.boneCount, job.boneCount);
+
+		for (const Submesh& submesh : job.mesh->GetSubmeshes())
+		{
+			if (submesh.vertexCount == 0) continue;
+
+			shader->SetInt(uniforms.vertexStart, submesh.vertexStart);
+			shader->SetInt(uniforms.vertexCount, submesh.vertexCount);
+			shader->SetInt(uniforms.skinnedStart, job.skinnedStart + submesh.vertexStart);
+			shader->SetFloat3(uniforms.positionOffset, submesh.minVertex);
+			shader->SetFloat3(uniforms.positionScale, submesh.maxVertex - submesh.minVertex);
+
+			glDispatchCompute((submesh.vertexCount + skinningWorkGroupSize - 1) / skinningWorkGroupSize, 1, 1);
+		}
+	}
+
+	glMemoryBarrier(GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT); // The passes read what was written as vertex attributes
+}
+
+VertexArrayObject* SkinningPass::GetSkinnedVertexArray(AnimatedMesh* mesh)
+{
+	std::unordered_map<const AnimatedMesh*, VertexArrayObject*>::iterator it = skinnedVertexArrays.find(mesh);
+	if (it != skinnedVertexArrays.end()) return it->second;
+
+	VertexArrayObject* vertexArray = new VertexArrayObject();
+	vertexArray->AddVertexBuffer(skinnedVertices);
+	vertexArray->SetIndexBuffer(mesh->GetIndexBuffer());
+	skinnedVertexArrays.insert({ mesh, vertexArray });
+	return vertexArray;
+}
\ No newline at end of file
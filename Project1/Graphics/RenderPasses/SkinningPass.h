@@ -0,0 +1,51 @@
+#pragma once
+
+#include "RenderSubmission.h"
+#include "ComputeShader.h"
+#include "VertexBuffer.h"
+#include "VertexArrayObject.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class AnimatedMesh;
+
+// Skins every animated mesh drawn this frame once, into one vertex buffer shared by all of them. The geometry, shadow & dynamic cube map passes
+// draw the result with their static mesh shaders instead of each skinning every vertex again
+class SkinningPass
+{
+public:
+	SkinningPass();
+	virtual ~SkinningPass();
+
+	// After Renderer::UploadBonePalettes. Points the submissions at their skinned vertices, submissions with the same mesh & palette (visible and casting shadows,
+	// or a baked crowd on the same frame) share them. While disabled the submissions are left alone and the passes skin in their vertex shaders like before
+	void DoPass(std::vector<RenderSubmission>& animatedSubmissions, std::vector<RenderSubmission>& animatedShadowSubmissions);
+
+	bool IsEnabled() const { return enabled; }
+	void SetEnabled(bool enabled) { this->enabled = enabled; }
+
+	static const std::string SKINNING_SHADER_KEY;
+
+private:
+	VertexArrayObject* GetSkinnedVertexArray(AnimatedMesh* mesh);
+
+	ComputeShader* shader;
+
+	struct SkinningUniforms
+	{
+		UniformHandle vertexStart;
+		UniformHandle vertexCount;
+		UniformHandle skinnedStart;
+		UniformHandle boneOffset;
+		UniformHandle boneCount;
+		UniformHandle positionOffset;
+		UniformHandle positionScale;
+	} uniforms;
+
+	VertexBuffer* skinnedVertices; // Rewritten every frame, grows to the most vertices a frame has needed
+	std::unordered_map<const AnimatedMesh*, VertexArrayObject*> skinnedVertexArrays; // skinnedVertices with the mesh's index buffer. The buffer keeps its name when it grows, so these stay valid
+
+	bool enabled;
+};
\ No newline at end of file
@@ -2,6 +2,7 @@
 #include "TextureManager.h"
 #include "ShaderLibrary.h"
 #include "Utils.h"
+#include "GLState.h"
 
 #include "vendor/imgui/imgui.h"
 
@@ -62,15 +63,12 @@ TerrainPass::TerrainPass()
     vbo->SetLayout(layout);
     vao->AddVertexBuffer(vbo);
 
-    shader->InitializeUniform("uProjection");
-    shader->InitializeUniform("uModel");
-    shader->InitializeUniform("uView");
-    shader->InitializeUniform("uSeed");
-    shader->InitializeUniform("uCameraPosition");
-    shader->InitializeUniform("uTerrainParams");
-    shader->InitializeUniform("uOctaves");
-    shader->InitializeUniform("uTerrainTexture");
-    shader->InitializeUniform("uTextureCoordScale");
+    uniforms.model = shader->GetUniform("uModel");
+    uniforms.seed = shader->GetUniform("uSeed");
+    uniforms.terrainParams = shader->GetUniform("uTerrainParams");
+    uniforms.octaves = shader->GetUniform("uOctaves");
+    uniforms.textureCoordScale = shader->GetUniform("uTextureCoordScale");
+    uniforms.terrainTexture = shader->GetUniform("uTerrainTexture");
 }
 
 void TerrainPass::DoPass(IFrameBuffer* geometryBuffer, TerrainGenerationInfo& terrainInfo, const glm::mat4& projection, const glm::mat4& view, const glm::vec3& cameraPos)
@@ -85,33 +83,30 @@ void TerrainPass::DoPass(IFrameBuffer* geometryBuffer, TerrainGenerationInfo& te
         ImGui::DragFloat("Persistence", &terrainInfo.persitence, 0.001f);
         ImGui::DragInt("Octaves", &terrainInfo.octaves);
         ImGui::DragFloat("Texture Scale", &terrainTextureScale, 0.1f);
+        ImGui::Checkbox("Collision", &terrainInfo.generateCollision);
         ImGui::TreePop();
     }
     ImGui::End();
 
-    glDisable(GL_CULL_FACE);
-    glEnable(GL_DEPTH_TEST);
+    GLState::Disable(GL_CULL_FACE);
+    GLState::Enable(GL_DEPTH_TEST);
 
     glPatchParameteri(GL_PATCH_VERTICES, numPatchPrimitives); // Consider every n vertices to be a "patch primitive"
 
     geometryBuffer->Bind();
 
-    shader->Bind();
+    shader->Bind(); // Camera data comes from the per-frame block bound by Renderer
 
-    glm::vec2 shaderPos(cameraPos.x, cameraPos.z);
     glm::mat4 transform = glm::translate(glm::mat4(1.0f), glm::vec3(cameraPos.x, 0.0f, cameraPos.z));
 
-    shader->SetMat4("uProjection", projection);
-    shader->SetMat4("uView", view);
-    shader->SetMat4("uModel", transform);
-    shader->SetFloat2("uCameraPosition", shaderPos);
-    shader->SetFloat2("uSeed", terrainInfo.seed);
-    shader->SetFloat4("uTerrainParams", glm::vec4(terrainInfo.amplitude, terrainInfo.roughness, terrainInfo.persitence, terrainInfo.frequency));
-    shader->SetInt("uOctaves", terrainInfo.octaves);
-    shader->SetFloat("uTextureCoordScale", terrainTextureScale);
+    shader->SetMat4(uniforms.model, transform);
+    shader->SetFloat2(uniforms.seed, terrainInfo.seed);
+    shader->SetFloat4(uniforms.terrainParams, glm::vec4(terrainInfo.amplitude, terrainInfo.roughness, terrainInfo.persitence, terrainInfo.frequency));
+    shader->SetInt(uniforms.octaves, terrainInfo.octaves);
+    shader->SetFloat(uniforms.textureCoordScale, terrainTextureScale);
 
     terrainTexture->BindToSlot(0);
-    shader->SetInt("uTerrainTexture", 0);
+    shader->SetInt(uniforms.terrainTexture, 0);
 
     //glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
 
@@ -24,6 +24,16 @@ private:
 
 	Shader* shader;
 
+	struct ShaderUniforms
+	{
+		UniformHandle model;
+		UniformHandle seed;
+		UniformHandle terrainParams;
+		UniformHandle octaves;
+		UniformHandle textureCoordScale;
+		UniformHandle terrainTexture;
+	} uniforms;
+
 	Texture2D* terrainTexture;
 	float terrainTextureScale;
 };
\ No newline at end of file
@@ -1,14 +1,31 @@
 #pragma once
 
 #include "Texture2D.h"
+#include "OceanSimulation.h"
 
 #include <glm/glm.hpp>
 
+// Owns the ocean simulation and keeps its maps on the GPU. The simulation stays readable from the CPU (OceanSimulation::SampleDisplacement) for buoyancy & gameplay
 class WaterPass
 {
 public:
+	WaterPass(const OceanSettings& settings = OceanSettings());
+	~WaterPass();
 
-	static Texture2D* GenH0();
-	static Texture2D* GenW();
-	static float Phillips(const glm::vec2& pos, const glm::vec2& windDir, float windSpeed, float A, float gravityAccel);
+	void DoPass(float time); // Simulates the ocean at time and uploads the maps
+
+	void SetSettings(const OceanSettings& settings);
+
+	OceanSimulation& GetSimulation() { return simulation; }
+	Texture2D* GetDisplacementMap() const { return displacementMap; }
+	Texture2D* GetNormalMap() const { return normalMap; }
+
+private:
+	void CreateMaps();
+	void DeleteMaps();
+
+	OceanSimulation simulation;
+
+	Texture2D* displacementMap; // RGB32F, xyz = dx, height, dz. Repeats every patchSize
+	Texture2D* normalMap; // RGB32F
 };
\ No newline at end of file
@@ -15,7 +15,11 @@ struct RenderSubmission
 		rotation(rotation),
 		transform(1.0f),
 		boneMatrices(nullptr),
-		boneMatricesLength(0)
+		boneMatricesLength(0),
+		boneOffset(0),
+		skinnedVertexArray(nullptr),
+		skinnedVertexStart(0),
+		lod(0)
 	{
 		transform *= glm::translate(glm::mat4(1.0f), position);
 		transform *= glm::toMat4(rotation);
@@ -29,12 +33,26 @@ struct RenderSubmission
 		rotation(rotation),
 		transform(transform),
 		boneMatrices(nullptr),
-		boneMatricesLength(0)
+		boneMatricesLength(0),
+		boneOffset(0),
+		skinnedVertexArray(nullptr),
+		skinnedVertexStart(0),
+		lod(0)
 	{
 
 	}
 
-	RenderSubmission() {}
+	RenderSubmission()
+		: renderComponent(nullptr),
+		boneMatrices(nullptr),
+		boneMatricesLength(0),
+		boneOffset(0),
+		skinnedVertexArray(nullptr),
+		skinnedVertexStart(0),
+		lod(0)
+	{
+
+	}
 
 	RenderComponent* renderComponent;
 	glm::vec3 position = glm::vec3(0.0f);
@@ -43,8 +61,15 @@ struct RenderSubmission
 
 	glm::mat4 transform;
 
-	glm::mat4* boneMatrices;
+	const glm::mat4* boneMatrices;
 	unsigned int boneMatricesLength;
+	unsigned int boneOffset; // Where boneMatrices were uploaded in the frame's bone palette buffer (set by Renderer)
+
+	// Set by the SkinningPass once it has skinned this submission's vertices, passes draw them as static geometry through RenderComponent::Draw instead of skinning them again
+	VertexArrayObject* skinnedVertexArray;
+	unsigned int skinnedVertexStart; // Where the mesh's first vertex went in the skinned vertex buffer
+
+	unsigned int lod; // Which of the mesh's LODs to draw
 };
 
 struct LineRenderSubmission
@@ -9,6 +9,10 @@
 #include "Texture2D.h"
 #include "CubeMap.h"
 #include "EquirectangularToCubeMapConverter.h"
+#include "UniformBlocks.h"
+#include "LightManager.h"
+#include "GLState.h"
+#include "NullRenderDevice.h"
 
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -23,6 +27,7 @@ glm::vec3 Renderer::cameraPos(0.0f);
 glm::vec3 cameraDir(0.0f);
 Frustum Renderer::viewFrustum;
 float Renderer::shadowCullRadius = 1000.0f;
+MeshLODSelection Renderer::lodSelection;
 
 std::vector<RenderSubmission> Renderer::culledShadowSubmissions;
 std::vector<RenderSubmission> Renderer::culledSubmissions;
@@ -34,6 +39,15 @@ std::vector<LineRenderSubmission> Renderer::lineSubmissions;
 float Renderer::farPlane = 1000.0f;
 float Renderer::nearPlane = 0.1f;
 
+UniformRingBuffer* Renderer::uniformRing = nullptr;
+UniformRingBuffer* Renderer::storageRing = nullptr;
+constexpr unsigned int uniformRingRegionSize = 4 * 1024 * 1024; // Per frame in flight, enough for ~8k draws at a 512 byte stride
+constexpr unsigned int storageRingRegionSize = 4 * 1024 * 1024; // Per frame in flight, shared by the bone palettes & light clusters
+
+RenderGraph Renderer::renderGraph;
+RenderGraphTexturePool* Renderer::renderGraphTextures = nullptr;
+
+SkinningPass* Renderer::skinningPass = nullptr;
 GeometryPass* Renderer::geometryPass = nullptr;
 EnvironmentMapPass* Renderer::envMapPass = nullptr;
 LightingPass* Renderer::lightingPass = nullptr;
@@ -73,7 +87,12 @@ void Renderer::Initialize(const Camera& camera, WindowSpecs* window)
 	Renderer::quad = new PrimitiveShape(ShapeType::Quad);
 	Renderer::cube = new PrimitiveShape(ShapeType::Cube);
 
-	geometryPass = new GeometryPass(windowDetails);
+	uniformRing = new UniformRingBuffer(uniformRingRegionSize);
+	storageRing = new UniformRingBuffer(storageRingRegionSize, 3, GL_SHADER_STORAGE_BUFFER);
+	renderGraphTextures = new RenderGraphTexturePool();
+
+	skinningPass = new SkinningPass();
+	geometryPass = new GeometryPass(windowDetails, uniformRing);
 
 	CascadedShadowMappingInfo csmInfo(view, camera.fov, nearPlane, farPlane);
 	csmInfo.windowSpecs = windowDetails;
@@ -81,7 +100,7 @@ void Renderer::Initialize(const Camera& camera, WindowSpecs* window)
 	shadowMappingPass = new CascadedShadowMapping(csmInfo);
 	envMapPass = new EnvironmentMapPass(windowDetails);
 	lightingPass = new LightingPass(windowDetails, shadowMappingPass->GetShadowMap(), shadowMappingPass->GetCascadeLevels());
-	forwardPass = new ForwardRenderPass(geometryPass->GetGBuffer());
+	forwardPass = new ForwardRenderPass(geometryPass->GetGBuffer(), uniformRing);
 	linePass = new LinePass();
 	terrainPass = new TerrainPass();
 	cloudPass = new CloudPass(100000.0f, 1000.0f, 3000.0f, 0.0004f, windowDetails);
@@ -90,10 +109,12 @@ void Renderer::Initialize(const Camera& camera, WindowSpecs* window)
 	dynamicCubeMapGenerator = new DynamicCubeMapRenderer(windowDetails);
 
 	EquirectangularToCubeMapConverter::Initialize();
+	LightManager::Initialize();
 }
 
 void Renderer::CleanUp()
 {
+	delete skinningPass;
 	delete geometryPass;
 	delete envMapPass;
 	delete lightingPass;
@@ -104,11 +125,15 @@ void Renderer::CleanUp()
 	delete dynamicCubeMapGenerator;
 	delete cloudPass;
 	delete grassPass;
+	delete uniformRing;
+	delete storageRing;
+	delete renderGraphTextures;
 
 	delete Renderer::quad;
 	delete Renderer::cube;
 
 	EquirectangularToCubeMapConverter::CleanUp();
+	LightManager::CleanUp();
 }
 
 void Renderer::SetViewType(uint32_t type)
@@ -123,7 +148,9 @@ void Renderer::SetViewType(uint32_t type)
 
 void Renderer::BeginFrame(const Camera& camera)
 {
-	Profiler::BeginProfile("BeginFrame");
+	PROFILE_ZONE("BeginFrame");
+
+	GLState::Invalidate(); // ImGui and anything else outside of the renderer may have changed the state since last frame
 
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -135,12 +162,22 @@ void Renderer::BeginFrame(const Camera& camera)
 	cameraDir = camera.front;
 	viewFrustum = FrustumUtils::CreateFrustumFromCamera(camera, aspect, farPlane, nearPlane);
 
-	Profiler::EndProfile("BeginFrame");
+	// Stream the camera data every pass shares, bound once for the whole frame
+	uniformRing->BeginFrame();
+	storageRing->BeginFrame();
+
+	FrameUniformData frameData;
+	frameData.projection = projection;
+	frameData.view = view;
+	frameData.cameraPosition = cameraPos;
+	frameData.time = (float)glfwGetTime();
+	unsigned int frameOffset = uniformRing->Push(frameData);
+	if (frameOffset != UniformRingBuffer::INVALID_OFFSET) uniformRing->BindRange(FRAME_UNIFORM_BLOCK_BINDING, frameOffset, sizeof(FrameUniformData));
 }
 
 void Renderer::EndFrame()
 {
-	Profiler::BeginProfile("EndFrame");
+	PROFILE_ZONE("EndFrame");
 
 	culledSubmissions.clear();
 	culledShadowSubmissions.clear();
@@ -151,59 +188,182 @@ void Renderer::EndFrame()
 	culledForwardSubmissions.clear();
 	lineSubmissions.clear();
 
-	glfwSwapBuffers(windowDetails->window);
-	Profiler::EndProfile("EndFrame");
+	uniformRing->EndFrame(); // Fence this frame's uniform data so it isn't overwritten while the GPU is still reading it
+	storageRing->EndFrame();
+
+	GLState::SubmitCounters();
+	if (NullRenderDevice::IsActive()) NullRenderDevice::EndFrame();
+
+	if (windowDetails->window) glfwSwapBuffers(windowDetails->window); // Headless runs don't have a window to present to
 }
 
 void Renderer::DrawFrame()
 {
-	Profiler::BeginProfile("DrawFrame");
+	PROFILE_ZONE("DrawFrame");
+
+	// Clusters go into the storage ring first, every lit pixel reads them. A crowd too big for what is left only loses its characters this frame
+	{
+		PROFILE_ZONE("LightClustering");
+		LightManager::BuildClusters(view, projection, nearPlane, farPlane, windowDetails, storageRing);
+	}
 
-	Profiler::BeginProfile("GeometryPass");
-	geometryPass->DoPass(culledSubmissions, culledAnimatedSubmissions, projection, view, cameraPos);
-	Profiler::EndProfile("GeometryPass");
+	UploadBonePalettes();
 
-	//Profiler::BeginProfile("TerrainPass");
-	//terrainPass->DoPass(geometryPass->GetGBuffer(), terrainInfo, projection, view, cameraPos);
-	//Profiler::EndProfile("TerrainPass");
+	// Declare this frame's passes and what they touch, the graph works out what actually has to run and in which order.
+	// The GBuffer, environment map & shadow maps are still owned by their passes, only the cloud targets are transient
+	renderGraph.Clear();
 
-	Profiler::BeginProfile("GrassPass");
-	grassPass->DoPass(geometryPass->GetGBuffer(), grassClusters, cameraPos, projection, view);
-	Profiler::EndProfile("GrassPass");
+	RenderGraphResource gBuffer = renderGraph.ImportResource("GBuffer");
+	RenderGraphResource environment = renderGraph.ImportResource("Environment");
+	RenderGraphResource shadowMaps = renderGraph.ImportResource("ShadowMaps");
+	RenderGraphResource backbuffer = renderGraph.ImportResource("Backbuffer");
+	RenderGraphResource skinnedVertices = renderGraph.ImportResource("SkinnedVertices");
+	RenderGraphResource sky = environment; // Without a light source there are no clouds, the lighting pass samples the plain environment instead
 
-	if (envMap1) // Only do env map pass if we have one
+	RenderGraphPass skinning = renderGraph.AddPass("SkinningPass", [&]()
+	{
+		skinningPass->DoPass(culledAnimatedSubmissions, culledAnimatedShadowSubmissions);
+	});
+	renderGraph.Write(skinning, skinnedVertices);
+
+	RenderGraphPass geometry = renderGraph.AddPass("GeometryPass", [&]()
+	{
+		geometryPass->DoPass(culledSubmissions, culledAnimatedSubmissions, projection, view, cameraPos);
+	});
+	renderGraph.Read(geometry, skinnedVertices);
+	renderGraph.Write(geometry, gBuffer);
+
+	//RenderGraphPass terrain = renderGraph.AddPass("TerrainPass", [&]()
+	//{
+	//	terrainPass->DoPass(geometryPass->GetGBuffer(), terrainInfo, projection, view, cameraPos);
+	//});
+	//renderGraph.Read(terrain, gBuffer);
+	//renderGraph.Write(terrain, gBuffer);
+
+	RenderGraphPass grass = renderGraph.AddPass("GrassPass", [&]()
 	{
-		glm::vec3 lightDir = mainLight ? mainLight->direction : glm::vec3(0.0f, 0.0f, 0.0f);
-		glm::vec3 lightColor = mainLight ? mainLight->color : glm::vec3(0.0f, 0.0f, 0.0f);
+		grassPass->DoPass(geometryPass->GetGBuffer(), grassClusters, viewFrustum, cameraPos, projection, view);
+	});
+	renderGraph.Read(grass, gBuffer); // Depth tested against what the geometry pass wrote
+	renderGraph.Write(grass, gBuffer);
 
-		Profiler::BeginProfile("EnvMapPass");
-		envMapPass->DoPass(envMap1, envMap2, environmentMixFactors, projection, view, mainLight, cameraPos, glm::normalize(lightDir), lightColor, cube);
-		Profiler::EndProfile("EnvMapPass");
+	if (envMap1) // Only do env map pass if we have one
+	{
+		RenderGraphPass envMap = renderGraph.AddPass("EnvMapPass", [&]()
+		{
+			glm::vec3 lightDir = mainLight ? mainLight->direction : glm::vec3(0.0f, 0.0f, 0.0f);
+			glm::vec3 lightColor = mainLight ? mainLight->color : glm::vec3(0.0f, 0.0f, 0.0f);
+			envMapPass->DoPass(envMap1, envMap2, environmentMixFactors, projection, view, mainLight, cameraPos, glm::normalize(lightDir), lightColor, cube);
+		});
+		renderGraph.Write(envMap, environment);
 	}
 
 	if (mainLight) // Can't do clouds & shadows without a light source
 	{
-		glm::vec3 lightDir = glm::normalize(mainLight->direction);
+		RenderGraphPass shadow = renderGraph.AddPass("ShadowPass", [&]()
+		{
+			shadowMappingPass->DoPass(culledShadowSubmissions, culledAnimatedShadowSubmissions, glm::normalize(mainLight->direction), projection, view, *quad);
+		});
+		renderGraph.Read(shadow, skinnedVertices);
+		renderGraph.Write(shadow, shadowMaps);
+
+		RenderGraphResource cloudColor = renderGraph.CreateTexture("CloudColor", CloudPass::GetCloudTargetDesc());
+		RenderGraphResource cloudBloom = renderGraph.CreateTexture("CloudBloom", CloudPass::GetCloudTargetDesc());
+		sky = renderGraph.CreateTexture("Sky", CloudPass::GetSkyTargetDesc(windowDetails));
+
+		RenderGraphPass clouds = renderGraph.AddPass("CloudPass", [&, cloudColor, cloudBloom, sky]()
+		{
+			cloudPass->DoPass(envMapPass->GetEnvironmentTexture(), geometryPass->GetPositionBuffer(), 
+				renderGraphTextures->GetTexture(renderGraph, cloudColor), renderGraphTextures->GetTexture(renderGraph, cloudBloom), renderGraphTextures->GetTexture(renderGraph, sky),
+				projection, view, cameraPos, glm::normalize(mainLight->direction), mainLight->color, cameraDir, windowDetails, quad);
+		});
+		renderGraph.Read(clouds, environment);
+		renderGraph.Read(clouds, gBuffer);
+		renderGraph.Write(clouds, cloudColor);
+		renderGraph.Write(clouds, cloudBloom);
+		renderGraph.Write(clouds, sky);
+	}
+
+	RenderGraphPass lighting = renderGraph.AddPass("LightingPass", [&, sky]()
+	{
+		ITexture* skyTexture = renderGraph.IsTransient(sky) ? renderGraphTextures->GetTexture(renderGraph, sky) : envMapPass->GetEnvironmentTexture();
+		lightingPass->DoPass(geometryPass->GetPositionBuffer(), geometryPass->GetAlbedoBuffer(), 
+			geometryPass->GetNormalBuffer(), geometryPass->GetEffectsBuffer(),
+			skyTexture, shadowMappingPass->GetSoftnessTexture(), projection, view, cameraPos, *quad);
+	});
+	renderGraph.Read(lighting, gBuffer);
+	renderGraph.Read(lighting, sky);
+	renderGraph.Read(lighting, shadowMaps);
+	renderGraph.Write(lighting, backbuffer);
+	renderGraph.SetSideEffect(lighting);
+
+	RenderGraphPass forward = renderGraph.AddPass("ForwardPass", [&]()
+	{
+		forwardPass->DoPass(culledForwardSubmissions, projection, view, windowDetails);
+	});
+	renderGraph.Read(forward, gBuffer); // Blits the GBuffer depth
+	renderGraph.Write(forward, backbuffer);
+	renderGraph.SetSideEffect(forward);
+
+	RenderGraphPass lines = renderGraph.AddPass("LinePass", [&]()
+	{
+		linePass->DoPass(lineSubmissions, projection, view, windowDetails);
+	});
+	renderGraph.Write(lines, backbuffer);
+	renderGraph.SetSideEffect(lines);
 
-		Profiler::BeginProfile("ShadowPass");
-		shadowMappingPass->DoPass(culledShadowSubmissions, culledAnimatedShadowSubmissions, lightDir, projection, view, *quad);
-		Profiler::EndProfile("ShadowPass");
+	if (renderGraph.Compile())
+	{
+		renderGraphTextures->Realize(renderGraph);
 
-		Profiler::BeginProfile("CloudPass");
-		cloudPass->DoPass(envMapPass->GetEnvironmentTexture(), geometryPass->GetPositionBuffer(), projection, view, cameraPos, lightDir, mainLight->color, cameraDir, windowDetails, quad);
-		Profiler::EndProfile("CloudPass");
+		for (RenderGraphPass pass : renderGraph.GetExecutionOrder())
+		{
+			PROFILE_ZONE(renderGraph.GetPassName(pass));
+			renderGraph.ExecutePass(pass);
+		}
 	}
-	
-	Profiler::BeginProfile("LightingPass");
-	lightingPass->DoPass(geometryPass->GetPositionBuffer(), geometryPass->GetAlbedoBuffer(), 
-		geometryPass->GetNormalBuffer(), geometryPass->GetEffectsBuffer(),
-		cloudPass->GetSkyTexture(), shadowMappingPass->GetSoftnessTexture(), projection, view, cameraPos, *quad);
-	Profiler::EndProfile("LightingPass");
+}
+
+void Renderer::UploadBonePalettes()
+{
+	// A mesh that is both visible and casting shadows shows up in both lists, only upload its palette once. Meshes the SkinningPass skins still need it here,
+	// the skinning shader reads it once per mesh & palette and the passes then draw the skinned vertices without it
+	std::unordered_map<const glm::mat4*, unsigned int> uploadedPalettes;
+	const unsigned int paletteStart = storageRing->GetRegionOffset() + storageRing->GetBytesUsed(); // The ring is shared, start after whatever was pushed before us
 
-	forwardPass->DoPass(culledForwardSubmissions, projection, view, windowDetails);
-	linePass->DoPass(lineSubmissions, projection, view, windowDetails);
+	std::vector<RenderSubmission>* submissionLists[2] = { &culledAnimatedSubmissions, &culledAnimatedShadowSubmissions };
+	for (std::vector<RenderSubmission>* submissions : submissionLists)
+	{
+		for (RenderSubmission& submission : *submissions)
+		{
+			if (submission.boneMatricesLength == 0) continue;
+
+			std::unordered_map<const glm::mat4*, unsigned int>::iterator it = uploadedPalettes.find(submission.boneMatrices);
+			if (it != uploadedPalettes.end())
+			{
+				submission.boneOffset = it->second;
+				continue;
+			}
+
+			unsigned int offset = storageRing->Push(submission.boneMatrices, sizeof(glm::mat4) * submission.boneMatricesLength);
+			if (offset == UniformRingBuffer::INVALID_OFFSET) // Out of space, the character isn't drawn this frame
+			{
+				submission.boneOffset = UniformRingBuffer::INVALID_OFFSET;
+				continue;
+			}
+
+			submission.boneOffset = (offset - paletteStart) / sizeof(glm::mat4); // Shaders index matrices relative to the start of the bound range
+			uploadedPalettes.insert({ submission.boneMatrices, submission.boneOffset });
+		}
+
+		submissions->erase(std::remove_if(submissions->begin(), submissions->end(), [](const RenderSubmission& submission) { return submission.boneMatricesLength > 0 && submission.boneOffset == UniformRingBuffer::INVALID_OFFSET; }), submissions->end());
+	}
 
-	Profiler::EndProfile("DrawFrame");
+	unsigned int paletteSize = storageRing->GetRegionOffset() + storageRing->GetBytesUsed() - paletteStart;
+	if (paletteSize > 0)
+	{
+		storageRing->BindRange(BONE_PALETTE_STORAGE_BINDING, paletteStart, paletteSize);
+	}
 }
 
 CubeMap* Renderer::GenerateDynamicCubeMap(const glm::vec3& center, ReflectRefractMapPriorityType meshPriority, RenderComponent* ignore, int viewportWidth, int viewportHeight)
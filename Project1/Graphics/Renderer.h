@@ -8,7 +8,11 @@
 #include "CubeMap.h"
 #include "Texture3D.h"
 #include "SimpleFastVector.h"
+#include "UniformRingBuffer.h"
+#include "RenderGraph.h"
+#include "RenderGraphTexturePool.h"
 
+#include "SkinningPass.h"
 #include "GeometryPass.h"
 #include "EnvironmentMapPass.h"
 #include "LightingPass.h"
@@ -23,6 +27,7 @@
 #include "TerrainGenerationInfo.h"
 #include "GrassCluster.h"
 #include "ProceduralGrassPass.h"
+#include "MeshLOD.h"
 
 #include <vector>
 #include <unordered_map>
@@ -53,6 +58,9 @@ public:
 	static std::vector<GrassCluster>& GetGrassClusters() { return grassClusters; }
 
 	static CloudPass* GetCloudPass() { return cloudPass; }
+	static SkinningPass* GetSkinningPass() { return skinningPass; }
+
+	static MeshLODSelection& GetLODSelection() { return lodSelection; }
 
 	static const std::string LIGHTING_SHADER_KEY;
 	static const std::string FORWARD_SHADER_KEY;
@@ -67,6 +75,8 @@ public:
 private:
 	friend class GameEngine;
 
+	static void UploadBonePalettes();
+
 	const static WindowSpecs* windowDetails;
 
 	static std::vector<RenderSubmission> culledShadowSubmissions;
@@ -81,11 +91,19 @@ private:
 	static glm::vec3 cameraPos;
 	static Frustum viewFrustum;
 	static float shadowCullRadius;
+	static MeshLODSelection lodSelection;
 
 	static float farPlane;
 	static float nearPlane;
 
+	static UniformRingBuffer* uniformRing; // Streams the per-frame and per-draw uniform blocks
+	static UniformRingBuffer* storageRing; // Streams per frame shader storage data (bone palettes, light clusters)
+
+	static RenderGraph renderGraph; // Rebuilt every frame in DrawFrame
+	static RenderGraphTexturePool* renderGraphTextures;
+
 	// Render Pass Objects
+	static SkinningPass* skinningPass;
 	static GeometryPass* geometryPass;
 	static EnvironmentMapPass* envMapPass;
 	static LightingPass* lightingPass;
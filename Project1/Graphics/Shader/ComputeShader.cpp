@@ -37,6 +37,8 @@ ComputeShader::ComputeShader(const std::string& path)
 	glLinkProgram(ID);
 	if (Shader::WasThereALinkError(ID)) return;
 
+	ResolveUniforms();
+
 	size_t index = path.find_last_of('/');
 	if (index == std::string::npos) // Not found, try blackslash
 	{
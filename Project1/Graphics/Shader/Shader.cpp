@@ -1,4 +1,5 @@
 #include "Shader.h"
+#include "GLState.h"
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -272,27 +273,70 @@ Shader::Shader(const std::string& path)
 		fileName = path.substr(index + 1);
 	}
 
-	WasThereALinkError(ID);
+	if (WasThereALinkError(ID)) return;
+
+	ResolveUniforms();
 }
 
 Shader::~Shader()
 {
+	GLState::OnProgramDeleted(ID);
 	glDeleteProgram(ID);
 }
 
 void Shader::InitializeUniform(const std::string& name)
 {
+	if (uniforms.find(name) != uniforms.end()) return; // Already resolved when the program was linked
+
 	uniforms.insert({ name, glGetUniformLocation(ID, name.c_str()) });
 }
 
+void Shader::ResolveUniforms()
+{
+	GLint uniformCount = 0;
+	GLint maxNameLength = 0;
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+	glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxNameLength);
+	if (uniformCount <= 0 || maxNameLength <= 0) return;
+
+	std::vector<char> nameBuffer(maxNameLength);
+	for (GLint i = 0; i < uniformCount; i++)
+	{
+		GLsizei nameLength = 0;
+		GLint arraySize = 0;
+		GLenum type = 0;
+		glGetActiveUniform(ID, (GLuint)i, maxNameLength, &nameLength, &arraySize, &type, nameBuffer.data());
+
+		std::string name(nameBuffer.data(), nameLength);
+		GLint location = glGetUniformLocation(ID, name.c_str());
+		if (location == -1) continue; // Members of uniform blocks don't have a location
+
+		uniforms.insert({ name, location });
+
+		// Arrays are reported once as "name[0]", register the base name and every element so they can be looked up individually
+		const std::string arraySuffix = "[0]";
+		if (name.size() > arraySuffix.size() && name.compare(name.size() - arraySuffix.size(), arraySuffix.size(), arraySuffix) == 0)
+		{
+			std::string baseName = name.substr(0, name.size() - arraySuffix.size());
+			uniforms.insert({ baseName, location });
+
+			for (GLint j = 1; j < arraySize; j++)
+			{
+				std::string elementName = baseName + "[" + std::to_string(j) + "]";
+				uniforms.insert({ elementName, glGetUniformLocation(ID, elementName.c_str()) });
+			}
+		}
+	}
+}
+
 void Shader::Bind() const
 {
-	glUseProgram(ID);
+	GLState::UseProgram(ID);
 }
 
 void Shader::Unbind() const
 {
-	glUseProgram(0);
+	GLState::UseProgram(0);
 }
 
 GLuint Shader::GetUniformLocation(const std::string& name) const
@@ -306,6 +350,17 @@ GLuint Shader::GetUniformLocation(const std::string& name) const
 	return uniforms.at(name);
 }
 
+UniformHandle Shader::GetUniform(const std::string& name) const
+{
+	std::unordered_map<std::string, GLuint>::const_iterator it = uniforms.find(name);
+	if (it == uniforms.end()) // Either misspelled or optimized out by the compiler, setting an invalid handle is a no-op
+	{
+		return UniformHandle();
+	}
+
+	return UniformHandle((GLint)it->second);
+}
+
 void Shader::SetInt(const std::string& name, int value) const
 {
 	glUniform1i(GetUniformID(name), value);
@@ -341,12 +396,57 @@ void Shader::SetMat4(const std::string& name, const glm::mat4& value) const
 	glUniformMatrix4fv(GetUniformID(name), 1, GL_FALSE, glm::value_ptr(value));
 }
 
+void Shader::SetInt(UniformHandle uniform, int value) const
+{
+	glUniform1i(uniform.location, value);
+}
+
+void Shader::SetIntArray(UniformHandle uniform, const int* values, uint32_t count) const
+{
+	glUniform1iv(uniform.location, count, values);
+}
+
+void Shader::SetFloat(UniformHandle uniform, float value) const
+{
+	glUniform1f(uniform.location, value);
+}
+
+void Shader::SetFloatArray(UniformHandle uniform, const float* values, uint32_t count) const
+{
+	glUniform1fv(uniform.location, count, values);
+}
+
+void Shader::SetFloat2(UniformHandle uniform, const glm::vec2& value) const
+{
+	glUniform2f(uniform.location, value.x, value.y);
+}
+
+void Shader::SetFloat3(UniformHandle uniform, const glm::vec3& value) const
+{
+	glUniform3f(uniform.location, value.x, value.y, value.z);
+}
+
+void Shader::SetFloat4(UniformHandle uniform, const glm::vec4& value) const
+{
+	glUniform4f(uniform.location, value.x, value.y, value.z, value.w);
+}
+
+void Shader::SetMat4(UniformHandle uniform, const glm::mat4& value) const
+{
+	glUniformMatrix4fv(uniform.location, 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void Shader::SetMat4Array(UniformHandle uniform, const glm::mat4* values, uint32_t count) const
+{
+	glUniformMatrix4fv(uniform.location, count, GL_FALSE, glm::value_ptr(values[0]));
+}
+
 GLuint Shader::GetUniformID(const std::string& name) const
 {
 	if (uniforms.count(name) <= 0)
 	{
 		std::cout << "Uniform location '" << name << "' does not exist in shader " << fileName << std::endl;
-		return 0;
+		return (GLuint)-1; // Location -1 is silently ignored by glUniform*, 0 would overwrite a real uniform
 	}
 
 	return uniforms.at(name);
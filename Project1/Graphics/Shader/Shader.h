@@ -17,6 +17,17 @@ enum class ShaderSourceType
 	TessellationEvaluation
 };
 
+// A uniform location that has already been resolved. Grab these once (ex. in a render pass constructor) and use them in place of the string setters
+struct UniformHandle
+{
+	UniformHandle() : location(-1) {}
+	explicit UniformHandle(GLint location) : location(location) {}
+
+	bool IsValid() const { return location != -1; }
+
+	GLint location;
+};
+
 class Shader
 {
 public:
@@ -28,6 +39,7 @@ public:
 	const std::string& GetFileName() const {return fileName; }
 
 	GLuint GetUniformLocation(const std::string& name) const;
+	UniformHandle GetUniform(const std::string& name) const;
 
 	void SetInt(const std::string& name, int value) const;
 	void SetIntArray(const std::string& name, int* values, uint32_t count) const;
@@ -37,6 +49,16 @@ public:
 	void SetFloat4(const std::string& name, const glm::vec4& value) const;
 	void SetMat4(const std::string& name, const glm::mat4& value) const;
 
+	void SetInt(UniformHandle uniform, int value) const;
+	void SetIntArray(UniformHandle uniform, const int* values, uint32_t count) const;
+	void SetFloat(UniformHandle uniform, float value) const;
+	void SetFloatArray(UniformHandle uniform, const float* values, uint32_t count) const;
+	void SetFloat2(UniformHandle uniform, const glm::vec2& value) const;
+	void SetFloat3(UniformHandle uniform, const glm::vec3& value) const;
+	void SetFloat4(UniformHandle uniform, const glm::vec4& value) const;
+	void SetMat4(UniformHandle uniform, const glm::mat4& value) const;
+	void SetMat4Array(UniformHandle uniform, const glm::mat4* values, uint32_t count) const;
+
 	static bool WasThereACompileError(const GLuint& shaderID, const std::string& filePath);
 	static bool WasThereALinkError(const GLuint& programID);
 
@@ -48,6 +70,7 @@ protected:
 	virtual ~Shader();
 
 	GLuint GetUniformID(const std::string& name) const;
+	void ResolveUniforms(); // Caches the location of every active uniform, should be called right after the program is linked
 
 	GLuint ID;
 	std::string fileName;
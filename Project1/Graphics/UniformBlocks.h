@@ -0,0 +1,46 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// Binding points for uniform blocks. 0 is taken by uLightSpaceMatrices (found in CascadedShadowMapping.h)
+constexpr unsigned int FRAME_UNIFORM_BLOCK_BINDING = 1;
+constexpr unsigned int DRAW_UNIFORM_BLOCK_BINDING = 2;
+
+// Shader storage binding points are separate from the uniform block ones
+constexpr unsigned int BONE_PALETTE_STORAGE_BINDING = 0; // Every animated mesh's bone matrices for the frame, indexed by uBoneOffset
+constexpr unsigned int LIGHT_STORAGE_BINDING = 1; // Every light, packed (found in LightManager.h)
+constexpr unsigned int LIGHT_CLUSTER_STORAGE_BINDING = 2; // Offset & count into the light index list for each cluster
+constexpr unsigned int LIGHT_INDEX_STORAGE_BINDING = 3; // Light indices for all clusters, back to back
+constexpr unsigned int SKINNING_SOURCE_STORAGE_BINDING = 4; // The compressed vertex buffer of the mesh being skinned (found in SkinningPass.h)
+constexpr unsigned int SKINNING_OUTPUT_STORAGE_BINDING = 5; // The frame's skinned vertex buffer
+
+// CPU mirror of the uFrameData block (std140). Written once per frame by Renderer and shared by every pass
+struct FrameUniformData
+{
+	glm::mat4 projection;
+	glm::mat4 view;
+	glm::vec3 cameraPosition;
+	float time;
+};
+
+// CPU mirror of the uDrawData block (std140). Written once per mesh draw by the geometry and forward passes
+struct DrawUniformData
+{
+	glm::mat4 model;
+	glm::mat4 projViewModel;
+	glm::mat4 prevProjViewModel;
+	glm::vec4 colorOverride;
+	glm::vec4 albedoRatios;
+	glm::vec4 materialOverrides;
+	glm::vec4 rrInfo;
+	glm::vec2 uvOffset;
+	float shadowSoftness;
+	float alphaTransparency;
+	int hasNormalTexture; // GLSL bools are 4 bytes in std140
+	int ignoreLighting;
+	int boneOffset; // Index of this draw's first matrix in the bone palette buffer
+	int boneCount;
+};
+
+static_assert(sizeof(FrameUniformData) == 144, "FrameUniformData no longer matches the std140 layout of uFrameData");
+static_assert(sizeof(DrawUniformData) == 288, "DrawUniformData no longer matches the std140 layout of uDrawData");
\ No newline at end of file
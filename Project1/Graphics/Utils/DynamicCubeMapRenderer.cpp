@@ -7,6 +7,7 @@
 #include "Utils.h"
 #include "EnvironmentMapPass.h"
 #include "RenderBuffer.h"
+#include "GLState.h"
 
 constexpr unsigned int dynamicMapResolution = 512;
 
@@ -25,23 +26,23 @@ DynamicCubeMapRenderer::DynamicCubeMapRenderer(const WindowSpecs* windowSpecs)
 	frameBuffer->Unbind();
 
 	shader->Bind();
-	shader->InitializeUniform("uMatModel");
-	shader->InitializeUniform("uMatView");
-	shader->InitializeUniform("uMatProjection");
-	shader->InitializeUniform("uAlbedoTexture1");
-	shader->InitializeUniform("uAlbedoTexture2");
-	shader->InitializeUniform("uAlbedoTexture3");
-	shader->InitializeUniform("uAlbedoTexture4");
-	shader->InitializeUniform("uAlbedoRatios");
-	shader->InitializeUniform("uColorOverride");
-	shader->InitializeUniform("uHasNormalTexture");
-	shader->InitializeUniform("uNormalTexture");
+	uniforms.matView = shader->GetUniform("uMatView");
+	uniforms.matProjection = shader->GetUniform("uMatProjection");
+	uniforms.matModel = shader->GetUniform("uMatModel");
+	uniforms.colorOverride = shader->GetUniform("uColorOverride");
+	for (int i = 0; i < 4; i++)
+	{
+		uniforms.albedoTextures[i] = shader->GetUniform("uAlbedoTexture" + std::to_string(i + 1));
+	}
+	uniforms.albedoRatios = shader->GetUniform("uAlbedoRatios");
+	uniforms.hasNormalTexture = shader->GetUniform("uHasNormalTexture");
+	uniforms.normalTexture = shader->GetUniform("uNormalTexture");
 	shader->Unbind();
 
 	conversionShader->Bind();
-	conversionShader->InitializeUniform("uFaceBuffer");
-	conversionShader->InitializeUniform("uEnvMap");
-	conversionShader->InitializeUniform("uCubeFace");
+	conversionUniforms.envMap = conversionShader->GetUniform("uEnvMap");
+	conversionUniforms.faceBuffer = conversionShader->GetUniform("uFaceBuffer");
+	conversionUniforms.cubeFace = conversionShader->GetUniform("uCubeFace");
 	conversionShader->Unbind();
 }
 
@@ -84,15 +85,15 @@ CubeMap* DynamicCubeMapRenderer::GenerateDynamicCubeMap(const glm::vec3& center,
 
 		frameBuffer->Bind();
 
-		glEnable(GL_DEPTH_TEST); // Enable depth test when drawing scene
-		glEnable(GL_CULL_FACE);
-		glCullFace(GL_BACK);
+		GLState::Enable(GL_DEPTH_TEST); // Enable depth test when drawing scene
+		GLState::Enable(GL_CULL_FACE);
+		GLState::CullFace(GL_BACK);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		// Draw geometry
 		shader->Bind();
-		shader->SetMat4("uMatView", view);
-		shader->SetMat4("uMatProjection", projection);
+		shader->SetMat4(uniforms.matView, view);
+		shader->SetMat4(uniforms.matProjection, projection);
 
 		frameBuffer->ClearColorBuffer(glm::vec4(0.0f, 0.0f, 0.0f, 1.0f)); // Make sure we clear the color buffer with 1.0 at index w incase there is no geometry
 
@@ -100,16 +101,16 @@ CubeMap* DynamicCubeMapRenderer::GenerateDynamicCubeMap(const glm::vec3& center,
 		{
 			RenderComponent* renderComponent = submissions->renderComponent;
 
-			shader->SetMat4("uMatModel", submissions->transform);
+			shader->SetMat4(uniforms.matModel, submissions->transform);
 
 			// Diffuse color
 			if (renderComponent->isColorOverride)
 			{
-				shader->SetFloat4("uColorOverride", glm::vec4(renderComponent->colorOverride.x, renderComponent->colorOverride.y, renderComponent->colorOverride.z, 1.0f));
+				shader->SetFloat4(uniforms.colorOverride, glm::vec4(renderComponent->colorOverride.x, renderComponent->colorOverride.y, renderComponent->colorOverride.z, 1.0f));
 			}
 			else // Bind diffuse textures
 			{
-				shader->SetFloat4("uColorOverride", glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
+				shader->SetFloat4(uniforms.colorOverride, glm::vec4(0.0f, 0.0f, 0.0f, 0.0f));
 
 				float ratios[4];
 				for (int i = 0; i < 4; i++)
@@ -117,7 +118,7 @@ CubeMap* DynamicCubeMapRenderer::GenerateDynamicCubeMap(const glm::vec3& center,
 					if (i < renderComponent->albedoTextures.size())
 					{
 						renderComponent->albedoTextures[i].first->BindToSlot(i);
-						shader->SetInt(std::string("uAlbedoTexture" + std::to_string(i + 1)), i);
+						shader->SetInt(uniforms.albedoTextures[i], i);
 						ratios[i] = renderComponent->albedoTextures[i].second;
 					}
 					else
@@ -125,24 +126,22 @@ CubeMap* DynamicCubeMapRenderer::GenerateDynamicCubeMap(const glm::vec3& center,
 						ratios[i] = 0.0f;
 					}
 				}
-				shader->SetFloat4("uAlbedoRatios", glm::vec4(ratios[0], ratios[1], ratios[2], ratios[3]));
+				shader->SetFloat4(uniforms.albedoRatios, glm::vec4(ratios[0], ratios[1], ratios[2], ratios[3]));
 			}
 
 			// Normals
 			if (renderComponent->normalTexture)
 			{
-				shader->SetInt("uHasNormalTexture", GL_TRUE);
+				shader->SetInt(uniforms.hasNormalTexture, GL_TRUE);
 				renderComponent->normalTexture->BindToSlot(4);
-				shader->SetInt("uNormalTexture", 4);
+				shader->SetInt(uniforms.normalTexture, 4);
 			}
 			else
 			{
-				shader->SetInt("uHasNormalTexture", GL_FALSE);
+				shader->SetInt(uniforms.hasNormalTexture, GL_FALSE);
 			}
 
-			renderComponent->mesh->GetVertexArray()->Bind();
-			glDrawElements(GL_TRIANGLES, renderComponent->mesh->GetIndexBuffer()->GetCount(), GL_UNSIGNED_INT, 0);
-			renderComponent->mesh->GetVertexArray()->Unbind();
+			renderComponent->Draw(shader, UniformHandle(), submissions->transform, renderComponent->lod, submissions->skinnedVertexArray, submissions->skinnedVertexStart); // Model matrix was already set above, animated meshes are drawn posed once skinned
 		}
 
 		frameBuffer->Unbind();
@@ -151,19 +150,19 @@ CubeMap* DynamicCubeMapRenderer::GenerateDynamicCubeMap(const glm::vec3& center,
 		cubeMapFrameBuffer->Bind();
 		conversionShader->Bind();
 
-		glDisable(GL_DEPTH_TEST); // Disable depth test when cube map face
-		glDisable(GL_CULL_FACE);
+		GLState::Disable(GL_DEPTH_TEST); // Disable depth test when cube map face
+		GLState::Disable(GL_CULL_FACE);
 
 		cubeMapFrameBuffer->AddColorAttachmentCubeMapFace("cubeFace", cubeMap, 0, (CubeMapFace)cubeMapIndex);
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 		Renderer::envMap1->BindToSlot(0);
-		conversionShader->SetInt("uEnvMap", 0);
+		conversionShader->SetInt(conversionUniforms.envMap, 0);
 
 		frameBuffer->GetColorAttachment("environment")->BindToSlot(1);
-		conversionShader->SetInt("uFaceBuffer", 1);
+		conversionShader->SetInt(conversionUniforms.faceBuffer, 1);
 
-		conversionShader->SetInt("uCubeFace", cubeMapIndex); // Tell shader what face we are mapping to
+		conversionShader->SetInt(conversionUniforms.cubeFace, cubeMapIndex); // Tell shader what face we are mapping to
 
 		quad.Draw();
 
@@ -31,5 +31,24 @@ private:
 	Shader* shader;
 	Shader* conversionShader;
 
+	struct ShaderUniforms
+	{
+		UniformHandle matView;
+		UniformHandle matProjection;
+		UniformHandle matModel;
+		UniformHandle colorOverride;
+		UniformHandle albedoTextures[4];
+		UniformHandle albedoRatios;
+		UniformHandle hasNormalTexture;
+		UniformHandle normalTexture;
+	} uniforms;
+
+	struct ConversionUniforms
+	{
+		UniformHandle envMap;
+		UniformHandle faceBuffer;
+		UniformHandle cubeFace;
+	} conversionUniforms;
+
 	PrimitiveShape quad;
 };
\ No newline at end of file
@@ -1,9 +1,12 @@
 #include "EquirectangularToCubeMapConverter.h"
 #include "ShaderLibrary.h"
 #include "FrameBuffer.h"
+#include "GLState.h"
 
 const std::string EquirectangularToCubeMapConverter::CUBE_MAP_CONVERT_SHADER_KEY = "hdrToCubeShader";
 Shader* EquirectangularToCubeMapConverter::conversionShader = nullptr;
+UniformHandle EquirectangularToCubeMapConverter::projectionUniform;
+UniformHandle EquirectangularToCubeMapConverter::viewUniform;
 IFrameBuffer* EquirectangularToCubeMapConverter::cubeMapBuffer = nullptr;
 
 void EquirectangularToCubeMapConverter::Initialize()
@@ -12,11 +15,8 @@ void EquirectangularToCubeMapConverter::Initialize()
 	cubeMapBuffer = new FrameBuffer();
 
 	// Setup conversion shader uniforms
-	conversionShader->Bind();
-	conversionShader->InitializeUniform("uProjection");
-	conversionShader->InitializeUniform("uView");
-	conversionShader->InitializeUniform("uEnvMap");
-	conversionShader->Unbind();
+	projectionUniform = conversionShader->GetUniform("uProjection");
+	viewUniform = conversionShader->GetUniform("uView");
 }
 
 void EquirectangularToCubeMapConverter::CleanUp()
@@ -26,7 +26,7 @@ void EquirectangularToCubeMapConverter::CleanUp()
 
 void EquirectangularToCubeMapConverter::ConvertEquirectangularToCubeMap(Texture2D* envMapHDR, CubeMap* cubeMap, PrimitiveShape* cube, unsigned int nativeWidth, unsigned int nativeHeight)
 {
-	glDisable(GL_CULL_FACE); // Make sure none of our cubes faces get culled
+	GLState::Disable(GL_CULL_FACE); // Make sure none of our cubes faces get culled
 
 	// Convert the HDR equirectangular texture to its cube map equivalent
 	{
@@ -43,7 +43,7 @@ void EquirectangularToCubeMapConverter::ConvertEquirectangularToCubeMap(Texture2
 		};
 
 		conversionShader->Bind();
-		conversionShader->SetMat4("uProjection", captureProjection);
+		conversionShader->SetMat4(projectionUniform, captureProjection);
 
 		envMapHDR->BindToSlot(0);
 
@@ -52,7 +52,7 @@ void EquirectangularToCubeMapConverter::ConvertEquirectangularToCubeMap(Texture2
 		cubeMapBuffer->Bind();
 		for (int i = 0; i < 6; i++) // Setup all faces of the cube
 		{
-			conversionShader->SetMat4("uView", captureViews[i]);
+			conversionShader->SetMat4(viewUniform, captureViews[i]);
 			cubeMapBuffer->AddColorAttachmentCubeMapFace("cubeFace", cubeMap, 0, (CubeMapFace)i);
 			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 			cube->Draw();
@@ -63,5 +63,5 @@ void EquirectangularToCubeMapConverter::ConvertEquirectangularToCubeMap(Texture2
 	}
 
 	glViewport(0, 0, nativeWidth, nativeHeight); // Set viewport back to native width/height
-	glEnable(GL_CULL_FACE); // Re-enable face culling
+	GLState::Enable(GL_CULL_FACE); // Re-enable face culling
 }
\ No newline at end of file
@@ -20,5 +20,7 @@ public:
 
 private:
 	static Shader* conversionShader;
+	static UniformHandle projectionUniform;
+	static UniformHandle viewUniform;
 	static IFrameBuffer* cubeMapBuffer;
 };
\ No newline at end of file
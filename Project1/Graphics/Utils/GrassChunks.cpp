@@ -0,0 +1,116 @@
+#include "GrassChunks.h"
+#include "AABB.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace GrassChunkUtils
+{
+	std::vector<GrassChunk> BuildChunks(std::vector<glm::vec4>& grassData, float chunkSize)
+	{
+		std::vector<GrassChunk> chunks;
+		if (grassData.empty() || chunkSize <= 0.0f) return chunks;
+
+		// Bucket the blades by the chunk cell they fall into, the map keeps the cells in a stable order
+		std::map<std::pair<int, int>, std::vector<glm::vec4>> cells;
+		for (const glm::vec4& blade : grassData)
+		{
+			std::pair<int, int> cell((int)std::floor(blade.x / chunkSize), (int)std::floor(blade.z / chunkSize));
+			cells[cell].push_back(blade);
+		}
+
+		std::mt19937 random(1337); // Fixed seed, the same data always ends up in the same order
+		grassData.clear();
+		chunks.reserve(cells.size());
+
+		std::map<std::pair<int, int>, std::vector<glm::vec4>>::iterator it;
+		for (it = cells.begin(); it != cells.end(); it++)
+		{
+			std::vector<glm::vec4>& blades = it->second;
+			std::shuffle(blades.begin(), blades.end(), random);
+
+			GrassChunk chunk;
+			chunk.min = glm::vec3(blades[0]);
+			chunk.max = glm::vec3(blades[0]);
+			chunk.first = (unsigned int)grassData.size();
+			chunk.count = (unsigned int)blades.size();
+
+			for (const glm::vec4& blade : blades)
+			{
+				chunk.min = glm::min(chunk.min, glm::vec3(blade));
+				chunk.max = glm::max(chunk.max, glm::vec3(blade));
+				grassData.push_back(blade);
+			}
+
+			chunks.push_back(chunk);
+		}
+
+		return chunks;
+	}
+
+	float GetDistanceToChunk(const GrassChunk& chunk, const glm::vec3& point)
+	{
+		glm::vec3 closest = glm::clamp(point, chunk.min, chunk.max);
+		return glm::length(point - closest);
+	}
+
+	unsigned int SelectStride(float distance, const GrassLODSettings& settings)
+	{
+		if (distance > settings.maxDrawDistance) return 0;
+
+		unsigned int stride = 1;
+		float band = settings.fullDensityDistance;
+		while (distance > band && stride < settings.maxStride)
+		{
+			stride *= 2;
+			band *= 2.0f;
+		}
+
+		return stride;
+	}
+
+	unsigned int BuildDrawCommands(const std::vector<GrassChunk>& chunks, const Frustum& frustum, const glm::vec3& cameraPos, const GrassLODSettings& settings, std::vector<GrassDrawCommand>& commands)
+	{
+		const glm::vec3 padding(settings.bladePadding);
+		unsigned int bladeCount = 0;
+		bool previousFullDensity = false;
+
+		for (const GrassChunk& chunk : chunks)
+		{
+			if (chunk.count == 0) continue;
+
+			const AABB bounds(chunk.min - padding, chunk.max + padding, false); // Already in world space
+			const IBoundingVolume& volume = bounds;
+			unsigned int stride = volume.IsOnFrustum(frustum) ? SelectStride(GetDistanceToChunk(chunk, cameraPos), settings) : 0;
+			if (stride == 0)
+			{
+				previousFullDensity = false;
+				continue;
+			}
+
+			unsigned int count = (chunk.count + stride - 1) / stride; // Blades are shuffled within the chunk, so any prefix is an even thinning
+			bladeCount += count;
+
+			// Chunks are contiguous in the buffer, a full density chunk right after another one can extend its command
+			if (stride == 1 && previousFullDensity && commands.back().first + commands.back().count == chunk.first)
+			{
+				commands.back().count += count;
+				continue;
+			}
+
+			GrassDrawCommand command;
+			command.count = count;
+			command.instanceCount = 1;
+			command.first = chunk.first;
+			command.baseInstance = 0;
+			commands.push_back(command);
+
+			previousFullDensity = stride == 1;
+		}
+
+		return bladeCount;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Frustum.h"
+
+#include <glm/glm.hpp>
+#include <vector>
+
+// A square (on the XZ plane) piece of a grass cluster. Its blades are a contiguous range of the cluster's grass data
+struct GrassChunk
+{
+	glm::vec3 min; // Bounds of the blade roots, the blades themselves stick out above them
+	glm::vec3 max;
+	unsigned int first;
+	unsigned int count;
+};
+
+// Laid out the way glMultiDrawArraysIndirect reads its commands
+struct GrassDrawCommand
+{
+	unsigned int count;
+	unsigned int instanceCount;
+	unsigned int first;
+	unsigned int baseInstance;
+};
+
+struct GrassLODSettings
+{
+	float fullDensityDistance; // Chunks closer than this draw every blade, the blade stride doubles every time the distance does
+	float maxDrawDistance; // Chunks further away than this aren't drawn
+	unsigned int maxStride;
+	float bladePadding; // How far blades can reach past their root, added to the chunk bounds before culling
+};
+
+// Everything here is CPU only so the chunking, culling & LOD selection can be run without a GL context
+namespace GrassChunkUtils
+{
+	// Reorders grassData so each chunk's blades are contiguous and shuffles the blades within every chunk,
+	// so drawing the first count / stride blades of a chunk thins it out evenly instead of dropping one side of it
+	std::vector<GrassChunk> BuildChunks(std::vector<glm::vec4>& grassData, float chunkSize);
+
+	float GetDistanceToChunk(const GrassChunk& chunk, const glm::vec3& point);
+	unsigned int SelectStride(float distance, const GrassLODSettings& settings); // 0 if the chunk is too far away to draw
+
+	// Culls the chunks against the frustum and appends one command per visible chunk to commands, neighbouring chunks drawn at full density share a command.
+	// Returns how many blades the commands draw
+	unsigned int BuildDrawCommands(const std::vector<GrassChunk>& chunks, const Frustum& frustum, const glm::vec3& cameraPos, const GrassLODSettings& settings, std::vector<GrassDrawCommand>& commands);
+}
\ No newline at end of file
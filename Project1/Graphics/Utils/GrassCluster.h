@@ -2,6 +2,7 @@
 
 #include "VertexArrayObject.h"
 #include "Texture2D.h"
+#include "GrassChunks.h"
 
 #include <glm/glm.hpp>
 
@@ -20,6 +21,12 @@ struct GrassCluster
 
 	std::vector<glm::vec4> grassData; // xyz = root pos, w = rotation angle
 
+	std::vector<GrassChunk> chunks; // Built (and grassData reordered to match) the first time the cluster is drawn
+	float chunkSize = 16.0f;
+	float fullDensityDistance = 100.0f; // Every blade is drawn up to here, then half as many blades every time the distance doubles
+	float maxDrawDistance = 1500.0f;
+	unsigned int maxLODStride = 16;
+
 	glm::vec2 windDirection = glm::vec2(0.3f, 0.9f);
 	float oscillationStrength = 2.5f;
 	float windForceMult = 1.0f;
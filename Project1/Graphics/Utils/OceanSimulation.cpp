@@ -0,0 +1,327 @@
+#include "OceanSimulation.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+static const float ONE_OVER_SQRT_2 = 0.7071067f;
+static const float TWO_PI = 6.283185f;
+
+static const unsigned int ROW_BATCH_SIZE = 16;
+
+static bool IsPowerOfTwo(unsigned int value)
+{
+	return value != 0 && (value & (value - 1)) == 0;
+}
+
+float OceanSimulation::Phillips(const glm::vec2& k, const glm::vec2& windDir, float windSpeed, float amplitude, float gravityAccel)
+{
+	float largestWave = (windSpeed * windSpeed) / gravityAccel; // Compute largest possible wave for wind speed
+	float suppressedValue = largestWave / 1000.0f; // Supress waves smaller than this
+
+	float kDotDir = glm::dot(k, windDir);
+	float k2 = glm::dot(k, k);
+
+	float phillips = amplitude * (expf(-1.0f / (k2 * largestWave * largestWave))) / (k2 * k2 * k2) * (kDotDir * kDotDir);
+
+	if (kDotDir < 0.0f)
+	{
+		phillips *= 0.07f; // Wave is moving against the wind direction
+	}
+
+	return phillips * expf(-k2 * suppressedValue * suppressedValue);
+}
+
+OceanSimulation::OceanSimulation(const OceanSettings& settings)
+	: log2Resolution(0),
+	currentFrame(0),
+	simulatedFrames(0)
+{
+	SetSettings(settings);
+}
+
+void OceanSimulation::SetSettings(const OceanSettings& newSettings)
+{
+	settings = newSettings;
+
+	if (!IsPowerOfTwo(settings.resolution) || settings.resolution < MIN_RESOLUTION || settings.resolution > MAX_RESOLUTION)
+	{
+		std::cout << "Ocean resolution " << settings.resolution << " isn't a power of two between " << MIN_RESOLUTION << " and " << MAX_RESOLUTION << ", using 256.\n";
+		settings.resolution = 256;
+	}
+
+	const unsigned int N = settings.resolution;
+	log2Resolution = 0;
+	while ((1u << log2Resolution) < N) log2Resolution++;
+
+	bitReverse.resize(N);
+	for (unsigned int i = 0; i < N; i++)
+	{
+		unsigned int reversed = 0;
+		for (unsigned int bit = 0; bit < log2Resolution; bit++)
+		{
+			if (i & (1u << bit)) reversed |= 1u << (log2Resolution - 1 - bit);
+		}
+		bitReverse[i] = reversed;
+	}
+
+	twiddles.resize(N / 2);
+	for (unsigned int i = 0; i < N / 2; i++)
+	{
+		float angle = TWO_PI * i / N; // Positive exponent, we only ever go from frequency to spatial domain
+		twiddles[i] = Complex(std::cos(angle), std::sin(angle));
+	}
+
+	for (int i = 0; i < 3; i++) spectra[i].resize(N * N);
+	for (int i = 0; i < 2; i++)
+	{
+		frames[i].time = 0.0f;
+		frames[i].displacement.assign(N * N, glm::vec3(0.0f));
+	}
+	normals.assign(N * N, glm::vec3(0.0f, 1.0f, 0.0f));
+	currentFrame = 0;
+	simulatedFrames = 0;
+
+	GenerateSpectrum();
+}
+
+void OceanSimulation::GenerateSpectrum()
+{
+	PROFILE_ZONE("OceanSpectrum");
+
+	const unsigned int N = settings.resolution;
+	const int start = (int)N / 2;
+	const glm::vec2 windDir = glm::normalize(settings.windDirection);
+
+	h0.resize(N * N);
+	h0MinusConj.resize(N * N);
+	kHat.resize(N * N);
+	kVectors.resize(N * N);
+	dispersion.resize(N * N);
+
+	// Every row gets its own generator seeded from its index, so the spectrum is the same no matter how the rows get split between threads
+	JobSystem::ParallelFor(N, ROW_BATCH_SIZE, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int z = first; z < last; z++)
+		{
+			std::seed_seq seed{ settings.seed, z };
+			std::mt19937 gen(seed);
+			std::normal_distribution<float> gaussian(0.0f, 1.0f);
+
+			for (unsigned int x = 0; x < N; x++)
+			{
+				unsigned int index = z * N + x;
+				glm::vec2 k(TWO_PI * ((int)x - start) / settings.patchSize, TWO_PI * ((int)z - start) / settings.patchSize);
+				float kLength = glm::length(k);
+
+				// The Nyquist row & column have no mirrored -k in the grid, leaving them empty keeps every spectrum hermitian
+				float sqrtPhillips = 0.0f;
+				if (kLength > 0.0f && x != 0 && z != 0)
+				{
+					sqrtPhillips = sqrtf(Phillips(k, windDir, settings.windSpeed, settings.amplitude, settings.gravity));
+				}
+
+				float real = gaussian(gen);
+				float imaginary = gaussian(gen);
+				h0[index] = Complex(real, imaginary) * (sqrtPhillips * ONE_OVER_SQRT_2);
+				kVectors[index] = k;
+				kHat[index] = kLength > 0.0f ? k / kLength : glm::vec2(0.0f);
+				dispersion[index] = sqrtf(settings.gravity * kLength);
+			}
+		}
+	});
+
+	// h0(-k) lives at the mirrored index, the row/column N/2 away from the center wraps back onto itself
+	JobSystem::ParallelFor(N, ROW_BATCH_SIZE, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int z = first; z < last; z++)
+		{
+			unsigned int minusZ = (N - z) % N;
+			for (unsigned int x = 0; x < N; x++)
+			{
+				unsigned int minusX = (N - x) % N;
+				h0MinusConj[z * N + x] = std::conj(h0[minusZ * N + minusX]);
+			}
+		}
+	});
+}
+
+void OceanSimulation::Simulate(float time)
+{
+	PROFILE_ZONE("OceanSimulate");
+
+	const unsigned int N = settings.resolution;
+	const Complex i(0.0f, 1.0f);
+
+	// Evolve the spectrum: h(k, t) = h0(k) * e^(iwt) + conj(h0(-k)) * e^(-iwt)
+	JobSystem::ParallelFor(N, ROW_BATCH_SIZE, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int index = first * N; index < last * N; index++)
+		{
+			float phase = dispersion[index] * time;
+			Complex rotation(std::cos(phase), std::sin(phase));
+			Complex h = h0[index] * rotation + h0MinusConj[index] * std::conj(rotation);
+
+			const glm::vec2& k = kVectors[index];
+			const glm::vec2& dir = kHat[index];
+			Complex dx = Complex(0.0f, -dir.x) * h;
+			Complex dz = Complex(0.0f, -dir.y) * h;
+			Complex slopeX = Complex(0.0f, k.x) * h;
+			Complex slopeZ = Complex(0.0f, k.y) * h;
+
+			spectra[0][index] = h + i * dx;
+			spectra[1][index] = dz + i * slopeX;
+			spectra[2][index] = slopeZ;
+		}
+	});
+
+	FFT2D();
+
+	// The spectrum is centered on k = 0, which leaves a (-1)^(x + z) factor on every spatial sample
+	currentFrame = 1 - currentFrame;
+	Frame& frame = frames[currentFrame];
+	frame.time = time;
+	const float choppiness = settings.choppiness;
+	JobSystem::ParallelFor(N, ROW_BATCH_SIZE, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int z = first; z < last; z++)
+		{
+			for (unsigned int x = 0; x < N; x++)
+			{
+				unsigned int index = z * N + x;
+				float sign = ((x + z) & 1) ? -1.0f : 1.0f;
+
+				float height = sign * spectra[0][index].real();
+				float dx = sign * spectra[0][index].imag();
+				float dz = sign * spectra[1][index].real();
+				float slopeX = sign * spectra[1][index].imag();
+				float slopeZ = sign * spectra[2][index].real();
+
+				frame.displacement[index] = glm::vec3(dx * choppiness, height, dz * choppiness);
+				normals[index] = glm::normalize(glm::vec3(-slopeX, 1.0f, -slopeZ));
+			}
+		}
+	});
+
+	simulatedFrames = std::min(simulatedFrames + 1, 2u);
+}
+
+void OceanSimulation::FFT(Complex* data) const
+{
+	const unsigned int N = settings.resolution;
+
+	for (unsigned int i = 0; i < N; i++)
+	{
+		unsigned int j = bitReverse[i];
+		if (i < j) std::swap(data[i], data[j]);
+	}
+
+	// Iterative radix-2 butterflies
+	for (unsigned int size = 2; size <= N; size *= 2)
+	{
+		unsigned int halfSize = size / 2;
+		unsigned int twiddleStep = N / size;
+		for (unsigned int start = 0; start < N; start += size)
+		{
+			for (unsigned int k = 0; k < halfSize; k++)
+			{
+				Complex even = data[start + k];
+				Complex odd = data[start + k + halfSize] * twiddles[k * twiddleStep];
+				data[start + k] = even + odd;
+				data[start + k + halfSize] = even - odd;
+			}
+		}
+	}
+}
+
+void OceanSimulation::FFT2D()
+{
+	const unsigned int N = settings.resolution;
+
+	// Rows of all 3 buffers in one go
+	JobSystem::ParallelFor(N * 3, ROW_BATCH_SIZE, [&](unsigned int first, unsigned int last)
+	{
+		for (unsigned int row = first; row < last; row++)
+		{
+			FFT(&spectra[row / N][(row % N) * N]);
+		}
+	});
+
+	// Columns are gathered into a contiguous scratch buffer first, so the butterflies don't stride across the whole grid
+	JobSystem::ParallelFor(N * 3, ROW_BATCH_SIZE, [&](unsigned int first, unsigned int last)
+	{
+		Complex column[MAX_RESOLUTION];
+		for (unsigned int col = first; col < last; col++)
+		{
+			std::vector<Complex>& spectrum = spectra[col / N];
+			unsigned int x = col % N;
+
+			for (unsigned int z = 0; z < N; z++) column[z] = spectrum[z * N + x];
+			FFT(column);
+			for (unsigned int z = 0; z < N; z++) spectrum[z * N + x] = column[z];
+		}
+	});
+}
+
+glm::vec3 OceanSimulation::SampleFrame(const Frame& frame, float x, float z) const
+{
+	const unsigned int N = settings.resolution;
+	float u = x / settings.patchSize * N;
+	float v = z / settings.patchSize * N;
+	float floorU = std::floor(u);
+	float floorV = std::floor(v);
+	float blendU = u - floorU;
+	float blendV = v - floorV;
+
+	// Wrap into [0, N), the patch tiles
+	unsigned int x0 = (unsigned int)(((int)floorU % (int)N + (int)N) % (int)N);
+	unsigned int z0 = (unsigned int)(((int)floorV % (int)N + (int)N) % (int)N);
+	unsigned int x1 = (x0 + 1) % N;
+	unsigned int z1 = (z0 + 1) % N;
+
+	const std::vector<glm::vec3>& grid = frame.displacement;
+	glm::vec3 bottom = glm::mix(grid[z0 * N + x0], grid[z0 * N + x1], blendU);
+	glm::vec3 top = glm::mix(grid[z1 * N + x0], grid[z1 * N + x1], blendU);
+	return glm::mix(bottom, top, blendV);
+}
+
+glm::vec3 OceanSimulation::SampleDisplacement(float x, float z, float time) const
+{
+	const Frame& current = frames[currentFrame];
+	if (simulatedFrames < 2) return SampleFrame(current, x, z);
+
+	const Frame& previous = frames[1 - currentFrame];
+	if (time >= current.time || current.time <= previous.time) return SampleFrame(current, x, z);
+	if (time <= previous.time) return SampleFrame(previous, x, z);
+
+	float blend = (time - previous.time) / (current.time - previous.time);
+	return glm::mix(SampleFrame(previous, x, z), SampleFrame(current, x, z), blend);
+}
+
+float OceanSimulation::SampleHeight(float x, float z, float time) const
+{
+	// The displacement is indexed by where a point rests, not where it ends up. Search for the resting point that gets pushed over (x, z),
+	// a few fixed point steps are plenty unless the choppiness is high enough for the waves to fold over
+	glm::vec2 target(x, z);
+	glm::vec2 rest = target;
+	for (int i = 0; i < 4; i++)
+	{
+		glm::vec3 displacement = SampleDisplacement(rest.x, rest.y, time);
+		rest = target - glm::vec2(displacement.x, displacement.z);
+	}
+
+	return SampleDisplacement(rest.x, rest.y, time).y;
+}
+
+glm::vec3 OceanSimulation::SampleNormal(float x, float z) const
+{
+	const unsigned int N = settings.resolution;
+	float u = x / settings.patchSize * N;
+	float v = z / settings.patchSize * N;
+	unsigned int x0 = (unsigned int)(((int)std::floor(u + 0.5f) % (int)N + (int)N) % (int)N);
+	unsigned int z0 = (unsigned int)(((int)std::floor(v + 0.5f) % (int)N + (int)N) % (int)N);
+	return normals[z0 * N + x0];
+}
\ No newline at end of file
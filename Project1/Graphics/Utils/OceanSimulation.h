@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include <complex>
+#include <vector>
+
+struct OceanSettings
+{
+	unsigned int resolution = 256; // Grid points per side, a power of two between OceanSimulation::MIN_RESOLUTION & MAX_RESOLUTION
+	float patchSize = 20.0f; // World size of the patch, the ocean repeats every patchSize units
+	glm::vec2 windDirection = glm::vec2(-0.4f, -0.9f);
+	float windSpeed = 6.5f;
+	float amplitude = 0.45f * 1e-3f; // Phillips spectrum constant
+	float gravity = 9.81f;
+	float choppiness = 1.0f; // Scales the horizontal displacement, 0 turns the waves back into a plain heightfield
+	unsigned int seed = 0;
+};
+
+// Tessendorf style FFT ocean simulated on the CPU. The Phillips spectrum is generated once, every Simulate() evolves it in time and runs inverse FFTs for the height,
+// the choppy horizontal displacement and the slopes. The work is split across the job system. Everything stays on the CPU so physics & gameplay
+// can sample exactly the surface the renderer uploads
+class OceanSimulation
+{
+public:
+	static const unsigned int MIN_RESOLUTION = 64;
+	static const unsigned int MAX_RESOLUTION = 512;
+
+	OceanSimulation(const OceanSettings& settings = OceanSettings());
+
+	void SetSettings(const OceanSettings& settings); // Regenerates the spectrum, the maps stay empty until the next Simulate()
+	const OceanSettings& GetSettings() const { return settings; }
+
+	void Simulate(float time);
+
+	// Offset of the surface point that rests at (x, z) on still water, xyz = dx, height, dz. (x, z) wraps every patchSize.
+	// Blends the 2 most recently simulated frames, times outside of them are clamped to the closest one
+	glm::vec3 SampleDisplacement(float x, float z, float time) const;
+	float SampleHeight(float x, float z, float time) const; // Height of the surface directly above (x, z), undoes the horizontal displacement first
+	glm::vec3 SampleNormal(float x, float z) const; // From the latest frame
+
+	// resolution * resolution, row by row along Z. Grid point (i, j) rests at (i, j) * patchSize / resolution
+	const std::vector<glm::vec3>& GetDisplacementMap() const { return frames[currentFrame].displacement; }
+	const std::vector<glm::vec3>& GetNormalMap() const { return normals; }
+	float GetSimulatedTime() const { return frames[currentFrame].time; }
+	unsigned int GetResolution() const { return settings.resolution; }
+
+	static float Phillips(const glm::vec2& k, const glm::vec2& windDir, float windSpeed, float amplitude, float gravityAccel);
+
+private:
+	typedef std::complex<float> Complex;
+
+	struct Frame
+	{
+		float time;
+		std::vector<glm::vec3> displacement;
+	};
+
+	void GenerateSpectrum();
+	void FFT(Complex* data) const; // In place inverse FFT of one contiguous row of resolution values
+	void FFT2D(); // All 3 spectrum buffers, rows then columns
+
+	glm::vec3 SampleFrame(const Frame& frame, float x, float z) const;
+
+	OceanSettings settings;
+	unsigned int log2Resolution;
+
+	std::vector<Complex> h0; // h0(k)
+	std::vector<Complex> h0MinusConj; // conj(h0(-k))
+	std::vector<glm::vec2> kHat; // k / |k|, 0 for k = 0
+	std::vector<glm::vec2> kVectors;
+	std::vector<float> dispersion; // omega(k)
+
+	std::vector<unsigned int> bitReverse;
+	std::vector<Complex> twiddles;
+
+	// Two real fields are packed into every complex FFT since their spectra are hermitian:
+	// 0 = height + i * dx, 1 = dz + i * slope x, 2 = slope z
+	std::vector<Complex> spectra[3];
+
+	Frame frames[2];
+	unsigned int currentFrame;
+	unsigned int simulatedFrames;
+	std::vector<glm::vec3> normals;
+};
\ No newline at end of file
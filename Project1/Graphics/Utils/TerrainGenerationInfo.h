@@ -12,4 +12,5 @@ struct TerrainGenerationInfo
 	float persitence = 5.0f;
 	float frequency = 0.001f;
 	int octaves = 3;
+	bool generateCollision = false; // Off while the terrain pass is left out of the render graph, the player would be standing on invisible ground
 };
\ No newline at end of file
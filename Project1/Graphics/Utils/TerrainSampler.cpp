@@ -0,0 +1,311 @@
+#include "TerrainSampler.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define TERRAIN_SAMPLER_SSE
+#include <emmintrin.h>
+#endif
+
+// Constants from terrain.glsl, changing them here without changing the shader will make the physics & rendered terrain disagree
+static const float HASH_X = 12.9898f;
+static const float HASH_Y = 78.233f;
+static const float HASH_SCALE = 43758.5453f;
+static const float SHADER_PI = 3.14159265359f;
+
+// Every InterpolateNoise call needs the hashes of a 4x4 block of lattice points around the cell the point is in.
+// The shader hashes 36 points to get them (9 per SmoothNoise), here each of the 16 is only hashed once. The sums are still done in the shader's order
+static float SmoothNoise(const float lattice[4][4], int x, int y)
+{
+	float cornerContrib = (lattice[y - 1][x - 1] + lattice[y - 1][x + 1] + lattice[y + 1][x + 1] + lattice[y + 1][x - 1]) / 16.0f;
+	float sideContrib = (lattice[y][x - 1] + lattice[y - 1][x] + lattice[y][x + 1] + lattice[y + 1][x]) / 8.0f;
+	float centerContrib = lattice[y][x] / 4.0f;
+
+	return cornerContrib + sideContrib + centerContrib;
+}
+
+static float InterpolateCos(float a, float b, float blend)
+{
+	float theta = blend * SHADER_PI;
+	float blendFactor = (1.0f - std::cos(theta)) * 0.5f;
+	return a * (1.0f - blendFactor) + b * blendFactor;
+}
+
+#ifdef TERRAIN_SAMPLER_SSE
+// SSE2 has no floor, truncate and step down where truncating rounded up (negative values)
+static __m128 FloorSSE(__m128 v)
+{
+	__m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+	return _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), _mm_set1_ps(1.0f)));
+}
+
+// There's no SSE sin/cos either, going through the same std::sin/std::cos as the scalar path keeps both paths giving identical results
+static __m128 SinSSE(__m128 v)
+{
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, v);
+	for (int i = 0; i < 4; i++) lanes[i] = std::sin(lanes[i]);
+	return _mm_load_ps(lanes);
+}
+
+static __m128 CosSSE(__m128 v)
+{
+	alignas(16) float lanes[4];
+	_mm_store_ps(lanes, v);
+	for (int i = 0; i < 4; i++) lanes[i] = std::cos(lanes[i]);
+	return _mm_load_ps(lanes);
+}
+
+static __m128 SmoothNoiseSSE(const __m128 lattice[4][4], int x, int y)
+{
+	__m128 cornerContrib = _mm_add_ps(_mm_add_ps(_mm_add_ps(lattice[y - 1][x - 1], lattice[y - 1][x + 1]), lattice[y + 1][x + 1]), lattice[y + 1][x - 1]);
+	cornerContrib = _mm_div_ps(cornerContrib, _mm_set1_ps(16.0f));
+	__m128 sideContrib = _mm_add_ps(_mm_add_ps(_mm_add_ps(lattice[y][x - 1], lattice[y - 1][x]), lattice[y][x + 1]), lattice[y + 1][x]);
+	sideContrib = _mm_div_ps(sideContrib, _mm_set1_ps(8.0f));
+	__m128 centerContrib = _mm_div_ps(lattice[y][x], _mm_set1_ps(4.0f));
+
+	return _mm_add_ps(_mm_add_ps(cornerContrib, sideContrib), centerContrib);
+}
+
+static __m128 InterpolateCosSSE(__m128 a, __m128 b, __m128 blendFactor)
+{
+	return _mm_add_ps(_mm_mul_ps(a, _mm_sub_ps(_mm_set1_ps(1.0f), blendFactor)), _mm_mul_ps(b, blendFactor));
+}
+
+static __m128 CosBlendFactorSSE(__m128 blend)
+{
+	__m128 theta = _mm_mul_ps(blend, _mm_set1_ps(SHADER_PI));
+	return _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(1.0f), CosSSE(theta)), _mm_set1_ps(0.5f));
+}
+#endif
+
+TerrainSampler::TerrainSampler(const TerrainGenerationInfo& info, float tileSize, unsigned int tileResolution, unsigned int maxCachedTiles)
+	: info(info),
+	hashWeights(glm::vec2(HASH_X, HASH_Y) + info.seed),
+	tileSize(tileSize),
+	tileResolution(std::max(tileResolution, 2u)), // Need at least the 2 edges
+	maxCachedTiles(std::max(maxCachedTiles, 1u)),
+	useCounter(0),
+	generation(0)
+{
+
+}
+
+void TerrainSampler::SetInfo(const TerrainGenerationInfo& newInfo)
+{
+	// Roughness isn't used by the shader, so it doesn't invalidate anything
+	bool changed = newInfo.seed != info.seed
+		|| newInfo.amplitude != info.amplitude
+		|| newInfo.persitence != info.persitence
+		|| newInfo.frequency != info.frequency
+		|| newInfo.octaves != info.octaves;
+
+	info = newInfo;
+	if (!changed) return;
+
+	hashWeights = glm::vec2(HASH_X, HASH_Y) + info.seed;
+	tiles.clear();
+	generation++;
+}
+
+float TerrainSampler::Rand(int x, int y) const
+{
+	float dot = (float)x * hashWeights.x + (float)y * hashWeights.y;
+	float value = std::sin(dot) * HASH_SCALE;
+	return value - std::floor(value);
+}
+
+float TerrainSampler::InterpolateNoise(float x, float y) const
+{
+	float floorX = std::floor(x);
+	float floorY = std::floor(y);
+	int iX = (int)floorX;
+	int iY = (int)floorY;
+	float fractX = x - floorX;
+	float fractY = y - floorY;
+
+	float lattice[4][4]; // lattice[j][i] = Rand(iX + i - 1, iY + j - 1)
+	for (int j = 0; j < 4; j++)
+	{
+		for (int i = 0; i < 4; i++)
+		{
+			lattice[j][i] = Rand(iX + i - 1, iY + j - 1);
+		}
+	}
+
+	// Generate smoothed noise values
+	float a = SmoothNoise(lattice, 1, 1);
+	float b = SmoothNoise(lattice, 2, 1);
+	float c = SmoothNoise(lattice, 1, 2);
+	float d = SmoothNoise(lattice, 2, 2);
+
+	// Interpolate between smoothed noise
+	float i1 = InterpolateCos(a, b, fractX);
+	float i2 = InterpolateCos(c, d, fractX);
+
+	return InterpolateCos(i1, i2, fractY);
+}
+
+float TerrainSampler::SampleHeight(float x, float z) const
+{
+	float height = 0.0f;
+	float amplitude = info.amplitude;
+	float freq = info.frequency;
+	for (int i = 0; i < info.octaves; i++)
+	{
+		freq *= 2.0f;
+		amplitude *= info.persitence;
+
+		height += InterpolateNoise(freq * x, freq * z) * amplitude;
+	}
+
+	return height;
+}
+
+glm::vec3 TerrainSampler::SampleNormal(float x, float z) const
+{
+	float heightLeft = SampleHeight(x - 1.0f, z);
+	float heightRight = SampleHeight(x + 1.0f, z);
+	float heightUp = SampleHeight(x, z + 1.0f);
+	float heightDown = SampleHeight(x, z - 1.0f);
+	return glm::normalize(glm::vec3(heightLeft - heightRight, 1.0f, heightDown - heightUp));
+}
+
+void TerrainSampler::SampleHeights(const glm::vec2* points, float* heights, size_t count) const
+{
+	size_t i = 0;
+
+#ifdef TERRAIN_SAMPLER_SSE
+	for (; i + 4 <= count; i += 4)
+	{
+		float xs[4] = { points[i].x, points[i + 1].x, points[i + 2].x, points[i + 3].x };
+		float zs[4] = { points[i].y, points[i + 1].y, points[i + 2].y, points[i + 3].y };
+		SampleHeights4(xs, zs, heights + i);
+	}
+#endif
+
+	for (; i < count; i++)
+	{
+		heights[i] = SampleHeight(points[i].x, points[i].y);
+	}
+}
+
+void TerrainSampler::SampleHeights4(const float* xs, const float* zs, float* heights) const
+{
+#ifdef TERRAIN_SAMPLER_SSE
+	const __m128 x = _mm_loadu_ps(xs);
+	const __m128 z = _mm_loadu_ps(zs);
+	const __m128 weightX = _mm_set1_ps(hashWeights.x);
+	const __m128 weightY = _mm_set1_ps(hashWeights.y);
+
+	__m128 result = _mm_setzero_ps();
+	float amplitude = info.amplitude;
+	float freq = info.frequency;
+	for (int octave = 0; octave < info.octaves; octave++)
+	{
+		freq *= 2.0f;
+		amplitude *= info.persitence;
+
+		__m128 px = _mm_mul_ps(_mm_set1_ps(freq), x);
+		__m128 py = _mm_mul_ps(_mm_set1_ps(freq), z);
+		__m128 floorX = FloorSSE(px);
+		__m128 floorY = FloorSSE(py);
+		__m128i iX = _mm_cvttps_epi32(floorX);
+		__m128i iY = _mm_cvttps_epi32(floorY);
+
+		__m128 lattice[4][4];
+		for (int j = 0; j < 4; j++)
+		{
+			__m128 latticeY = _mm_cvtepi32_ps(_mm_add_epi32(iY, _mm_set1_epi32(j - 1)));
+			for (int i = 0; i < 4; i++)
+			{
+				__m128 latticeX = _mm_cvtepi32_ps(_mm_add_epi32(iX, _mm_set1_epi32(i - 1)));
+				__m128 dot = _mm_add_ps(_mm_mul_ps(latticeX, weightX), _mm_mul_ps(latticeY, weightY));
+				__m128 value = _mm_mul_ps(SinSSE(dot), _mm_set1_ps(HASH_SCALE));
+				lattice[j][i] = _mm_sub_ps(value, FloorSSE(value));
+			}
+		}
+
+		__m128 a = SmoothNoiseSSE(lattice, 1, 1);
+		__m128 b = SmoothNoiseSSE(lattice, 2, 1);
+		__m128 c = SmoothNoiseSSE(lattice, 1, 2);
+		__m128 d = SmoothNoiseSSE(lattice, 2, 2);
+
+		__m128 blendX = CosBlendFactorSSE(_mm_sub_ps(px, floorX));
+		__m128 blendY = CosBlendFactorSSE(_mm_sub_ps(py, floorY));
+		__m128 i1 = InterpolateCosSSE(a, b, blendX);
+		__m128 i2 = InterpolateCosSSE(c, d, blendX);
+		__m128 noise = InterpolateCosSSE(i1, i2, blendY);
+
+		result = _mm_add_ps(result, _mm_mul_ps(noise, _mm_set1_ps(amplitude)));
+	}
+
+	_mm_storeu_ps(heights, result);
+#else
+	for (int i = 0; i < 4; i++)
+	{
+		heights[i] = SampleHeight(xs[i], zs[i]);
+	}
+#endif
+}
+
+glm::ivec2 TerrainSampler::GetTileCoords(float x, float z) const
+{
+	return glm::ivec2((int)std::floor(x / tileSize), (int)std::floor(z / tileSize));
+}
+
+const TerrainTile& TerrainSampler::GetTile(int tileX, int tileZ)
+{
+	useCounter++;
+
+	std::pair<int, int> key(tileX, tileZ);
+	std::map<std::pair<int, int>, CachedTile>::iterator it = tiles.find(key);
+	if (it != tiles.end())
+	{
+		it->second.lastUsed = useCounter;
+		return it->second.tile;
+	}
+
+	if (tiles.size() >= maxCachedTiles) // Evict the least recently used tile
+	{
+		std::map<std::pair<int, int>, CachedTile>::iterator oldest = tiles.begin();
+		for (it = tiles.begin(); it != tiles.end(); it++)
+		{
+			if (it->second.lastUsed < oldest->second.lastUsed) oldest = it;
+		}
+		tiles.erase(oldest);
+	}
+
+	CachedTile& cached = tiles[key];
+	cached.lastUsed = useCounter;
+	cached.tile.tileX = tileX;
+	cached.tile.tileZ = tileZ;
+	BuildTile(cached.tile);
+	return cached.tile;
+}
+
+void TerrainSampler::BuildTile(TerrainTile& tile) const
+{
+	tile.origin = glm::vec2(tile.tileX * tileSize, tile.tileZ * tileSize);
+	tile.spacing = tileSize / (float)(tileResolution - 1);
+	tile.resolution = tileResolution;
+
+	std::vector<glm::vec2> points;
+	points.reserve(tileResolution * tileResolution);
+	for (unsigned int z = 0; z < tileResolution; z++)
+	{
+		for (unsigned int x = 0; x < tileResolution; x++)
+		{
+			points.push_back(tile.origin + glm::vec2(x * tile.spacing, z * tile.spacing));
+		}
+	}
+
+	tile.heights.resize(points.size());
+	SampleHeights(points.data(), tile.heights.data(), points.size());
+
+	std::vector<float>::const_iterator minIt = std::min_element(tile.heights.begin(), tile.heights.end());
+	std::vector<float>::const_iterator maxIt = std::max_element(tile.heights.begin(), tile.heights.end());
+	tile.minHeight = *minIt;
+	tile.maxHeight = *maxIt;
+}
\ No newline at end of file
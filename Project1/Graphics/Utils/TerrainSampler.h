@@ -0,0 +1,72 @@
+#pragma once
+
+#include "TerrainGenerationInfo.h"
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <map>
+#include <utility>
+#include <vector>
+
+// A square grid of terrain heights, tiles share their edge vertices with their neighbours
+struct TerrainTile
+{
+	int tileX;
+	int tileZ;
+	glm::vec2 origin; // World XZ of heights[0]
+	float spacing; // World distance between two neighbouring heights
+	unsigned int resolution; // Heights per side
+	std::vector<float> heights; // resolution * resolution, row by row along Z (heights[z * resolution + x])
+	float minHeight;
+	float maxHeight;
+};
+
+// Evaluates the terrain on the CPU with the same noise as the tessellation evaluation shader in terrain.glsl, so gameplay, physics & placement code can ask for the ground height.
+// The maths is done in 32 bit floats in the shader's order, GPU sin/cos aren't IEEE exact though so expect small differences against the rendered terrain
+class TerrainSampler
+{
+public:
+	TerrainSampler(const TerrainGenerationInfo& info, float tileSize = 64.0f, unsigned int tileResolution = 65, unsigned int maxCachedTiles = 64);
+
+	void SetInfo(const TerrainGenerationInfo& info); // Drops the cached tiles if anything that changes the heights changed
+	const TerrainGenerationInfo& GetInfo() const { return info; }
+	unsigned int GetGeneration() const { return generation; } // Bumped every time the cached tiles are dropped
+
+	float SampleHeight(float x, float z) const;
+	glm::vec3 SampleNormal(float x, float z) const; // Same 1 unit central differences as the shader
+
+	// Samples many points at once, 4 at a time with SSE where available. Gives the same results as SampleHeight
+	void SampleHeights(const glm::vec2* points, float* heights, size_t count) const;
+
+	// Cached heightfield of the tile covering [tileX, tileX + 1) * tileSize on X and the same on Z. The reference stays valid until SetInfo drops the cache or the tile gets evicted
+	const TerrainTile& GetTile(int tileX, int tileZ);
+	glm::ivec2 GetTileCoords(float x, float z) const;
+
+	float GetTileSize() const { return tileSize; }
+	unsigned int GetTileResolution() const { return tileResolution; }
+
+private:
+	struct CachedTile
+	{
+		TerrainTile tile;
+		unsigned int lastUsed;
+	};
+
+	float Rand(int x, int y) const;
+	float InterpolateNoise(float x, float y) const;
+	void SampleHeights4(const float* xs, const float* zs, float* heights) const;
+
+	void BuildTile(TerrainTile& tile) const;
+
+	TerrainGenerationInfo info;
+	glm::vec2 hashWeights; // vec2(12.9898, 78.233) + seed, the vector Rand dots the lattice coords with
+
+	float tileSize;
+	unsigned int tileResolution;
+	unsigned int maxCachedTiles;
+
+	std::map<std::pair<int, int>, CachedTile> tiles;
+	unsigned int useCounter;
+	unsigned int generation;
+};
\ No newline at end of file
@@ -20,7 +20,9 @@ enum class ShaderDataType
 	Float, Float2, Float3, Float4, // Float Types
 	Int, Int2, Int3, Int4, // Int Types
 	Mat3x3, Mat4x4, // Matrix Types,
-	Bool
+	Bool,
+	UByte4, UShort4, Short2, // Packed integer types, read as floats when the element is normalized and as integers otherwise
+	Half2 // Half floats, always read as floats
 };
 
 // Gets the size (in bytes) of a ShaderDataType
@@ -50,6 +52,14 @@ static size_t GetShaderDataTypeSize(ShaderDataType type)
 		return 4 * 4 * 4;
 	case ShaderDataType::Bool:
 		return 1;
+	case ShaderDataType::UByte4:
+		return 1 * 4;
+	case ShaderDataType::UShort4:
+		return 2 * 4;
+	case ShaderDataType::Short2:
+		return 2 * 2;
+	case ShaderDataType::Half2:
+		return 2 * 2;
 	default:
 		std::cout << "Invalid ShaderDataType!" << std::endl;
 		return 0;
@@ -65,7 +75,7 @@ struct BufferElement
 		shaderDataType(dataType), 
 		size(GetShaderDataTypeSize(dataType)), 
 		offset(0), 
-		normalized(false) {}
+		normalized(normalized) {}
 
 	size_t NumberOfComponents() const
 	{
@@ -94,6 +104,12 @@ struct BufferElement
 			return 4; // 4x Float3
 		case ShaderDataType::Bool:
 			return 1;
+		case ShaderDataType::UByte4:
+		case ShaderDataType::UShort4:
+			return 4;
+		case ShaderDataType::Short2:
+		case ShaderDataType::Half2:
+			return 2;
 		default:
 			std::cout << "Invalid ShaderDataType!" << std::endl;
 			return 0;
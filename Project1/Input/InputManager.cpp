@@ -75,11 +75,13 @@ void InputManager::ClearState()
 
 void InputManager::SetCursorMode(CursorMode mode)
 {
+	if (!window) return; // Headless
 	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_NORMAL + (int)mode);
 }
 
 CursorMode InputManager::GetCursorMode()
 {
+	if (!window) return CursorMode::Normal;
 	return (CursorMode)(glfwGetInputMode(window, GLFW_CURSOR) - GLFW_CURSOR_NORMAL);
 }
 
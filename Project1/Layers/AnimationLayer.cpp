@@ -117,35 +117,17 @@ void AnimationLayer::OnUpdate(float deltaTime)
 
 int AnimationLayer::FindKeyFramePositionIndex(AnimationComponent* animComp, float time)
 {
-    int index = 1;
-    for (; index < animComp->keyFramePositions.size(); index++)
-    {
-        if (animComp->keyFramePositions[index].time > time) return index - 1;
-    }
-
-    return animComp->keyFramePositions.size() - 1;
+    return animComp->positionCursor.Seek(animComp->keyFramePositions, &KeyFramePositionComponent::time, time);
 }
 
 int AnimationLayer::FindKeyFrameScaleIndex(AnimationComponent* animComp, float time)
 {
-    int index = 1;
-    for (; index < animComp->keyFrameScales.size(); index++)
-    {
-        if (animComp->keyFrameScales[index].time > time) return index - 1;
-    }
-
-    return animComp->keyFrameScales.size() - 1;
+    return animComp->scaleCursor.Seek(animComp->keyFrameScales, &KeyFrameScaleComponent::time, time);
 }
 
 int AnimationLayer::FindKeyFrameRotationIndex(AnimationComponent* animComp, float time)
 {
-    int index = 1;
-    for (; index < animComp->keyFrameRotations.size(); index++)
-    {
-        if (animComp->keyFrameRotations[index].time > time) return index - 1;
-    }
-
-    return animComp->keyFrameRotations.size() - 1;
+    return animComp->rotationCursor.Seek(animComp->keyFrameRotations, &KeyFrameRotationComponent::time, time);
 }
 
 void AnimationLayer::UpdateAnimationPosition(AnimationComponent* animComp, PositionComponent* posComp, glm::vec3& color)
@@ -3,8 +3,10 @@
 #include "InputManager.h"
 #include "MeshManager.h"
 #include "Utils.h"
-#include "TextureManager.h"
 #include "Texture2D.h"
+#include "Renderer.h"
+#include "AssetLoader.h"
+#include "SoundManager.h"
 
 #include <glm/gtx/vector_angle.hpp>
 #include <iostream>
@@ -26,10 +28,17 @@ constexpr float equipTime = 3.0f;
 
 constexpr float animAttackSpeed = 17.0f;
 
+// Events the player's clips can mark in their events files (see AnimationEventUtils::LoadEvents)
+static const size_t footstepEvent = AnimationEventUtils::HashName("Footstep"); // Parameter is the sound to play
+static const size_t chainWindowOpenEvent = AnimationEventUtils::HashName("ChainWindowOpen"); // Attacks can chain into the next stage from here...
+static const size_t chainWindowCloseEvent = AnimationEventUtils::HashName("ChainWindowClose"); // ...until here
+
 PlayerController::PlayerController(Camera& camera, EntityManager& entityManager, PhysicsWorld* physicsWorld)
     : entityManager(entityManager),
     physicsWorld(physicsWorld),
     camera(camera),
+    terrainSampler(Renderer::GetTerrainInfo()),
+    terrainCollider(nullptr),
     equipped(false),
     animationStateMachine(nullptr),
     unequipIdle({ MeshManager::GetAnimation("assets/models/Unequip_Idle.fbx"), 0.0f, true, 15.0f }),
@@ -58,7 +67,8 @@ PlayerController::PlayerController(Camera& camera, EntityManager& entityManager,
     attack1({ MeshManager::GetAnimation("assets/models/Combo01_1.fbx"), 0.7f, true, 20.0f, 1 }),
     attack2({ MeshManager::GetAnimation("assets/models/Combo01_2.fbx"), 0.7f, true, 23.0f, 1 }),
     attack3({ MeshManager::GetAnimation("assets/models/Combo01_3.fbx"), 0.8f, true, 23.0f, 1 }),
-    attack4({ MeshManager::GetAnimation("assets/models/Combo01_4.fbx"), 0.9f, true, 19.0f, 1 })
+    attack4({ MeshManager::GetAnimation("assets/models/Combo01_4.fbx"), 0.9f, true, 19.0f, 1 }),
+    chainWindowOpen(false)
 {
     basicAttack.attackStages.push_back({ attack1, 0.2f, 10.0f });
     basicAttack.attackStages.push_back({ attack2, 0.25f, 10.0f });
@@ -66,6 +76,50 @@ PlayerController::PlayerController(Camera& camera, EntityManager& entityManager,
     basicAttack.attackStages.push_back({ attack4, 0.1, 10.0f });
 }
 
+void PlayerController::RequestAssets()
+{
+    AssetLoader::LoadAnimatedMesh("assets/models/Character.FBX");
+    AssetLoader::LoadMesh("assets/models/Lantern.fbx");
+    AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    const char* animations[] = {
+        "assets/models/Unequip_Idle.fbx",
+        "assets/models/Unequip_Walk.fbx",
+        "assets/models/Unequip_Run.fbx",
+        "assets/models/Jump.fbx",
+        "assets/models/Equip.fbx",
+        "assets/models/Unequip.fbx",
+        "assets/models/Equip_Idle.fbx",
+        "assets/models/8Way_Run_F.fbx",
+        "assets/models/8Way_Run_FR.fbx",
+        "assets/models/8Way_Run_FL.fbx",
+        "assets/models/8Way_Run_L.fbx",
+        "assets/models/8Way_Run_R.fbx",
+        "assets/models/8Way_Run_B.fbx",
+        "assets/models/8Way_Run_BR.fbx",
+        "assets/models/8Way_Run_BL.fbx",
+        "assets/models/8Way_Walk_F.fbx",
+        "assets/models/8Way_Walk_FR.fbx",
+        "assets/models/8Way_Walk_FL.fbx",
+        "assets/models/8Way_Walk_L.fbx",
+        "assets/models/8Way_Walk_R.fbx",
+        "assets/models/8Way_Walk_B.fbx",
+        "assets/models/8Way_Walk_BR.fbx",
+        "assets/models/8Way_Walk_BL.fbx",
+        "assets/models/Combo01_1.fbx",
+        "assets/models/Combo01_2.fbx",
+        "assets/models/Combo01_3.fbx",
+        "assets/models/Combo01_4.fbx"
+    };
+
+    for (const char* animation : animations)
+    {
+        AssetLoader::LoadAnimation(animation);
+    }
+}
+
 void PlayerController::OnAttach()
 {
     AnimatedMesh* playerMesh = MeshManager::GetAnimatedMesh("assets/models/Character.FBX");
@@ -87,6 +141,7 @@ void PlayerController::OnAttach()
     playerEntity->AddComponent<SkeletalAnimationComponent>();
     animComp = playerEntity->GetComponent<SkeletalAnimationComponent>();
     animComp->lerpSpeed = 5.0f;
+    animComp->AddEventListener(this);
     animationStateMachine.animComp = animComp;
     animationStateMachine.SetState(unequipIdle);
     
@@ -107,6 +162,8 @@ void PlayerController::OnAttach()
     btController->setGravity(btVector3(0.0f, -100.0f, 0.0f));
     physicsWorld->GetBulletWorld()->addAction(btController); // Add controller to world
 
+    terrainCollider = new TerrainCollider(physicsWorld->GetBulletWorld(), terrainSampler);
+
     // Setup lantern anchor
     Physics::RigidBodyInfo lanternRigidInfo;
     lanternRigidInfo.mass = 0.0f;
@@ -128,9 +185,9 @@ void PlayerController::OnAttach()
 
         RenderComponent::RenderInfo lanternInfo;
         lanternInfo.mesh = MeshManager::GetMesh("assets/models/Lantern.fbx");
-        lanternInfo.albedoTextures.push_back({ TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Doors_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat), 1.0f });
-        lanternInfo.normalTexture = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Doors_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-        lanternInfo.ormTexture = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Doors_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+        lanternInfo.albedoTextures.push_back({ AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat), 1.0f }); // Already loaded by RequestAssets
+        lanternInfo.normalTexture = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+        lanternInfo.ormTexture = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
         lanternInfo.colorOverride = glm::vec3(0.0f, 1.0f, 0.0f);
         lanternE->AddComponent<RenderComponent>(lanternInfo);
 
@@ -156,6 +213,27 @@ void PlayerController::OnAttach()
     lanternLight = new Light(lightInfo);
 }
 
+void PlayerController::OnAnimationEvents(SkeletalAnimationComponent* animComponent, Span<const AnimationEventRecord> events)
+{
+    for (const AnimationEventRecord& record : events)
+    {
+        const AnimationEvent& event = *record.event;
+        if (event.nameHash == footstepEvent)
+        {
+            if (record.weight < 0.5f || event.parameter.empty()) continue; // Only the clip that is mostly visible steps, or fading between 2 runs would play every step twice
+
+            PlaySoundInfo soundInfo;
+            soundInfo.startPaused = false;
+            SoundManager::PlaySound(event.parameter, soundInfo);
+        }
+        else if (record.animation == animationStateMachine.GetAnimation()) // Leftovers of the attack we just chained from don't count
+        {
+            if (event.nameHash == chainWindowOpenEvent) chainWindowOpen = true;
+            else if (event.nameHash == chainWindowCloseEvent) chainWindowOpen = false;
+        }
+    }
+}
+
 void PlayerController::OnUpdate(float deltaTime)
 {
     glm::vec3 vel(0.0f);
@@ -244,14 +322,19 @@ void PlayerController::OnUpdate(float deltaTime)
             float timePlayed = animationStateMachine.GetTimePlayed();   
             float animDuration = attackStage.animationState.duration;
 
-            float minWindowTime = animDuration - attackStage.chainingWindow;
-            if (timePlayed >= minWindowTime && timePlayed < animDuration) // We chanined the attack, move to the next stage
+            // Clips that mark their chain window in their events file open & close it from there, the others use the last chainingWindow seconds of the state
+            bool inWindow;
+            if (attackStage.animationState.anim->HasEvent(chainWindowOpenEvent)) inWindow = chainWindowOpen;
+            else inWindow = timePlayed >= animDuration - attackStage.chainingWindow;
+
+            if (inWindow && timePlayed < animDuration) // We chanined the attack, move to the next stage
             {
                 basicAttack.currentStage++;
                 if (basicAttack.currentStage >= basicAttack.attackStages.size()) basicAttack.currentStage = 0; // Reset to beginning
 
                 AttackStage& newAttackStage = basicAttack.attackStages[basicAttack.currentStage];
                 animationStateMachine.SetState(newAttackStage.animationState); // Play the animation
+                chainWindowOpen = false;
             }
         }
         else // No attack animation is playing, we can safely assume that this is the first "Stage" of the attack
@@ -260,6 +343,7 @@ void PlayerController::OnUpdate(float deltaTime)
             AttackStage& resetAttackStage = basicAttack.attackStages[basicAttack.currentStage];
 
             animationStateMachine.SetState(resetAttackStage.animationState);
+            chainWindowOpen = false;
         }
     }
 
@@ -343,6 +427,18 @@ void PlayerController::OnUpdate(float deltaTime)
         }
     }
 
+    // Keep the terrain under the player collidable
+    const TerrainGenerationInfo& terrainInfo = Renderer::GetTerrainInfo();
+    if (terrainInfo.generateCollision)
+    {
+        terrainSampler.SetInfo(terrainInfo);
+        terrainCollider->Update(BulletUtils::BulletVec3ToGLM(ghostObj->getWorldTransform().getOrigin()));
+    }
+    else if (terrainCollider->GetTileCount() > 0)
+    {
+        terrainCollider->Clear();
+    }
+
     btVector3 walkDirection = BulletUtils::GLMVec3ToBullet(vel);
     btController->setWalkDirection(walkDirection);
     btController->updateAction(physicsWorld->GetBulletWorld(), deltaTime);
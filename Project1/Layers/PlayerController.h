@@ -7,6 +7,9 @@
 #include "PhysicsWorld.h"
 #include "ASM.h"
 #include "Light.h"
+#include "TerrainSampler.h"
+#include "TerrainCollider.h"
+#include "IAnimationEventListener.h"
 
 #include <BulletDynamics/Character/btKinematicCharacterController.h>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
@@ -26,14 +29,18 @@ struct Attack
 
 class SkeletalAnimationComponent;
 class Animation;
-class PlayerController : public ApplicationLayer
+class PlayerController : public ApplicationLayer, public IAnimationEventListener
 {
 public:
 	PlayerController(Camera& camera, EntityManager& entityManager, PhysicsWorld* physicsWorld);
 
+	static void RequestAssets(); // Starts loading the player's meshes, textures & animations on the AssetLoader, so they don't load one by one when the controller is created
+
 	virtual void OnAttach() override;
 	virtual void OnUpdate(float deltaTime) override;
 
+	virtual void OnAnimationEvents(SkeletalAnimationComponent* animComponent, Span<const AnimationEventRecord> events) override; // Footsteps & the attack chain window
+
 private:
 	EntityManager& entityManager;
 	PhysicsWorld* physicsWorld;
@@ -43,6 +50,9 @@ private:
 	btKinematicCharacterController* btController;
 	btPairCachingGhostObject* ghostObj;
 
+	TerrainSampler terrainSampler;
+	TerrainCollider* terrainCollider; // Heightfield tiles around the player, only kept while the terrain has collision turned on
+
 	RigidBody* lanternHinge;
 	RigidBody* lanternRigidBody;
 	Light* lanternLight;
@@ -86,4 +96,5 @@ private:
 
 	Attack basicAttack;
 	float lastLeftClickTime;
+	bool chainWindowOpen; // Set by the current attack's events, when its clip has them
 };
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "AnimationLOD.h"
+
+namespace AnimationLODUtils
+{
+	AnimationLODTier SelectTier(bool visible, bool shadowVisible, float screenSize, AnimationLODTier currentTier, const AnimationLODSettings& settings)
+	{
+		if (!visible) return shadowVisible ? AnimationLODTier::Low : AnimationLODTier::OffScreen;
+
+		// Coming back up from a coarser tier takes a bit more than the size it dropped at
+		float reducedSize = settings.reducedScreenSize * (currentTier >= AnimationLODTier::Reduced ? 1.0f + settings.hysteresis : 1.0f);
+		float lowSize = settings.lowScreenSize * (currentTier >= AnimationLODTier::Low ? 1.0f + settings.hysteresis : 1.0f);
+
+		if (screenSize >= reducedSize) return AnimationLODTier::Full;
+		if (screenSize >= lowSize) return AnimationLODTier::Reduced;
+		return AnimationLODTier::Low;
+	}
+
+	unsigned int GetUpdateInterval(AnimationLODTier tier, const AnimationLODSettings& settings)
+	{
+		switch (tier)
+		{
+		case AnimationLODTier::Full:
+			return 1;
+		case AnimationLODTier::Reduced:
+			return settings.reducedInterval > 0 ? settings.reducedInterval : 1;
+		case AnimationLODTier::Low:
+			return settings.lowInterval > 0 ? settings.lowInterval : 1;
+		default:
+			return 0;
+		}
+	}
+
+	bool SkipsDetailJoints(AnimationLODTier tier)
+	{
+		return tier == AnimationLODTier::Reduced || tier == AnimationLODTier::Low;
+	}
+
+	const char* GetTierName(AnimationLODTier tier)
+	{
+		switch (tier)
+		{
+		case AnimationLODTier::Full:
+			return "Full";
+		case AnimationLODTier::Reduced:
+			return "Reduced";
+		case AnimationLODTier::Low:
+			return "Low";
+		case AnimationLODTier::OffScreen:
+			return "Off Screen";
+		default:
+			return "Unknown";
+		}
+	}
+}
\ No newline at end of file
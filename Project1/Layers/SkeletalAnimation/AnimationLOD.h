@@ -0,0 +1,31 @@
+#pragma once
+
+enum class AnimationLODTier
+{
+	Full = 0, // Evaluated every frame with every joint
+	Reduced, // Evaluated every few frames without the skeleton's detail joints, extrapolated in between
+	Low, // Like Reduced, but even less often. Off screen characters whose shadow can be seen end up here too
+	OffScreen, // Only time advances
+	Count
+};
+
+struct AnimationLODSettings
+{
+	bool enabled = true;
+	float reducedScreenSize = 300.0f; // Characters smaller than this many pixels on screen drop to Reduced
+	float lowScreenSize = 100.0f; // And smaller than this to Low
+	float hysteresis = 0.15f; // A character only goes back to a finer tier once it's this fraction above the size it dropped at, so it doesn't flicker between them
+	unsigned int reducedInterval = 2; // Frames between evaluations
+	unsigned int lowInterval = 4;
+};
+
+// Everything here is CPU only so tier selection can be checked without a scene
+namespace AnimationLODUtils
+{
+	// visible & shadowVisible come from the last frame's culling, screenSize is the character's size on screen in pixels (the radius of its bounding sphere). currentTier is the tier picked last frame
+	AnimationLODTier SelectTier(bool visible, bool shadowVisible, float screenSize, AnimationLODTier currentTier, const AnimationLODSettings& settings);
+
+	unsigned int GetUpdateInterval(AnimationLODTier tier, const AnimationLODSettings& settings); // Frames between evaluations, 0 if the tier is never evaluated
+	bool SkipsDetailJoints(AnimationLODTier tier);
+	const char* GetTierName(AnimationLODTier tier);
+}
\ No newline at end of file
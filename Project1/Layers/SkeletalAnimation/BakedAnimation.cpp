@@ -0,0 +1,80 @@
+#include "BakedAnimation.h"
+#include "Pose.h"
+
+#include <algorithm>
+#include <cmath>
+
+float BakedAnimation::GetFrame(float time) const
+{
+	return glm::clamp(time * framesPerTick, 0.0f, (float)(frameCount - 1));
+}
+
+unsigned int BakedAnimation::GetNearestFrame(float time) const
+{
+	return (unsigned int)std::round(GetFrame(time));
+}
+
+void BakedAnimation::Interpolate(float time, glm::mat4* boneMatrices) const
+{
+	float frame = GetFrame(time);
+	unsigned int frameA = (unsigned int)frame;
+	unsigned int frameB = std::min(frameA + 1, frameCount - 1);
+	float t = frame - frameA;
+
+	const glm::mat4* a = GetPalette(frameA);
+	const glm::mat4* b = GetPalette(frameB);
+	for (unsigned int i = 0; i < boneCount; i++)
+	{
+		boneMatrices[i] = a[i] + (b[i] - a[i]) * t;
+	}
+}
+
+bool BakedAnimation::GetBounds(float time, bool interpolate, glm::vec3& min, glm::vec3& max) const
+{
+	if (frameBounds.empty()) return false;
+
+	// An interpolated palette is a weighted average of the 2 frames' palettes, so it stays inside both their bounds together
+	float frame = GetFrame(time);
+	unsigned int frameA = interpolate ? (unsigned int)frame : GetNearestFrame(time);
+	unsigned int frameB = interpolate ? std::min(frameA + 1, frameCount - 1) : frameA;
+	min = glm::min(frameBounds[frameA].min, frameBounds[frameB].min);
+	max = glm::max(frameBounds[frameA].max, frameBounds[frameB].max);
+	return !frameBounds[frameA].IsEmpty();
+}
+
+BakedAnimation BakedAnimation::Bake(const Animation* animation, const std::vector<int>& binding, const Skeleton& skeleton, const glm::mat4& inverseTransform, const std::vector<BoneBounds>& boneBounds, unsigned int boneCount, float sampleRate)
+{
+	BakedAnimation baked;
+	baked.boneCount = boneCount;
+	baked.sampleRate = sampleRate;
+
+	float ticksPerSecond = animation->GetTicksPerSecond() > 0 ? (float)animation->GetTicksPerSecond() : 1.0f;
+	float duration = std::max(animation->GetDuration(), 0.0f);
+	baked.framesPerTick = sampleRate / ticksPerSecond;
+	baked.frameCount = (unsigned int)std::ceil(duration * baked.framesPerTick) + 1;
+
+	// Bones outside the skeleton are never written by ComputeSkinningMatrices, they stay identity like they do in SkeletalAnimationComponent::boneMatrices
+	baked.palettes.resize(baked.frameCount * boneCount, glm::mat4(1.0f));
+
+	Pose pose;
+	std::vector<ChannelCursor> cursors(animation->GetChannelCount());
+	for (unsigned int frame = 0; frame < baked.frameCount; frame++)
+	{
+		float time = std::min(frame / baked.framesPerTick, duration);
+		PoseUtils::SamplePose(animation, binding, time, cursors.data(), skeleton, pose);
+		if (skeleton.GetJointCount() > 0) pose.SetJoint(0, glm::vec3(0.0f, 0.0f, 0.0f), pose.GetRotation(0), pose.GetScale(0));
+
+		PoseUtils::ComputeSkinningMatrices(skeleton, pose, inverseTransform, &baked.palettes[frame * boneCount]);
+	}
+
+	if (!boneBounds.empty())
+	{
+		baked.frameBounds.resize(baked.frameCount);
+		for (unsigned int frame = 0; frame < baked.frameCount; frame++)
+		{
+			SkinnedBoundsUtils::ComputeSkinnedBounds(boneBounds, baked.GetPalette(frame), baked.frameBounds[frame].min, baked.frameBounds[frame].max);
+		}
+	}
+
+	return baked;
+}
\ No newline at end of file
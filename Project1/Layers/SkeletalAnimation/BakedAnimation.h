@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Animation.h"
+#include "Skeleton.h"
+#include "SkinnedBounds.h"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+// Skinning palettes of one animation on one mesh, sampled at a fixed rate & stored back to back. One table is shared by every character playing that animation on that mesh
+struct BakedAnimation
+{
+	std::vector<glm::mat4> palettes; // frameCount palettes of boneCount matrices
+	std::vector<BoneBounds> frameBounds; // Skinned bounds of every frame, empty if the mesh has no bone bounds
+	unsigned int frameCount = 0;
+	unsigned int boneCount = 0;
+	float framesPerTick = 0.0f;
+	float sampleRate = 0.0f; // Frames per second it was baked at
+
+	const glm::mat4* GetPalette(unsigned int frame) const { return &palettes[frame * boneCount]; }
+	float GetFrame(float time) const; // Frame at time (in ticks), between 2 frames has a fraction
+	unsigned int GetNearestFrame(float time) const;
+	void Interpolate(float time, glm::mat4* boneMatrices) const; // Linear between the 2 frames around time
+
+	// Skinned bounds at time, covering both frames around it when interpolating. false if there are none
+	bool GetBounds(float time, bool interpolate, glm::vec3& min, glm::vec3& max) const;
+
+	// The root is kept in place like the SkeletalAnimationLayer does without root motion. Frames go up to & include the animation's duration
+	static BakedAnimation Bake(const Animation* animation, const std::vector<int>& binding, const Skeleton& skeleton, const glm::mat4& inverseTransform, const std::vector<BoneBounds>& boneBounds, unsigned int boneCount, float sampleRate);
+};
\ No newline at end of file
@@ -0,0 +1,455 @@
+#include "Pose.h"
+
+#if defined(_M_X64) || defined(__SSE2__)
+#define POSE_SSE
+#include <emmintrin.h>
+#endif
+
+// Local transforms turned into matrices, then global transforms in place. Every thread evaluating poses gets its own
+static thread_local std::vector<glm::mat4> transforms;
+
+// SamplePose gathers the key frames after each joint's into nextKeyFrames & how far to go towards them into the lerps, then interpolates every joint at once
+static thread_local Pose nextKeyFrames;
+static thread_local std::vector<float> positionLerps;
+static thread_local std::vector<float> rotationLerps;
+static thread_local std::vector<float> scaleLerps;
+
+// weight scaled by the mask for every joint, so blending runs the same loops with or without one
+static thread_local std::vector<float> jointWeights;
+
+void Pose::Resize(unsigned int jointCount)
+{
+	std::vector<float>* arrays[10] = { &positionX, &positionY, &positionZ, &rotationX, &rotationY, &rotationZ, &rotationW, &scaleX, &scaleY, &scaleZ };
+	for (std::vector<float>* array : arrays)
+	{
+		array->resize(jointCount);
+	}
+}
+
+void Pose::SetJoint(unsigned int joint, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+	positionX[joint] = position.x;
+	positionY[joint] = position.y;
+	positionZ[joint] = position.z;
+	rotationX[joint] = rotation.x;
+	rotationY[joint] = rotation.y;
+	rotationZ[joint] = rotation.z;
+	rotationW[joint] = rotation.w;
+	scaleX[joint] = scale.x;
+	scaleY[joint] = scale.y;
+	scaleZ[joint] = scale.z;
+}
+
+BoneMask BoneMask::FromJoint(const Skeleton& skeleton, const std::string& jointName, float weight)
+{
+	BoneMask mask;
+
+	int root = skeleton.FindJoint(jointName);
+	if (root == -1) return mask;
+
+	// Children come after their parents, so the joints below root are the ones after it whose parent already got the weight
+	mask.weights.resize(skeleton.GetJointCount(), 0.0f);
+	mask.weights[root] = weight;
+	for (unsigned int i = root + 1; i < skeleton.GetJointCount(); i++)
+	{
+		int parent = skeleton.parents[i];
+		if (parent >= root) mask.weights[i] = mask.weights[parent];
+	}
+
+	return mask;
+}
+
+Pose& PosePool::Acquire(unsigned int jointCount)
+{
+	if (used == poses.size()) poses.emplace_back(new Pose());
+
+	Pose& pose = *poses[used++];
+	pose.Resize(jointCount);
+	return pose;
+}
+
+// translate(position) * toMat4(rotation) * scale(scale) without the 2 matrix multiplies
+static void ComposeLocalMatrix(const Pose& pose, unsigned int joint, glm::mat4& matrix)
+{
+	float x = pose.rotationX[joint];
+	float y = pose.rotationY[joint];
+	float z = pose.rotationZ[joint];
+	float w = pose.rotationW[joint];
+
+	float xx = x * x;
+	float yy = y * y;
+	float zz = z * z;
+	float xy = x * y;
+	float xz = x * z;
+	float yz = y * z;
+	float wx = w * x;
+	float wy = w * y;
+	float wz = w * z;
+
+	// Same terms & order as glm::mat3_cast
+	matrix[0] = glm::vec4((1.0f - 2.0f * (yy + zz)) * pose.scaleX[joint], (2.0f * (xy + wz)) * pose.scaleX[joint], (2.0f * (xz - wy)) * pose.scaleX[joint], 0.0f);
+	matrix[1] = glm::vec4((2.0f * (xy - wz)) * pose.scaleY[joint], (1.0f - 2.0f * (xx + zz)) * pose.scaleY[joint], (2.0f * (yz + wx)) * pose.scaleY[joint], 0.0f);
+	matrix[2] = glm::vec4((2.0f * (xz + wy)) * pose.scaleZ[joint], (2.0f * (yz - wx)) * pose.scaleZ[joint], (1.0f - 2.0f * (xx + yy)) * pose.scaleZ[joint], 0.0f);
+	matrix[3] = glm::vec4(pose.positionX[joint], pose.positionY[joint], pose.positionZ[joint], 1.0f);
+}
+
+#ifdef POSE_SSE
+// The same as ComposeLocalMatrix for joints [joint, joint + 4), one joint per lane
+static void ComposeLocalMatricesSSE(const Pose& pose, unsigned int joint, glm::mat4* matrices)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 two = _mm_set1_ps(2.0f);
+
+	__m128 x = _mm_loadu_ps(&pose.rotationX[joint]);
+	__m128 y = _mm_loadu_ps(&pose.rotationY[joint]);
+	__m128 z = _mm_loadu_ps(&pose.rotationZ[joint]);
+	__m128 w = _mm_loadu_ps(&pose.rotationW[joint]);
+
+	__m128 xx = _mm_mul_ps(x, x);
+	__m128 yy = _mm_mul_ps(y, y);
+	__m128 zz = _mm_mul_ps(z, z);
+	__m128 xy = _mm_mul_ps(x, y);
+	__m128 xz = _mm_mul_ps(x, z);
+	__m128 yz = _mm_mul_ps(y, z);
+	__m128 wx = _mm_mul_ps(w, x);
+	__m128 wy = _mm_mul_ps(w, y);
+	__m128 wz = _mm_mul_ps(w, z);
+
+	__m128 scaleX = _mm_loadu_ps(&pose.scaleX[joint]);
+	__m128 scaleY = _mm_loadu_ps(&pose.scaleY[joint]);
+	__m128 scaleZ = _mm_loadu_ps(&pose.scaleZ[joint]);
+
+	__m128 columns[4][4] =
+	{
+		{
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), scaleX),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, wz)), scaleX),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, wy)), scaleX),
+			_mm_setzero_ps()
+		},
+		{
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, wz)), scaleY),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), scaleY),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, wx)), scaleY),
+			_mm_setzero_ps()
+		},
+		{
+			_mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, wy)), scaleZ),
+			_mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, wx)), scaleZ),
+			_mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), scaleZ),
+			_mm_setzero_ps()
+		},
+		{
+			_mm_loadu_ps(&pose.positionX[joint]),
+			_mm_loadu_ps(&pose.positionY[joint]),
+			_mm_loadu_ps(&pose.positionZ[joint]),
+			one
+		}
+	};
+
+	// Every column holds one component for 4 joints, transposing turns it into that column for each joint
+	for (int column = 0; column < 4; column++)
+	{
+		_MM_TRANSPOSE4_PS(columns[column][0], columns[column][1], columns[column][2], columns[column][3]);
+		for (int lane = 0; lane < 4; lane++)
+		{
+			_mm_storeu_ps(&matrices[joint + lane][column][0], columns[column][lane]);
+		}
+	}
+}
+#endif
+
+// result = a * b, result may be a or b
+static void Multiply(const glm::mat4& a, const glm::mat4& b, glm::mat4& result)
+{
+#ifdef POSE_SSE
+	__m128 a0 = _mm_loadu_ps(&a[0][0]);
+	__m128 a1 = _mm_loadu_ps(&a[1][0]);
+	__m128 a2 = _mm_loadu_ps(&a[2][0]);
+	__m128 a3 = _mm_loadu_ps(&a[3][0]);
+
+	for (int column = 0; column < 4; column++)
+	{
+		__m128 value = _mm_mul_ps(a0, _mm_set1_ps(b[column][0]));
+		value = _mm_add_ps(value, _mm_mul_ps(a1, _mm_set1_ps(b[column][1])));
+		value = _mm_add_ps(value, _mm_mul_ps(a2, _mm_set1_ps(b[column][2])));
+		value = _mm_add_ps(value, _mm_mul_ps(a3, _mm_set1_ps(b[column][3])));
+		_mm_storeu_ps(&result[column][0], value);
+	}
+#else
+	result = a * b;
+#endif
+}
+
+#ifdef POSE_SSE
+// result = a + (b - a) * t for 4 joints
+static void LerpSSE(const float* a, const float* b, const float* t, float* result)
+{
+	__m128 from = _mm_loadu_ps(a);
+	_mm_storeu_ps(result, _mm_add_ps(from, _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(b), from), _mm_loadu_ps(t))));
+}
+
+// 1 / length of 4 quaternions, one per lane
+static __m128 InverseLengthSSE(__m128 x, __m128 y, __m128 z, __m128 w)
+{
+	__m128 lengthSquared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_add_ps(_mm_mul_ps(z, z), _mm_mul_ps(w, w)));
+	return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(lengthSquared));
+}
+
+// KeyFrameUtils::Nlerp() for joints [joint, joint + 4), one joint per lane
+static void NlerpSSE(const Pose& from, const Pose& to, const float* t, Pose& result, unsigned int joint)
+{
+	__m128 ax = _mm_loadu_ps(&from.rotationX[joint]);
+	__m128 ay = _mm_loadu_ps(&from.rotationY[joint]);
+	__m128 az = _mm_loadu_ps(&from.rotationZ[joint]);
+	__m128 aw = _mm_loadu_ps(&from.rotationW[joint]);
+	__m128 bx = _mm_loadu_ps(&to.rotationX[joint]);
+	__m128 by = _mm_loadu_ps(&to.rotationY[joint]);
+	__m128 bz = _mm_loadu_ps(&to.rotationZ[joint]);
+	__m128 bw = _mm_loadu_ps(&to.rotationW[joint]);
+
+	// Going the shorter way around flips b when the dot product is negative, moving its sign bit onto t does that
+	__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, bx), _mm_mul_ps(ay, by)), _mm_add_ps(_mm_mul_ps(az, bz), _mm_mul_ps(aw, bw)));
+	__m128 lerp = _mm_loadu_ps(t);
+	__m128 toWeight = _mm_xor_ps(lerp, _mm_and_ps(dot, _mm_set1_ps(-0.0f)));
+	__m128 fromWeight = _mm_sub_ps(_mm_set1_ps(1.0f), lerp);
+
+	__m128 x = _mm_add_ps(_mm_mul_ps(ax, fromWeight), _mm_mul_ps(bx, toWeight));
+	__m128 y = _mm_add_ps(_mm_mul_ps(ay, fromWeight), _mm_mul_ps(by, toWeight));
+	__m128 z = _mm_add_ps(_mm_mul_ps(az, fromWeight), _mm_mul_ps(bz, toWeight));
+	__m128 w = _mm_add_ps(_mm_mul_ps(aw, fromWeight), _mm_mul_ps(bw, toWeight));
+
+	__m128 inverseLength = InverseLengthSSE(x, y, z, w);
+	_mm_storeu_ps(&result.rotationX[joint], _mm_mul_ps(x, inverseLength));
+	_mm_storeu_ps(&result.rotationY[joint], _mm_mul_ps(y, inverseLength));
+	_mm_storeu_ps(&result.rotationZ[joint], _mm_mul_ps(z, inverseLength));
+	_mm_storeu_ps(&result.rotationW[joint], _mm_mul_ps(w, inverseLength));
+}
+
+// The same as AddPose's loop body for joints [joint, joint + 4), one joint per lane
+static void AddJointsSSE(const Pose& base, const Pose& additive, const Pose& reference, const float* t, Pose& result, unsigned int joint)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	__m128 weight = _mm_loadu_ps(t);
+
+	const std::vector<float>* baseArrays[3] = { &base.positionX, &base.positionY, &base.positionZ };
+	const std::vector<float>* additiveArrays[3] = { &additive.positionX, &additive.positionY, &additive.positionZ };
+	const std::vector<float>* referenceArrays[3] = { &reference.positionX, &reference.positionY, &reference.positionZ };
+	std::vector<float>* resultArrays[3] = { &result.positionX, &result.positionY, &result.positionZ };
+	for (int array = 0; array < 3; array++)
+	{
+		__m128 difference = _mm_sub_ps(_mm_loadu_ps(&(*additiveArrays[array])[joint]), _mm_loadu_ps(&(*referenceArrays[array])[joint]));
+		_mm_storeu_ps(&(*resultArrays[array])[joint], _mm_add_ps(_mm_loadu_ps(&(*baseArrays[array])[joint]), _mm_mul_ps(difference, weight)));
+	}
+
+	const std::vector<float>* baseScales[3] = { &base.scaleX, &base.scaleY, &base.scaleZ };
+	const std::vector<float>* additiveScales[3] = { &additive.scaleX, &additive.scaleY, &additive.scaleZ };
+	const std::vector<float>* referenceScales[3] = { &reference.scaleX, &reference.scaleY, &reference.scaleZ };
+	std::vector<float>* resultScales[3] = { &result.scaleX, &result.scaleY, &result.scaleZ };
+	for (int array = 0; array < 3; array++)
+	{
+		__m128 ratio = _mm_div_ps(_mm_loadu_ps(&(*additiveScales[array])[joint]), _mm_loadu_ps(&(*referenceScales[array])[joint]));
+		__m128 scale = _mm_add_ps(one, _mm_mul_ps(_mm_sub_ps(ratio, one), weight));
+		_mm_storeu_ps(&(*resultScales[array])[joint], _mm_mul_ps(_mm_loadu_ps(&(*baseScales[array])[joint]), scale));
+	}
+
+	// difference = conjugate(reference) * additive
+	__m128 rx = _mm_loadu_ps(&reference.rotationX[joint]);
+	__m128 ry = _mm_loadu_ps(&reference.rotationY[joint]);
+	__m128 rz = _mm_loadu_ps(&reference.rotationZ[joint]);
+	__m128 rw = _mm_loadu_ps(&reference.rotationW[joint]);
+	__m128 ax = _mm_loadu_ps(&additive.rotationX[joint]);
+	__m128 ay = _mm_loadu_ps(&additive.rotationY[joint]);
+	__m128 az = _mm_loadu_ps(&additive.rotationZ[joint]);
+	__m128 aw = _mm_loadu_ps(&additive.rotationW[joint]);
+
+	__m128 dw = _mm_add_ps(_mm_add_ps(_mm_mul_ps(rw, aw), _mm_mul_ps(rx, ax)), _mm_add_ps(_mm_mul_ps(ry, ay), _mm_mul_ps(rz, az)));
+	__m128 dx = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rw, ax), _mm_mul_ps(rz, ay)), _mm_add_ps(_mm_mul_ps(rx, aw), _mm_mul_ps(ry, az)));
+	__m128 dy = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rw, ay), _mm_mul_ps(rx, az)), _mm_add_ps(_mm_mul_ps(ry, aw), _mm_mul_ps(rz, ax)));
+	__m128 dz = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(rw, az), _mm_mul_ps(ry, ax)), _mm_add_ps(_mm_mul_ps(rz, aw), _mm_mul_ps(rx, ay)));
+
+	// Nlerp from the identity to difference, the identity's dot product with it is just w
+	__m128 toWeight = _mm_xor_ps(weight, _mm_and_ps(dw, _mm_set1_ps(-0.0f)));
+	__m128 sx = _mm_mul_ps(dx, toWeight);
+	__m128 sy = _mm_mul_ps(dy, toWeight);
+	__m128 sz = _mm_mul_ps(dz, toWeight);
+	__m128 sw = _mm_add_ps(_mm_sub_ps(one, weight), _mm_mul_ps(dw, toWeight));
+	__m128 inverseLength = InverseLengthSSE(sx, sy, sz, sw);
+	sx = _mm_mul_ps(sx, inverseLength);
+	sy = _mm_mul_ps(sy, inverseLength);
+	sz = _mm_mul_ps(sz, inverseLength);
+	sw = _mm_mul_ps(sw, inverseLength);
+
+	// base * scaled difference
+	__m128 bx = _mm_loadu_ps(&base.rotationX[joint]);
+	__m128 by = _mm_loadu_ps(&base.rotationY[joint]);
+	__m128 bz = _mm_loadu_ps(&base.rotationZ[joint]);
+	__m128 bw = _mm_loadu_ps(&base.rotationW[joint]);
+
+	__m128 w = _mm_sub_ps(_mm_mul_ps(bw, sw), _mm_add_ps(_mm_add_ps(_mm_mul_ps(bx, sx), _mm_mul_ps(by, sy)), _mm_mul_ps(bz, sz)));
+	__m128 x = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bw, sx), _mm_mul_ps(bx, sw)), _mm_sub_ps(_mm_mul_ps(by, sz), _mm_mul_ps(bz, sy)));
+	__m128 y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bw, sy), _mm_mul_ps(by, sw)), _mm_sub_ps(_mm_mul_ps(bz, sx), _mm_mul_ps(bx, sz)));
+	__m128 z = _mm_add_ps(_mm_add_ps(_mm_mul_ps(bw, sz), _mm_mul_ps(bz, sw)), _mm_sub_ps(_mm_mul_ps(bx, sy), _mm_mul_ps(by, sx)));
+
+	inverseLength = InverseLengthSSE(x, y, z, w);
+	_mm_storeu_ps(&result.rotationX[joint], _mm_mul_ps(x, inverseLength));
+	_mm_storeu_ps(&result.rotationY[joint], _mm_mul_ps(y, inverseLength));
+	_mm_storeu_ps(&result.rotationZ[joint], _mm_mul_ps(z, inverseLength));
+	_mm_storeu_ps(&result.rotationW[joint], _mm_mul_ps(w, inverseLength));
+}
+#endif
+
+// result = from + (to - from) * lerp for every joint, rotations nlerped. Any of the poses may be the same one
+static void InterpolatePoses(const Pose& from, const Pose& to, const float* positionLerps, const float* rotationLerps, const float* scaleLerps, Pose& result)
+{
+	unsigned int jointCount = from.GetJointCount();
+
+	const std::vector<float>* fromArrays[6] = { &from.positionX, &from.positionY, &from.positionZ, &from.scaleX, &from.scaleY, &from.scaleZ };
+	const std::vector<float>* toArrays[6] = { &to.positionX, &to.positionY, &to.positionZ, &to.scaleX, &to.scaleY, &to.scaleZ };
+	std::vector<float>* resultArrays[6] = { &result.positionX, &result.positionY, &result.positionZ, &result.scaleX, &result.scaleY, &result.scaleZ };
+
+	unsigned int joint = 0;
+#ifdef POSE_SSE
+	for (; joint + 4 <= jointCount; joint += 4)
+	{
+		for (int array = 0; array < 6; array++)
+		{
+			LerpSSE(&(*fromArrays[array])[joint], &(*toArrays[array])[joint], (array < 3 ? positionLerps : scaleLerps) + joint, &(*resultArrays[array])[joint]);
+		}
+		NlerpSSE(from, to, rotationLerps + joint, result, joint);
+	}
+#endif
+	for (; joint < jointCount; joint++)
+	{
+		for (int array = 0; array < 6; array++)
+		{
+			float a = (*fromArrays[array])[joint];
+			float t = array < 3 ? positionLerps[joint] : scaleLerps[joint];
+			(*resultArrays[array])[joint] = a + ((*toArrays[array])[joint] - a) * t;
+		}
+
+		glm::quat rotation = KeyFrameUtils::Nlerp(from.GetRotation(joint), to.GetRotation(joint), rotationLerps[joint]);
+		result.rotationX[joint] = rotation.x;
+		result.rotationY[joint] = rotation.y;
+		result.rotationZ[joint] = rotation.z;
+		result.rotationW[joint] = rotation.w;
+	}
+}
+
+// weight * the mask's weight of every joint into jointWeights
+static const float* GetJointWeights(unsigned int jointCount, float weight, const BoneMask* mask)
+{
+	jointWeights.resize(jointCount);
+	for (unsigned int i = 0; i < jointCount; i++)
+	{
+		jointWeights[i] = mask ? weight * mask->GetWeight(i) : weight;
+	}
+
+	return jointWeights.data();
+}
+
+namespace PoseUtils
+{
+	void SamplePose(const Animation* animation, const std::vector<int>& binding, float time, ChannelCursor* cursors, const Skeleton& skeleton, Pose& pose)
+	{
+		unsigned int jointCount = skeleton.GetJointCount();
+		pose.Resize(jointCount);
+		nextKeyFrames.Resize(jointCount);
+		positionLerps.resize(jointCount);
+		rotationLerps.resize(jointCount);
+		scaleLerps.resize(jointCount);
+
+		// Looking up the key frames differs per channel, interpolating them is the same for every joint
+		ChannelKeyFrames keyFrames;
+		for (unsigned int i = 0; i < jointCount; i++)
+		{
+			int channel = binding[i];
+			if (channel == -1)
+			{
+				pose.SetJoint(i, skeleton.restPositions[i], skeleton.restRotations[i], skeleton.restScales[i]);
+				nextKeyFrames.SetJoint(i, skeleton.restPositions[i], skeleton.restRotations[i], skeleton.restScales[i]);
+				positionLerps[i] = rotationLerps[i] = scaleLerps[i] = 0.0f;
+				continue;
+			}
+
+			animation->GetChannelKeyFrames(channel, time, keyFrames, cursors ? &cursors[channel] : nullptr);
+			pose.SetJoint(i, keyFrames.positions[0], keyFrames.rotations[0], keyFrames.scales[0]);
+			nextKeyFrames.SetJoint(i, keyFrames.positions[1], keyFrames.rotations[1], keyFrames.scales[1]);
+			positionLerps[i] = keyFrames.positionLerp;
+			rotationLerps[i] = keyFrames.rotationLerp;
+			scaleLerps[i] = keyFrames.scaleLerp;
+		}
+
+		InterpolatePoses(pose, nextKeyFrames, positionLerps.data(), rotationLerps.data(), scaleLerps.data(), pose);
+	}
+
+	void SetRestPose(const Skeleton& skeleton, Pose& pose)
+	{
+		unsigned int jointCount = skeleton.GetJointCount();
+		pose.Resize(jointCount);
+		for (unsigned int i = 0; i < jointCount; i++)
+		{
+			pose.SetJoint(i, skeleton.restPositions[i], skeleton.restRotations[i], skeleton.restScales[i]);
+		}
+	}
+
+	void BlendPoses(const Pose& from, const Pose& to, float weight, Pose& result, const BoneMask* mask)
+	{
+		unsigned int jointCount = from.GetJointCount();
+		result.Resize(jointCount);
+
+		const float* weights = GetJointWeights(jointCount, weight, mask);
+		InterpolatePoses(from, to, weights, weights, weights, result);
+	}
+
+	void AddPose(const Pose& base, const Pose& additive, const Pose& reference, float weight, Pose& result, const BoneMask* mask)
+	{
+		unsigned int jointCount = base.GetJointCount();
+		result.Resize(jointCount);
+
+		const float* weights = GetJointWeights(jointCount, weight, mask);
+
+		unsigned int joint = 0;
+#ifdef POSE_SSE
+		for (; joint + 4 <= jointCount; joint += 4)
+		{
+			AddJointsSSE(base, additive, reference, weights + joint, result, joint);
+		}
+#endif
+		for (; joint < jointCount; joint++)
+		{
+			float t = weights[joint];
+			glm::vec3 position = base.GetPosition(joint) + (additive.GetPosition(joint) - reference.GetPosition(joint)) * t;
+			glm::quat difference = glm::conjugate(reference.GetRotation(joint)) * additive.GetRotation(joint);
+			glm::quat rotation = glm::normalize(base.GetRotation(joint) * KeyFrameUtils::Nlerp(glm::quat(1.0f, 0.0f, 0.0f, 0.0f), difference, t));
+			glm::vec3 scale = base.GetScale(joint) * (glm::vec3(1.0f) + (additive.GetScale(joint) / reference.GetScale(joint) - glm::vec3(1.0f)) * t);
+			result.SetJoint(joint, position, rotation, scale);
+		}
+	}
+
+	void ComputeSkinningMatrices(const Skeleton& skeleton, const Pose& pose, const glm::mat4& inverseTransform, glm::mat4* boneMatrices)
+	{
+		unsigned int jointCount = skeleton.GetJointCount();
+		if (transforms.size() < jointCount) transforms.resize(jointCount);
+
+		unsigned int joint = 0;
+#ifdef POSE_SSE
+		for (; joint + 4 <= jointCount; joint += 4)
+		{
+			ComposeLocalMatricesSSE(pose, joint, transforms.data());
+		}
+#endif
+		for (; joint < jointCount; joint++)
+		{
+			ComposeLocalMatrix(pose, joint, transforms[joint]);
+		}
+
+		// Parents come before their children, so their global transform is always ready. inverseTransform is folded into the root, which saves a matrix multiply per joint
+		for (unsigned int i = 0; i < jointCount; i++)
+		{
+			int parent = skeleton.parents[i];
+			Multiply(parent == -1 ? inverseTransform : transforms[parent], transforms[i], transforms[i]);
+			Multiply(transforms[i], skeleton.offsetTransforms[i], boneMatrices[skeleton.boneIDs[i]]);
+		}
+	}
+}
\ No newline at end of file
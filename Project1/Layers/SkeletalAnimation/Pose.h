@@ -0,0 +1,69 @@
+#pragma once
+
+#include "Animation.h"
+#include "Skeleton.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtx/quaternion.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Local transform of every joint in a skeleton, kept as struct of arrays so blending & building matrices run as straight loops over the joints (4 at a time with SSE)
+struct Pose
+{
+	std::vector<float> positionX, positionY, positionZ;
+	std::vector<float> rotationX, rotationY, rotationZ, rotationW;
+	std::vector<float> scaleX, scaleY, scaleZ;
+
+	void Resize(unsigned int jointCount);
+	unsigned int GetJointCount() const { return (unsigned int)positionX.size(); }
+
+	glm::vec3 GetPosition(unsigned int joint) const { return glm::vec3(positionX[joint], positionY[joint], positionZ[joint]); }
+	glm::quat GetRotation(unsigned int joint) const { return glm::quat(rotationW[joint], rotationX[joint], rotationY[joint], rotationZ[joint]); }
+	glm::vec3 GetScale(unsigned int joint) const { return glm::vec3(scaleX[joint], scaleY[joint], scaleZ[joint]); }
+
+	void SetJoint(unsigned int joint, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale);
+};
+
+// How much a layer applies to every joint of one skeleton, 0 leaves the joint alone & 1 applies the layer fully
+struct BoneMask
+{
+	std::vector<float> weights;
+
+	float GetWeight(unsigned int joint) const { return joint < weights.size() ? weights[joint] : 0.0f; }
+
+	// weight for jointName & every joint below it (e.g. the spine for an upper body layer), 0 for the rest. Empty if the skeleton has no such joint
+	static BoneMask FromJoint(const Skeleton& skeleton, const std::string& jointName, float weight = 1.0f);
+};
+
+// Scratch poses for one evaluation, handed out again by the next one so blending stops allocating once the pool has grown to fit. Keep one per thread
+class PosePool
+{
+public:
+	Pose& Acquire(unsigned int jointCount);
+	void ReleaseAll() { used = 0; } // Every pose acquired so far can be handed out again
+
+private:
+	std::vector<std::unique_ptr<Pose>> poses; // Pointers so poses already handed out stay put while the pool grows
+	unsigned int used = 0;
+};
+
+// Everything here only touches the data it is handed, so different characters can be evaluated on different threads at the same time
+namespace PoseUtils
+{
+	// binding maps joints to channels of animation (see AnimatedMesh::GetAnimationBinding), joints the animation doesn't move get the skeleton's rest pose
+	// cursors has one cursor per channel of animation, nullptr binary searches every track instead
+	void SamplePose(const Animation* animation, const std::vector<int>& binding, float time, ChannelCursor* cursors, const Skeleton& skeleton, Pose& pose);
+	void SetRestPose(const Skeleton& skeleton, Pose& pose);
+
+	// weight 0 = from, 1 = to, scaled per joint by mask if there is one. result may be from or to
+	void BlendPoses(const Pose& from, const Pose& to, float weight, Pose& result, const BoneMask* mask = nullptr);
+
+	// result = base + (additive - reference) * weight, scaled per joint by mask if there is one. Rotations & scales are applied in the joint's local space. result may be base
+	void AddPose(const Pose& base, const Pose& additive, const Pose& reference, float weight, Pose& result, const BoneMask* mask = nullptr);
+
+	// Writes inverseTransform * global transform * offset transform of every joint to boneMatrices[boneID]
+	void ComputeSkinningMatrices(const Skeleton& skeleton, const Pose& pose, const glm::mat4& inverseTransform, glm::mat4* boneMatrices);
+}
\ No newline at end of file
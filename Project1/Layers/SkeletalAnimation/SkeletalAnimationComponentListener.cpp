@@ -27,6 +27,7 @@ void SkeletalAnimationComponentListener::OnAddComponent(Entity* entity, Componen
 		AnimatedMesh* riggedMesh = dynamic_cast<AnimatedMesh*>(renderComp->mesh);
 		if (!riggedMesh) return; // The mesh on this entity is NOT rigged so we can't animate it
 
+		animComp->boneMatrices.resize(riggedMesh->GetBoneCount(), glm::mat4(1.0f)); // Default to identity matrix
 		animations.push_back({ riggedMesh, animComp });
 	}
 	else if (renderComponent) // We just added a render component
@@ -37,6 +38,7 @@ void SkeletalAnimationComponentListener::OnAddComponent(Entity* entity, Componen
 		SkeletalAnimationComponent* animationComponent = entity->GetComponent<SkeletalAnimationComponent>();
 		if (!animationComponent) return; // No animation component
 
+		animationComponent->boneMatrices.resize(riggedMesh->GetBoneCount(), glm::mat4(1.0f)); // Default to identity matrix
 		animations.push_back({ riggedMesh, animationComponent });
 	}
 	
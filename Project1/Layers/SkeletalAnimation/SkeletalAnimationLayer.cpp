@@ -1,12 +1,24 @@
 #include "SkeletalAnimationLayer.h"
 #include "Animation.h"
 #include "AnimatedMesh.h"
+#include "Profiler.h"
+#include "JobSystem.h"
+#include "Pose.h"
+#include "AnimationLOD.h"
+#include "BakedAnimation.h"
+#include "AnimationEvents.h"
 
 #include <glm/gtx/matrix_interpolation.hpp>
 
+#include <algorithm>
+#include <chrono>
 #include <iostream>
 
 SkeletalAnimationLayer::SkeletalAnimationLayer()
+	: frameIndex(0),
+	bakeSampleRate(30.0f),
+	totalBonesEvaluated(0),
+	totalUpdateTime(0.0)
 {
 
 }
@@ -16,69 +28,340 @@ SkeletalAnimationLayer::~SkeletalAnimationLayer()
 
 }
 
+// Scratch poses of every worker, reused across characters & frames
+static thread_local PosePool posePool;
+
+static const float MAX_EXTRAPOLATION = 0.1f; // Seconds, throttled characters hold their pose past this in case their next evaluation is late
+
+// Moves value towards target by at most step
+static float MoveTowards(float value, float target, float step)
+{
+	return value < target ? std::min(value + step, target) : std::max(value - step, target);
+}
+
+bool SkeletalAnimationLayer::AdvanceLayers(SkeletalAnimationComponent* animComp, float deltaTime, std::vector<AnimationEventRecord>& events)
+{
+	float fadeStep = animComp->lerpSpeed * deltaTime;
+
+	bool playing = false;
+	for (unsigned int layerIndex = 0; layerIndex < animComp->layers.size(); layerIndex++)
+	{
+		SkeletalAnimationComponent::Layer& layer = animComp->layers[layerIndex];
+		layer.weight = MoveTowards(layer.weight, layer.targetWeight, fadeStep);
+		if (layer.clips.empty()) continue;
+
+		// Once a clip has fully faded in, the ones before it can't be seen anymore
+		unsigned int firstVisible = 0;
+		for (unsigned int i = 0; i < layer.clips.size(); i++)
+		{
+			SkeletalAnimationComponent::PlayingClip& clip = layer.clips[i];
+			clip.fade = std::min(clip.fade + fadeStep, 1.0f);
+			if (clip.fade >= 1.0f) firstVisible = i;
+		}
+		layer.clips.erase(layer.clips.begin(), layer.clips.begin() + firstVisible);
+
+		if (layer.weight <= 0.0f) continue; // Faded out
+
+		// Advance every clip by ticks per second, clips being faded out keep playing (& crossing events, listeners can tell them apart by weight)
+		for (SkeletalAnimationComponent::PlayingClip& clip : layer.clips)
+		{
+			Animation* animation = clip.anim;
+			float advance = animation->GetTicksPerSecond() * layer.speed * animComp->speed * deltaTime;
+
+			if (!animComp->eventListeners.empty())
+			{
+				AnimationEventRecord record = { nullptr, animation, layerIndex, layer.weight * clip.fade };
+				AnimationEventUtils::CollectEvents(animation->GetEvents(), clip.time, advance, animation->GetDuration(), layer.repeat, clip.eventCursor, record, events);
+			}
+
+			clip.time = AnimationEventUtils::WrapTime(clip.time + advance, animation->GetDuration(), layer.repeat);
+		}
+
+		playing = true;
+	}
+
+	return playing;
+}
+
+void SkeletalAnimationLayer::DispatchEvents(SkeletalAnimationComponent* animComp)
+{
+	Span<const AnimationEventRecord> events(eventBatch.data(), eventBatch.size());
+	for (unsigned int i = 0; i < animComp->eventListeners.size(); i++)
+	{
+		animComp->eventListeners[i]->OnAnimationEvents(animComp, events);
+	}
+}
+
+bool SkeletalAnimationLayer::CanPlayBaked(const SkeletalAnimationComponent* animComp)
+{
+	if (!animComp->baked || animComp->allowRootMotion) return false;
+
+	const SkeletalAnimationComponent::Layer& base = animComp->layers[0];
+	if (base.clips.size() != 1 || base.weight < 1.0f || base.additive || base.mask) return false;
+
+	for (unsigned int i = 1; i < animComp->layers.size(); i++)
+	{
+		const SkeletalAnimationComponent::Layer& layer = animComp->layers[i];
+		if (!layer.clips.empty() && layer.weight > 0.0f) return false;
+	}
+
+	return true;
+}
+
+const BakedAnimation& SkeletalAnimationLayer::GetBakedAnimation(AnimatedMesh* mesh, Animation* animation)
+{
+	std::pair<const AnimatedMesh*, const Animation*> key(mesh, animation);
+	std::map<std::pair<const AnimatedMesh*, const Animation*>, BakedAnimation>::iterator it = bakedAnimations.find(key);
+	if (it != bakedAnimations.end()) return it->second;
+
+	BakedAnimation& baked = bakedAnimations[key];
+	baked = BakedAnimation::Bake(animation, mesh->GetAnimationBinding(animation), mesh->GetSkeleton(), mesh->GetInverseTransform(), mesh->GetBoneBounds(), mesh->GetBoneCount(), bakeSampleRate);
+	return baked;
+}
+
 void SkeletalAnimationLayer::OnUpdate(float deltaTime)
 {
-	for (AnimationData& animData : animations)
+	PROFILE_ZONE("SkeletalAnimation");
+	std::chrono::steady_clock::time_point updateStart = std::chrono::steady_clock::now();
+
+	// Advancing & binding happens here on the main thread, AnimatedMesh::GetAnimationBinding caches its bindings and isn't thread safe
+	jobs.clear();
+	frameIndex++;
+	unsigned int bonesEvaluated = 0;
+	unsigned int bakedCount = 0;
+	unsigned int eventsDispatched = 0;
+	unsigned int tierCounts[(int)AnimationLODTier::Count] = {};
+	for (unsigned int i = 0; i < animations.size(); i++)
 	{
-		SkeletalAnimationComponent* animComp = animData.animationComp;
-		Animation* animation = animComp->anim;
-		AnimatedMesh* mesh = animData.animatedMesh;
+		SkeletalAnimationComponent* animComp = animations[i].animationComp;
+		AnimatedMesh* mesh = animations[i].animatedMesh;
 
-		if (!animation) continue; // No animation currently tied to the component
+		eventBatch.clear();
+		bool playing = AdvanceLayers(animComp, deltaTime, eventBatch);
+		if (!eventBatch.empty())
+		{
+			eventsDispatched += (unsigned int)eventBatch.size();
+			DispatchEvents(animComp);
+		}
 
-		if (animComp->currentTime > animation->GetDuration() && !animComp->repeat) continue; // Not repeating
+		if (!playing) continue;
 
-		// Advance the animation by ticks per second
-		animComp->currentTime += animation->GetTicksPerSecond() * animComp->speed * deltaTime;
-		animComp->currentTime = fmod(animComp->currentTime, animation->GetDuration());
+		// Culling runs after the layers update, so the tier comes from what could be seen last frame
+		AnimationLODTier lastTier = animComp->lodTier;
+		animComp->lodTier = lodSettings.enabled ? AnimationLODUtils::SelectTier(animComp->visible, animComp->shadowVisible, animComp->screenSize, lastTier, lodSettings) : AnimationLODTier::Full;
+		tierCounts[(int)animComp->lodTier]++;
 
-		ComputeBoneTransforms(animComp, mesh->GetRootBone(), mesh->GetInverseTransform(), glm::mat4(1.0f), true);
+		unsigned int interval = AnimationLODUtils::GetUpdateInterval(animComp->lodTier, lodSettings);
+		if (interval == 0) // Off screen, the time it advanced is all it needs
+		{
+			animComp->hasBounds = false; // Its pose isn't kept up to date, culling goes back to the bind pose box so it can't get stuck out of view
+			continue;
+		}
 
-		if (animComp->lerping)
+		animComp->bakedPalette = nullptr;
+		if (CanPlayBaked(animComp))
 		{
-			animComp->lerpTime += animComp->lerpSpeed * deltaTime;
-			if (animComp->lerpTime >= 1.0f) animComp->lerping = false;
+			const BakedAnimation& baked = GetBakedAnimation(mesh, animComp->layers[0].clips[0].anim);
+			float time = animComp->layers[0].clips[0].time;
+			bakedCount++;
+
+			animComp->evaluatedBoneMatrices.clear(); // Going back to live evaluation has nothing to extrapolate from
+
+			// Only characters at full detail are worth interpolating for, everyone else points straight at the nearest frame
+			bool interpolate = animComp->bakedInterpolation && animComp->lodTier == AnimationLODTier::Full;
+			animComp->hasBounds = baked.GetBounds(time, interpolate, animComp->boundsMin, animComp->boundsMax);
+			if (interpolate)
+			{
+				PoseJob job;
+				job.data = animations[i];
+				job.evaluate = false;
+				job.baked = &baked;
+				jobs.push_back(job);
+			}
+			else
+			{
+				animComp->bakedPalette = baked.GetPalette(baked.GetNearestFrame(time));
+			}
+
+			continue;
 		}
+
+		// Throttled characters are spread over the frames by their index, so they don't all evaluate on the same one. Coming back on screen evaluates straight away
+		animComp->timeSinceEvaluation += deltaTime;
+		PoseJob job;
+		job.data = animations[i];
+		job.baked = nullptr;
+		job.evaluate = (frameIndex + i) % interval == 0 || lastTier == AnimationLODTier::OffScreen || animComp->evaluatedBoneMatrices.empty();
+		jobs.push_back(job);
+
+		if (!job.evaluate) continue;
+
+		bool skipDetailJoints = AnimationLODUtils::SkipsDetailJoints(animComp->lodTier);
+		for (SkeletalAnimationComponent::Layer& layer : animComp->layers)
+		{
+			if (layer.weight <= 0.0f) continue;
+
+			for (SkeletalAnimationComponent::PlayingClip& clip : layer.clips)
+			{
+				clip.binding = &mesh->GetAnimationBinding(clip.anim, skipDetailJoints);
+				clip.cursors.resize(clip.anim->GetChannelCount());
+				bonesEvaluated += mesh->GetSkeleton().GetJointCount();
+			}
+		}
+	}
+
+	// Every character is independent, so each one is its own task
+	JobSystem::ParallelFor((unsigned int)jobs.size(), 1, [this](unsigned int start, unsigned int end)
+	{
+		for (unsigned int i = start; i < end; i++)
+		{
+			EvaluatePose(jobs[i]);
+		}
+	});
+
+	totalBonesEvaluated += bonesEvaluated;
+	totalUpdateTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - updateStart).count();
+
+	Profiler::SetCounter("Bones Evaluated", bonesEvaluated);
+	Profiler::SetCounter("Animation Baked", bakedCount);
+	Profiler::SetCounter("Animation Events", eventsDispatched);
+	for (int tier = 0; tier < (int)AnimationLODTier::Count; tier++)
+	{
+		Profiler::SetCounter(std::string("Animation LOD ") + AnimationLODUtils::GetTierName((AnimationLODTier)tier), tierCounts[tier]);
 	}
 }
 
-void SkeletalAnimationLayer::ComputeBoneTransforms(SkeletalAnimationComponent* anim, const Bone& bone, const glm::mat4& inverseTransform, glm::mat4 parentTransform, bool root)
+// Samples every clip of the layer & fades them into each other, reference gets the same done to the clips' first frames when it isn't nullptr
+static Pose& SampleLayer(SkeletalAnimationComponent::Layer& layer, const Skeleton& skeleton, Pose** reference)
 {
-	Animation* animation = anim->anim;
+	unsigned int jointCount = skeleton.GetJointCount();
+	Pose& pose = posePool.Acquire(jointCount);
+	Pose* clipPose = layer.clips.size() > 1 ? &posePool.Acquire(jointCount) : nullptr;
+	if (reference) *reference = nullptr;
 
-	glm::vec3 position;
-	glm::quat rotation;
-	glm::vec3 scale;
- 	animation->GetFrameData(bone.name, anim->currentTime, position, rotation, scale);
+	for (unsigned int i = 0; i < layer.clips.size(); i++)
+	{
+		SkeletalAnimationComponent::PlayingClip& clip = layer.clips[i];
+		Pose& target = i == 0 ? pose : *clipPose;
+		PoseUtils::SamplePose(clip.anim, *clip.binding, clip.time, clip.cursors.data(), skeleton, target);
+		if (i > 0) PoseUtils::BlendPoses(pose, target, clip.fade, pose);
+
+		if (!reference) continue;
 
-	if (root && !anim->allowRootMotion) position = glm::vec3(0.0f, 0.0f, 0.0f); 
+		if (clip.reference.GetJointCount() != jointCount) PoseUtils::SamplePose(clip.anim, *clip.binding, 0.0f, nullptr, skeleton, clip.reference);
+		if (i == 0)
+		{
+			*reference = &clip.reference;
+		}
+		else
+		{
+			if (i == 1)
+			{
+				Pose& blendedReference = posePool.Acquire(jointCount);
+				PoseUtils::BlendPoses(**reference, clip.reference, clip.fade, blendedReference);
+				*reference = &blendedReference;
+			}
+			else
+			{
+				PoseUtils::BlendPoses(**reference, clip.reference, clip.fade, **reference);
+			}
+		}
+	}
 
-	glm::mat4 transform = glm::translate(glm::mat4(1.0f), position) * glm::toMat4(rotation) * glm::scale(glm::mat4(1.0f), scale);
+	return pose;
+}
 
-	if (anim->lerping)
+void SkeletalAnimationLayer::ExtrapolateBoneMatrices(SkeletalAnimationComponent* anim)
+{
+	float time = std::min(anim->timeSinceEvaluation, MAX_EXTRAPOLATION);
+	for (unsigned int i = 0; i < anim->boneMatrices.size(); i++)
 	{
-		glm::vec3 lastPosition;
-		glm::quat lastRotation;
-		glm::vec3 lastScale;
-		anim->lastAnim->GetFrameData(bone.name, anim->lastTime, lastPosition, lastRotation, lastScale);
+		anim->boneMatrices[i] = anim->evaluatedBoneMatrices[i] + anim->boneMatrixVelocities[i] * time;
+	}
+}
+
+void SkeletalAnimationLayer::StoreEvaluation(SkeletalAnimationComponent* anim)
+{
+	// Full tier characters need the velocities too, they can drop a tier on any frame
+	bool hasLast = anim->evaluatedBoneMatrices.size() == anim->boneMatrices.size() && anim->timeSinceEvaluation > 0.0f;
 
-		if (root && !anim->allowRootMotion) lastPosition = glm::vec3(0.0f, 0.0f, 0.0f);
+	anim->boneMatrixVelocities.resize(anim->boneMatrices.size());
+	for (unsigned int i = 0; i < anim->boneMatrices.size(); i++)
+	{
+		anim->boneMatrixVelocities[i] = hasLast ? (anim->boneMatrices[i] - anim->evaluatedBoneMatrices[i]) / anim->timeSinceEvaluation : glm::mat4(0.0f);
+	}
 
-		glm::quat rot = glm::slerp(lastRotation, rotation, anim->lerpTime);
-		glm::vec3 pos = glm::mix(lastPosition, position, anim->lerpTime);
-		glm::vec3 sc = glm::mix(lastScale, scale, anim->lerpTime);
+	anim->evaluatedBoneMatrices = anim->boneMatrices;
+	anim->timeSinceEvaluation = 0.0f;
+}
 
-		transform = glm::translate(glm::mat4(1.0f), pos) * glm::toMat4(rot) * glm::scale(glm::mat4(1.0f), sc);
+void SkeletalAnimationLayer::EvaluatePose(const PoseJob& job)
+{
+	const AnimationData& data = job.data;
+	SkeletalAnimationComponent* anim = data.animationComp;
+	if (job.baked)
+	{
+		job.baked->Interpolate(anim->layers[0].clips[0].time, anim->boneMatrices.data());
+		return;
 	}
 
-	glm::mat4 globalTransform = parentTransform * transform;
+	if (!job.evaluate)
+	{
+		ExtrapolateBoneMatrices(anim);
+		UpdateBounds(data);
+		return;
+	}
 
-	glm::mat4 transformResult = inverseTransform * globalTransform * bone.offsetTransform;
+	const Skeleton& skeleton = data.animatedMesh->GetSkeleton();
+	if (skeleton.GetJointCount() == 0) return;
 
-	anim->boneMatrices[bone.ID] = transformResult; // Assign the bone matrix at the bone's index
+	posePool.ReleaseAll();
 
-	for (const Bone& bone : bone.children) // Go through the bone's children and do the same thing
+	// Every layer is sampled in local space & blended into result, the hierarchy is only walked once at the end
+	Pose* result = nullptr;
+	for (SkeletalAnimationComponent::Layer& layer : anim->layers)
 	{
-		ComputeBoneTransforms(anim, bone, inverseTransform, globalTransform, false);
+		if (layer.clips.empty() || layer.weight <= 0.0f) continue;
+
+		Pose* reference;
+		Pose& layerPose = SampleLayer(layer, skeleton, layer.additive ? &reference : nullptr);
+
+		if (!result)
+		{
+			bool replaces = !layer.additive && !layer.mask && layer.weight >= 1.0f;
+			if (replaces) // Nothing below it to blend with
+			{
+				result = &layerPose;
+				continue;
+			}
+
+			result = &posePool.Acquire(skeleton.GetJointCount());
+			PoseUtils::SetRestPose(skeleton, *result);
+		}
+
+		if (layer.additive)
+		{
+			PoseUtils::AddPose(*result, layerPose, *reference, layer.weight, *result, layer.mask);
+		}
+		else
+		{
+			PoseUtils::BlendPoses(*result, layerPose, layer.weight, *result, layer.mask);
+		}
 	}
+
+	if (!result) return;
+
+	// The root is always the first joint
+	if (!anim->allowRootMotion) result->SetJoint(0, glm::vec3(0.0f, 0.0f, 0.0f), result->GetRotation(0), result->GetScale(0));
+
+	// Straight into the component's palette, the renderer uploads it from there
+	PoseUtils::ComputeSkinningMatrices(skeleton, *result, data.animatedMesh->GetInverseTransform(), anim->boneMatrices.data());
+	StoreEvaluation(anim);
+	UpdateBounds(data);
+}
+
+void SkeletalAnimationLayer::UpdateBounds(const AnimationData& data)
+{
+	SkeletalAnimationComponent* anim = data.animationComp;
+	anim->hasBounds = SkinnedBoundsUtils::ComputeSkinnedBounds(data.animatedMesh->GetBoneBounds(), anim->boneMatrices.data(), anim->boundsMin, anim->boundsMax);
 }
\ No newline at end of file
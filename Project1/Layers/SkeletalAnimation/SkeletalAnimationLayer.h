@@ -2,7 +2,12 @@
 
 #include "ApplicationLayer.h"
 #include "SkeletalAnimationComponent.h"
+#include "AnimationLOD.h"
+#include "BakedAnimation.h"
+#include "AnimationEvents.h"
 
+#include <cstdint>
+#include <map>
 #include <vector>
 
 class AnimatedMesh;
@@ -22,6 +27,42 @@ public:
 
 	std::vector<AnimationData> animations;
 
+	AnimationLODSettings& GetLODSettings() { return lodSettings; }
+
+	// Frames per second of the tables SkeletalAnimationComponent::baked plays from. Tables that were already baked keep their rate
+	void SetBakeSampleRate(float sampleRate) { bakeSampleRate = sampleRate; }
+	float GetBakeSampleRate() const { return bakeSampleRate; }
+
+	// Totals since the layer was created, --bench-animation divides them for the bones evaluated per second
+	uint64_t GetTotalBonesEvaluated() const { return totalBonesEvaluated; }
+	double GetTotalUpdateTime() const { return totalUpdateTime; } // Seconds spent in OnUpdate
+
 private:
-	void ComputeBoneTransforms(SkeletalAnimationComponent* anim, const Bone& bone, const glm::mat4& inverseTransform, glm::mat4 parentTransform, bool root);
+	struct PoseJob
+	{
+		AnimationData data;
+		bool evaluate; // false extrapolates the last evaluations instead, for throttled characters between their updates
+		const BakedAnimation* baked; // Interpolates this table instead when set
+	};
+
+	static bool CanPlayBaked(const SkeletalAnimationComponent* animComp);
+	const BakedAnimation& GetBakedAnimation(AnimatedMesh* mesh, Animation* animation); // Bakes it the first time, main thread only
+
+	static bool AdvanceLayers(SkeletalAnimationComponent* animComp, float deltaTime, std::vector<AnimationEventRecord>& events); // Fades & advances every playing clip, true if anything can be seen. Appends the events they crossed when the component has listeners
+	void DispatchEvents(SkeletalAnimationComponent* animComp); // Hands eventBatch to the component's listeners
+	static void EvaluatePose(const PoseJob& job); // Runs on the JobSystem, only touches the job's component
+	static void ExtrapolateBoneMatrices(SkeletalAnimationComponent* animComp); // Moves the palette along the way it moved between the last 2 evaluations
+	static void StoreEvaluation(SkeletalAnimationComponent* animComp); // Remembers the palette that was just evaluated & how fast it changed since the last one
+	static void UpdateBounds(const AnimationData& data); // Skinned bounds of boneMatrices
+
+	std::vector<PoseJob> jobs; // Characters on screen this frame
+	std::vector<AnimationEventRecord> eventBatch; // Events of the component being advanced, reused so dispatching doesn't allocate once it has grown
+	AnimationLODSettings lodSettings;
+	unsigned int frameIndex;
+
+	std::map<std::pair<const AnimatedMesh*, const Animation*>, BakedAnimation> bakedAnimations; // Never rebaked or freed, components point into them
+	float bakeSampleRate;
+
+	uint64_t totalBonesEvaluated;
+	double totalUpdateTime;
 };
\ No newline at end of file
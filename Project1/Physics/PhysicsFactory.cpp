@@ -34,12 +34,18 @@ Physics::MeshShape* PhysicsFactory::GetMeshShape(IMesh* mesh)
 	std::unordered_map<IMesh*, Physics::MeshShape*>::iterator it = meshCoilliders.find(mesh);
 	if (it != meshCoilliders.end()) return it->second;
 
+	if (!mesh->HasCPUData())
+	{
+		std::cout << "Can't create a mesh collider for " << mesh->GetPath() << ", its CPU data was already released!" << std::endl;
+		return nullptr;
+	}
+
+	Span<const Face> meshFaces = mesh->GetFaces();
 	std::vector<int> faces;
-	unsigned int faceSize = mesh->GetFaces().size() * 3;
-	faces.resize(faceSize);
+	faces.resize(meshFaces.Size() * 3);
 
 	int i = 0;
-	for (const Face& face : mesh->GetFaces())
+	for (const Face& face : meshFaces)
 	{
 		faces[i] = face.v1;
 		faces[i + 1] = face.v2;
@@ -47,16 +53,15 @@ Physics::MeshShape* PhysicsFactory::GetMeshShape(IMesh* mesh)
 		i += 3;
 	}
 
+	StridedSpan<const glm::vec3> positions = mesh->GetPositions();
 	std::vector<float> vertices;
-	int vertexSize = mesh->GetVertices().size() * 3;
-	vertices.resize(vertexSize);
-	i = 0;
-	for (IVertex* v : mesh->GetVertices())
+	vertices.resize(positions.Size() * 3);
+	for (unsigned int j = 0; j < positions.Size(); j++)
 	{
-		vertices[i] = v->Data()[0];
-		vertices[i + 1] = v->Data()[1];
-		vertices[i + 2] = v->Data()[2];
-		i += 3;
+		const glm::vec3& position = positions[j];
+		vertices[j * 3] = position.x;
+		vertices[j * 3 + 1] = position.y;
+		vertices[j * 3 + 2] = position.z;
 	}
 
 	Physics::MeshShape* meshShape = new Physics::MeshShape(faces, 3 * sizeof(int), vertices, 3 * sizeof(float));
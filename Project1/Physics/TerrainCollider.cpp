@@ -0,0 +1,95 @@
+#include "TerrainCollider.h"
+
+#include <cstdlib>
+
+TerrainCollider::TerrainCollider(btDiscreteDynamicsWorld* world, TerrainSampler& sampler, int tileRadius)
+	: world(world),
+	sampler(sampler),
+	tileRadius(tileRadius),
+	builtGeneration(sampler.GetGeneration())
+{
+
+}
+
+TerrainCollider::~TerrainCollider()
+{
+	Clear();
+}
+
+void TerrainCollider::Update(const glm::vec3& center)
+{
+	if (builtGeneration != sampler.GetGeneration()) // Terrain settings changed, none of the current tiles match anymore
+	{
+		Clear();
+		builtGeneration = sampler.GetGeneration();
+	}
+
+	glm::ivec2 centerTile = sampler.GetTileCoords(center.x, center.z);
+
+	// Drop the tiles that fell out of range
+	std::map<std::pair<int, int>, ColliderTile*>::iterator it = tiles.begin();
+	while (it != tiles.end())
+	{
+		if (std::abs(it->first.first - centerTile.x) > tileRadius || std::abs(it->first.second - centerTile.y) > tileRadius)
+		{
+			RemoveTile(it->second);
+			it = tiles.erase(it);
+		}
+		else
+		{
+			it++;
+		}
+	}
+
+	for (int z = centerTile.y - tileRadius; z <= centerTile.y + tileRadius; z++)
+	{
+		for (int x = centerTile.x - tileRadius; x <= centerTile.x + tileRadius; x++)
+		{
+			if (tiles.find(std::make_pair(x, z)) == tiles.end()) AddTile(x, z);
+		}
+	}
+}
+
+void TerrainCollider::Clear()
+{
+	std::map<std::pair<int, int>, ColliderTile*>::iterator it;
+	for (it = tiles.begin(); it != tiles.end(); it++)
+	{
+		RemoveTile(it->second);
+	}
+	tiles.clear();
+}
+
+void TerrainCollider::AddTile(int tileX, int tileZ)
+{
+	const TerrainTile& terrainTile = sampler.GetTile(tileX, tileZ);
+
+	ColliderTile* tile = new ColliderTile();
+	tile->heights = terrainTile.heights; // Copied, the sampler is free to evict its tile while we still collide with it
+
+	int resolution = (int)terrainTile.resolution;
+	tile->shape = new btHeightfieldTerrainShape(resolution, resolution, tile->heights.data(), 1.0f, terrainTile.minHeight, terrainTile.maxHeight, 1, PHY_FLOAT, false);
+	tile->shape->setLocalScaling(btVector3(terrainTile.spacing, 1.0f, terrainTile.spacing));
+
+	// Bullet centers heightfields on their bounds, so the origin has to be the middle of the tile
+	float tileSize = terrainTile.spacing * (resolution - 1);
+	btTransform transform;
+	transform.setIdentity();
+	transform.setOrigin(btVector3(terrainTile.origin.x + tileSize * 0.5f, (terrainTile.minHeight + terrainTile.maxHeight) * 0.5f, terrainTile.origin.y + tileSize * 0.5f));
+
+	tile->object = new btCollisionObject();
+	tile->object->setCollisionShape(tile->shape);
+	tile->object->setWorldTransform(transform);
+	tile->object->setCollisionFlags(tile->object->getCollisionFlags() | btCollisionObject::CF_STATIC_OBJECT);
+	world->addCollisionObject(tile->object, btBroadphaseProxy::StaticFilter, btBroadphaseProxy::AllFilter ^ btBroadphaseProxy::StaticFilter);
+
+	tiles[std::make_pair(tileX, tileZ)] = tile;
+}
+
+void TerrainCollider::RemoveTile(ColliderTile* tile)
+{
+	world->removeCollisionObject(tile->object);
+	delete tile->object;
+	delete tile->shape;
+	delete tile;
+}
\ No newline at end of file
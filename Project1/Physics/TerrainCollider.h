@@ -0,0 +1,47 @@
+#pragma once
+
+#include "TerrainSampler.h"
+
+#include <Bullet/btBulletDynamicsCommon.h>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+
+#include <glm/glm.hpp>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+// Keeps static heightfield colliders for the terrain tiles around a point (usually the player) in the physics world.
+// Tiles come from the sampler's cache and are swapped in & out as the point moves, everything is rebuilt when the terrain settings change
+class TerrainCollider
+{
+public:
+	TerrainCollider(btDiscreteDynamicsWorld* world, TerrainSampler& sampler, int tileRadius = 1);
+	~TerrainCollider();
+
+	void Update(const glm::vec3& center);
+	void Clear(); // Removes every tile from the world
+
+	unsigned int GetTileCount() const { return (unsigned int)tiles.size(); }
+
+private:
+	struct ColliderTile
+	{
+		std::vector<float> heights; // The shape reads straight from this, so it has to live as long as the shape does
+		btHeightfieldTerrainShape* shape;
+		btCollisionObject* object;
+	};
+
+	void AddTile(int tileX, int tileZ);
+	void RemoveTile(ColliderTile* tile);
+
+	btDiscreteDynamicsWorld* world;
+	TerrainSampler& sampler;
+	int tileRadius;
+
+	std::map<std::pair<int, int>, ColliderTile*> tiles;
+	unsigned int builtGeneration;
+
+	TerrainCollider(const TerrainCollider& other) = delete;
+	TerrainCollider& operator=(const TerrainCollider& other) = delete;
+};
\ No newline at end of file
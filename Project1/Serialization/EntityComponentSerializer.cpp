@@ -5,6 +5,7 @@
 #include "IMesh.h"
 #include "TextureManager.h"
 #include "Texture2D.h"
+#include "AssetLoader.h"
 #include "BulletUtils.h"
 #include "PhysicsFactory.h"
 #include "Renderer.h"
@@ -278,7 +279,7 @@ void EntityComponentSerializer::SaveRenderComponent(YAML::Emitter& emitter, Rend
 	for (std::pair<ITexture*, float>& p : renderComp->albedoTextures)
 	{
 		emitter << YAML::BeginMap;
-		emitter << YAML::Key << "Path" << YAML::Value << p.first->GetPath();
+		emitter << YAML::Key << "Path" << YAML::Value << AssetLoader::GetTexturePath(p.first);
 		emitter << YAML::Key << "FilterType" << YAML::Value << (int)p.first->GetFilterType();
 		emitter << YAML::Key << "WrapType" << YAML::Value << (int)p.first->GetWrapType();
 		emitter << YAML::Key << "Strength" << YAML::Value << p.second;
@@ -289,7 +290,7 @@ void EntityComponentSerializer::SaveRenderComponent(YAML::Emitter& emitter, Rend
 	if (renderComp->normalTexture)
 	{
 		emitter << YAML::Key << "NormalTexture" << YAML::Value << YAML::BeginMap;
-		emitter << YAML::Key << "Path" << YAML::Value << renderComp->normalTexture->GetPath();
+		emitter << YAML::Key << "Path" << YAML::Value << AssetLoader::GetTexturePath(renderComp->normalTexture);
 		emitter << YAML::Key << "FilterType" << YAML::Value << (int)renderComp->normalTexture->GetFilterType();
 		emitter << YAML::Key << "WrapType" << YAML::Value << (int)renderComp->normalTexture->GetWrapType();
 		emitter << YAML::EndMap;
@@ -298,7 +299,7 @@ void EntityComponentSerializer::SaveRenderComponent(YAML::Emitter& emitter, Rend
 	if (renderComp->ormTexture)
 	{
 		emitter << YAML::Key << "ORMTexture" << YAML::Value << YAML::BeginMap;
-		emitter << YAML::Key << "Path" << YAML::Value << renderComp->ormTexture->GetPath();
+		emitter << YAML::Key << "Path" << YAML::Value << AssetLoader::GetTexturePath(renderComp->ormTexture);
 		emitter << YAML::Key << "FilterType" << YAML::Value << (int)renderComp->ormTexture->GetFilterType();
 		emitter << YAML::Key << "WrapType" << YAML::Value << (int)renderComp->ormTexture->GetWrapType();
 		emitter << YAML::EndMap;
@@ -1,5 +1,6 @@
 #include "GrassSerializer.h"
 #include "TextureManager.h"
+#include "AssetLoader.h"
 
 GrassSerializer::GrassSerializer(GrassCluster& cluster)
 	: cluster(cluster)
@@ -11,9 +12,9 @@ void GrassSerializer::Serialize(YAML::Emitter& emitter)
 {
 	emitter << YAML::BeginMap;
 
-	emitter << YAML::Key << "AlbedoTexture" << YAML::Value << cluster.albedoTexture->GetPath();
-	if (cluster.discardTexture) emitter << YAML::Key << "DiscardTexture" << YAML::Value << cluster.discardTexture->GetPath();
-	if (cluster.normalTexture) emitter << YAML::Key << "NormalTexture" << YAML::Value << cluster.normalTexture->GetPath();
+	emitter << YAML::Key << "AlbedoTexture" << YAML::Value << AssetLoader::GetTexturePath(cluster.albedoTexture);
+	if (cluster.discardTexture) emitter << YAML::Key << "DiscardTexture" << YAML::Value << AssetLoader::GetTexturePath(cluster.discardTexture);
+	if (cluster.normalTexture) emitter << YAML::Key << "NormalTexture" << YAML::Value << AssetLoader::GetTexturePath(cluster.normalTexture);
 
 	emitter << YAML::Key << "Roughness" << YAML::Value << cluster.roughness;
 	emitter << YAML::Key << "Metalness" << YAML::Value << cluster.metalness;
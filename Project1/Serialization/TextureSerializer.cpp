@@ -1,4 +1,5 @@
 #include "TextureSerializer.h"
+#include "AssetLoader.h"
 
 TextureSerializer::TextureSerializer(ITexture* t)
 	: texture(t)
@@ -25,7 +26,7 @@ void TextureSerializer::Deserialize(const YAML::Node& node)
 
 void TextureSerializer::SaveTexture2D(YAML::Emitter& emitter, Texture2D* t)
 {
-	emitter << YAML::Key << "Path" << YAML::Value << t->GetPath();
+	emitter << YAML::Key << "Path" << YAML::Value << AssetLoader::GetTexturePath(t);
 	emitter << YAML::Key << "FilterType" << YAML::Value << (int) t->GetFilterType();
 	emitter << YAML::Key << "WrapType" << YAML::Value << (int)t->GetWrapType();
 }
\ No newline at end of file
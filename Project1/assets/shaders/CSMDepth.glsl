@@ -1,15 +1,31 @@
 //type vertex
 #version 420
 
-layout (location = 0) in vec3 vPosition;
-layout (location = 1) in vec3 vNormal;
-layout (location = 2) in vec2 vTextureCoordinates;
+layout (location = 0) in vec4 vPosition; // UNORM16 inside the submesh bounds (found in VertexCompression.h)
+layout (location = 1) in vec2 vNormal; // SNORM16 octahedral encoding
+layout (location = 2) in vec2 vTextureCoordinates; // Half floats
+layout (location = 5) in vec3 vPositionOffset; // Constant for the whole submesh, set by RenderComponent::Draw
+layout (location = 6) in vec3 vPositionScale;
 
 uniform mat4 uMatModel;
 
+vec3 DecodePosition()
+{
+	return vPosition.xyz * vPositionScale + vPositionOffset;
+}
+
+vec3 DecodeOctahedral(vec2 encoded) // Same as VertexCompressionUtils::DecodeNormal
+{
+	vec3 normal = vec3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float t = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return normalize(normal);
+}
+
 void main()
 {	
-	gl_Position = uMatModel * vec4(vPosition, 1.0f);
+	gl_Position = uMatModel * vec4(DecodePosition(), 1.0f);
 };
 
 
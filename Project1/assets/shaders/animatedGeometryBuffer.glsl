@@ -1,23 +1,46 @@
 //type vertex
-#version 420
+#version 430
 
-layout (location = 0) in vec3 vPosition;
-layout (location = 1) in vec3 vNormal;
-layout (location = 2) in vec2 vTextureCoordinates;
-layout (location = 3) in vec4 vBoneIDs;
-layout (location = 4) in vec4 vBoneWeights;
+layout (location = 0) in vec4 vPosition; // UNORM16 inside the submesh bounds (found in VertexCompression.h)
+layout (location = 1) in vec2 vNormal; // SNORM16 octahedral encoding
+layout (location = 2) in vec2 vTextureCoordinates; // Half floats
+layout (location = 3) in uvec4 vBoneIDs;
+layout (location = 4) in vec4 vBoneWeights; // UNORM8, unused influences have a weight of 0
+layout (location = 5) in vec3 vPositionOffset; // Constant for the whole submesh, set by RenderComponent::Draw
+layout (location = 6) in vec3 vPositionScale;
 
-const int MAX_BONES = 100;
 const int MAX_BONE_INFLUENCE = 4;
 
-uniform mat4 uMatModel;
-uniform mat4 uMatModelInverseTranspose;
-uniform mat4 uMatView;
-uniform mat4 uMatProjection;
-uniform mat4 uMatProjViewModel;
-uniform mat4 uMatPrevProjViewModel;
-uniform vec3 uCameraPosition;
-uniform mat4 uBoneMatrices[MAX_BONES];
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
+
+layout (std140, binding = 2) uniform uDrawData // Written once per draw by GeometryPass & ForwardRenderPass (found in UniformBlocks.h)
+{
+	mat4 uMatModel;
+	mat4 uMatProjViewModel;
+	mat4 uMatPrevProjViewModel;
+	vec4 uColorOverride;
+	vec4 uAlbedoRatios;
+	vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
+	vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
+	vec2 uUVOffset;
+	float uShadowSoftness;
+	float uAlphaTransparency;
+	bool uHasNormalTexture;
+	bool uIgnoreLighting;
+	int uBoneOffset;
+	int uBoneCount;
+};
+
+layout (std430, binding = 0) readonly buffer uBonePalette // Every animated mesh's bone matrices for the frame, uploaded once by Renderer (found in UniformBlocks.h)
+{
+	mat4 uBoneMatrices[];
+};
 
 out vec3 mWorldPosition;
 out vec2 mTextureCoordinates;
@@ -26,30 +49,44 @@ out vec4 mFragPosition;
 out vec4 mPrevFragPosition;
 out vec3 mView;
 
+vec3 DecodePosition()
+{
+	return vPosition.xyz * vPositionScale + vPositionOffset;
+}
+
+vec3 DecodeOctahedral(vec2 encoded) // Same as VertexCompressionUtils::DecodeNormal
+{
+	vec3 normal = vec3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float t = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return normalize(normal);
+}
+
 void main()
 {		
-	vec4 vertexPos = vec4(vPosition, 1.0f);
+	vec4 vertexPos = vec4(DecodePosition(), 1.0f);
+	vec3 vertexNormal = DecodeOctahedral(vNormal);
 
 	vec4 transformedPos = vec4(0.0f, 0.0f, 0.0f, 0.0f);
 	vec3 transformedNormal = vec3(0.0f, 0.0f, 0.0f);
 	for(int i = 0; i < MAX_BONE_INFLUENCE; i++)
 	{
+		float weight = vBoneWeights[i];
+		if(weight == 0.0f) continue; // Unused influence
+
 		int boneID = int(vBoneIDs[i]);
-		if(boneID == -1) break; // Bone ID was still non-existent, nothing to do here
-		
-		if(boneID >= MAX_BONES) // We have exceeded the max bone count, just set this vertex to the default vertex position
+		if(boneID >= uBoneCount) // We have exceeded the bone count, just set this vertex to the default vertex position
 		{
 			transformedPos = vertexPos;
-			transformedNormal = vNormal;
+			transformedNormal = vertexNormal;
 			break;
 		}
-		
-		float weight = vBoneWeights[i];
 
-		vec4 localPos = uBoneMatrices[boneID] * vertexPos;
+		vec4 localPos = uBoneMatrices[uBoneOffset + boneID] * vertexPos;
 		transformedPos += localPos * weight;
 		
-		vec3 localNormal = mat3(uBoneMatrices[boneID]) * vNormal;
+		vec3 localNormal = mat3(uBoneMatrices[uBoneOffset + boneID]) * vertexNormal;
 		transformedNormal += localNormal * weight;
 	}
 
@@ -85,26 +122,35 @@ in vec4 mFragPosition;
 in vec4 mPrevFragPosition;
 in vec3 mView;
 
+layout (std140, binding = 2) uniform uDrawData // Written once per draw by GeometryPass & ForwardRenderPass (found in UniformBlocks.h)
+{
+	mat4 uMatModel;
+	mat4 uMatProjViewModel;
+	mat4 uMatPrevProjViewModel;
+	vec4 uColorOverride;
+	vec4 uAlbedoRatios;
+	vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
+	vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
+	vec2 uUVOffset;
+	float uShadowSoftness;
+	float uAlphaTransparency;
+	bool uHasNormalTexture;
+	bool uIgnoreLighting;
+	int uBoneOffset;
+	int uBoneCount;
+};
+
 uniform sampler2D uAlbedoTexture1;
 uniform sampler2D uAlbedoTexture2;
 uniform sampler2D uAlbedoTexture3;
 uniform sampler2D uAlbedoTexture4;
-uniform vec4 uAlbedoRatios;
-uniform vec2 uUVOffset;
-uniform vec4 uColorOverride;
-
-uniform bool uHasNormalTexture;
 uniform sampler2D uNormalTexture;
 
-uniform float uShadowSoftness;
-
 // RR = Reflectivity/Refraction
 uniform samplerCube uRRMap;
-uniform vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
 
 // Material
 uniform sampler2D uORMTexture;
-uniform vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
 
 const float NEAR_PLANE = 0.1f;
 const float FAR_PLANE = 1000.0f;
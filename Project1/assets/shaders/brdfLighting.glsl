@@ -26,7 +26,7 @@ void main()
 
 
 //type fragment
-#version 420 
+#version 430
 
 in vec2 mTextureCoordinates;
 in vec3 mEnvMapCoordinates;
@@ -37,16 +37,14 @@ out vec4 oColor;
 
 const float PI = 3.14159265359f;
 const float preFilterLODLevel = 4.0f;
-const int MAX_LIGHTS = 100;
 const float ATTEN_MULT = 10.0f;
 
-struct LightInfo
+struct LightInfo // Packed by LightManager (found in LightManager.h)
 {
-	vec3 position;
-	vec3 direction;
+	vec4 position;
+	vec4 direction; // w = cast shadows
 	vec4 color; // a = intensity
 	vec4 param1; // x = light type, y = radius, z = on/off, w = attenuationMode (0 = quadratic, 1 = UE4 style)
-	bool castShadows;
 };
 
 // LIGHT TYPES
@@ -61,9 +59,24 @@ uniform sampler2D gNormal;
 uniform sampler2D gEffects;
 uniform vec4 gMaterialOverrides;
 
-// Lighitng
-uniform int uLightAmount;
-uniform LightInfo uLightArray[MAX_LIGHTS];
+// Lighting, lights are binned into a froxel grid by LightManager so we only loop over the ones that can reach this fragment
+const uvec3 CLUSTER_GRID = uvec3(16, 9, 24); // Has to match LightManager.h
+uniform vec4 uClusterParams; // x = depth slice scale, y = depth slice bias, z = tile width, w = tile height (pixels)
+
+layout (std430, binding = 1) readonly buffer uLightBuffer
+{
+	LightInfo uLights[];
+};
+
+layout (std430, binding = 2) readonly buffer uLightClusters
+{
+	uvec2 uClusterRanges[]; // x = offset into uLightIndices, y = light count
+};
+
+layout (std430, binding = 3) readonly buffer uLightIndexList
+{
+	uint uLightIndices[];
+};
 
 // Lighting factors
 uniform sampler2D uEnvMap;
@@ -81,14 +94,21 @@ layout (std140, binding = 0) uniform uLightSpaceMatrices // Our UniformBuffer fr
 	mat4 lightSpaceMatrices[MAX_CASCADES];
 };
 
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
+
 // Extra uniforms
-uniform vec3 uCameraPosition;
-uniform mat4 uView;
 uniform int uViewType; // 1 = color, 2 = position, 3 = normal, 4 = albedo, 5 = roughness, 6 = metalness, 7 = depth, 8 = velocity
 uniform vec3 uReflectivity; // F0 https://gyazo.com/14a06a2f540467848b3e2f94cff506ad
 
 vec3 LinearizeColor(vec3 color); // Converts to linear color space (sRGB to RGB). In other words, gamma correction https://lettier.github.io/3d-game-shaders-for-beginners/gamma-correction.html
 float Saturate(float value); // Clamps a value from 0 to 1
+uvec2 GetClusterLightRange(float viewDepth); // Returns the range in uLightIndices of the lights affecting this fragment
 
 // Math helpers
 vec3 ComputeFresnelSchlick(float cosTheta, vec3 surfaceReflection); // Computes reflection and refraction ratio using a simplified Fresnel equation (Schlick's equation)
@@ -135,22 +155,23 @@ void main()
 		
 		vec3 surfaceReflection = mix(uReflectivity, albedo, metalness); // Get the surface reflection at zero incidence (how much the surface reflects when looking directly at the surface)
 
-		for(int i = 0; i < min(uLightAmount, MAX_LIGHTS); i++)
+		uvec2 lightRange = GetClusterLightRange(-(uMatView * vec4(worldPos, 1.0f)).z);
+		for(uint i = 0; i < lightRange.y; i++)
 		{
-			LightInfo light = uLightArray[i];
+			LightInfo light = uLights[uLightIndices[lightRange.x + i]];
 			if(light.param1.z == 0.0f) // Light is off
 			{
 				continue;
 			}
 			
-			if(length(worldPos - light.position) > light.param1.y && light.param1.x != 0.0f) // Outside of reach
+			if(length(worldPos - light.position.xyz) > light.param1.y && light.param1.x != 0.0f) // Outside of reach
 			{
 				continue;
 			}
 			
 			if(light.param1.x == 0.0f) // Directional light
 			{	
-				vec3 lightDir = normalize(-light.direction);
+				vec3 lightDir = normalize(-light.direction.xyz);
 				vec3 halfwayDir = normalize(lightDir + V);
 				
 				float lightDot = Saturate(dot(N, lightDir)); // Get how much force is applied in the direction of normal in relation to the light direction clamped in range 0 - 1
@@ -168,9 +189,9 @@ void main()
 				kD *= 1.0f - metalness;
 				
 				float shadowContrib = 0.0f;
-				if(light.castShadows && canCastShadowOn)
+				if(light.direction.w > 0.0f && canCastShadowOn)
 				{
-					shadowContrib = ComputeShadow(worldPos, light.direction, normal) * shadowSoftness;
+					shadowContrib = ComputeShadow(worldPos, light.direction.xyz, normal) * shadowSoftness;
 				}
 				
 				vec3 diffuse = kD * albedo / PI;
@@ -179,7 +200,7 @@ void main()
 			
 			else if(light.param1.x == 1.0f) // Point light
 			{	
-				vec3 lightDir = light.position - worldPos;
+				vec3 lightDir = light.position.xyz - worldPos;
 				float distance = length(lightDir);
 				lightDir = normalize(lightDir);
 				vec3 halfwayDir = normalize(lightDir + V);
@@ -274,6 +295,13 @@ float Saturate(float value)
 	return clamp(value, 0.0f, 1.0f);
 }
 
+uvec2 GetClusterLightRange(float viewDepth)
+{
+	uint slice = uint(clamp(log(max(viewDepth, 0.0001f)) * uClusterParams.x + uClusterParams.y, 0.0f, float(CLUSTER_GRID.z - 1u)));
+	uvec2 tile = min(uvec2(gl_FragCoord.xy / uClusterParams.zw), CLUSTER_GRID.xy - 1u);
+	return uClusterRanges[tile.x + tile.y * CLUSTER_GRID.x + slice * CLUSTER_GRID.x * CLUSTER_GRID.y];
+}
+
 vec3 ComputeFresnelSchlick(float cosTheta, vec3 surfaceReflection)
 {
 	return surfaceReflection + (1.0f - surfaceReflection) * pow(2.0f, (-5.55473 * cosTheta - 6.98316) * cosTheta);
@@ -317,7 +345,7 @@ float ComputeGeometrySchlickGGX(float NdotV, float roughness)
 
 float ComputeShadow(vec3 fragmentPositionWorldSpace, vec3 lightDir, vec3 normal)
 {
-	vec4 fragPosViewSpace = uView * vec4(fragmentPositionWorldSpace, 1.0f); // Convert fragment world pos to view space
+	vec4 fragPosViewSpace = uMatView * vec4(fragmentPositionWorldSpace, 1.0f); // Convert fragment world pos to view space
 	float depth = abs(fragPosViewSpace.z); // Retreive the depth of the fragment in terms of view space
 	
 	// Get the cascade layer we should sample from
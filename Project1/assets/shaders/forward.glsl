@@ -1,39 +1,78 @@
 //type vertex
 #version 420
 
-layout (location = 0) in vec3 vPosition;
-layout (location = 1) in vec3 vNormal;
-layout (location = 2) in vec2 vTextureCoordinates;
+layout (location = 0) in vec4 vPosition; // UNORM16 inside the submesh bounds (found in VertexCompression.h)
+layout (location = 1) in vec2 vNormal; // SNORM16 octahedral encoding
+layout (location = 2) in vec2 vTextureCoordinates; // Half floats
+layout (location = 5) in vec3 vPositionOffset; // Constant for the whole submesh, set by RenderComponent::Draw
+layout (location = 6) in vec3 vPositionScale;
 
 out vec3 mNormal;
 out vec2 mTextureCoordinates;
 out vec3 mWorldPosition;
 out vec3 mViewPosition;
 
-uniform mat4 uMatModel;
-uniform mat4 uMatView;
-uniform mat4 uMatProjection;
-uniform mat4 uMatModelInverseTranspose;
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
+
+layout (std140, binding = 2) uniform uDrawData // Written once per draw by GeometryPass & ForwardRenderPass (found in UniformBlocks.h)
+{
+	mat4 uMatModel;
+	mat4 uMatProjViewModel;
+	mat4 uMatPrevProjViewModel;
+	vec4 uColorOverride;
+	vec4 uAlbedoRatios;
+	vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
+	vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
+	vec2 uUVOffset;
+	float uShadowSoftness;
+	float uAlphaTransparency;
+	bool uHasNormalTexture;
+	bool uIgnoreLighting;
+	int uBoneOffset;
+	int uBoneCount;
+};
+
+vec3 DecodePosition()
+{
+	return vPosition.xyz * vPositionScale + vPositionOffset;
+}
+
+vec3 DecodeOctahedral(vec2 encoded) // Same as VertexCompressionUtils::DecodeNormal
+{
+	vec3 normal = vec3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float t = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return normalize(normal);
+}
 
 void main()
 {	
+	vec4 vertexPos = vec4(DecodePosition(), 1.0f);
+
 	// Translate to view space
-	vec4 viewFragmentPosition = uMatView * uMatModel * vec4(vPosition, 1.0f);
+	vec4 viewFragmentPosition = uMatView * uMatModel * vertexPos;
 	mViewPosition = viewFragmentPosition.xyz;
 	
 	mTextureCoordinates = vTextureCoordinates;
 	
 	// Apply transformation to normal
-	mNormal = mat3(uMatModel) * vNormal;
+	mNormal = mat3(uMatModel) * DecodeOctahedral(vNormal);
 	
-	mWorldPosition = vec3(uMatModel * vec4(vPosition, 1.0f));
-	gl_Position = uMatProjection * uMatView * uMatModel * vec4(vPosition, 1.0f);
+	mWorldPosition = vec3(uMatModel * vertexPos);
+	gl_Position = uMatProjection * uMatView * uMatModel * vertexPos;
 };
 
 
 
 //type fragment
-#version 420 
+#version 430
 
 out vec3 mNormal;
 in vec2 mTextureCoordinates;
@@ -44,13 +83,12 @@ out vec4 oColor;
 
 const float PI = 3.14159265359f;
 const float preFilterLODLevel = 4.0f;
-const int MAX_LIGHTS = 100;
 const float ATTEN_MULT = 100.0f;
 
-struct LightInfo
+struct LightInfo // Packed by LightManager (found in LightManager.h)
 {
-	vec3 position;
-	vec3 direction;
+	vec4 position;
+	vec4 direction; // w = cast shadows
 	vec4 color;
 	vec4 param1; // x = light type, y = radius, z = on/off, w = attenuationMode (0 = quadratic, 1 = UE4 style)
 };
@@ -60,25 +98,49 @@ struct LightInfo
 // 2 = point
 // 3 = IBL
 
+layout (std140, binding = 2) uniform uDrawData // Written once per draw by GeometryPass & ForwardRenderPass (found in UniformBlocks.h)
+{
+	mat4 uMatModel;
+	mat4 uMatProjViewModel;
+	mat4 uMatPrevProjViewModel;
+	vec4 uColorOverride;
+	vec4 uAlbedoRatios;
+	vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
+	vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
+	vec2 uUVOffset;
+	float uShadowSoftness;
+	float uAlphaTransparency;
+	bool uHasNormalTexture;
+	bool uIgnoreLighting;
+	int uBoneOffset;
+	int uBoneCount;
+};
+
 uniform sampler2D uAlbedoTexture1;
 uniform sampler2D uAlbedoTexture2;
 uniform sampler2D uAlbedoTexture3;
 uniform sampler2D uAlbedoTexture4;
-uniform vec4 uAlbedoRatios;
-uniform vec4 uColorOverride;
-
-uniform bool uHasNormalTexture;
 uniform sampler2D uNormalTexture;
-
 uniform sampler2D uORMTexture;
-uniform vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
 
-uniform float uAlphaTransparency;
-uniform bool uIgnoreLighting;
+// Lighting, lights are binned into a froxel grid by LightManager so we only loop over the ones that can reach this fragment
+const uvec3 CLUSTER_GRID = uvec3(16, 9, 24); // Has to match LightManager.h
+uniform vec4 uClusterParams; // x = depth slice scale, y = depth slice bias, z = tile width, w = tile height (pixels)
+
+layout (std430, binding = 1) readonly buffer uLightBuffer
+{
+	LightInfo uLights[];
+};
+
+layout (std430, binding = 2) readonly buffer uLightClusters
+{
+	uvec2 uClusterRanges[]; // x = offset into uLightIndices, y = light count
+};
 
-// Lighitng
-uniform int uLightAmount;
-uniform LightInfo uLightArray[MAX_LIGHTS];
+layout (std430, binding = 3) readonly buffer uLightIndexList
+{
+	uint uLightIndices[];
+};
 
 uniform vec3 uReflectivity; 
 
@@ -87,6 +149,7 @@ vec3 ComputeTextureNormal();
 vec3 LinearizeColor(vec3 color); // Converts to linear color space (sRGB to RGB). In other words, gamma correction https://lettier.github.io/3d-game-shaders-for-beginners/gamma-correction.html
 vec2 ConvertCoordsToSpherical(vec3 normalizedCoords); // Converts a set of normalized coordinates 
 float Saturate(float value); // Clamps a value from 0 to 1
+uvec2 GetClusterLightRange(float viewDepth); // Returns the range in uLightIndices of the lights affecting this fragment
 
 // Math helpers
 vec3 ComputeFresnelSchlick(float cosTheta, vec3 surfaceReflection); // Computes reflection and refraction ratio using a simplified Fresnel equation (Schlick's equation)
@@ -158,22 +221,23 @@ void main()
 		
 		vec3 surfaceReflection = mix(uReflectivity, albedo, metalness); // Get the surface reflection at zero incidence (how much the surface reflects when looking directly at the surface)
 
-		for(int i = 0; i < min(uLightAmount, MAX_LIGHTS); i++)
+		uvec2 lightRange = GetClusterLightRange(-viewPos.z);
+		for(uint i = 0; i < lightRange.y; i++)
 		{
-			LightInfo light = uLightArray[i];
+			LightInfo light = uLights[uLightIndices[lightRange.x + i]];
 			if(light.param1.z == 0.0f) // Light is off
 			{
 				continue;
 			}
 			
-			if(length(worldPos - light.position) > light.param1.y) // Outside of reach
+			if(length(worldPos - light.position.xyz) > light.param1.y && light.param1.x != 0.0f) // Outside of reach
 			{
 				continue;
 			}
 			
 			if(light.param1.x == 0.0f) // Directional light
 			{	
-				vec3 lightDir = normalize(-light.direction);
+				vec3 lightDir = normalize(-light.direction.xyz);
 				vec3 halfwayDir = normalize(lightDir + V);
 				
 				vec3 gammaCorrectedColor = LinearizeColor(light.color.rgb);
@@ -199,11 +263,11 @@ void main()
 			
 			else if(light.param1.x == 1.0f) // Point light
 			{	
-				vec3 lightDir = normalize(light.position - worldPos);
+				vec3 lightDir = normalize(light.position.xyz - worldPos);
 				vec3 halfwayDir = normalize(lightDir + V);
 
 				vec3 gammaCorrectedColor = LinearizeColor(light.color.rgb);
-				float distance = length(light.position - worldPos);
+				float distance = length(light.position.xyz - worldPos);
 
 				float attenuation;
 				if(light.param1.w == 0.0f) // Linear atten
@@ -283,6 +347,13 @@ float Saturate(float value)
 	return clamp(value, 0.0f, 1.0f);
 }
 
+uvec2 GetClusterLightRange(float viewDepth)
+{
+	uint slice = uint(clamp(log(max(viewDepth, 0.0001f)) * uClusterParams.x + uClusterParams.y, 0.0f, float(CLUSTER_GRID.z - 1u)));
+	uvec2 tile = min(uvec2(gl_FragCoord.xy / uClusterParams.zw), CLUSTER_GRID.xy - 1u);
+	return uClusterRanges[tile.x + tile.y * CLUSTER_GRID.x + slice * CLUSTER_GRID.x * CLUSTER_GRID.y];
+}
+
 vec3 ComputeFresnelSchlick(float cosTheta, vec3 surfaceReflection)
 {
 	return surfaceReflection + (1.0f - surfaceReflection) * pow(1.0f - cosTheta, 5.0f);
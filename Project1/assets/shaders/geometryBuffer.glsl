@@ -1,17 +1,37 @@
 //type vertex
 #version 420
 
-layout (location = 0) in vec3 vPosition;
-layout (location = 1) in vec3 vNormal;
-layout (location = 2) in vec2 vTextureCoordinates;
-
-uniform mat4 uMatModel;
-uniform mat4 uMatModelInverseTranspose;
-uniform mat4 uMatView;
-uniform mat4 uMatProjection;
-uniform mat4 uMatProjViewModel;
-uniform mat4 uMatPrevProjViewModel;
-uniform vec3 uCameraPosition;
+layout (location = 0) in vec4 vPosition; // UNORM16 inside the submesh bounds (found in VertexCompression.h)
+layout (location = 1) in vec2 vNormal; // SNORM16 octahedral encoding
+layout (location = 2) in vec2 vTextureCoordinates; // Half floats
+layout (location = 5) in vec3 vPositionOffset; // Constant for the whole submesh, set by RenderComponent::Draw
+layout (location = 6) in vec3 vPositionScale;
+
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
+
+layout (std140, binding = 2) uniform uDrawData // Written once per draw by GeometryPass & ForwardRenderPass (found in UniformBlocks.h)
+{
+	mat4 uMatModel;
+	mat4 uMatProjViewModel;
+	mat4 uMatPrevProjViewModel;
+	vec4 uColorOverride;
+	vec4 uAlbedoRatios;
+	vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
+	vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
+	vec2 uUVOffset;
+	float uShadowSoftness;
+	float uAlphaTransparency;
+	bool uHasNormalTexture;
+	bool uIgnoreLighting;
+	int uBoneOffset;
+	int uBoneCount;
+};
 
 out vec3 mWorldPosition;
 out vec2 mTextureCoordinates;
@@ -20,15 +40,29 @@ out vec4 mFragPosition;
 out vec4 mPrevFragPosition;
 out vec3 mView;
 
+vec3 DecodePosition()
+{
+	return vPosition.xyz * vPositionScale + vPositionOffset;
+}
+
+vec3 DecodeOctahedral(vec2 encoded) // Same as VertexCompressionUtils::DecodeNormal
+{
+	vec3 normal = vec3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float t = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return normalize(normal);
+}
+
 void main()
 {		
-	vec4 vertexPos = vec4(vPosition, 1.0f);
+	vec4 vertexPos = vec4(DecodePosition(), 1.0f);
 	mWorldPosition = (uMatModel * vertexPos).xyz;
 	
 	mTextureCoordinates = vTextureCoordinates;
 	
 	// Apply transformation to normal
-	mNormal = mat3(uMatModel) * vNormal;
+	mNormal = mat3(uMatModel) * DecodeOctahedral(vNormal);
 
 	mFragPosition = uMatProjViewModel * vertexPos;
 	mPrevFragPosition = uMatPrevProjViewModel * vertexPos;
@@ -55,26 +89,35 @@ in vec4 mFragPosition;
 in vec4 mPrevFragPosition;
 in vec3 mView;
 
+layout (std140, binding = 2) uniform uDrawData // Written once per draw by GeometryPass & ForwardRenderPass (found in UniformBlocks.h)
+{
+	mat4 uMatModel;
+	mat4 uMatProjViewModel;
+	mat4 uMatPrevProjViewModel;
+	vec4 uColorOverride;
+	vec4 uAlbedoRatios;
+	vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
+	vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
+	vec2 uUVOffset;
+	float uShadowSoftness;
+	float uAlphaTransparency;
+	bool uHasNormalTexture;
+	bool uIgnoreLighting;
+	int uBoneOffset;
+	int uBoneCount;
+};
+
 uniform sampler2D uAlbedoTexture1;
 uniform sampler2D uAlbedoTexture2;
 uniform sampler2D uAlbedoTexture3;
 uniform sampler2D uAlbedoTexture4;
-uniform vec4 uAlbedoRatios;
-uniform vec2 uUVOffset;
-uniform vec4 uColorOverride;
-
-uniform bool uHasNormalTexture;
 uniform sampler2D uNormalTexture;
 
-uniform float uShadowSoftness;
-
 // RR = Reflectivity/Refraction
 uniform samplerCube uRRMap;
-uniform vec4 uRRInfo; // x =  1.0f = reflect, 2.0f = refract), y = reflectivity/refraction strength, z = refractive ratio
 
 // Material
 uniform sampler2D uORMTexture;
-uniform vec4 uMaterialOverrides; // r = roughness, g = metalness, b = ao, w = isMaterialOverride
 
 const float NEAR_PLANE = 0.1f;
 const float FAR_PLANE = 1000.0f;
@@ -20,16 +20,19 @@ out vec3 mWorldPosition;
 out vec3 mNormal;
 out vec2 mTextureCoordinates;
 
-uniform vec3 uCameraPosition;
-uniform mat4 uProjection;
-uniform mat4 uView;
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
 
 uniform vec2 uWidthHeight; // x = width, y = height
 
 // Wind
 uniform vec3 uWindParams; // x = oscillationStength, y = force factor, z = stiffness
 uniform vec2 uWindDirection;
-uniform float uTime;
 
 const float PI = 3.141592f;
 const float HALF_PI = 1.57079632679f;
@@ -40,7 +43,7 @@ mat4 RotationMatrix(vec3 axis, float angle);
 
 void main()
 {
-    mat4 viewProj = uProjection * uView;
+    mat4 viewProj = uMatProjection * uMatView;
     vec3 worldPos = gl_in[0].gl_Position.xyz;
     mat4 rotationMat = RotationMatrix(vec3(0.0f, 1.0f, 0.0f), gl_in[0].gl_Position.w);
     vec4 normal = vec4(0.0f, 0.0f, 1.0f, 1.0f);
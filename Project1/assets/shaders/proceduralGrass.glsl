@@ -20,16 +20,19 @@ out vec3 mWorldPosition;
 out vec3 mNormal;
 out vec2 mTextureCoordinates;
 
-uniform vec3 uCameraPosition;
-uniform mat4 uProjection;
-uniform mat4 uView;
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
 
 uniform vec2 uWidthHeight; // x = width, y = height
 
 // Wind
 uniform vec3 uWindParams; // x = oscillationStength, y = force factor, z = stiffness
 uniform vec2 uWindDirection;
-uniform float uTime;
 
 // Terrain
 uniform vec2 uSeed;
@@ -50,7 +53,7 @@ float GetHeight(vec2 v);
 
 void main()
 {
-    mat4 viewProj = uProjection * uView;
+    mat4 viewProj = uMatProjection * uMatView;
 
     // Get position relative to origin
     vec4 pointPos = vec4(gl_in[0].gl_Position.xyz, 1.0f);
@@ -0,0 +1,99 @@
+#version 430
+
+// Skins one submesh of an animated mesh into the frame's skinned vertex buffer (found in SkinningPass.h), every pass then draws it as static geometry.
+// Same math as the animated mesh shaders, SkinningUtils::SkinVertex is the CPU reference
+
+layout (local_size_x = 64) in;
+
+const int MAX_BONE_INFLUENCE = 4;
+const int SOURCE_VERTEX_STRIDE = 6; // CompressedAnimatedVertex in uints (found in VertexCompression.h)
+const int SKINNED_VERTEX_STRIDE = 5; // SkinnedVertex in uints (found in Skinning.h)
+
+layout (std430, binding = 0) readonly buffer uBonePalette // Every animated mesh's bone matrices for the frame, uploaded once by Renderer (found in UniformBlocks.h)
+{
+	mat4 uBoneMatrices[];
+};
+
+layout (std430, binding = 4) readonly buffer uSourceVertices // The mesh's compressed vertex buffer
+{
+	uint uSource[];
+};
+
+layout (std430, binding = 5) writeonly buffer uSkinnedVertices
+{
+	uint uSkinned[];
+};
+
+uniform int uVertexStart; // Submesh's first vertex in the mesh's vertex buffer
+uniform int uVertexCount;
+uniform int uSkinnedStart; // Where the submesh's first vertex goes in the skinned vertex buffer
+uniform int uBoneOffset;
+uniform int uBoneCount;
+uniform vec3 uPositionOffset; // Bounds the submesh's positions were quantized to
+uniform vec3 uPositionScale;
+
+vec3 DecodeOctahedral(vec2 encoded) // Same as VertexCompressionUtils::DecodeNormal
+{
+	vec3 normal = vec3(encoded.xy, 1.0f - abs(encoded.x) - abs(encoded.y));
+	float t = max(-normal.z, 0.0f);
+	normal.x += normal.x >= 0.0f ? -t : t;
+	normal.y += normal.y >= 0.0f ? -t : t;
+	return normalize(normal);
+}
+
+uint EncodeOctahedral(vec3 normal) // Same as VertexCompressionUtils::EncodeNormal
+{
+	float manhattanLength = abs(normal.x) + abs(normal.y) + abs(normal.z);
+	if(manhattanLength <= 0.0f) return 0u; // Broken normal, store +Z rather than NaNs
+
+	// Project onto the octahedron & fold the lower half over the upper one
+	vec2 p = normal.xy / manhattanLength;
+	if(normal.z < 0.0f)
+	{
+		vec2 signNotZero = vec2(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+		p = (1.0f - abs(p.yx)) * signNotZero;
+	}
+
+	return packSnorm2x16(p);
+}
+
+void main()
+{
+	int index = int(gl_GlobalInvocationID.x);
+	if(index >= uVertexCount) return;
+
+	int source = (uVertexStart + index) * SOURCE_VERTEX_STRIDE;
+	vec2 positionXY = unpackUnorm2x16(uSource[source]);
+	vec2 positionZW = unpackUnorm2x16(uSource[source + 1]);
+	vec4 vertexPos = vec4(vec3(positionXY, positionZW.x) * uPositionScale + uPositionOffset, 1.0f);
+	vec3 vertexNormal = DecodeOctahedral(unpackSnorm2x16(uSource[source + 2]));
+	uint texCoords = uSource[source + 3];
+	uint boneIDs = uSource[source + 4];
+	vec4 boneWeights = unpackUnorm4x8(uSource[source + 5]);
+
+	vec4 transformedPos = vec4(0.0f, 0.0f, 0.0f, 0.0f);
+	vec3 transformedNormal = vec3(0.0f, 0.0f, 0.0f);
+	for(int i = 0; i < MAX_BONE_INFLUENCE; i++)
+	{
+		float weight = boneWeights[i];
+		if(weight == 0.0f) continue; // Unused influence
+
+		int boneID = int((boneIDs >> (8 * i)) & 0xFFu);
+		if(boneID >= uBoneCount) // We have exceeded the bone count, just set this vertex to the default vertex position
+		{
+			transformedPos = vertexPos;
+			transformedNormal = vertexNormal;
+			break;
+		}
+
+		transformedPos += uBoneMatrices[uBoneOffset + boneID] * vertexPos * weight;
+		transformedNormal += mat3(uBoneMatrices[uBoneOffset + boneID]) * vertexNormal * weight;
+	}
+
+	int skinned = (uSkinnedStart + index) * SKINNED_VERTEX_STRIDE;
+	uSkinned[skinned] = floatBitsToUint(transformedPos.x);
+	uSkinned[skinned + 1] = floatBitsToUint(transformedPos.y);
+	uSkinned[skinned + 2] = floatBitsToUint(transformedPos.z);
+	uSkinned[skinned + 3] = EncodeOctahedral(transformedNormal);
+	uSkinned[skinned + 4] = texCoords;
+}
\ No newline at end of file
@@ -21,7 +21,14 @@ in vec2 mTextureCoordinates[];
 out vec2 mTextureCoords[];
 
 uniform mat4 uModel;
-uniform mat4 uView;
+
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
 
 const float NEAR_PLANE = 0.1f;
 const float FAR_PLANE = 1000.0f;
@@ -41,10 +48,10 @@ void main()
         const float MAX_DISTANCE = 400;
 
 		// Convert quad vertices to view space
-		vec4 pos1 = uView * uModel * gl_in[0].gl_Position;
-		vec4 pos2 = uView * uModel * gl_in[1].gl_Position;
-		vec4 pos3 = uView * uModel * gl_in[2].gl_Position;
-		vec4 pos4 = uView * uModel * gl_in[3].gl_Position;
+		vec4 pos1 = uMatView * uModel * gl_in[0].gl_Position;
+		vec4 pos2 = uMatView * uModel * gl_in[1].gl_Position;
+		vec4 pos3 = uMatView * uModel * gl_in[2].gl_Position;
+		vec4 pos4 = uMatView * uModel * gl_in[3].gl_Position;
 
 		// Get distance relative to camera
 		float dist1 = clamp((abs(pos1.z) - MIN_DISTANCE) / (MAX_DISTANCE - MIN_DISTANCE), 0.0f, 1.0f);
@@ -93,9 +100,14 @@ uniform vec4 uTerrainParams; // x = amplitude, y = roughness, z = persistence, w
 uniform int uOctaves;
 
 uniform mat4 uModel;
-uniform mat4 uProjection;
-uniform mat4 uView;
-uniform vec2 uCameraPosition;
+
+layout (std140, binding = 1) uniform uFrameData // Written once per frame by Renderer (found in UniformBlocks.h)
+{
+	mat4 uMatProjection;
+	mat4 uMatView;
+	vec3 uCameraPosition;
+	float uTime;
+};
 
 float Rand(vec2 co); // Generates a pseudo random number https://stackoverflow.com/questions/4200224/random-noise-functions-for-glsl
 float SmoothNoise(int x, int y); // Generates a pseudo random "smoothed" noise value
@@ -148,7 +160,7 @@ void main()
 	vec4 worldPos = uModel * v;
 	mWorldPosition = worldPos.xyz; 
 
-	gl_Position = uProjection * uView * worldPos;
+	gl_Position = uMatProjection * uMatView * worldPos;
 }
 
 float Rand(vec2 co)
@@ -197,7 +209,7 @@ float GetHeight(vec2 v)
 	float heightResult = 0.0f;
 	float amplitude = uTerrainParams.x;
 	float freq = uTerrainParams.w;
-	vec2 pos = uCameraPosition + v;
+	vec2 pos = uCameraPosition.xz + v;
 	for(int i = 0; i < uOctaves; i++)
 	{
 		freq *= 2.0f;
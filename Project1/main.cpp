@@ -1,6 +1,7 @@
 #include "GameEngine.h"
 #include "Window.h"
 #include "MeshManager.h"
+#include "AssetLoader.h"
 
 #include "InputManager.h"
 #include "EntityManager.h"
@@ -29,127 +30,143 @@
 #include "DayNightCycle.h"
 
 #include <fstream>
+#include <iostream>
 #include <sstream>
 
 float GetRandom(float low, float high);
 
 void ShaderBallTest(Mesh* shaderBall, ITexture* normalTexture, ITexture* albedo, GameEngine& gameEngine);
+void SpawnAnimationBenchmarkCrowd(unsigned int characterCount, GameEngine& gameEngine);
 
-int main()
+int main(int argc, char** argv)
 {
-    WindowSpecs windowSpecs = GameEngine::InitializeGLFW(true);
+    // --headless [frames] runs the scene without a window for that many frames (1000 by default) and prints what the renderer would have submitted
+    // --bench-animation [characters] [frames] does the same with a crowd of characters (100 by default) that are all evaluated every frame, and prints the bones evaluated per second
+    std::string mode = argc > 1 ? argv[1] : "";
+    bool benchAnimation = mode == "--bench-animation";
+    bool headless = mode == "--headless" || benchAnimation;
+    int framesArg = benchAnimation ? 3 : 2;
+    unsigned int benchCharacters = benchAnimation && argc > 2 ? (unsigned int)std::stoul(argv[2]) : 100;
+    unsigned int headlessFrames = argc > framesArg ? (unsigned int)std::stoul(argv[framesArg]) : 1000;
+
+    WindowSpecs windowSpecs = headless ? GameEngine::InitializeHeadless(1920, 1080) : GameEngine::InitializeGLFW(true);
 
     // Load models
-    Mesh* shaderBall = MeshManager::GetMesh("assets/models/shaderball/shaderball.obj");
-    Mesh* sphere = MeshManager::GetMesh("assets/models/sphere.obj");
-    Mesh* plane = MeshManager::GetMesh("assets/models/plane.obj");
-    Mesh* cube = MeshManager::GetMesh("assets/models/cube.obj");
-    Mesh* cyl = MeshManager::GetMesh("assets/models/cylinder.obj");
-    Mesh* cone = MeshManager::GetMesh("assets/models/cone.obj");
-    Mesh* tile4m = MeshManager::GetMesh("assets/models/FantasyVillage/SM_TileGround4m.FBX");
-    Mesh* rock1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Rock01.FBX");
-    Mesh* rock2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Rock02.FBX");
-    Mesh* houseFirstFloor1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_House1stFloor01.FBX");
-    Mesh* houseFirstFloor2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_House1stFloor02.FBX");
-    Mesh* houseFirstFloor3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_House1stFloor03.FBX");
-    Mesh* houseFirstFloor4 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_House1stFloor04.FBX");
-    Mesh* houseFirstFloor5 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_House1stFloor05.FBX");
-    Mesh* houseSecondFloor1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_House2dFloor01.FBX");
-    Mesh* roof1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_HouseRoof01.FBX");
-    Mesh* roof2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_HouseRoof02.FBX");
-    Mesh* roof3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_HouseRoof03.FBX");
-    Mesh* wallBorder6m = MeshManager::GetMesh("assets/models/FantasyVillage/SM_StoneWallBorder6m.FBX");
-    Mesh* houseBase1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_HouseBase01.FBX");
-    Mesh* castleStairs3m = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleStairs3m.FBX");
-    Mesh* castleStairs3mSmall = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleStairs3m01.FBX");
-    Mesh* castleBridge6m2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleBridge6m2.FBX");
-    Mesh* castleWallCorner6m = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleWallCorner6m01.FBX");
-    Mesh* castleWallCorner6m3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleWallCorner3m.FBX");
-    Mesh* castleWall6m = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleWall6m.FBX");
-    Mesh* chimney3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_ChimneyLarge03.FBX");
-    Mesh* barrel1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Barrel01.FBX");
-    Mesh* barrel2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Barrel02.FBX");
-    Mesh* barrel3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Barrel03.FBX");
-    Mesh* barrel4 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Barrel04.FBX");
-    Mesh* woodChunks1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_WoodChunks01.FBX");
-    Mesh* woodChunks2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_WoodChunks02.FBX");
-    Mesh* woodChunks3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_WoodChunks03.FBX");
-    Mesh* woodChunks4 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_WoodChunks04.FBX");
-    Mesh* woodChunks5 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_WoodChunks05.FBX");
-    Mesh* fence1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_WoodFence01.FBX");
-    Mesh* wagon1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Wagon01.FBX");
-    Mesh* wagon2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Wagon02.FBX");
-    Mesh* wagon3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Wagon03.FBX");
-    Mesh* canopy1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Canopy01.FBX");
-    Mesh* canopy2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Canopy02.FBX");
-    Mesh* canopy3 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Canopy03.FBX");
-    Mesh* canopy4 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Canopy04.FBX");
-    Mesh* canopy5 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Canopy05.FBX");
-    Mesh* fabric1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Fabric01.FBX");
-    Mesh* fabric2 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Fabric02.FBX");
-    Mesh* castleBanner = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Flag01.FBX");
-    Mesh* planks = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Planks.FBX");
-    Mesh* castleWall3m4 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_CastleWall3m04.FBX");
-    Mesh* stoneWallSingle = MeshManager::GetMesh("assets/models/FantasyVillage/SM_StoneWallSingle03.FBX");
-    Mesh* door1 = MeshManager::GetMesh("assets/models/FantasyVillage/SM_Door01.FBX");
-    Mesh* streetLight = MeshManager::GetMesh("assets/models/FantasyVillage/SM_StreetLight02.FBX");
-    Mesh* lantern = MeshManager::GetMesh("assets/models/FantasyVillage/SM_StreetLight03.FBX");
-
-    // Load textures
-    Texture2D* albedoTexture = TextureManager::CreateTexture2D("assets/textures/pbr/rustediron/rustediron_albedo.png", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* normalTexture = TextureManager::CreateTexture2D("assets/textures/pbr/rustediron/rustediron_normal.png", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* roughnessTexture = TextureManager::CreateTexture2D("assets/textures/pbr/rustediron/rustediron_roughness.png", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* metalnessTexture = TextureManager::CreateTexture2D("assets/textures/pbr/rustediron/rustediron_metalness.png", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* aoTexture = TextureManager::CreateTexture2D("assets/textures/pbr/rustediron/rustediron_ao.png", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* blue = TextureManager::CreateTexture2D("assets/textures/blue.png", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* terrain = TextureManager::CreateTexture2D("assets/textures/terrain.jpg", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* wood = TextureManager::CreateTexture2D("assets/textures/T_WoodDetails_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* woodN = TextureManager::CreateTexture2D("assets/textures/T_WoodDetails_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* woodORM = TextureManager::CreateTexture2D("assets/textures/T_WoodDetails_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* groundStoneColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_GroundStones_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* groundStoneNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_GroundStones_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* groundStoneORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_GroundStones_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* rockColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Rock01_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* rockNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Rock01_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* rockORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Rock01_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* castleWallColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_CastleWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* castleWallNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_CastleWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* castleWallORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_CastleWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* castleWallDetailColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_CastleWallDetails_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* castleWallDetailNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_CastleWallDetails_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* castleWallDetailORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_CastleWallDetails_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* houseWallColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_HouseWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* houseWallNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_HouseWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* houseWallORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_HouseWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* roofTilesColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_RoofTiles_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* roofTilesGrayColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_RoofTilesGrey_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* roofTilesNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_RoofTiles_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* roofTilesORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_RoofTiles_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* stoneWallColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_StoneWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* stoneWallNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_StoneWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* stoneWalllORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_StoneWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* fabricColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Fabric01_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* fabricNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Fabric01_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* fabricORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Fabric01_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* doorColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Doors_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* doorNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Doors_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* doorORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_Doors_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    Texture2D* stoneColor = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_StoneWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* stoneNormal = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_StoneWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-    Texture2D* stoneORM = TextureManager::CreateTexture2D("assets/textures/FantasyVillage/T_StoneWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
-
-    GameEngine gameEngine(windowSpecs, true);
+    AssetHandle<Mesh> shaderBall = AssetLoader::LoadMesh("assets/models/shaderball/shaderball.obj");
+    AssetHandle<Mesh> sphere = AssetLoader::LoadMesh("assets/models/sphere.obj");
+    AssetHandle<Mesh> plane = AssetLoader::LoadMesh("assets/models/plane.obj");
+    AssetHandle<Mesh> cube = AssetLoader::LoadMesh("assets/models/cube.obj");
+    AssetHandle<Mesh> cyl = AssetLoader::LoadMesh("assets/models/cylinder.obj");
+    AssetHandle<Mesh> cone = AssetLoader::LoadMesh("assets/models/cone.obj");
+    AssetHandle<Mesh> tile4m = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_TileGround4m.FBX");
+    AssetHandle<Mesh> rock1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Rock01.FBX");
+    AssetHandle<Mesh> rock2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Rock02.FBX");
+    AssetHandle<Mesh> houseFirstFloor1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_House1stFloor01.FBX");
+    AssetHandle<Mesh> houseFirstFloor2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_House1stFloor02.FBX");
+    AssetHandle<Mesh> houseFirstFloor3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_House1stFloor03.FBX");
+    AssetHandle<Mesh> houseFirstFloor4 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_House1stFloor04.FBX");
+    AssetHandle<Mesh> houseFirstFloor5 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_House1stFloor05.FBX");
+    AssetHandle<Mesh> houseSecondFloor1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_House2dFloor01.FBX");
+    AssetHandle<Mesh> roof1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_HouseRoof01.FBX");
+    AssetHandle<Mesh> roof2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_HouseRoof02.FBX");
+    AssetHandle<Mesh> roof3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_HouseRoof03.FBX");
+    AssetHandle<Mesh> wallBorder6m = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_StoneWallBorder6m.FBX");
+    AssetHandle<Mesh> houseBase1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_HouseBase01.FBX");
+    AssetHandle<Mesh> castleStairs3m = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleStairs3m.FBX");
+    AssetHandle<Mesh> castleStairs3mSmall = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleStairs3m01.FBX");
+    AssetHandle<Mesh> castleBridge6m2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleBridge6m2.FBX");
+    AssetHandle<Mesh> castleWallCorner6m = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleWallCorner6m01.FBX");
+    AssetHandle<Mesh> castleWallCorner6m3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleWallCorner3m.FBX");
+    AssetHandle<Mesh> castleWall6m = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleWall6m.FBX");
+    AssetHandle<Mesh> chimney3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_ChimneyLarge03.FBX");
+    AssetHandle<Mesh> barrel1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Barrel01.FBX");
+    AssetHandle<Mesh> barrel2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Barrel02.FBX");
+    AssetHandle<Mesh> barrel3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Barrel03.FBX");
+    AssetHandle<Mesh> barrel4 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Barrel04.FBX");
+    AssetHandle<Mesh> woodChunks1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_WoodChunks01.FBX");
+    AssetHandle<Mesh> woodChunks2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_WoodChunks02.FBX");
+    AssetHandle<Mesh> woodChunks3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_WoodChunks03.FBX");
+    AssetHandle<Mesh> woodChunks4 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_WoodChunks04.FBX");
+    AssetHandle<Mesh> woodChunks5 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_WoodChunks05.FBX");
+    AssetHandle<Mesh> fence1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_WoodFence01.FBX");
+    AssetHandle<Mesh> wagon1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Wagon01.FBX");
+    AssetHandle<Mesh> wagon2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Wagon02.FBX");
+    AssetHandle<Mesh> wagon3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Wagon03.FBX");
+    AssetHandle<Mesh> canopy1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Canopy01.FBX");
+    AssetHandle<Mesh> canopy2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Canopy02.FBX");
+    AssetHandle<Mesh> canopy3 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Canopy03.FBX");
+    AssetHandle<Mesh> canopy4 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Canopy04.FBX");
+    AssetHandle<Mesh> canopy5 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Canopy05.FBX");
+    AssetHandle<Mesh> fabric1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Fabric01.FBX");
+    AssetHandle<Mesh> fabric2 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Fabric02.FBX");
+    AssetHandle<Mesh> castleBanner = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Flag01.FBX");
+    AssetHandle<Mesh> planks = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Planks.FBX");
+    AssetHandle<Mesh> castleWall3m4 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_CastleWall3m04.FBX");
+    AssetHandle<Mesh> stoneWallSingle = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_StoneWallSingle03.FBX");
+    AssetHandle<Mesh> door1 = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_Door01.FBX");
+    AssetHandle<Mesh> streetLight = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_StreetLight02.FBX");
+    AssetHandle<Mesh> lantern = AssetLoader::LoadMesh("assets/models/FantasyVillage/SM_StreetLight03.FBX");
+    PlayerController::RequestAssets();
+
+    // Load textures, decoded on the loader's threads alongside the models
+    AssetHandle<Texture2D> albedoTexture = AssetLoader::LoadTexture2D("assets/textures/pbr/rustediron/rustediron_albedo.png", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> normalTexture = AssetLoader::LoadTexture2D("assets/textures/pbr/rustediron/rustediron_normal.png", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> roughnessTexture = AssetLoader::LoadTexture2D("assets/textures/pbr/rustediron/rustediron_roughness.png", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> metalnessTexture = AssetLoader::LoadTexture2D("assets/textures/pbr/rustediron/rustediron_metalness.png", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> aoTexture = AssetLoader::LoadTexture2D("assets/textures/pbr/rustediron/rustediron_ao.png", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> blue = AssetLoader::LoadTexture2D("assets/textures/blue.png", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> terrain = AssetLoader::LoadTexture2D("assets/textures/terrain.jpg", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> wood = AssetLoader::LoadTexture2D("assets/textures/T_WoodDetails_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> woodN = AssetLoader::LoadTexture2D("assets/textures/T_WoodDetails_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> woodORM = AssetLoader::LoadTexture2D("assets/textures/T_WoodDetails_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> groundStoneColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_GroundStones_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> groundStoneNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_GroundStones_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> groundStoneORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_GroundStones_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> rockColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Rock01_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> rockNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Rock01_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> rockORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Rock01_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> castleWallColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_CastleWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> castleWallNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_CastleWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> castleWallORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_CastleWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> castleWallDetailColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_CastleWallDetails_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> castleWallDetailNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_CastleWallDetails_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> castleWallDetailORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_CastleWallDetails_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> houseWallColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_HouseWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> houseWallNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_HouseWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> houseWallORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_HouseWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> roofTilesColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_RoofTiles_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> roofTilesGrayColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_RoofTilesGrey_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> roofTilesNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_RoofTiles_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> roofTilesORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_RoofTiles_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> stoneWallColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_StoneWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> stoneWallNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_StoneWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> stoneWalllORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_StoneWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> fabricColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Fabric01_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> fabricNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Fabric01_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> fabricORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Fabric01_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> doorColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> doorNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> doorORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_Doors_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    AssetHandle<Texture2D> stoneColor = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_StoneWall_BC.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> stoneNormal = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_StoneWall_N.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+    AssetHandle<Texture2D> stoneORM = AssetLoader::LoadTexture2D("assets/textures/FantasyVillage/T_StoneWall_ORM.TGA", TextureFilterType::Linear, TextureWrapType::Repeat);
+
+    // Finish off the models & textures before anything uses them. The handles turn into plain pointers from here on
+    AssetLoader::WaitForAll();
+    AssetLoader::PrintReport("Cold start");
+
+    GameEngine gameEngine(windowSpecs, !headless);
 
     // Animation system setup
     SkeletalAnimationLayer* sal = new SkeletalAnimationLayer();
@@ -378,7 +395,10 @@ int main()
         Renderer::envMap1 = envMap;
     }
 
-    gameEngine.AddLayer(new EditorLayer(gameEngine.GetEntityManager(), gameEngine.physicsWorld));
+    if (!headless)
+    {
+        gameEngine.AddLayer(new EditorLayer(gameEngine.GetEntityManager(), gameEngine.physicsWorld));
+    }
 
     std::ifstream ifs("scene.yaml");
     std::stringstream ss;
@@ -434,7 +454,22 @@ int main()
 
     gameEngine.AddLayer(new PlayerController(gameEngine.camera, gameEngine.GetEntityManager(), static_cast<PhysicsWorld*>(gameEngine.physicsWorld)));
     gameEngine.AddLayer(new DayNightCycle(gameEngine.GetEntityManager()));
-    gameEngine.Run();
+
+    if (benchAnimation)
+    {
+        sal->GetLODSettings().enabled = false; // Nothing gets throttled, every character is evaluated every frame
+        SpawnAnimationBenchmarkCrowd(benchCharacters, gameEngine);
+    }
+
+    gameEngine.Run(headless ? headlessFrames : 0);
+
+    if (benchAnimation)
+    {
+        double updateTime = sal->GetTotalUpdateTime();
+        uint64_t bonesEvaluated = sal->GetTotalBonesEvaluated();
+        std::cout << "Animation benchmark: " << sal->animations.size() << " characters, " << bonesEvaluated << " bones evaluated in " << updateTime * 1000.0 << "ms of SkeletalAnimationLayer updates\n";
+        std::cout << "Bones evaluated per second: " << (updateTime > 0.0 ? (uint64_t)(bonesEvaluated / updateTime) : 0) << std::endl;
+    }
 
     return 0;
 }
@@ -468,4 +503,36 @@ void ShaderBallTest(Mesh* shaderBall, ITexture* normalTexture, ITexture* albedo,
     testInfo.reflectRefractMapType = ReflectRefractMapType::Environment;
     testInfo.reflectRefractStrength = 0.5f;
     testEntity->AddComponent<RenderComponent>(testInfo);
+}
+
+// Rows of characters in front of the camera, half running & half walking with their clips started at different times so they don't all sample the same keys
+void SpawnAnimationBenchmarkCrowd(unsigned int characterCount, GameEngine& gameEngine)
+{
+    AnimatedMesh* characterMesh = MeshManager::GetAnimatedMesh("assets/models/Character.FBX");
+    Animation* clips[] = { MeshManager::GetAnimation("assets/models/Unequip_Run.fbx"), MeshManager::GetAnimation("assets/models/Unequip_Walk.fbx") };
+
+    const unsigned int rowLength = 20;
+    for (unsigned int i = 0; i < characterCount; i++)
+    {
+        Entity* e = gameEngine.GetEntityManager().CreateEntity("BenchCharacter");
+        e->shouldSave = false;
+        e->AddComponent<PositionComponent>(glm::vec3(((float)(i % rowLength) - rowLength * 0.5f) * 3.0f, 0.0f, -(float)(i / rowLength) * 3.0f));
+        e->AddComponent<RotationComponent>(glm::quat(-0.7071f, 0.7071f, 0.0f, 0.0f));
+        e->AddComponent<ScaleComponent>(glm::vec3(0.1f));
+
+        RenderComponent::RenderInfo renderInfo;
+        renderInfo.mesh = characterMesh;
+        renderInfo.isColorOverride = true;
+        renderInfo.colorOverride = glm::vec3(0.6f, 0.6f, 0.6f);
+        renderInfo.faceCullType = FaceCullType::None;
+        e->AddComponent<RenderComponent>(renderInfo);
+
+        e->AddComponent<SkeletalAnimationComponent>();
+        SkeletalAnimationComponent* animComp = e->GetComponent<SkeletalAnimationComponent>();
+        Animation* clip = clips[i % 2];
+        animComp->SetAnimation(clip, false);
+        animComp->GetLayer(0).clips.back().time = clip->GetDuration() * (float)((i * 7) % 16) / 16.0f;
+    }
+
+    std::cout << "Spawned " << characterCount << " characters for the animation benchmark\n";
 }
\ No newline at end of file
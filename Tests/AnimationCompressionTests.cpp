@@ -0,0 +1,329 @@
+#include "Test.h"
+#include "Animation.h"
+#include "AnimationCompression.h"
+#include "KeyFrames.h"
+
+#include <random>
+
+// Uneven key frames along a smooth curve, the way a file's would be before Animation::Resample()
+static std::vector<KeyFramePosition> MakePositionTrack(std::mt19937& rng, float duration)
+{
+	std::uniform_real_distribution<float> step(0.2f, 3.0f);
+
+	std::vector<KeyFramePosition> keyFrames;
+	for (float time = 0.0f; time < duration; time += step(rng))
+	{
+		keyFrames.push_back({ glm::vec3(std::sin(time * 0.3f) * 20.0f, time * 0.5f, std::cos(time * 0.1f) * 5.0f), time });
+	}
+	keyFrames.push_back({ glm::vec3(std::sin(duration * 0.3f) * 20.0f, duration * 0.5f, std::cos(duration * 0.1f) * 5.0f), duration });
+	return keyFrames;
+}
+
+static std::vector<KeyFrameRotation> MakeRotationTrack(std::mt19937& rng, float duration)
+{
+	std::uniform_real_distribution<float> step(0.2f, 3.0f);
+
+	std::vector<KeyFrameRotation> keyFrames;
+	for (float time = 0.0f; time < duration; time += step(rng))
+	{
+		keyFrames.push_back({ glm::angleAxis(time * 0.2f, glm::normalize(glm::vec3(1.0f, std::sin(time * 0.05f), 0.5f))), time });
+	}
+	keyFrames.push_back({ glm::angleAxis(duration * 0.2f, glm::normalize(glm::vec3(1.0f, std::sin(duration * 0.05f), 0.5f))), duration });
+	return keyFrames;
+}
+
+// Resampled at 24Hz from 30 ticks a second, so the grid doesn't land on whole ticks & the times get spread over the 16 bits like Animation::Compress() does
+static const float DURATION = 120.0f;
+static const float INTERVAL = 30.0f / 24.0f;
+static const float TIME_SCALE = AnimationCompressionUtils::MAX_TIME / DURATION;
+
+TEST(AnimationCompression_ResampledPositionsStayOnTheGrid)
+{
+	std::mt19937 rng(3);
+	std::vector<KeyFramePosition> keyFrames = MakePositionTrack(rng, DURATION);
+	KeyFrameUtils::ResampleTrack(keyFrames, INTERVAL, DURATION);
+
+	std::vector<float> times;
+	std::vector<glm::vec3> values;
+	for (const KeyFramePosition& keyFrame : keyFrames)
+	{
+		times.push_back(keyFrame.timeStamp * TIME_SCALE);
+		values.push_back(keyFrame.position);
+	}
+
+	float maxError = 0.01f;
+	float error;
+	CompressedTrack track = AnimationCompressionUtils::CompressTrack(times, values, maxError, &error, true);
+	CHECK_EQUAL(track.times.size(), keyFrames.size());
+	CHECK(error <= maxError);
+
+	// Reducing the same track would leave key frames the uniform lookup can't index
+	CompressedTrack reduced = AnimationCompressionUtils::CompressTrack(times, values, maxError, nullptr);
+	CHECK(reduced.times.size() < keyFrames.size());
+
+	// Key frame i is still the one at i * INTERVAL
+	for (unsigned int i = 0; i < keyFrames.size(); i++)
+	{
+		CHECK_NEAR(glm::length(AnimationCompressionUtils::DecodeVector(track, i) - keyFrames[i].position), 0.0f, maxError);
+	}
+}
+
+TEST(AnimationCompression_ResampledRotationsStayOnTheGrid)
+{
+	std::mt19937 rng(4);
+	std::vector<KeyFrameRotation> keyFrames = MakeRotationTrack(rng, DURATION);
+	KeyFrameUtils::ResampleTrack(keyFrames, INTERVAL, DURATION);
+
+	std::vector<float> times;
+	std::vector<glm::quat> values;
+	for (const KeyFrameRotation& keyFrame : keyFrames)
+	{
+		times.push_back(keyFrame.timeStamp * TIME_SCALE);
+		values.push_back(keyFrame.rotation);
+	}
+
+	float maxError = 0.0005f;
+	float error;
+	CompressedTrack track = AnimationCompressionUtils::CompressTrack(times, values, maxError, &error, true);
+	CHECK_EQUAL(track.times.size(), keyFrames.size());
+	CHECK(error <= maxError);
+
+	for (unsigned int i = 0; i < keyFrames.size(); i++)
+	{
+		CHECK_NEAR(AnimationCompressionUtils::GetAngle(AnimationCompressionUtils::DecodeRotation(track, i), keyFrames[i].rotation), 0.0f, maxError);
+	}
+}
+
+TEST(AnimationCompression_ResampledConstantTrackCollapses)
+{
+	std::vector<KeyFrameScale> keyFrames;
+	for (float time = 0.0f; time <= DURATION; time += 7.0f) keyFrames.push_back({ glm::vec3(1.0f, 2.0f, 3.0f), time });
+	KeyFrameUtils::ResampleTrack(keyFrames, INTERVAL, DURATION);
+
+	std::vector<float> times;
+	std::vector<glm::vec3> values;
+	for (const KeyFrameScale& keyFrame : keyFrames)
+	{
+		times.push_back(keyFrame.timeStamp * TIME_SCALE);
+		values.push_back(keyFrame.scale);
+	}
+
+	CompressedTrack track = AnimationCompressionUtils::CompressTrack(times, values, 0.0005f, nullptr, true);
+	CHECK_EQUAL(track.times.size(), (size_t)1);
+	CHECK(AnimationCompressionUtils::DecodeVector(track, 0) == glm::vec3(1.0f, 2.0f, 3.0f));
+}
+
+// The same steps MeshManager & AssetLoader take after loading a clip
+TEST(AnimationCompression_ImportedClipStaysResampled)
+{
+	std::mt19937 rng(8);
+	KeyFrames keyFrames;
+	keyFrames.positions = MakePositionTrack(rng, DURATION);
+	keyFrames.rotations = MakeRotationTrack(rng, DURATION);
+	keyFrames.scales.push_back({ glm::vec3(1.0f), 0.0f });
+
+	Animation animation("Resampled", 30, DURATION);
+	animation.AddChannel("Hips", keyFrames);
+	animation.Resample(24.0f);
+	CHECK_EQUAL(animation.GetSampleInterval(), INTERVAL);
+
+	std::vector<glm::vec3> positions;
+	std::vector<glm::quat> rotations;
+	for (float time = 0.0f; time <= DURATION; time += 0.37f)
+	{
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+		animation.GetChannelFrameData(0, time, position, rotation, scale);
+		positions.push_back(position);
+		rotations.push_back(rotation);
+	}
+
+	AnimationCompressionSettings settings;
+	animation.Compress(settings);
+	CHECK(animation.IsCompressed());
+	CHECK_EQUAL(animation.GetSampleInterval(), INTERVAL); // Still takes the uniform lookup
+
+	unsigned int sample = 0;
+	for (float time = 0.0f; time <= DURATION; time += 0.37f, sample++)
+	{
+		glm::vec3 position;
+		glm::quat rotation;
+		glm::vec3 scale;
+		animation.GetChannelFrameData(0, time, position, rotation, scale);
+		CHECK(glm::length(position - positions[sample]) <= settings.maxPositionError);
+		CHECK(AnimationCompressionUtils::GetAngle(rotation, rotations[sample]) <= settings.maxRotationError);
+		CHECK(scale == glm::vec3(1.0f));
+	}
+
+	// Clips that weren't resampled still get their key frames reduced
+	Animation reduced("Reduced", 30, DURATION);
+	reduced.AddChannel("Hips", keyFrames);
+	reduced.Compress(settings);
+	CHECK_EQUAL(reduced.GetSampleInterval(), 0.0f);
+	CHECK(reduced.GetCompressionStats().compressedBytes < animation.GetCompressionStats().compressedBytes);
+}
+
+// Value of the compressed track at time (in compressed time units), searching for the key frame the way Animation::GetChannelFrameData() does for clips that weren't resampled
+static glm::vec3 SampleReducedVector(const CompressedTrack& track, float time)
+{
+	KeyFrameCursor cursor;
+	unsigned int frame = cursor.Seek(track.times, time);
+	glm::vec3 value = AnimationCompressionUtils::DecodeVector(track, frame);
+	if (frame + 1 == track.times.size()) return value;
+
+	float length = (float)track.times[frame + 1] - (float)track.times[frame];
+	return glm::mix(value, AnimationCompressionUtils::DecodeVector(track, frame + 1), length > 0.0f ? glm::clamp((time - track.times[frame]) / length, 0.0f, 1.0f) : 0.0f);
+}
+
+static glm::quat SampleReducedRotation(const CompressedTrack& track, float time)
+{
+	KeyFrameCursor cursor;
+	unsigned int frame = cursor.Seek(track.times, time);
+	glm::quat value = AnimationCompressionUtils::DecodeRotation(track, frame);
+	if (frame + 1 == track.times.size()) return value;
+
+	float length = (float)track.times[frame + 1] - (float)track.times[frame];
+	return KeyFrameUtils::Nlerp(value, AnimationCompressionUtils::DecodeRotation(track, frame + 1), length > 0.0f ? glm::clamp((time - track.times[frame]) / length, 0.0f, 1.0f) : 0.0f);
+}
+
+TEST(AnimationCompression_PositionsStayWithinMaxError)
+{
+	std::mt19937 rng(5);
+	std::vector<KeyFramePosition> keyFrames = MakePositionTrack(rng, DURATION);
+
+	std::vector<float> times;
+	std::vector<glm::vec3> values;
+	for (const KeyFramePosition& keyFrame : keyFrames)
+	{
+		times.push_back(std::round(keyFrame.timeStamp * TIME_SCALE));
+		values.push_back(keyFrame.position);
+	}
+
+	for (float maxError : { 0.001f, 0.01f, 0.1f })
+	{
+		float error;
+		CompressedTrack track = AnimationCompressionUtils::CompressTrack(times, values, maxError, &error);
+		CHECK(track.times.size() > 1 && track.times.size() <= keyFrames.size());
+		CHECK(error <= maxError);
+
+		float measured = 0.0f;
+		for (unsigned int i = 0; i < keyFrames.size(); i++)
+		{
+			measured = std::max(measured, glm::length(SampleReducedVector(track, times[i]) - values[i]));
+		}
+		CHECK(measured <= maxError);
+		CHECK_NEAR(measured, error, 1e-5f);
+	}
+}
+
+TEST(AnimationCompression_RotationsStayWithinMaxError)
+{
+	std::mt19937 rng(6);
+	std::vector<KeyFrameRotation> keyFrames = MakeRotationTrack(rng, DURATION);
+
+	std::vector<float> times;
+	std::vector<glm::quat> values;
+	for (const KeyFrameRotation& keyFrame : keyFrames)
+	{
+		times.push_back(std::round(keyFrame.timeStamp * TIME_SCALE));
+		values.push_back(keyFrame.rotation);
+	}
+
+	for (float maxError : { 0.0005f, 0.005f, 0.05f })
+	{
+		float error;
+		CompressedTrack track = AnimationCompressionUtils::CompressTrack(times, values, maxError, &error);
+		CHECK(track.times.size() > 1 && track.times.size() <= keyFrames.size());
+		CHECK(error <= maxError);
+
+		for (unsigned int i = 0; i < keyFrames.size(); i++)
+		{
+			CHECK(AnimationCompressionUtils::GetAngle(SampleReducedRotation(track, times[i]), values[i]) <= maxError);
+		}
+	}
+}
+
+TEST(AnimationCompression_ScalesStayWithinMaxError)
+{
+	std::vector<float> times;
+	std::vector<glm::vec3> values;
+	for (unsigned int i = 0; i < 200; i++)
+	{
+		times.push_back((float)i * 10.0f);
+		values.push_back(glm::vec3(1.0f + 0.2f * std::sin(i * 0.1f), 1.0f, 1.0f - 0.1f * std::cos(i * 0.05f)));
+	}
+
+	float maxError = 0.0005f;
+	float error;
+	CompressedTrack track = AnimationCompressionUtils::CompressTrack(times, values, maxError, &error);
+	CHECK(track.times.size() < values.size());
+	CHECK(error <= maxError);
+
+	for (unsigned int i = 0; i < values.size(); i++)
+	{
+		CHECK(glm::length(SampleReducedVector(track, times[i]) - values[i]) <= maxError);
+	}
+}
+
+// Every quantization step of the 15 bit components is 2/sqrt(2)/32767, a few steps of angle at most
+static const float SMALLEST_THREE_TOLERANCE = 0.0002f;
+
+static glm::quat RoundTrip(const glm::quat& rotation)
+{
+	uint16_t encoded[3];
+	AnimationCompressionUtils::EncodeQuaternion(rotation, encoded);
+	return AnimationCompressionUtils::DecodeQuaternion(encoded);
+}
+
+TEST(AnimationCompression_SmallestThreeLargestComponent)
+{
+	// Each component the largest once positive & once negative, glm::quat takes w first
+	struct Case
+	{
+		glm::quat rotation;
+		unsigned int largest; // x y z w order, the bits the encoding stores
+	};
+	Case cases[] =
+	{
+		{ glm::normalize(glm::quat(0.2f, 0.9f, -0.3f, 0.1f)), 0 },
+		{ glm::normalize(glm::quat(0.2f, -0.9f, -0.3f, 0.1f)), 0 },
+		{ glm::normalize(glm::quat(0.1f, 0.3f, 0.9f, -0.2f)), 1 },
+		{ glm::normalize(glm::quat(0.1f, 0.3f, -0.9f, -0.2f)), 1 },
+		{ glm::normalize(glm::quat(-0.3f, 0.1f, 0.2f, 0.9f)), 2 },
+		{ glm::normalize(glm::quat(-0.3f, 0.1f, 0.2f, -0.9f)), 2 },
+		{ glm::normalize(glm::quat(0.9f, -0.2f, 0.1f, 0.3f)), 3 },
+		{ glm::normalize(glm::quat(-0.9f, -0.2f, 0.1f, 0.3f)), 3 },
+	};
+
+	for (const Case& test : cases)
+	{
+		uint16_t encoded[3];
+		AnimationCompressionUtils::EncodeQuaternion(test.rotation, encoded);
+		CHECK_EQUAL((encoded[0] >> 15) | ((encoded[1] >> 15) << 1), test.largest);
+
+		glm::quat decoded = AnimationCompressionUtils::DecodeQuaternion(encoded);
+		CHECK(AnimationCompressionUtils::GetAngle(decoded, test.rotation) <= SMALLEST_THREE_TOLERANCE);
+
+		// The dropped component always decodes positive, a negative one comes back as -q which is the same rotation
+		float sign = test.rotation[test.largest] < 0.0f ? -1.0f : 1.0f;
+		CHECK(decoded[test.largest] > 0.0f);
+		for (int i = 0; i < 4; i++) CHECK_NEAR(decoded[i], test.rotation[i] * sign, 1e-4f);
+	}
+}
+
+TEST(AnimationCompression_SmallestThreeRoundTrip)
+{
+	std::mt19937 rng(7);
+	std::normal_distribution<float> normal;
+	for (unsigned int i = 0; i < 10000; i++)
+	{
+		glm::quat rotation = glm::normalize(glm::quat(normal(rng), normal(rng), normal(rng), normal(rng)));
+		CHECK(AnimationCompressionUtils::GetAngle(RoundTrip(rotation), rotation) <= SMALLEST_THREE_TOLERANCE);
+	}
+
+	// Ties between the largest components & the smallest three at their limit of 1/sqrt(2)
+	CHECK(AnimationCompressionUtils::GetAngle(RoundTrip(glm::quat(0.5f, 0.5f, 0.5f, 0.5f)), glm::quat(0.5f, 0.5f, 0.5f, 0.5f)) <= SMALLEST_THREE_TOLERANCE);
+	CHECK(AnimationCompressionUtils::GetAngle(RoundTrip(glm::quat(0.0f, 0.70710678f, -0.70710678f, 0.0f)), glm::quat(0.0f, 0.70710678f, -0.70710678f, 0.0f)) <= SMALLEST_THREE_TOLERANCE);
+	CHECK(AnimationCompressionUtils::GetAngle(RoundTrip(glm::quat(-1.0f, 0.0f, 0.0f, 0.0f)), glm::quat(1.0f, 0.0f, 0.0f, 0.0f)) <= SMALLEST_THREE_TOLERANCE);
+}
\ No newline at end of file
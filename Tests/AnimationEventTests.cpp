@@ -0,0 +1,168 @@
+#include "Test.h"
+#include "AnimationEvents.h"
+
+#include <cstdio>
+#include <fstream>
+
+static AnimationEvent MakeEvent(float time, const std::string& name)
+{
+	return AnimationEvent{ time, name, AnimationEventUtils::HashName(name), "" };
+}
+
+// 0 & 30 are the two ends of the clip, the two at 20 share a time
+static std::vector<AnimationEvent> MakeEvents()
+{
+	std::vector<AnimationEvent> events = { MakeEvent(0.0f, "Start"), MakeEvent(10.0f, "LeftFoot"), MakeEvent(20.0f, "RightFoot"), MakeEvent(20.0f, "Sound"), MakeEvent(30.0f, "End") };
+	AnimationEventUtils::SortEvents(events);
+	return events;
+}
+
+static const float DURATION = 30.0f;
+
+// Names of the events crossed moving advance ticks from time, time is moved along like the layer does
+static std::string Collect(const std::vector<AnimationEvent>& events, float& time, float advance, bool repeat, unsigned int& cursor)
+{
+	AnimationEventRecord record = { nullptr, nullptr, 0, 1.0f };
+	std::vector<AnimationEventRecord> batch;
+	AnimationEventUtils::CollectEvents(events, time, advance, DURATION, repeat, cursor, record, batch);
+	time = AnimationEventUtils::WrapTime(time + advance, DURATION, repeat);
+
+	std::string names;
+	for (const AnimationEventRecord& crossed : batch) names += (names.empty() ? "" : " ") + crossed.event->name;
+	return names;
+}
+
+TEST(AnimationEvents_SortAndFind)
+{
+	std::vector<AnimationEvent> events = { MakeEvent(5.0f, "B"), MakeEvent(1.0f, "A"), MakeEvent(5.0f, "C"), MakeEvent(2.0f, "D") };
+	AnimationEventUtils::SortEvents(events);
+	CHECK(events[0].name == "A" && events[1].name == "D" && events[2].name == "B" && events[3].name == "C"); // B & C keep their order
+
+	CHECK_EQUAL(AnimationEventUtils::FindCursor(events, 0.0f), 0u);
+	CHECK_EQUAL(AnimationEventUtils::FindCursor(events, 1.0f), 0u); // Events at time are still ahead
+	CHECK_EQUAL(AnimationEventUtils::FindCursor(events, 1.5f), 1u);
+	CHECK_EQUAL(AnimationEventUtils::FindCursor(events, 5.0f), 2u);
+	CHECK_EQUAL(AnimationEventUtils::FindCursor(events, 6.0f), 4u);
+}
+
+TEST(AnimationEvents_WrapTime)
+{
+	CHECK_EQUAL(AnimationEventUtils::WrapTime(35.0f, DURATION, true), 5.0f);
+	CHECK_EQUAL(AnimationEventUtils::WrapTime(-5.0f, DURATION, true), 25.0f);
+	CHECK_EQUAL(AnimationEventUtils::WrapTime(DURATION, DURATION, true), 0.0f);
+	CHECK(AnimationEventUtils::WrapTime(-1e-7f, DURATION, true) < DURATION);
+	CHECK_EQUAL(AnimationEventUtils::WrapTime(35.0f, DURATION, false), DURATION);
+	CHECK_EQUAL(AnimationEventUtils::WrapTime(-5.0f, DURATION, false), 0.0f);
+	CHECK_EQUAL(AnimationEventUtils::WrapTime(5.0f, 0.0f, true), 0.0f);
+}
+
+TEST(AnimationEvents_PlayingForwardCrossesEveryEventOncePerLoop)
+{
+	std::vector<AnimationEvent> events = MakeEvents();
+	float time = 0.0f;
+	unsigned int cursor = 0;
+
+	CHECK(Collect(events, time, 4.0f, true, cursor) == "Start"); // Events at the starting time go off
+	CHECK(Collect(events, time, 4.0f, true, cursor) == "");
+	CHECK(Collect(events, time, 4.0f, true, cursor) == "LeftFoot");
+	CHECK(Collect(events, time, 8.0f, true, cursor) == ""); // Stops at 20, the events there go off next update
+	CHECK(Collect(events, time, 1.0f, true, cursor) == "RightFoot Sound");
+	CHECK(Collect(events, time, 15.0f, true, cursor) == "End Start"); // 21 to 6, across the loop
+	CHECK_EQUAL(time, 6.0f);
+	CHECK(Collect(events, time, 5.0f, true, cursor) == "LeftFoot");
+}
+
+TEST(AnimationEvents_PlayingBackwards)
+{
+	std::vector<AnimationEvent> events = MakeEvents();
+	float time = 25.0f;
+	unsigned int cursor = AnimationEventUtils::FindCursor(events, time);
+
+	CHECK(Collect(events, time, -5.0f, true, cursor) == "Sound RightFoot"); // In the order they were crossed
+	CHECK(Collect(events, time, -10.0f, true, cursor) == "LeftFoot");
+	CHECK(Collect(events, time, -15.0f, true, cursor) == "Start End"); // 10 to 25, across the loop
+	CHECK_EQUAL(time, 25.0f);
+}
+
+TEST(AnimationEvents_HitchesDontReplayEvents)
+{
+	std::vector<AnimationEvent> events = MakeEvents();
+	float time = 15.0f;
+	unsigned int cursor = AnimationEventUtils::FindCursor(events, time);
+
+	// Three loops in one update cross every event once, starting where the clip was
+	CHECK(Collect(events, time, 3.0f * DURATION + 1.0f, true, cursor) == "RightFoot Sound End Start LeftFoot");
+	CHECK_EQUAL(time, 16.0f);
+	CHECK(Collect(events, time, 5.0f, true, cursor) == "RightFoot Sound");
+
+	// Ending up before where it started still crosses every event, the ones after 5 were passed on an earlier loop
+	CHECK(Collect(events, time, 2.0f * DURATION - 16.0f, true, cursor) == "End Start LeftFoot RightFoot Sound");
+	CHECK_EQUAL(time, 5.0f);
+
+	CHECK(Collect(events, time, -3.0f * DURATION, true, cursor) == "Start End Sound RightFoot LeftFoot");
+}
+
+TEST(AnimationEvents_ClipsThatDontRepeatStopAtTheEnd)
+{
+	std::vector<AnimationEvent> events = MakeEvents();
+	float time = 25.0f;
+	unsigned int cursor = AnimationEventUtils::FindCursor(events, time);
+
+	CHECK(Collect(events, time, 10.0f, false, cursor) == "End");
+	CHECK_EQUAL(time, DURATION);
+	CHECK(Collect(events, time, 10.0f, false, cursor) == ""); // Already went off when it got there
+
+	CHECK(Collect(events, time, -35.0f, false, cursor) == "Sound RightFoot LeftFoot Start"); // End was crossed on the way in
+	CHECK(Collect(events, time, -5.0f, false, cursor) == "");
+}
+
+TEST(AnimationEvents_StaleCursorsAreSearchedAgain)
+{
+	std::vector<AnimationEvent> events = MakeEvents();
+
+	// The clip's time was set from outside, the cursor still points at the start
+	float time = 15.0f;
+	unsigned int cursor = 0;
+	CHECK(Collect(events, time, 10.0f, true, cursor) == "RightFoot Sound");
+
+	cursor = 100;
+	CHECK(Collect(events, time, 6.0f, true, cursor) == "End Start");
+
+	std::vector<AnimationEvent> none;
+	cursor = 0;
+	CHECK(Collect(none, time, 50.0f, true, cursor) == "");
+}
+
+TEST(AnimationEvents_LoadEvents)
+{
+	const std::string clipPath = "AnimationEventTests.fbx";
+	{
+		std::ofstream file(clipPath + ".events.yaml");
+		file << "Events:\n"
+			"  - Name: RightFoot\n"
+			"    Time: 0.5\n"
+			"  - Name: LeftFoot\n"
+			"    Time: 0.25\n"
+			"    Parameter: footstepDirt\n"
+			"  - Time: 0.3\n" // No name, skipped
+			"  - Name: Late\n"
+			"    Time: 10\n";
+	}
+
+	std::vector<AnimationEvent> events = AnimationEventUtils::LoadEvents(clipPath, 30.0f, DURATION);
+	std::remove((clipPath + ".events.yaml").c_str());
+
+	CHECK_EQUAL(events.size(), (size_t)3);
+	if (events.size() != 3) return;
+
+	CHECK(events[0].name == "LeftFoot");
+	CHECK_EQUAL(events[0].time, 7.5f); // Seconds to ticks
+	CHECK(events[0].parameter == "footstepDirt");
+	CHECK_EQUAL(events[0].nameHash, AnimationEventUtils::HashName("LeftFoot"));
+	CHECK(events[1].name == "RightFoot");
+	CHECK_EQUAL(events[1].time, 15.0f);
+	CHECK(events[1].parameter.empty());
+	CHECK_EQUAL(events[2].time, DURATION); // Clamped to the clip
+
+	CHECK(AnimationEventUtils::LoadEvents("NoSuchClip.fbx", 30.0f, DURATION).empty());
+}
\ No newline at end of file
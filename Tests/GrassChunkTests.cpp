@@ -0,0 +1,301 @@
+#include "Test.h"
+#include "GrassChunks.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <utility>
+
+static const float CHUNK_SIZE = 8.0f;
+
+static std::pair<int, int> GetCell(const glm::vec4& blade, float chunkSize)
+{
+	return std::pair<int, int>((int)std::floor(blade.x / chunkSize), (int)std::floor(blade.z / chunkSize));
+}
+
+static bool BladeLess(const glm::vec4& a, const glm::vec4& b)
+{
+	if (a.x != b.x) return a.x < b.x;
+	if (a.y != b.y) return a.y < b.y;
+	if (a.z != b.z) return a.z < b.z;
+	return a.w < b.w;
+}
+
+// Camera at the origin looking down -Z with a 90 degree fov, so the side planes are x = +-z and y = +-z
+static Frustum MakeFrustum()
+{
+	return FrustumUtils::CreateFrustumFromCamera(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f),
+		glm::radians(90.0f), 1.0f, 500.0f, 0.1f);
+}
+
+static GrassLODSettings MakeSettings()
+{
+	GrassLODSettings settings;
+	settings.fullDensityDistance = 10.0f;
+	settings.maxDrawDistance = 100.0f;
+	settings.maxStride = 8;
+	settings.bladePadding = 0.0f;
+	return settings;
+}
+
+// A flat chunk of roots in front of the camera, the distance is to its nearest edge
+static GrassChunk MakeChunk(float distance, unsigned int first, unsigned int count)
+{
+	GrassChunk chunk;
+	chunk.min = glm::vec3(-1.0f, 0.0f, -distance - 2.0f);
+	chunk.max = glm::vec3(1.0f, 0.0f, -distance);
+	chunk.first = first;
+	chunk.count = count;
+	return chunk;
+}
+
+TEST(GrassChunksAssignBladesToTheirCell)
+{
+	std::mt19937 rng(5);
+	std::uniform_real_distribution<float> position(-50.0f, 50.0f);
+	std::uniform_real_distribution<float> height(0.5f, 2.0f);
+
+	std::vector<glm::vec4> grassData;
+	for (int i = 0; i < 2000; i++)
+	{
+		grassData.push_back(glm::vec4(position(rng), height(rng), position(rng), height(rng)));
+	}
+
+	// Right on & just below the cell edges, floor puts -0.001 in cell -1 and 8 in cell 1
+	grassData.push_back(glm::vec4(-0.001f, 0.0f, 0.0f, 1.0f));
+	grassData.push_back(glm::vec4(CHUNK_SIZE, 0.0f, -CHUNK_SIZE, 1.0f));
+	grassData.push_back(glm::vec4(0.0f, 0.0f, -0.001f, 1.0f));
+
+	std::vector<glm::vec4> original = grassData;
+	std::vector<GrassChunk> chunks = GrassChunkUtils::BuildChunks(grassData, CHUNK_SIZE);
+
+	CHECK_EQUAL(grassData.size(), original.size());
+	CHECK(!chunks.empty());
+
+	std::set<std::pair<int, int>> cells;
+	unsigned int nextFirst = 0;
+	for (const GrassChunk& chunk : chunks)
+	{
+		CHECK_EQUAL(chunk.first, nextFirst); // Chunks are back to back in the buffer
+		CHECK(chunk.count > 0);
+		nextFirst = chunk.first + chunk.count;
+
+		std::pair<int, int> cell = GetCell(grassData[chunk.first], CHUNK_SIZE);
+		CHECK(cells.insert(cell).second); // One chunk per cell
+
+		glm::vec3 min(grassData[chunk.first]);
+		glm::vec3 max(grassData[chunk.first]);
+		for (unsigned int i = chunk.first; i < chunk.first + chunk.count; i++)
+		{
+			CHECK(GetCell(grassData[i], CHUNK_SIZE) == cell);
+			min = glm::min(min, glm::vec3(grassData[i]));
+			max = glm::max(max, glm::vec3(grassData[i]));
+		}
+
+		CHECK(chunk.min == min);
+		CHECK(chunk.max == max);
+	}
+	CHECK_EQUAL(nextFirst, (unsigned int)grassData.size());
+
+	CHECK(cells.count(std::pair<int, int>(-1, 0)) == 1);
+	CHECK(cells.count(std::pair<int, int>(1, -1)) == 1);
+	CHECK(cells.count(std::pair<int, int>(0, -1)) == 1);
+
+	// Reordered, not changed
+	std::vector<glm::vec4> sortedOriginal = original;
+	std::vector<glm::vec4> sortedChunked = grassData;
+	std::sort(sortedOriginal.begin(), sortedOriginal.end(), BladeLess);
+	std::sort(sortedChunked.begin(), sortedChunked.end(), BladeLess);
+	CHECK(sortedOriginal == sortedChunked);
+
+	// Same data, same order
+	std::vector<glm::vec4> again = original;
+	std::vector<GrassChunk> chunksAgain = GrassChunkUtils::BuildChunks(again, CHUNK_SIZE);
+	CHECK_EQUAL(chunksAgain.size(), chunks.size());
+	CHECK(again == grassData);
+}
+
+TEST(GrassChunksThinOutEvenly)
+{
+	// One chunk of blades laid out in a row, sorted by x. Drawing a quarter of them should still cover the whole row
+	std::vector<glm::vec4> grassData;
+	for (int i = 0; i < 1024; i++)
+	{
+		grassData.push_back(glm::vec4(CHUNK_SIZE * (i + 0.5f) / 1024.0f, 0.0f, 1.0f, 1.0f));
+	}
+
+	std::vector<GrassChunk> chunks = GrassChunkUtils::BuildChunks(grassData, CHUNK_SIZE);
+	CHECK_EQUAL(chunks.size(), (size_t)1);
+
+	const unsigned int drawn = chunks[0].count / 4;
+	float sum = 0.0f;
+	int firstHalf = 0;
+	for (unsigned int i = 0; i < drawn; i++)
+	{
+		sum += grassData[i].x;
+		if (grassData[i].x < CHUNK_SIZE * 0.5f) firstHalf++;
+	}
+
+	CHECK_NEAR(sum / drawn, CHUNK_SIZE * 0.5f, 0.5f);
+	CHECK(firstHalf > (int)drawn / 2 - 40 && firstHalf < (int)drawn / 2 + 40);
+}
+
+TEST(GrassChunksEmptyInput)
+{
+	std::vector<glm::vec4> grassData;
+	CHECK(GrassChunkUtils::BuildChunks(grassData, CHUNK_SIZE).empty());
+
+	grassData.push_back(glm::vec4(1.0f));
+	CHECK(GrassChunkUtils::BuildChunks(grassData, 0.0f).empty());
+}
+
+TEST(GrassChunksStrideFallsOffWithDistance)
+{
+	GrassLODSettings settings = MakeSettings();
+
+	// Full density up to fullDensityDistance, then the stride doubles each time the distance does
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(0.0f, settings), 1u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(10.0f, settings), 1u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(10.5f, settings), 2u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(20.0f, settings), 2u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(25.0f, settings), 4u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(40.0f, settings), 4u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(45.0f, settings), 8u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(95.0f, settings), 8u); // Capped at maxStride
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(100.0f, settings), 8u);
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(100.5f, settings), 0u); // Too far to draw
+
+	settings.maxStride = 4;
+	CHECK_EQUAL(GrassChunkUtils::SelectStride(80.0f, settings), 4u);
+
+	// Never denser further away
+	settings = MakeSettings();
+	unsigned int previous = 1;
+	for (float distance = 0.0f; distance <= settings.maxDrawDistance; distance += 0.25f)
+	{
+		unsigned int stride = GrassChunkUtils::SelectStride(distance, settings);
+		CHECK(stride >= previous);
+		previous = stride;
+	}
+}
+
+TEST(GrassChunksDistanceIsToTheNearestPoint)
+{
+	GrassChunk chunk = MakeChunk(20.0f, 0, 1);
+	CHECK_NEAR(GrassChunkUtils::GetDistanceToChunk(chunk, glm::vec3(0.0f)), 20.0f, 1e-5f);
+	CHECK_NEAR(GrassChunkUtils::GetDistanceToChunk(chunk, glm::vec3(0.0f, 0.0f, -21.0f)), 0.0f, 1e-5f); // Inside
+	CHECK_NEAR(GrassChunkUtils::GetDistanceToChunk(chunk, glm::vec3(4.0f, 0.0f, -21.0f)), 3.0f, 1e-5f);
+}
+
+TEST(GrassChunksDrawFewerBladesFurtherAway)
+{
+	const Frustum frustum = MakeFrustum();
+	const GrassLODSettings settings = MakeSettings();
+
+	// Distance to the nearest edge -> blades drawn out of 100
+	const float distances[] = { 5.0f, 15.0f, 30.0f, 60.0f, 99.0f, 150.0f };
+	const unsigned int expected[] = { 100, 50, 25, 13, 13, 0 };
+
+	unsigned int previous = 100;
+	for (int i = 0; i < 6; i++)
+	{
+		std::vector<GrassChunk> chunks = { MakeChunk(distances[i], 0, 100) };
+		std::vector<GrassDrawCommand> commands;
+		unsigned int drawn = GrassChunkUtils::BuildDrawCommands(chunks, frustum, glm::vec3(0.0f), settings, commands);
+
+		CHECK_EQUAL(drawn, expected[i]);
+		CHECK(drawn <= previous);
+		previous = drawn;
+
+		CHECK_EQUAL(commands.size(), (size_t)(expected[i] > 0 ? 1 : 0));
+		if (!commands.empty())
+		{
+			CHECK_EQUAL(commands[0].count, expected[i]);
+			CHECK_EQUAL(commands[0].first, 0u);
+			CHECK_EQUAL(commands[0].instanceCount, 1u);
+			CHECK_EQUAL(commands[0].baseInstance, 0u);
+		}
+	}
+}
+
+TEST(GrassChunksOutsideTheFrustumAreRejected)
+{
+	const Frustum frustum = MakeFrustum();
+	GrassLODSettings settings = MakeSettings();
+
+	GrassChunk inFront = MakeChunk(5.0f, 0, 10);
+
+	GrassChunk behind = MakeChunk(5.0f, 10, 10);
+	behind.min.z = 5.0f;
+	behind.max.z = 7.0f;
+
+	GrassChunk toTheSide = MakeChunk(5.0f, 20, 10); // Right of the x = -z plane
+	toTheSide.min = glm::vec3(21.0f, 0.0f, -20.0f);
+	toTheSide.max = glm::vec3(22.0f, 0.0f, -19.0f);
+
+	GrassChunk above = MakeChunk(5.0f, 30, 10);
+	above.min = glm::vec3(-1.0f, 30.0f, -20.0f);
+	above.max = glm::vec3(1.0f, 31.0f, -19.0f);
+
+	std::vector<GrassChunk> chunks = { inFront, behind, toTheSide, above };
+	std::vector<GrassDrawCommand> commands;
+	unsigned int drawn = GrassChunkUtils::BuildDrawCommands(chunks, frustum, glm::vec3(0.0f), settings, commands);
+
+	CHECK_EQUAL(drawn, 10u);
+	CHECK_EQUAL(commands.size(), (size_t)1);
+	CHECK_EQUAL(commands[0].first, 0u);
+
+	// The blades of the chunk to the side reach 2 units past their roots, enough to poke into view. The chunk above stays out of it
+	settings.bladePadding = 2.0f;
+	commands.clear();
+	drawn = GrassChunkUtils::BuildDrawCommands(chunks, frustum, glm::vec3(0.0f), settings, commands);
+
+	CHECK_EQUAL(drawn, 13u);
+	CHECK_EQUAL(commands.size(), (size_t)2);
+	CHECK_EQUAL(commands[1].first, 20u);
+	CHECK_EQUAL(commands[1].count, 3u); // ~27 units away, every 4th blade
+}
+
+TEST(GrassChunksMergeNeighbouringFullDensityCommands)
+{
+	const Frustum frustum = MakeFrustum();
+	const GrassLODSettings settings = MakeSettings();
+
+	GrassChunk culled = MakeChunk(5.0f, 20, 10);
+	culled.min.z = 5.0f;
+	culled.max.z = 7.0f;
+
+	std::vector<GrassChunk> chunks =
+	{
+		MakeChunk(2.0f, 0, 10), // These two are full density & back to back, one command
+		MakeChunk(4.0f, 10, 10),
+		culled, // Breaks the run
+		MakeChunk(6.0f, 30, 10),
+		MakeChunk(8.0f, 45, 10), // Not right after the previous chunk in the buffer
+		MakeChunk(30.0f, 55, 10), // Thinned out, gets its own command
+		MakeChunk(30.0f, 65, 10) // Even right after one
+	};
+
+	std::vector<GrassDrawCommand> commands;
+	unsigned int drawn = GrassChunkUtils::BuildDrawCommands(chunks, frustum, glm::vec3(0.0f), settings, commands);
+
+	CHECK_EQUAL(drawn, 20u + 10u + 10u + 3u + 3u);
+	CHECK_EQUAL(commands.size(), (size_t)5);
+	if (commands.size() != 5) return;
+
+	CHECK_EQUAL(commands[0].first, 0u);
+	CHECK_EQUAL(commands[0].count, 20u);
+	CHECK_EQUAL(commands[1].first, 30u);
+	CHECK_EQUAL(commands[1].count, 10u);
+	CHECK_EQUAL(commands[2].first, 45u);
+	CHECK_EQUAL(commands[2].count, 10u);
+	CHECK_EQUAL(commands[3].first, 55u);
+	CHECK_EQUAL(commands[3].count, 3u);
+	CHECK_EQUAL(commands[4].first, 65u);
+	CHECK_EQUAL(commands[4].count, 3u);
+
+	// Commands are appended, not replaced
+	GrassChunkUtils::BuildDrawCommands(chunks, frustum, glm::vec3(0.0f), settings, commands);
+	CHECK_EQUAL(commands.size(), (size_t)10);
+}
\ No newline at end of file
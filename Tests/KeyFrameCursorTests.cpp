@@ -0,0 +1,170 @@
+#include "Test.h"
+#include "KeyFrames.h"
+
+#include <random>
+
+// The sampler from before cursors, every lookup scans from the first key frame
+static unsigned int LinearScan(const std::vector<KeyFramePosition>& keyFrames, float time)
+{
+	for (unsigned int i = 1; i < keyFrames.size(); i++)
+	{
+		if (keyFrames[i].timeStamp > time) return i - 1;
+	}
+	return (unsigned int)keyFrames.size() - 1;
+}
+
+static glm::vec3 LinearScanSample(const std::vector<KeyFramePosition>& keyFrames, float time)
+{
+	return KeyFrameUtils::SampleTrack(keyFrames, LinearScan(keyFrames, time), time).position;
+}
+
+// Uneven spacing, with some key frames sharing a time the way exporters sometimes write them
+static std::vector<KeyFramePosition> MakeTrack(std::mt19937& rng, unsigned int count)
+{
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	std::vector<KeyFramePosition> keyFrames;
+	float time = 0.0f;
+	for (unsigned int i = 0; i < count; i++)
+	{
+		keyFrames.push_back({ glm::vec3(unit(rng), unit(rng), unit(rng)), time });
+		if (i % 7 != 3) time += 0.1f + unit(rng);
+	}
+	return keyFrames;
+}
+
+TEST(KeyFrameCursor_PlayingForwardMatchesLinearScan)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> step(0.0f, 0.4f);
+	std::vector<KeyFramePosition> keyFrames = MakeTrack(rng, 200);
+	float duration = keyFrames.back().timeStamp;
+
+	// Starts before the first key frame & plays past the end of the track before looping back to 0 a few times
+	KeyFrameCursor cursor;
+	float time = -1.0f;
+	unsigned int wraps = 0;
+	while (wraps < 3)
+	{
+		CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, time), LinearScan(keyFrames, time));
+		time += step(rng);
+		if (time > duration + 1.0f)
+		{
+			time -= duration + 1.0f;
+			wraps++;
+		}
+	}
+}
+
+TEST(KeyFrameCursor_LoopWrap)
+{
+	std::mt19937 rng(2);
+	std::vector<KeyFramePosition> keyFrames = MakeTrack(rng, 50);
+	float duration = keyFrames.back().timeStamp;
+
+	KeyFrameCursor cursor;
+	CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, duration - 0.01f), LinearScan(keyFrames, duration - 0.01f));
+	CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, duration), 49u);
+	CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, 0.05f), 0u); // Wrapped back to the start
+	CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, keyFrames[1].timeStamp), LinearScan(keyFrames, keyFrames[1].timeStamp));
+}
+
+TEST(KeyFrameCursor_SeeksBackwardsAndAtRandom)
+{
+	std::mt19937 rng(3);
+	std::vector<KeyFramePosition> keyFrames = MakeTrack(rng, 200);
+	float duration = keyFrames.back().timeStamp;
+	std::uniform_real_distribution<float> anyTime(-2.0f, duration + 2.0f);
+	std::uniform_real_distribution<float> step(0.0f, 0.4f);
+
+	// Played backwards from the end, one cursor throughout
+	KeyFrameCursor cursor;
+	for (float time = duration + 1.0f; time > -1.0f; time -= step(rng))
+	{
+		CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, time), LinearScan(keyFrames, time));
+	}
+
+	for (int i = 0; i < 2000; i++)
+	{
+		float time = anyTime(rng);
+		CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, time), LinearScan(keyFrames, time));
+	}
+
+	// Exactly on key frames, including the ones that share a time
+	for (unsigned int i = (unsigned int)keyFrames.size(); i-- > 0;)
+	{
+		CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, keyFrames[i].timeStamp), LinearScan(keyFrames, keyFrames[i].timeStamp));
+	}
+}
+
+TEST(KeyFrameCursor_SingleKeyFrameTrack)
+{
+	std::vector<KeyFramePosition> keyFrames = { { glm::vec3(1.0f, 2.0f, 3.0f), 0.5f } };
+
+	KeyFrameCursor cursor;
+	for (float time : { -1.0f, 0.0f, 0.5f, 10.0f, 0.25f })
+	{
+		CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, time), 0u);
+		CHECK(KeyFrameUtils::SampleTrack(keyFrames, 0, time).position == keyFrames[0].position);
+	}
+
+	// A cursor left further along by a longer track starts over
+	cursor.index = 5;
+	CHECK_EQUAL(cursor.Seek(keyFrames, &KeyFramePosition::timeStamp, 1.0f), 0u);
+}
+
+TEST(KeyFrameCursor_SeeksArraysOfTimes)
+{
+	// Compressed tracks keep integer times in an array of their own
+	std::vector<uint16_t> times = { 0, 3, 3, 4, 10, 11, 30, 31, 32, 100 };
+	std::vector<KeyFramePosition> keyFrames;
+	for (uint16_t time : times) keyFrames.push_back({ glm::vec3(0.0f), (float)time });
+
+	KeyFrameCursor cursor;
+	for (float time = -2.0f; time < 105.0f; time += 0.5f)
+	{
+		CHECK_EQUAL(cursor.Seek(times, time), LinearScan(keyFrames, time));
+	}
+	for (float time = 105.0f; time > -2.0f; time -= 3.25f)
+	{
+		CHECK_EQUAL(cursor.Seek(times, time), LinearScan(keyFrames, time));
+	}
+}
+
+TEST(KeyFrameCursor_ResampledTrackMatchesLinearScan)
+{
+	// Key frames on whole ticks, resampled once per tick, come back as the same curve
+	std::mt19937 rng(4);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::vector<KeyFramePosition> keyFrames;
+	for (unsigned int tick = 0; tick <= 60; tick += 1 + (tick % 3)) keyFrames.push_back({ glm::vec3(unit(rng), unit(rng), unit(rng)), (float)tick });
+
+	float duration = 64.0f; // Longer than the last key frame, it's held to the end
+	std::vector<KeyFramePosition> resampled = keyFrames;
+	KeyFrameUtils::ResampleTrack(resampled, 1.0f, duration);
+	CHECK_EQUAL(resampled.size(), (size_t)65);
+
+	KeyFrameCursor cursor;
+	for (float time = -1.0f; time < duration + 2.0f; time += 0.0625f)
+	{
+		unsigned int index = KeyFrameUtils::GetUniformKeyFrame(resampled.size(), time, 1.0f);
+		CHECK_EQUAL(index, cursor.Seek(resampled, &KeyFramePosition::timeStamp, time));
+
+		glm::vec3 position = KeyFrameUtils::SampleTrack(resampled, index, time).position;
+		CHECK(glm::length(position - LinearScanSample(keyFrames, time)) <= 1e-5f);
+	}
+
+	// Off the grid the curve is only approximated, the index lookup still has to agree with a search
+	std::vector<KeyFramePosition> uneven = MakeTrack(rng, 40);
+	KeyFrameUtils::ResampleTrack(uneven, 0.3f, uneven.back().timeStamp);
+	for (float time = -1.0f; time < uneven.back().timeStamp + 1.0f; time += 0.07f)
+	{
+		CHECK_EQUAL(KeyFrameUtils::GetUniformKeyFrame(uneven.size(), time, 0.3f), LinearScan(uneven, time));
+	}
+
+	// Single key frame tracks aren't resampled
+	std::vector<KeyFramePosition> constant = { { glm::vec3(1.0f), 0.0f } };
+	KeyFrameUtils::ResampleTrack(constant, 1.0f, duration);
+	CHECK_EQUAL(constant.size(), (size_t)1);
+	CHECK_EQUAL(KeyFrameUtils::GetUniformKeyFrame(constant.size(), 10.0f, 1.0f), 0u);
+}
\ No newline at end of file
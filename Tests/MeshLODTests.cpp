@@ -0,0 +1,291 @@
+#include "Test.h"
+#include "MeshLOD.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <map>
+#include <utility>
+
+static const float TEST_PI = 3.14159265358979323846f;
+
+// Closed unit sphere, rings * segments * 2 - 2 * segments triangles with the poles welded. 64 * 128 gives 16128
+static void BuildSphere(int rings, int segments, std::vector<glm::vec3>& positions, std::vector<Face>& faces)
+{
+	positions.push_back(glm::vec3(0.0f, 1.0f, 0.0f));
+	for (int ring = 1; ring < rings; ring++)
+	{
+		for (int segment = 0; segment < segments; segment++)
+		{
+			float theta = TEST_PI * ring / rings;
+			float phi = 2.0f * TEST_PI * segment / segments;
+			positions.push_back(glm::vec3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+		}
+	}
+	positions.push_back(glm::vec3(0.0f, -1.0f, 0.0f));
+
+	uint32_t southPole = (uint32_t)positions.size() - 1;
+	auto index = [segments](int ring, int segment) { return (uint32_t)(1 + (ring - 1) * segments + segment % segments); };
+
+	for (int segment = 0; segment < segments; segment++) faces.push_back({ 0, index(1, segment + 1), index(1, segment) });
+	for (int ring = 1; ring < rings - 1; ring++)
+	{
+		for (int segment = 0; segment < segments; segment++)
+		{
+			faces.push_back({ index(ring, segment), index(ring, segment + 1), index(ring + 1, segment) });
+			faces.push_back({ index(ring, segment + 1), index(ring + 1, segment + 1), index(ring + 1, segment) });
+		}
+	}
+	for (int segment = 0; segment < segments; segment++) faces.push_back({ southPole, index(rings - 1, segment), index(rings - 1, segment + 1) });
+}
+
+static StridedSpan<const glm::vec3> MakeSpan(const std::vector<glm::vec3>& positions)
+{
+	return StridedSpan<const glm::vec3>(positions.data(), positions.size(), sizeof(glm::vec3));
+}
+
+// The surface still faces out of the sphere, and every edge is shared by exactly 2 triangles going opposite ways (still closed).
+// Collapsing can leave needle triangles standing on their edge, those are allowed to lean slightly inwards as they hardly cover anything,
+// but everything facing inwards together has to cover less than a tenth of an average triangle
+static void CheckClosedSphere(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+	std::map<std::pair<unsigned int, unsigned int>, int> edges;
+	float area = 0.0f;
+	float inwardArea = 0.0f; // Projected onto the sphere's normal
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const glm::vec3& a = positions[indices[i]];
+		const glm::vec3& b = positions[indices[i + 1]];
+		const glm::vec3& c = positions[indices[i + 2]];
+		glm::vec3 areaVector = glm::cross(b - a, c - a) * 0.5f;
+		float facing = glm::dot(areaVector, glm::normalize(a + b + c));
+		area += glm::length(areaVector);
+		if (facing < 0.0f) inwardArea -= facing;
+
+		for (int edge = 0; edge < 3; edge++) edges[std::make_pair(indices[i + edge], indices[i + (edge + 1) % 3])]++;
+	}
+	CHECK(inwardArea < 0.1f * area / (indices.size() / 3));
+
+	unsigned int unmatched = 0;
+	for (const std::pair<const std::pair<unsigned int, unsigned int>, int>& edge : edges)
+	{
+		std::map<std::pair<unsigned int, unsigned int>, int>::const_iterator opposite = edges.find(std::make_pair(edge.first.second, edge.first.first));
+		if (edge.second != 1 || opposite == edges.end() || opposite->second != 1) unmatched++;
+	}
+	CHECK_EQUAL(unmatched, 0u);
+}
+
+// How far the simplified surface is from the sphere, measured at the middle of every triangle (where a flat triangle over a sphere is furthest from it)
+static float MeasureSphereDeviation(const std::vector<glm::vec3>& positions, const std::vector<unsigned int>& indices)
+{
+	float deviation = 0.0f;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		glm::vec3 center = (positions[indices[i]] + positions[indices[i + 1]] + positions[indices[i + 2]]) / 3.0f;
+		deviation = std::max(deviation, 1.0f - glm::length(center));
+	}
+	return deviation;
+}
+
+TEST(MeshLOD_SimplifyMeetsTheTriangleBudget)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<Face> faces;
+	BuildSphere(64, 128, positions, faces);
+	CHECK_EQUAL(faces.size(), (size_t)16128);
+
+	size_t indexCount = faces.size() * 3;
+	size_t targetIndexCount = indexCount / 4;
+	float error = -1.0f;
+	std::vector<unsigned int> indices = MeshLODUtils::Simplify(MakeSpan(positions), reinterpret_cast<const unsigned int*>(faces.data()), indexCount, targetIndexCount, 1.0f, &error);
+
+	CHECK(!indices.empty());
+	CHECK(indices.size() <= targetIndexCount);
+	CHECK(indices.size() > targetIndexCount * 9 / 10); // Stops once it's under budget, not long after
+	CHECK(indices.size() % 3 == 0);
+	CHECK(error > 0.0f);
+	CHECK(MeasureSphereDeviation(positions, indices) <= error); // The estimate has to cover how far it really moved, or LODs get picked too early
+	CheckClosedSphere(positions, indices);
+}
+
+TEST(MeshLOD_SimplifyStopsAtTheErrorLimit)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<Face> faces;
+	BuildSphere(64, 128, positions, faces);
+
+	const float maxError = 0.01f;
+	size_t indexCount = faces.size() * 3;
+	float error = -1.0f;
+	std::vector<unsigned int> indices = MeshLODUtils::Simplify(MakeSpan(positions), reinterpret_cast<const unsigned int*>(faces.data()), indexCount, 0, maxError, &error);
+
+	CHECK(indices.size() < indexCount);
+	CHECK(indices.size() > 0);
+	CHECK(error <= maxError);
+	CHECK(MeasureSphereDeviation(positions, indices) <= maxError);
+	CheckClosedSphere(positions, indices);
+}
+
+TEST(MeshLOD_SimplifyKeepsOpenEdges)
+{
+	// Flat 32 x 32 quad grid, the inside can be collapsed for free but the border has to stay put
+	const unsigned int size = 33;
+	std::vector<glm::vec3> positions;
+	std::vector<Face> faces;
+	for (unsigned int z = 0; z < size; z++)
+	{
+		for (unsigned int x = 0; x < size; x++) positions.push_back(glm::vec3((float)x, 0.0f, (float)z));
+	}
+	for (unsigned int z = 0; z + 1 < size; z++)
+	{
+		for (unsigned int x = 0; x + 1 < size; x++)
+		{
+			uint32_t i = z * size + x;
+			faces.push_back({ i, i + size, i + 1 });
+			faces.push_back({ i + 1, i + size, i + size + 1 });
+		}
+	}
+
+	size_t indexCount = faces.size() * 3;
+	float error = -1.0f;
+	std::vector<unsigned int> indices = MeshLODUtils::Simplify(MakeSpan(positions), reinterpret_cast<const unsigned int*>(faces.data()), indexCount, 0, 0.001f, &error);
+	CHECK(indices.size() < indexCount / 4);
+	CHECK(error <= 0.001f);
+
+	std::vector<bool> used(positions.size(), false);
+	float area = 0.0f;
+	for (size_t i = 0; i < indices.size(); i += 3)
+	{
+		const glm::vec3& a = positions[indices[i]];
+		const glm::vec3& b = positions[indices[i + 1]];
+		const glm::vec3& c = positions[indices[i + 2]];
+		area += glm::cross(b - a, c - a).y * 0.5f; // Signed, a flipped triangle would take away from it
+		used[indices[i]] = used[indices[i + 1]] = used[indices[i + 2]] = true;
+	}
+
+	unsigned int missingBorder = 0;
+	for (unsigned int i = 0; i < size; i++)
+	{
+		if (!used[i] || !used[(size - 1) * size + i] || !used[i * size] || !used[i * size + size - 1]) missingBorder++;
+	}
+	CHECK_EQUAL(missingBorder, 0u);
+	CHECK_NEAR(area, (float)((size - 1) * (size - 1)), 0.01f);
+}
+
+TEST(MeshLOD_GenerateLODsHalvesTrianglesWithinTheErrorBound)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<Face> faces;
+	BuildSphere(64, 128, positions, faces);
+
+	std::vector<Submesh> submeshes(1);
+	submeshes[0].vertexStart = 0;
+	submeshes[0].indexStart = 0;
+	submeshes[0].indexCount = (unsigned int)faces.size() * 3;
+	submeshes[0].vertexCount = (unsigned int)positions.size();
+	submeshes[0].minVertex = glm::vec3(-1.0f);
+	submeshes[0].maxVertex = glm::vec3(1.0f);
+
+	MeshLODSettings settings;
+	size_t fullFaceCount = faces.size();
+	std::vector<float> lodErrors;
+	MeshLODUtils::GenerateLODs(MakeSpan(positions), faces, submeshes, settings, lodErrors);
+
+	const Submesh& submesh = submeshes[0];
+	CHECK_EQUAL(lodErrors.size(), submesh.lods.size() + 1);
+	CHECK_EQUAL(lodErrors.size(), (size_t)settings.maxLODs);
+	CHECK_EQUAL(lodErrors[0], 0.0f);
+
+	float maxError = glm::length(submesh.maxVertex - submesh.minVertex) * settings.maxRelativeError;
+	unsigned int previousIndexCount = submesh.indexCount;
+	unsigned int expectedIndexStart = (unsigned int)fullFaceCount * 3;
+	for (size_t lod = 0; lod < submesh.lods.size(); lod++)
+	{
+		const SubmeshLOD& submeshLOD = submesh.lods[lod];
+		CHECK(submeshLOD.indexCount / 3 <= (unsigned int)(previousIndexCount / 3 * settings.reduction));
+		CHECK(submeshLOD.indexCount / 3 >= settings.minTriangles);
+		CHECK(submeshLOD.error <= maxError);
+		CHECK(lodErrors[lod + 1] >= lodErrors[lod]);
+		CHECK_EQUAL(submeshLOD.indexStart, expectedIndexStart); // Appended one after the other
+
+		const unsigned int* first = reinterpret_cast<const unsigned int*>(faces.data()) + submeshLOD.indexStart;
+		std::vector<unsigned int> indices(first, first + submeshLOD.indexCount);
+		CHECK(MeasureSphereDeviation(positions, indices) <= submeshLOD.error);
+
+		expectedIndexStart += submeshLOD.indexCount;
+		previousIndexCount = submeshLOD.indexCount;
+	}
+	CHECK_EQUAL((unsigned int)faces.size() * 3, expectedIndexStart);
+}
+
+TEST(MeshLOD_GenerateLODsSkipsSmallSubmeshes)
+{
+	std::vector<glm::vec3> positions;
+	std::vector<Face> faces;
+	BuildSphere(6, 8, positions, faces); // 80 triangles
+
+	std::vector<Submesh> submeshes(1);
+	submeshes[0].vertexStart = 0;
+	submeshes[0].indexStart = 0;
+	submeshes[0].indexCount = (unsigned int)faces.size() * 3;
+	submeshes[0].vertexCount = (unsigned int)positions.size();
+	submeshes[0].minVertex = glm::vec3(-1.0f);
+	submeshes[0].maxVertex = glm::vec3(1.0f);
+
+	MeshLODSettings settings; // 40 triangles would be under minTriangles
+	std::vector<float> lodErrors;
+	MeshLODUtils::GenerateLODs(MakeSpan(positions), faces, submeshes, settings, lodErrors);
+	CHECK(submeshes[0].lods.empty());
+	CHECK_EQUAL(lodErrors.size(), (size_t)1);
+	CHECK_EQUAL(faces.size(), (size_t)80);
+}
+
+TEST(MeshLOD_ProjectionScale)
+{
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+	CHECK_NEAR(MeshLODUtils::GetProjectionScale(projection, 1080.0f), 540.0f, 0.01f); // tan(45) = 1, a unit at distance 1 covers half the screen
+}
+
+TEST(MeshLOD_SelectLODKeepsTheErrorUnderAPixel)
+{
+	std::vector<float> lodErrors = { 0.0f, 0.01f, 0.04f, 0.1f };
+	MeshLODSelection selection;
+	selection.hysteresis = 0.0f;
+	const float projectionScale = 500.0f;
+
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 1.0f, projectionScale, 0, selection), 0u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 5.0f, projectionScale, 0, selection), 1u); // 0.01 * 500 / 5 = 1 pixel
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 19.0f, projectionScale, 0, selection), 1u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 20.0f, projectionScale, 0, selection), 2u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 1000.0f, projectionScale, 0, selection), 3u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 2.0f, 20.0f, projectionScale, 0, selection), 1u); // Twice as big on screen
+
+	// Never past the errors there are, a mesh without LODs always draws the full mesh
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 1000.0f, projectionScale, 10, selection), 3u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(std::vector<float>(1, 0.0f), 1.0f, 1000.0f, projectionScale, 0, selection), 0u);
+
+	// Whatever it picks has to be under the limit, & the next one over it
+	for (float distance = 0.5f; distance < 2000.0f; distance *= 1.3f)
+	{
+		unsigned int lod = MeshLODUtils::SelectLOD(lodErrors, 1.0f, distance, projectionScale, 0, selection);
+		float pixelsPerUnit = projectionScale / distance;
+		CHECK(lodErrors[lod] * pixelsPerUnit <= selection.pixelError);
+		CHECK(lod + 1 == lodErrors.size() || lodErrors[lod + 1] * pixelsPerUnit > selection.pixelError);
+	}
+}
+
+TEST(MeshLOD_SelectLODHysteresis)
+{
+	std::vector<float> lodErrors = { 0.0f, 0.01f, 0.04f, 0.1f };
+	MeshLODSelection selection;
+	selection.hysteresis = 0.25f;
+	const float projectionScale = 500.0f;
+
+	// At 5.5 LOD 1 is 0.91 pixels off, under the limit but not by the 25% needed to switch to it
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 5.5f, projectionScale, 0, selection), 0u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 5.5f, projectionScale, 1, selection), 1u); // Already on it, it stays
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 7.0f, projectionScale, 0, selection), 1u); // 0.71 pixels
+
+	// Going finer doesn't wait
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 4.0f, projectionScale, 1, selection), 0u);
+	CHECK_EQUAL(MeshLODUtils::SelectLOD(lodErrors, 1.0f, 4.0f, projectionScale, 3, selection), 0u);
+}
\ No newline at end of file
@@ -0,0 +1,200 @@
+#include "Test.h"
+#include "OceanSimulation.h"
+
+#include <complex>
+#include <random>
+
+typedef std::complex<double> Complex;
+
+static const float TWO_PI = 6.283185f;
+
+static OceanSettings MakeSettings()
+{
+	OceanSettings settings;
+	settings.resolution = 64;
+	settings.seed = 7;
+	return settings;
+}
+
+// h0(k) drawn the same way OceanSimulation::GenerateSpectrum does: one generator per row seeded with (seed, row), 2 gaussians per grid point, Nyquist row & column left empty
+static std::vector<std::complex<float>> MakeSpectrum(const OceanSettings& settings)
+{
+	const unsigned int N = settings.resolution;
+	const int start = (int)N / 2;
+	glm::vec2 windDir = glm::normalize(settings.windDirection);
+
+	std::vector<std::complex<float>> h0(N * N);
+	for (unsigned int z = 0; z < N; z++)
+	{
+		std::seed_seq seed{ settings.seed, z };
+		std::mt19937 gen(seed);
+		std::normal_distribution<float> gaussian(0.0f, 1.0f);
+		for (unsigned int x = 0; x < N; x++)
+		{
+			glm::vec2 k(TWO_PI * ((int)x - start) / settings.patchSize, TWO_PI * ((int)z - start) / settings.patchSize);
+			float sqrtPhillips = glm::length(k) > 0.0f && x != 0 && z != 0 ? std::sqrt(OceanSimulation::Phillips(k, windDir, settings.windSpeed, settings.amplitude, settings.gravity)) : 0.0f;
+
+			float real = gaussian(gen);
+			float imaginary = gaussian(gen);
+			h0[z * N + x] = std::complex<float>(real, imaginary) * (sqrtPhillips * 0.7071067f);
+		}
+	}
+	return h0;
+}
+
+// Every field of the surface at every grid point, summed straight from the definition: f(x) = sum over k of F(k, t) * e^(i k.x)
+struct NaiveOcean
+{
+	std::vector<Complex> height, dx, dz, slopeX, slopeZ;
+};
+
+static NaiveOcean NaiveDFT(const OceanSettings& settings, float time)
+{
+	const unsigned int N = settings.resolution;
+	const int start = (int)N / 2;
+	std::vector<std::complex<float>> h0 = MakeSpectrum(settings);
+
+	// Evolved spectrum of each field: h(k, t) = h0(k) * e^(iwt) + conj(h0(-k)) * e^(-iwt), dx = -i * kx / |k| * h, slope x = i * kx * h
+	std::vector<Complex> h(N * N), kx(N * N), kz(N * N);
+	for (unsigned int z = 0; z < N; z++)
+	{
+		for (unsigned int x = 0; x < N; x++)
+		{
+			unsigned int index = z * N + x;
+			kx[index] = TWO_PI * ((int)x - start) / settings.patchSize;
+			kz[index] = TWO_PI * ((int)z - start) / settings.patchSize;
+			double phase = std::sqrt(settings.gravity * std::sqrt(std::norm(kx[index]) + std::norm(kz[index]))) * time;
+			Complex minusK = (Complex)h0[((N - z) % N) * N + (N - x) % N];
+			h[index] = (Complex)h0[index] * std::polar(1.0, phase) + std::conj(minusK) * std::polar(1.0, -phase);
+		}
+	}
+
+	NaiveOcean ocean;
+	ocean.height.assign(N * N, 0.0);
+	ocean.dx.assign(N * N, 0.0);
+	ocean.dz.assign(N * N, 0.0);
+	ocean.slopeX.assign(N * N, 0.0);
+	ocean.slopeZ.assign(N * N, 0.0);
+
+	const Complex i(0.0, 1.0);
+	for (unsigned int z = 0; z < N; z++)
+	{
+		for (unsigned int x = 0; x < N; x++)
+		{
+			double worldX = (double)x * settings.patchSize / N;
+			double worldZ = (double)z * settings.patchSize / N;
+			unsigned int point = z * N + x;
+			for (unsigned int k = 0; k < N * N; k++)
+			{
+				double kLength = std::sqrt(std::norm(kx[k]) + std::norm(kz[k]));
+				Complex wave = h[k] * std::polar(1.0, kx[k].real() * worldX + kz[k].real() * worldZ);
+				ocean.height[point] += wave;
+				if (kLength > 0.0)
+				{
+					ocean.dx[point] += -i * (kx[k] / kLength) * wave;
+					ocean.dz[point] += -i * (kz[k] / kLength) * wave;
+				}
+				ocean.slopeX[point] += i * kx[k] * wave;
+				ocean.slopeZ[point] += i * kz[k] * wave;
+			}
+		}
+	}
+	return ocean;
+}
+
+static double LargestMagnitude(const std::vector<Complex>& field)
+{
+	double largest = 0.0;
+	for (const Complex& value : field) largest = std::max(largest, std::abs(value));
+	return largest;
+}
+
+TEST(OceanSimulation_SimulateMatchesNaiveDFT)
+{
+	OceanSettings settings = MakeSettings();
+	OceanSimulation ocean(settings);
+	ocean.Simulate(3.7f);
+
+	NaiveOcean naive = NaiveDFT(settings, 3.7f);
+	const std::vector<glm::vec3>& displacement = ocean.GetDisplacementMap();
+	const std::vector<glm::vec3>& normals = ocean.GetNormalMap();
+
+	// The FFT runs in floats, a few ulps of the largest wave is as close as it gets
+	float heightTolerance = (float)LargestMagnitude(naive.height) * 1e-4f;
+	float displacementTolerance = (float)std::max(LargestMagnitude(naive.dx), LargestMagnitude(naive.dz)) * 1e-4f;
+	CHECK(heightTolerance > 0.0f);
+
+	for (unsigned int i = 0; i < displacement.size(); i++)
+	{
+		CHECK_NEAR(displacement[i].y, (float)naive.height[i].real(), heightTolerance);
+		CHECK_NEAR(displacement[i].x, (float)naive.dx[i].real() * settings.choppiness, displacementTolerance);
+		CHECK_NEAR(displacement[i].z, (float)naive.dz[i].real() * settings.choppiness, displacementTolerance);
+
+		glm::vec3 normal = glm::normalize(glm::vec3(-naive.slopeX[i].real(), 1.0f, -naive.slopeZ[i].real()));
+		CHECK_NEAR(glm::dot(normals[i], normal), 1.0f, 1e-5f);
+	}
+}
+
+TEST(OceanSimulation_PackedFieldsAreReal)
+{
+	// Two fields share every complex FFT, which only works if each field on its own comes out real. Any imaginary part would leak into its partner
+	OceanSettings settings = MakeSettings();
+	settings.windDirection = glm::vec2(0.8f, -0.3f);
+	NaiveOcean naive = NaiveDFT(settings, 12.25f);
+
+	const std::vector<Complex>* fields[5] = { &naive.height, &naive.dx, &naive.dz, &naive.slopeX, &naive.slopeZ };
+	for (const std::vector<Complex>* field : fields)
+	{
+		double largest = LargestMagnitude(*field);
+		CHECK(largest > 0.0);
+
+		double largestImaginary = 0.0;
+		for (const Complex& value : *field) largestImaginary = std::max(largestImaginary, std::abs(value.imag()));
+		CHECK(largestImaginary <= largest * 1e-5);
+	}
+
+	// And the packed partners come back out on their own, dx is packed with the height & slope x with dz
+	OceanSimulation ocean(settings);
+	ocean.Simulate(12.25f);
+	float tolerance = (float)LargestMagnitude(naive.dx) * 1e-4f;
+	for (unsigned int i = 0; i < naive.dx.size(); i++)
+	{
+		CHECK_NEAR(ocean.GetDisplacementMap()[i].x, (float)naive.dx[i].real(), tolerance);
+	}
+}
+
+TEST(OceanSimulation_SampleDisplacementWraps)
+{
+	OceanSettings settings = MakeSettings();
+	OceanSimulation ocean(settings);
+	ocean.Simulate(1.5f);
+
+	const unsigned int N = settings.resolution;
+	const float cell = settings.patchSize / N;
+	const std::vector<glm::vec3>& grid = ocean.GetDisplacementMap();
+
+	// Halfway between the last column & the first one, from both sides of the edge
+	for (unsigned int z = 0; z < N; z += 9)
+	{
+		glm::vec3 expected = glm::mix(grid[z * N + N - 1], grid[z * N], 0.5f);
+		CHECK_NEAR(glm::length(ocean.SampleDisplacement(settings.patchSize - cell * 0.5f, z * cell, 1.5f) - expected), 0.0f, 1e-5f);
+		CHECK_NEAR(glm::length(ocean.SampleDisplacement(-cell * 0.5f, z * cell, 1.5f) - expected), 0.0f, 1e-5f);
+	}
+
+	// Same across the last row, and the corner where both wrap
+	for (unsigned int x = 0; x < N; x += 9)
+	{
+		glm::vec3 expected = glm::mix(grid[(N - 1) * N + x], grid[x], 0.25f);
+		CHECK_NEAR(glm::length(ocean.SampleDisplacement(x * cell, -cell * 0.75f, 1.5f) - expected), 0.0f, 1e-5f);
+	}
+	glm::vec3 corner = glm::mix(glm::mix(grid[N * N - 1], grid[(N - 1) * N], 0.5f), glm::mix(grid[N - 1], grid[0], 0.5f), 0.5f);
+	CHECK_NEAR(glm::length(ocean.SampleDisplacement(-cell * 0.5f, -cell * 0.5f, 1.5f) - corner), 0.0f, 1e-5f);
+
+	// Whole patches away is the same point
+	for (float x = 0.3f; x < settings.patchSize; x += 3.1f)
+	{
+		glm::vec3 inside = ocean.SampleDisplacement(x, 7.7f, 1.5f);
+		CHECK_NEAR(glm::length(ocean.SampleDisplacement(x + settings.patchSize, 7.7f, 1.5f) - inside), 0.0f, 1e-4f);
+		CHECK_NEAR(glm::length(ocean.SampleDisplacement(x - 3.0f * settings.patchSize, 7.7f - settings.patchSize, 1.5f) - inside), 0.0f, 1e-4f);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,256 @@
+#include "Test.h"
+#include "Pose.h"
+
+#include <random>
+
+// 5 joints so the blends run over a group of 4 & a remainder of 1
+static const unsigned int JOINT_COUNT = 5;
+
+static glm::quat AroundY(float degrees)
+{
+	return glm::angleAxis(glm::radians(degrees), glm::vec3(0.0f, 1.0f, 0.0f));
+}
+
+static glm::quat AroundZ(float degrees)
+{
+	return glm::angleAxis(glm::radians(degrees), glm::vec3(0.0f, 0.0f, 1.0f));
+}
+
+// Where nlerping t of the way from the identity to AroundY(degrees) ends up: (1 - t, 0, t * sin(half), 0) + t * cos(half) in w, normalized
+static glm::quat NlerpAroundY(float degrees, float t)
+{
+	float half = glm::radians(degrees) * 0.5f;
+	return AroundY(glm::degrees(2.0f * std::atan2(t * std::sin(half), 1.0f - t + t * std::cos(half))));
+}
+
+static Pose MakePose(const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+	Pose pose;
+	pose.Resize(JOINT_COUNT);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) pose.SetJoint(i, position + glm::vec3((float)i, 0.0f, 0.0f), rotation, scale);
+	return pose;
+}
+
+static void CheckJoint(const Pose& pose, unsigned int joint, const glm::vec3& position, const glm::quat& rotation, const glm::vec3& scale)
+{
+	CHECK_NEAR(glm::length(pose.GetPosition(joint) - position), 0.0f, 1e-5f);
+	CHECK_NEAR(std::abs(glm::dot(pose.GetRotation(joint), rotation)), 1.0f, 1e-5f);
+	CHECK_NEAR(glm::length(pose.GetRotation(joint)), 1.0f, 1e-5f);
+	CHECK_NEAR(glm::length(pose.GetScale(joint) - scale), 0.0f, 1e-5f);
+}
+
+TEST(Pose_BlendPosesWeights)
+{
+	Pose from = MakePose(glm::vec3(0.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f, 1.0f, 1.0f));
+	Pose to = MakePose(glm::vec3(4.0f, 8.0f, -4.0f), AroundY(90.0f), glm::vec3(3.0f, 1.0f, 2.0f));
+
+	Pose result;
+	PoseUtils::BlendPoses(from, to, 0.0f, result);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, from.GetPosition(i), from.GetRotation(i), from.GetScale(i));
+
+	PoseUtils::BlendPoses(from, to, 1.0f, result);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, to.GetPosition(i), to.GetRotation(i), to.GetScale(i));
+
+	PoseUtils::BlendPoses(from, to, 0.25f, result);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, glm::vec3(1.0f + i, 2.0f, -1.0f), NlerpAroundY(90.0f, 0.25f), glm::vec3(1.5f, 1.0f, 1.25f));
+
+	// Into one of its inputs, the way layers blend into the result
+	PoseUtils::BlendPoses(from, to, 0.25f, from);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(from, i, glm::vec3(1.0f + i, 2.0f, -1.0f), NlerpAroundY(90.0f, 0.25f), glm::vec3(1.5f, 1.0f, 1.25f));
+}
+
+TEST(Pose_BlendPosesWeightsAddUpToOne)
+{
+	// Fading clips in one after the other (see SkeletalAnimationLayer) with weight / (sum of weights so far) gives each clip its share of the total
+	Pose a = MakePose(glm::vec3(0.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+	Pose b = MakePose(glm::vec3(6.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(2.0f));
+	Pose c = MakePose(glm::vec3(0.0f, 12.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(4.0f));
+
+	float weights[3] = { 1.0f, 1.0f, 2.0f };
+	Pose result;
+	PoseUtils::BlendPoses(a, b, weights[1] / (weights[0] + weights[1]), result);
+	PoseUtils::BlendPoses(result, c, weights[2] / (weights[0] + weights[1] + weights[2]), result);
+
+	// 1/4 a + 1/4 b + 1/2 c
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, glm::vec3(1.5f + i, 6.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(2.75f));
+
+	// The same pose blended with itself stays put at any weight
+	Pose same = MakePose(glm::vec3(1.0f, 2.0f, 3.0f), AroundZ(70.0f), glm::vec3(0.5f));
+	for (float weight : { 0.1f, 0.5f, 0.9f })
+	{
+		PoseUtils::BlendPoses(same, same, weight, result);
+		for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, same.GetPosition(i), same.GetRotation(i), same.GetScale(i));
+	}
+}
+
+TEST(Pose_BlendPosesMask)
+{
+	Pose from = MakePose(glm::vec3(0.0f, 0.0f, 0.0f), glm::quat(1.0f, 0.0f, 0.0f, 0.0f), glm::vec3(1.0f));
+	Pose to = MakePose(glm::vec3(0.0f, 8.0f, 0.0f), AroundY(80.0f), glm::vec3(5.0f));
+
+	// The mask is shorter than the skeleton, the joints past its end are left out too
+	BoneMask mask;
+	mask.weights = { 1.0f, 0.0f, 0.5f, 0.25f };
+
+	Pose result;
+	PoseUtils::BlendPoses(from, to, 0.5f, result, &mask);
+	CheckJoint(result, 0, glm::vec3(0.0f, 4.0f, 0.0f), AroundY(40.0f), glm::vec3(3.0f));
+	CheckJoint(result, 1, from.GetPosition(1), from.GetRotation(1), from.GetScale(1));
+	CheckJoint(result, 2, glm::vec3(2.0f, 2.0f, 0.0f), NlerpAroundY(80.0f, 0.25f), glm::vec3(2.0f));
+	CheckJoint(result, 3, glm::vec3(3.0f, 1.0f, 0.0f), NlerpAroundY(80.0f, 0.125f), glm::vec3(1.5f));
+	CheckJoint(result, 4, from.GetPosition(4), from.GetRotation(4), from.GetScale(4));
+}
+
+TEST(Pose_BoneMaskFromJoint)
+{
+	//     0
+	//   1   3
+	//   2   4
+	Skeleton skeleton;
+	skeleton.parents = { -1, 0, 1, 0, 3 };
+	skeleton.names = { "Hips", "Spine", "Head", "Leg", "Foot" };
+	for (const std::string& name : skeleton.names) skeleton.nameHashes.push_back(std::hash<std::string>()(name));
+
+	BoneMask mask = BoneMask::FromJoint(skeleton, "Spine", 0.75f);
+	CHECK_EQUAL(mask.weights.size(), (size_t)JOINT_COUNT);
+	CHECK_EQUAL(mask.GetWeight(0), 0.0f);
+	CHECK_EQUAL(mask.GetWeight(1), 0.75f);
+	CHECK_EQUAL(mask.GetWeight(2), 0.75f);
+	CHECK_EQUAL(mask.GetWeight(3), 0.0f);
+	CHECK_EQUAL(mask.GetWeight(4), 0.0f);
+
+	CHECK(BoneMask::FromJoint(skeleton, "Tail").weights.empty());
+}
+
+TEST(Pose_AddPoseRelativeToReference)
+{
+	Pose base = MakePose(glm::vec3(5.0f, 5.0f, 5.0f), AroundY(90.0f), glm::vec3(2.0f));
+	Pose reference = MakePose(glm::vec3(1.0f, 0.0f, 0.0f), AroundZ(10.0f), glm::vec3(2.0f));
+	Pose additive = MakePose(glm::vec3(1.0f, 2.0f, 0.0f), AroundZ(40.0f), glm::vec3(3.0f));
+
+	// Only the difference from the reference is added: 2 up, 30 degrees around the joint's own z & 1.5 times the scale
+	Pose result;
+	PoseUtils::AddPose(base, additive, reference, 1.0f, result);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, glm::vec3(5.0f + i, 7.0f, 5.0f), AroundY(90.0f) * AroundZ(30.0f), glm::vec3(3.0f));
+
+	PoseUtils::AddPose(base, additive, reference, 0.5f, result);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, glm::vec3(5.0f + i, 6.0f, 5.0f), AroundY(90.0f) * AroundZ(15.0f), glm::vec3(2.5f));
+
+	// Playing the reference pose itself adds nothing
+	PoseUtils::AddPose(base, reference, reference, 1.0f, result);
+	for (unsigned int i = 0; i < JOINT_COUNT; i++) CheckJoint(result, i, base.GetPosition(i), base.GetRotation(i), base.GetScale(i));
+
+	// Masked out joints keep the base, result may be base
+	BoneMask mask;
+	mask.weights = { 0.0f, 1.0f, 0.0f, 0.5f, 1.0f };
+	PoseUtils::AddPose(base, additive, reference, 1.0f, base, &mask);
+	CheckJoint(base, 0, glm::vec3(5.0f, 5.0f, 5.0f), AroundY(90.0f), glm::vec3(2.0f));
+	CheckJoint(base, 1, glm::vec3(6.0f, 7.0f, 5.0f), AroundY(90.0f) * AroundZ(30.0f), glm::vec3(3.0f));
+	CheckJoint(base, 2, glm::vec3(7.0f, 5.0f, 5.0f), AroundY(90.0f), glm::vec3(2.0f));
+	CheckJoint(base, 3, glm::vec3(8.0f, 6.0f, 5.0f), AroundY(90.0f) * AroundZ(15.0f), glm::vec3(2.5f));
+	CheckJoint(base, 4, glm::vec3(9.0f, 7.0f, 5.0f), AroundY(90.0f) * AroundZ(30.0f), glm::vec3(3.0f));
+}
+
+static glm::quat RandomRotation(std::mt19937& rng)
+{
+	std::normal_distribution<float> normal;
+	return glm::normalize(glm::quat(normal(rng), normal(rng), normal(rng), normal(rng)));
+}
+
+// 11 joints, 2 groups of 4 & a remainder of 3, with every joint different
+static Pose MakeRandomPose(std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> unit(0.5f, 2.0f);
+
+	Pose pose;
+	pose.Resize(11);
+	for (unsigned int i = 0; i < pose.GetJointCount(); i++) pose.SetJoint(i, glm::vec3(unit(rng), -unit(rng), unit(rng)), RandomRotation(rng), glm::vec3(unit(rng), unit(rng), unit(rng)));
+	return pose;
+}
+
+TEST(Pose_EveryJointBlendsTheSame)
+{
+	std::mt19937 rng(9);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	Pose a = MakeRandomPose(rng);
+	Pose b = MakeRandomPose(rng);
+	Pose c = MakeRandomPose(rng);
+
+	BoneMask mask;
+	for (unsigned int i = 0; i < a.GetJointCount(); i++) mask.weights.push_back(unit(rng));
+
+	Pose blended;
+	PoseUtils::BlendPoses(a, b, 0.7f, blended, &mask);
+	Pose added;
+	PoseUtils::AddPose(a, b, c, 0.6f, added, &mask);
+
+	// Joint by joint, the 4 at a time paths have to agree with the one at a time remainder
+	for (unsigned int i = 0; i < a.GetJointCount(); i++)
+	{
+		float t = 0.7f * mask.weights[i];
+		CheckJoint(blended, i, glm::mix(a.GetPosition(i), b.GetPosition(i), t), KeyFrameUtils::Nlerp(a.GetRotation(i), b.GetRotation(i), t), glm::mix(a.GetScale(i), b.GetScale(i), t));
+
+		t = 0.6f * mask.weights[i];
+		glm::quat difference = glm::conjugate(c.GetRotation(i)) * b.GetRotation(i);
+		CheckJoint(added, i, a.GetPosition(i) + (b.GetPosition(i) - c.GetPosition(i)) * t, a.GetRotation(i) * KeyFrameUtils::Nlerp(glm::quat(1.0f, 0.0f, 0.0f, 0.0f), difference, t),
+			a.GetScale(i) * glm::mix(glm::vec3(1.0f), b.GetScale(i) / c.GetScale(i), t));
+	}
+}
+
+TEST(Pose_SamplePoseMatchesTheAnimation)
+{
+	std::mt19937 rng(10);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	// Uneven key frames so both the searching & the uniform lookups get used
+	Animation animation("SamplePose", 30, 60.0f);
+	for (unsigned int channel = 0; channel < 8; channel++)
+	{
+		KeyFrames keyFrames;
+		for (float time = 0.0f; time < 60.0f; time += 0.5f + unit(rng) * 4.0f)
+		{
+			keyFrames.positions.push_back({ glm::vec3(unit(rng), unit(rng), unit(rng)), time });
+			keyFrames.rotations.push_back({ RandomRotation(rng), time });
+		}
+		if (channel % 3 == 0) keyFrames.scales.push_back({ glm::vec3(1.0f + unit(rng)), 0.0f });
+		animation.AddChannel("Channel" + std::to_string(channel), keyFrames);
+	}
+
+	// 11 joints, the ones bound to -1 aren't animated & get their rest pose
+	Skeleton skeleton;
+	std::vector<int> binding = { 0, 1, -1, 2, 3, 4, -1, 5, 6, 7, -1 };
+	for (unsigned int i = 0; i < binding.size(); i++)
+	{
+		skeleton.parents.push_back((int)i - 1);
+		skeleton.restPositions.push_back(glm::vec3((float)i, 1.0f, 0.0f));
+		skeleton.restRotations.push_back(RandomRotation(rng));
+		skeleton.restScales.push_back(glm::vec3(1.0f));
+	}
+
+	Pose pose;
+	for (int pass = 0; pass < 3; pass++)
+	{
+		if (pass == 1) animation.Resample(30.0f);
+		if (pass == 2) animation.Compress(AnimationCompressionSettings());
+
+		std::vector<ChannelCursor> cursors(animation.GetChannelCount());
+		for (float time = 0.0f; time <= 60.0f; time += 0.77f)
+		{
+			PoseUtils::SamplePose(&animation, binding, time, cursors.data(), skeleton, pose);
+			for (unsigned int i = 0; i < binding.size(); i++)
+			{
+				if (binding[i] == -1)
+				{
+					CheckJoint(pose, i, skeleton.restPositions[i], skeleton.restRotations[i], skeleton.restScales[i]);
+					continue;
+				}
+
+				glm::vec3 position;
+				glm::quat rotation;
+				glm::vec3 scale;
+				animation.GetChannelFrameData(binding[i], time, position, rotation, scale);
+				CheckJoint(pose, i, position, rotation, scale);
+			}
+		}
+	}
+}
\ No newline at end of file
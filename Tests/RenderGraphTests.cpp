@@ -0,0 +1,244 @@
+#include "Test.h"
+#include "RenderGraph.h"
+
+#include <algorithm>
+
+static RenderGraphTextureDesc MakeDesc(uint32_t width, uint32_t height)
+{
+	return RenderGraphTextureDesc{ width, height, 0x8058 /* GL_RGBA8 */, 0x1908 /* GL_RGBA */, 0x1401 /* GL_UNSIGNED_BYTE */, false };
+}
+
+static unsigned int PositionOf(const RenderGraph& graph, RenderGraphPass pass)
+{
+	const std::vector<RenderGraphPass>& order = graph.GetExecutionOrder();
+	return (unsigned int)(std::find(order.begin(), order.end(), pass) - order.begin());
+}
+
+TEST(RenderGraph_CullsPassesNothingVisibleDependsOn)
+{
+	RenderGraph graph;
+	RenderGraphResource a = graph.CreateTexture("A", MakeDesc(64, 64));
+	RenderGraphResource b = graph.CreateTexture("B", MakeDesc(64, 64));
+	RenderGraphResource unused = graph.CreateTexture("Unused", MakeDesc(64, 64));
+	RenderGraphResource backbuffer = graph.ImportResource("Backbuffer");
+
+	RenderGraphPass writeA = graph.AddPass("WriteA", []() {});
+	graph.Write(writeA, a);
+
+	RenderGraphPass writeUnused = graph.AddPass("WriteUnused", []() {});
+	graph.Write(writeUnused, unused);
+
+	RenderGraphPass aToB = graph.AddPass("AToB", []() {});
+	graph.Read(aToB, a);
+	graph.Write(aToB, b);
+
+	RenderGraphPass present = graph.AddPass("Present", []() {});
+	graph.Read(present, b);
+	graph.Write(present, backbuffer);
+	graph.SetSideEffect(present);
+
+	RenderGraphPass debug = graph.AddPass("Debug", []() {}); // Reads what the others produce, but nothing reads what it does
+	graph.Read(debug, a);
+
+	CHECK(graph.Compile());
+	CHECK(!graph.IsPassCulled(writeA));
+	CHECK(!graph.IsPassCulled(aToB));
+	CHECK(!graph.IsPassCulled(present));
+	CHECK(graph.IsPassCulled(writeUnused));
+	CHECK(graph.IsPassCulled(debug));
+	CHECK_EQUAL(graph.GetExecutionOrder().size(), (size_t)3);
+
+	CHECK_EQUAL(graph.GetFirstUse(unused), RENDER_GRAPH_INVALID);
+	CHECK_EQUAL(graph.GetPhysicalIndex(unused), RENDER_GRAPH_INVALID);
+}
+
+TEST(RenderGraph_KeepsSideEffectPassesWithoutResources)
+{
+	RenderGraph graph;
+	RenderGraphPass ui = graph.AddPass("UI", []() {});
+	graph.SetSideEffect(ui);
+	graph.AddPass("Nothing", []() {});
+
+	CHECK(graph.Compile());
+	CHECK_EQUAL(graph.GetExecutionOrder().size(), (size_t)1);
+	CHECK(!graph.IsPassCulled(ui));
+}
+
+TEST(RenderGraph_ReadAfterWriteSeesTheLastWrite)
+{
+	RenderGraph graph;
+	RenderGraphResource a = graph.CreateTexture("A", MakeDesc(64, 64));
+
+	RenderGraphPass first = graph.AddPass("First", []() {});
+	graph.Write(first, a);
+
+	RenderGraphPass second = graph.AddPass("Second", []() {});
+	graph.Write(second, a);
+
+	RenderGraphPass reader = graph.AddPass("Reader", []() {});
+	graph.Read(reader, a);
+	graph.SetSideEffect(reader);
+
+	CHECK(graph.Compile());
+	CHECK(graph.IsPassCulled(first)); // Overwritten before anything read it
+	CHECK(!graph.IsPassCulled(second));
+	CHECK(PositionOf(graph, second) < PositionOf(graph, reader));
+}
+
+TEST(RenderGraph_WriteAfterWriteKeepsOrderWithoutKeepingPassesAlive)
+{
+	RenderGraph graph;
+	RenderGraphResource gbuffer = graph.ImportResource("GBuffer");
+
+	RenderGraphPass clear = graph.AddPass("Clear", []() {});
+	graph.Write(clear, gbuffer);
+	graph.SetSideEffect(clear);
+
+	RenderGraphPass unkept = graph.AddPass("Unkept", []() {});
+	graph.Write(unkept, gbuffer);
+
+	RenderGraphPass geometry = graph.AddPass("Geometry", []() {});
+	graph.Write(geometry, gbuffer);
+	graph.SetSideEffect(geometry);
+
+	CHECK(graph.Compile());
+	CHECK(graph.IsPassCulled(unkept));
+	CHECK(PositionOf(graph, clear) < PositionOf(graph, geometry));
+}
+
+TEST(RenderGraph_WriteAfterReadWaitsForTheReader)
+{
+	RenderGraph graph;
+	RenderGraphResource history = graph.ImportResource("History");
+	RenderGraphResource backbuffer = graph.ImportResource("Backbuffer");
+
+	RenderGraphPass resolve = graph.AddPass("Resolve", []() {}); // Reads last frame's history before this frame's is written over it
+	graph.Read(resolve, history);
+	graph.Write(resolve, backbuffer);
+	graph.SetSideEffect(resolve);
+
+	RenderGraphPass storeHistory = graph.AddPass("StoreHistory", []() {});
+	graph.Write(storeHistory, history);
+	graph.SetSideEffect(storeHistory);
+
+	CHECK(graph.Compile());
+	CHECK(PositionOf(graph, resolve) < PositionOf(graph, storeHistory));
+}
+
+TEST(RenderGraph_FailsWhenATransientIsReadBeforeItIsWritten)
+{
+	RenderGraph graph;
+	RenderGraphResource a = graph.CreateTexture("A", MakeDesc(64, 64));
+
+	RenderGraphPass reader = graph.AddPass("Reader", []() {});
+	graph.Read(reader, a);
+	graph.SetSideEffect(reader);
+
+	RenderGraphPass writer = graph.AddPass("Writer", []() {});
+	graph.Write(writer, a);
+
+	CHECK(!graph.Compile());
+}
+
+TEST(RenderGraph_LifetimesSpanFirstToLastUse)
+{
+	RenderGraph graph;
+	RenderGraphResource a = graph.CreateTexture("A", MakeDesc(64, 64));
+	RenderGraphResource b = graph.CreateTexture("B", MakeDesc(64, 64));
+	RenderGraphResource c = graph.CreateTexture("C", MakeDesc(64, 64));
+
+	RenderGraphPass pass0 = graph.AddPass("Pass0", []() {});
+	graph.Write(pass0, a);
+
+	RenderGraphPass pass1 = graph.AddPass("Pass1", []() {});
+	graph.Read(pass1, a);
+	graph.Write(pass1, b);
+
+	RenderGraphPass pass2 = graph.AddPass("Pass2", []() {});
+	graph.Read(pass2, b);
+	graph.Write(pass2, c);
+
+	RenderGraphPass pass3 = graph.AddPass("Pass3", []() {});
+	graph.Read(pass3, a);
+	graph.Read(pass3, c);
+	graph.SetSideEffect(pass3);
+
+	CHECK(graph.Compile());
+	CHECK_EQUAL(graph.GetExecutionOrder().size(), (size_t)4);
+
+	CHECK_EQUAL(graph.GetFirstUse(a), PositionOf(graph, pass0));
+	CHECK_EQUAL(graph.GetLastUse(a), PositionOf(graph, pass3));
+	CHECK_EQUAL(graph.GetFirstUse(b), PositionOf(graph, pass1));
+	CHECK_EQUAL(graph.GetLastUse(b), PositionOf(graph, pass2));
+	CHECK_EQUAL(graph.GetFirstUse(c), PositionOf(graph, pass2));
+	CHECK_EQUAL(graph.GetLastUse(c), PositionOf(graph, pass3));
+}
+
+TEST(RenderGraph_AliasesTransientsWhoseLifetimesDontOverlap)
+{
+	RenderGraph graph;
+	RenderGraphResource a = graph.CreateTexture("A", MakeDesc(64, 64));
+	RenderGraphResource b = graph.CreateTexture("B", MakeDesc(64, 64));
+	RenderGraphResource c = graph.CreateTexture("C", MakeDesc(64, 64));
+	RenderGraphResource d = graph.CreateTexture("D", MakeDesc(32, 32)); // Doesn't overlap A either, but can't share with it
+	RenderGraphResource backbuffer = graph.ImportResource("Backbuffer");
+
+	RenderGraphPass pass0 = graph.AddPass("Pass0", []() {});
+	graph.Write(pass0, a);
+
+	RenderGraphPass pass1 = graph.AddPass("Pass1", []() {});
+	graph.Read(pass1, a);
+	graph.Write(pass1, b);
+
+	RenderGraphPass pass2 = graph.AddPass("Pass2", []() {});
+	graph.Read(pass2, b);
+	graph.Write(pass2, c);
+	graph.Write(pass2, d);
+
+	RenderGraphPass pass3 = graph.AddPass("Pass3", []() {});
+	graph.Read(pass3, c);
+	graph.Read(pass3, d);
+	graph.Write(pass3, backbuffer);
+	graph.SetSideEffect(pass3);
+
+	CHECK(graph.Compile());
+
+	// A (0-1) & C (2-3) don't overlap, B (1-2) overlaps both
+	CHECK_EQUAL(graph.GetPhysicalIndex(a), graph.GetPhysicalIndex(c));
+	CHECK(graph.GetPhysicalIndex(b) != graph.GetPhysicalIndex(a));
+	CHECK(graph.GetPhysicalIndex(d) != graph.GetPhysicalIndex(a));
+	CHECK(graph.GetPhysicalIndex(d) != graph.GetPhysicalIndex(b));
+	CHECK_EQUAL(graph.GetPhysicalIndex(backbuffer), RENDER_GRAPH_INVALID);
+	CHECK_EQUAL(graph.GetPhysicalTextureCount(), 3u);
+
+	CHECK(graph.GetPhysicalTextureDesc(graph.GetPhysicalIndex(d)) == MakeDesc(32, 32));
+	CHECK(graph.GetPhysicalTextureDesc(graph.GetPhysicalIndex(a)) == MakeDesc(64, 64));
+}
+
+TEST(RenderGraph_ExecutesSurvivingPassesInOrder)
+{
+	RenderGraph graph;
+	RenderGraphResource a = graph.CreateTexture("A", MakeDesc(64, 64));
+	std::vector<int> ran;
+
+	RenderGraphPass writer = graph.AddPass("Writer", [&ran]() { ran.push_back(0); });
+	graph.Write(writer, a);
+
+	graph.AddPass("Culled", [&ran]() { ran.push_back(1); });
+
+	RenderGraphPass reader = graph.AddPass("Reader", [&ran]() { ran.push_back(2); });
+	graph.Read(reader, a);
+	graph.SetSideEffect(reader);
+
+	CHECK(graph.Compile());
+	graph.Execute();
+	CHECK_EQUAL(ran.size(), (size_t)2);
+	CHECK(ran.size() == 2 && ran[0] == 0 && ran[1] == 2);
+
+	// Rebuilt every frame, nothing from the last frame's graph carries over
+	graph.Clear();
+	CHECK_EQUAL(graph.GetPassCount(), 0u);
+	CHECK(graph.Compile());
+	CHECK(graph.GetExecutionOrder().empty());
+	CHECK_EQUAL(graph.GetPhysicalTextureCount(), 0u);
+}
\ No newline at end of file
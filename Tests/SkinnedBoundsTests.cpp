@@ -0,0 +1,158 @@
+#include "Test.h"
+#include "SkinnedBounds.h"
+#include "VertexCompression.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cfloat>
+#include <random>
+
+static const unsigned int BONE_COUNT = 16;
+static const unsigned int POSE_COUNT = 64;
+
+struct SkinnedBoundsMesh
+{
+	std::vector<AnimatedVertex> vertices;
+	std::vector<CompressedAnimatedVertex> compressed; // What the shaders skin
+	glm::vec3 boundsMin;
+	glm::vec3 boundsMax;
+	float padding;
+};
+
+// A tall body of vertices, each influenced by 1 to 4 bones picked near its height like a limb's would be. The last bone influences nothing
+static SkinnedBoundsMesh MakeMesh(std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	std::uniform_int_distribution<int> influenceRange(1, MAX_BONE_INFLUENCE);
+
+	SkinnedBoundsMesh mesh;
+	mesh.boundsMin = glm::vec3(-0.5f, 0.0f, -0.3f);
+	mesh.boundsMax = glm::vec3(0.5f, 2.0f, 0.3f);
+	for (unsigned int i = 0; i < 3000; i++)
+	{
+		AnimatedVertex vertex(mesh.boundsMin + glm::vec3(unit(rng), unit(rng), unit(rng)) * (mesh.boundsMax - mesh.boundsMin), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec2(0.0f));
+
+		int influences = influenceRange(rng);
+		unsigned int firstBone = std::min((unsigned int)(vertex.position.y / 2.0f * (BONE_COUNT - 1)), BONE_COUNT - 2);
+		for (int j = 0; j < influences; j++) vertex.AddBoneData(std::min(firstBone + j, BONE_COUNT - 2), unit(rng) + 0.01f);
+		mesh.vertices.push_back(vertex);
+	}
+
+	// Same padding AnimatedMesh uses, a quantization step of the whole mesh
+	glm::vec3 size = mesh.boundsMax - mesh.boundsMin;
+	mesh.padding = glm::max(size.x, glm::max(size.y, size.z)) / 65535.0f;
+
+	for (const AnimatedVertex& vertex : mesh.vertices) mesh.compressed.push_back(VertexCompressionUtils::Compress(vertex, mesh.boundsMin, mesh.boundsMax, nullptr));
+	return mesh;
+}
+
+// Same blend as the animated mesh & skinning shaders, from the quantized position & weights
+static glm::vec3 Skin(const SkinnedBoundsMesh& mesh, const CompressedAnimatedVertex& vertex, const glm::mat4* boneMatrices)
+{
+	glm::vec4 position(VertexCompressionUtils::DecodePosition(vertex.position, mesh.boundsMin, mesh.boundsMax), 1.0f);
+	glm::vec4 skinned(0.0f);
+	for (unsigned int i = 0; i < MAX_BONE_INFLUENCE; i++)
+	{
+		skinned += boneMatrices[vertex.boneIDs[i]] * position * VertexCompressionUtils::DecodeBoneWeight(vertex.boneWeights[i]);
+	}
+	return glm::vec3(skinned);
+}
+
+// Any affine transform, including non uniform & mirroring scales
+static glm::mat4 RandomBoneMatrix(std::mt19937& rng)
+{
+	std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> scaleRange(0.25f, 2.0f);
+
+	glm::vec3 axis(signedUnit(rng), signedUnit(rng), signedUnit(rng));
+	if (glm::length(axis) < 0.01f) axis = glm::vec3(0.0f, 1.0f, 0.0f);
+
+	glm::vec3 scale(scaleRange(rng), scaleRange(rng), scaleRange(rng));
+	if (signedUnit(rng) < -0.8f) scale.x = -scale.x;
+
+	glm::mat4 matrix = glm::translate(glm::mat4(1.0f), glm::vec3(signedUnit(rng), signedUnit(rng), signedUnit(rng)) * 3.0f);
+	matrix = glm::rotate(matrix, signedUnit(rng) * glm::pi<float>(), glm::normalize(axis));
+	return glm::scale(matrix, scale);
+}
+
+static bool Contains(const glm::vec3& min, const glm::vec3& max, const glm::vec3& point)
+{
+	glm::vec3 epsilon = glm::max(glm::abs(min), glm::abs(max)) * 1e-6f; // Rounding of the bound's own matrix math
+	return glm::all(glm::greaterThanEqual(point, min - epsilon)) && glm::all(glm::lessThanEqual(point, max + epsilon));
+}
+
+TEST(SkinnedBounds_ContainsEverySkinnedVertex)
+{
+	std::mt19937 rng(1);
+	SkinnedBoundsMesh mesh = MakeMesh(rng);
+	std::vector<BoneBounds> boneBounds = SkinnedBoundsUtils::ComputeBoneBounds(Span<const AnimatedVertex>(mesh.vertices.data(), mesh.vertices.size()), BONE_COUNT, mesh.padding);
+	CHECK(boneBounds[BONE_COUNT - 1].IsEmpty());
+
+	std::vector<glm::mat4> boneMatrices(BONE_COUNT);
+	for (unsigned int pose = 0; pose < POSE_COUNT; pose++)
+	{
+		// The first pose is the bind pose, the rest move every bone independently of its neighbours, worse than any skeleton can
+		for (glm::mat4& matrix : boneMatrices) matrix = pose == 0 ? glm::mat4(1.0f) : RandomBoneMatrix(rng);
+
+		glm::vec3 min;
+		glm::vec3 max;
+		CHECK(SkinnedBoundsUtils::ComputeSkinnedBounds(boneBounds, boneMatrices.data(), min, max));
+
+		unsigned int outside = 0;
+		for (const CompressedAnimatedVertex& vertex : mesh.compressed)
+		{
+			if (!Contains(min, max, Skin(mesh, vertex, boneMatrices.data()))) outside++;
+		}
+		CHECK_EQUAL(outside, 0u);
+	}
+}
+
+TEST(SkinnedBounds_BindPoseIsTheMeshBounds)
+{
+	std::mt19937 rng(2);
+	SkinnedBoundsMesh mesh = MakeMesh(rng);
+	std::vector<BoneBounds> boneBounds = SkinnedBoundsUtils::ComputeBoneBounds(Span<const AnimatedVertex>(mesh.vertices.data(), mesh.vertices.size()), BONE_COUNT, mesh.padding);
+
+	glm::vec3 vertexMin(FLT_MAX);
+	glm::vec3 vertexMax(-FLT_MAX);
+	for (const AnimatedVertex& vertex : mesh.vertices)
+	{
+		vertexMin = glm::min(vertexMin, vertex.position);
+		vertexMax = glm::max(vertexMax, vertex.position);
+	}
+
+	// Unused bones are skipped, however far away their matrix puts them
+	std::vector<glm::mat4> boneMatrices(BONE_COUNT, glm::mat4(1.0f));
+	boneMatrices[BONE_COUNT - 1] = glm::translate(glm::mat4(1.0f), glm::vec3(1000.0f));
+
+	glm::vec3 min;
+	glm::vec3 max;
+	CHECK(SkinnedBoundsUtils::ComputeSkinnedBounds(boneBounds, boneMatrices.data(), min, max));
+	for (int axis = 0; axis < 3; axis++)
+	{
+		CHECK_NEAR(min[axis], vertexMin[axis] - mesh.padding, 1e-5f);
+		CHECK_NEAR(max[axis], vertexMax[axis] + mesh.padding, 1e-5f);
+	}
+
+	// Moving every bone the same way moves the box with it
+	glm::vec3 offset(3.0f, -2.0f, 0.5f);
+	for (glm::mat4& matrix : boneMatrices) matrix = glm::translate(glm::mat4(1.0f), offset);
+
+	glm::vec3 movedMin;
+	glm::vec3 movedMax;
+	SkinnedBoundsUtils::ComputeSkinnedBounds(boneBounds, boneMatrices.data(), movedMin, movedMax);
+	CHECK(glm::length(movedMin - (min + offset)) <= 1e-5f);
+	CHECK(glm::length(movedMax - (max + offset)) <= 1e-5f);
+}
+
+TEST(SkinnedBounds_MeshWithoutBones)
+{
+	std::vector<AnimatedVertex> vertices = { AnimatedVertex(glm::vec3(1.0f), glm::vec3(0.0f, 1.0f, 0.0f), glm::vec2(0.0f)) };
+	std::vector<BoneBounds> boneBounds = SkinnedBoundsUtils::ComputeBoneBounds(Span<const AnimatedVertex>(vertices.data(), vertices.size()), 4, 0.0f);
+	CHECK_EQUAL(boneBounds.size(), (size_t)4);
+
+	std::vector<glm::mat4> boneMatrices(4, glm::mat4(1.0f));
+	glm::vec3 min;
+	glm::vec3 max;
+	CHECK(!SkinnedBoundsUtils::ComputeSkinnedBounds(boneBounds, boneMatrices.data(), min, max));
+}
\ No newline at end of file
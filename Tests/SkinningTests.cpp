@@ -0,0 +1,188 @@
+#include "Test.h"
+#include "Skinning.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <cstring>
+#include <random>
+
+static const unsigned int SOURCE_VERTEX_STRIDE = 6; // skinning.glsl's strides, in uints
+static const unsigned int SKINNED_VERTEX_STRIDE = 5;
+
+static_assert(sizeof(CompressedAnimatedVertex) == SOURCE_VERTEX_STRIDE * sizeof(uint32_t), "skinning.glsl reads CompressedAnimatedVertex as 6 uints");
+static_assert(sizeof(SkinnedVertex) == SKINNED_VERTEX_STRIDE * sizeof(uint32_t), "skinning.glsl writes SkinnedVertex as 5 uints");
+
+struct SkinningShaderUniforms
+{
+	int boneOffset;
+	int boneCount;
+	glm::vec3 positionOffset;
+	glm::vec3 positionScale;
+};
+
+// main() from assets/shaders/skinning.glsl line for line, reading & writing the raw buffer words with glm's versions of the GLSL pack functions
+static void RunSkinningShader(const uint32_t* source, const glm::mat4* boneMatrices, const SkinningShaderUniforms& uniforms, uint32_t* skinned)
+{
+	glm::vec2 positionXY = glm::unpackUnorm2x16(source[0]);
+	glm::vec2 positionZW = glm::unpackUnorm2x16(source[1]);
+	glm::vec4 vertexPos = glm::vec4(glm::vec3(positionXY, positionZW.x) * uniforms.positionScale + uniforms.positionOffset, 1.0f);
+
+	glm::vec2 encodedNormal = glm::unpackSnorm2x16(source[2]);
+	glm::vec3 vertexNormal(encodedNormal.x, encodedNormal.y, 1.0f - std::abs(encodedNormal.x) - std::abs(encodedNormal.y));
+	float t = glm::max(-vertexNormal.z, 0.0f);
+	vertexNormal.x += vertexNormal.x >= 0.0f ? -t : t;
+	vertexNormal.y += vertexNormal.y >= 0.0f ? -t : t;
+	vertexNormal = glm::normalize(vertexNormal);
+
+	uint32_t texCoords = source[3];
+	uint32_t boneIDs = source[4];
+	glm::vec4 boneWeights = glm::unpackUnorm4x8(source[5]);
+
+	glm::vec4 transformedPos(0.0f);
+	glm::vec3 transformedNormal(0.0f);
+	for (int i = 0; i < (int)MAX_BONE_INFLUENCE; i++)
+	{
+		float weight = boneWeights[i];
+		if (weight == 0.0f) continue;
+
+		int boneID = int((boneIDs >> (8 * i)) & 0xFFu);
+		if (boneID >= uniforms.boneCount)
+		{
+			transformedPos = vertexPos;
+			transformedNormal = vertexNormal;
+			break;
+		}
+
+		transformedPos += boneMatrices[uniforms.boneOffset + boneID] * vertexPos * weight;
+		transformedNormal += glm::mat3(boneMatrices[uniforms.boneOffset + boneID]) * vertexNormal * weight;
+	}
+
+	uint32_t normal = 0u;
+	float manhattanLength = std::abs(transformedNormal.x) + std::abs(transformedNormal.y) + std::abs(transformedNormal.z);
+	if (manhattanLength > 0.0f)
+	{
+		glm::vec2 p = glm::vec2(transformedNormal) / manhattanLength;
+		if (transformedNormal.z < 0.0f)
+		{
+			glm::vec2 signNotZero(p.x >= 0.0f ? 1.0f : -1.0f, p.y >= 0.0f ? 1.0f : -1.0f);
+			p = (1.0f - glm::abs(glm::vec2(p.y, p.x))) * signNotZero;
+		}
+		normal = glm::packSnorm2x16(p);
+	}
+
+	std::memcpy(&skinned[0], &transformedPos.x, sizeof(float));
+	std::memcpy(&skinned[1], &transformedPos.y, sizeof(float));
+	std::memcpy(&skinned[2], &transformedPos.z, sizeof(float));
+	skinned[3] = normal;
+	skinned[4] = texCoords;
+}
+
+static CompressedAnimatedVertex MakeVertex(const glm::vec3& position, const glm::vec3& normal, const glm::vec3& boundsMin, const glm::vec3& boundsMax, std::initializer_list<std::pair<int, float>> bones)
+{
+	AnimatedVertex vertex(position, normal, glm::vec2(0.25f, 0.75f));
+	for (const std::pair<int, float>& bone : bones) vertex.AddBoneData(bone.first, bone.second);
+	return VertexCompressionUtils::Compress(vertex, boundsMin, boundsMax, nullptr);
+}
+
+static glm::vec3 PositionOf(const SkinnedVertex& vertex)
+{
+	return glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]);
+}
+
+TEST(Skinning_MatchesTheShader)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+	const unsigned int boneCount = 40;
+	const unsigned int boneOffset = 5; // The mesh's palette sits after another mesh's in the frame's buffer
+
+	std::vector<glm::mat4> palette(boneOffset + boneCount);
+	for (glm::mat4& matrix : palette)
+	{
+		glm::vec3 axis = glm::normalize(glm::vec3(signedUnit(rng), signedUnit(rng), signedUnit(rng)) + glm::vec3(0.0f, 0.01f, 0.0f));
+		matrix = glm::translate(glm::mat4(1.0f), glm::vec3(signedUnit(rng), signedUnit(rng), signedUnit(rng)));
+		matrix = glm::rotate(matrix, signedUnit(rng) * glm::pi<float>(), axis);
+		matrix = glm::scale(matrix, glm::vec3(0.8f + unit(rng) * 0.4f));
+	}
+
+	glm::vec3 boundsMin(-1.0f, 0.0f, -0.5f);
+	glm::vec3 boundsMax(1.0f, 2.0f, 0.5f);
+	std::vector<CompressedAnimatedVertex> vertices;
+	for (unsigned int i = 0; i < 5000; i++)
+	{
+		glm::vec3 normal(signedUnit(rng), signedUnit(rng), signedUnit(rng));
+		AnimatedVertex vertex(boundsMin + glm::vec3(unit(rng), unit(rng), unit(rng)) * (boundsMax - boundsMin), glm::normalize(normal + glm::vec3(0.0f, 0.0f, 0.01f)), glm::vec2(signedUnit(rng), unit(rng)));
+
+		// Every 50th vertex has a bone past the palette & stays in its bind pose
+		unsigned int influences = 1 + rng() % MAX_BONE_INFLUENCE;
+		for (unsigned int j = 0; j < influences; j++) vertex.AddBoneData(rng() % (i % 50 == 0 ? boneCount + 3 : boneCount), unit(rng) + 0.05f);
+		vertices.push_back(VertexCompressionUtils::Compress(vertex, boundsMin, boundsMax, nullptr));
+	}
+
+	std::vector<SkinnedVertex> reference(vertices.size());
+	SkinningUtils::SkinVertices(Span<const CompressedAnimatedVertex>(vertices.data(), vertices.size()), boundsMin, boundsMax, &palette[boneOffset], boneCount, reference.data());
+
+	SkinningShaderUniforms uniforms = { (int)boneOffset, (int)boneCount, boundsMin, boundsMax - boundsMin };
+	for (size_t i = 0; i < vertices.size(); i++)
+	{
+		uint32_t source[SOURCE_VERTEX_STRIDE];
+		std::memcpy(source, &vertices[i], sizeof(source));
+		uint32_t words[SKINNED_VERTEX_STRIDE];
+		RunSkinningShader(source, palette.data(), uniforms, words);
+		SkinnedVertex shader;
+		std::memcpy(&shader, words, sizeof(shader));
+
+		// Decoding can round differently from the GLSL unpack functions, never by more than float noise or a step of the normal encoding
+		CHECK(glm::length(PositionOf(reference[i]) - PositionOf(shader)) <= 1e-5f);
+		CHECK(std::abs(reference[i].normal[0] - shader.normal[0]) <= 1);
+		CHECK(std::abs(reference[i].normal[1] - shader.normal[1]) <= 1);
+		CHECK(std::memcmp(reference[i].texCoord, shader.texCoord, sizeof(shader.texCoord)) == 0);
+	}
+}
+
+TEST(Skinning_KnownPoses)
+{
+	glm::vec3 boundsMin(-1.0f);
+	glm::vec3 boundsMax(1.0f);
+	glm::vec3 position(0.5f, 0.25f, -0.75f); // Quantizing it to 16 bits moves it by less than 1e-4
+	glm::vec3 normal(1.0f, 0.0f, 0.0f);
+
+	std::vector<glm::mat4> palette =
+	{
+		glm::mat4(1.0f),
+		glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 2.0f, 0.0f)),
+		glm::rotate(glm::mat4(1.0f), glm::half_pi<float>(), glm::vec3(0.0f, 1.0f, 0.0f)),
+		glm::scale(glm::mat4(1.0f), glm::vec3(2.0f))
+	};
+
+	// The bind pose keeps the vertex where it was
+	SkinnedVertex skinned = SkinningUtils::SkinVertex(MakeVertex(position, normal, boundsMin, boundsMax, { { 0, 1.0f } }), boundsMin, boundsMax, palette.data(), 4);
+	CHECK(glm::length(PositionOf(skinned) - position) <= 1e-4f);
+	CHECK(glm::dot(VertexCompressionUtils::DecodeNormal(skinned.normal), normal) > 0.9999f);
+	CHECK(VertexCompressionUtils::DecodeTexCoord(skinned.texCoord) == glm::vec2(0.25f, 0.75f));
+
+	// Translations move positions but not normals
+	skinned = SkinningUtils::SkinVertex(MakeVertex(position, normal, boundsMin, boundsMax, { { 1, 1.0f } }), boundsMin, boundsMax, palette.data(), 4);
+	CHECK(glm::length(PositionOf(skinned) - (position + glm::vec3(0.0f, 2.0f, 0.0f))) <= 1e-4f);
+	CHECK(glm::dot(VertexCompressionUtils::DecodeNormal(skinned.normal), normal) > 0.9999f);
+
+	// A quarter turn around Y takes +X to -Z
+	skinned = SkinningUtils::SkinVertex(MakeVertex(position, normal, boundsMin, boundsMax, { { 2, 1.0f } }), boundsMin, boundsMax, palette.data(), 4);
+	CHECK(glm::length(PositionOf(skinned) - glm::vec3(-0.75f, 0.25f, -0.5f)) <= 1e-4f);
+	CHECK(glm::dot(VertexCompressionUtils::DecodeNormal(skinned.normal), glm::vec3(0.0f, 0.0f, -1.0f)) > 0.9999f);
+
+	// Scaled normals come back unit length
+	skinned = SkinningUtils::SkinVertex(MakeVertex(position, normal, boundsMin, boundsMax, { { 3, 1.0f } }), boundsMin, boundsMax, palette.data(), 4);
+	CHECK(glm::length(PositionOf(skinned) - position * 2.0f) <= 1e-4f);
+	CHECK_NEAR(glm::length(VertexCompressionUtils::DecodeNormal(skinned.normal)), 1.0f, 1e-5f);
+
+	// Equal weights blend halfway
+	skinned = SkinningUtils::SkinVertex(MakeVertex(position, normal, boundsMin, boundsMax, { { 0, 0.5f }, { 1, 0.5f } }), boundsMin, boundsMax, palette.data(), 4);
+	CHECK(glm::length(PositionOf(skinned) - (position + glm::vec3(0.0f, 1.0f, 0.0f))) <= 1e-2f); // 0.5 is 127.5/255, one weight gets the extra 255th
+
+	// A bone past the palette keeps the bind pose, even when another bone is valid
+	skinned = SkinningUtils::SkinVertex(MakeVertex(position, normal, boundsMin, boundsMax, { { 1, 0.5f }, { 9, 0.5f } }), boundsMin, boundsMax, palette.data(), 4);
+	CHECK(glm::length(PositionOf(skinned) - position) <= 1e-4f);
+}
\ No newline at end of file
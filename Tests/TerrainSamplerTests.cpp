@@ -0,0 +1,117 @@
+#include "Test.h"
+#include "TerrainSampler.h"
+
+struct TerrainGolden
+{
+	float x;
+	float z;
+	float height;
+};
+
+// GetHeight from terrain.glsl transliterated line for line into C++ floats (glm::fract/sin/dot/floor, the shader's 36 Rand calls per InterpolateNoise),
+// evaluated with the settings from MakeInfo(). Regenerate them the same way if the shader's noise changes on purpose
+static const TerrainGolden GOLDEN_HEIGHTS[] =
+{
+	{ 0.0f, 0.0f, 58.125f },
+	{ 1.0f, 1.0f, 58.1268082f },
+	{ 12.5f, -7.25f, 57.771183f },
+	{ -3.75f, 200.0f, 91.3036957f },
+	{ 250.0f, 250.0f, 85.7024689f },
+	{ 499.9f, 500.1f, 67.4327011f },
+	{ -1000.0f, 1000.0f, 57.9750061f },
+	{ 1234.5f, -987.25f, 72.0025711f },
+	{ -2500.5f, -1750.0f, 84.8469925f },
+	{ 4096.0f, 3072.0f, 77.0085449f },
+	{ -64.0f, -64.0f, 67.9930954f },
+	{ 63.5f, 0.5f, 51.8384933f },
+	{ 777.7f, -333.3f, 59.6946716f },
+	{ -0.001f, 0.001f, 58.125f },
+	{ 10000.0f, -10000.0f, 88.8168335f },
+	{ 5.0f, -5000.75f, 87.5916901f }
+};
+
+static const size_t GOLDEN_COUNT = sizeof(GOLDEN_HEIGHTS) / sizeof(GOLDEN_HEIGHTS[0]);
+
+// sin can be an ulp apart between C runtimes, Rand's * 43758.5453 magnifies that. A change to the formula moves heights by whole units
+static const float GOLDEN_TOLERANCE = 0.1f;
+
+static TerrainGenerationInfo MakeInfo()
+{
+	// Every field is given so the random default seed is never generated
+	TerrainGenerationInfo info = { glm::vec2(123.25f, 456.5f), 1.0f, 0.3f, 5.0f, 0.001f, 3, false };
+	return info;
+}
+
+TEST(TerrainSampler_SampleHeightMatchesShader)
+{
+	TerrainSampler sampler(MakeInfo());
+	for (size_t i = 0; i < GOLDEN_COUNT; i++)
+	{
+		CHECK_NEAR(sampler.SampleHeight(GOLDEN_HEIGHTS[i].x, GOLDEN_HEIGHTS[i].z), GOLDEN_HEIGHTS[i].height, GOLDEN_TOLERANCE);
+	}
+}
+
+TEST(TerrainSampler_SampleHeightsMatchesShader)
+{
+	TerrainSampler sampler(MakeInfo());
+
+	// 16 points, a multiple of 4 so every one goes down the SSE path where it's compiled in
+	std::vector<glm::vec2> points;
+	for (size_t i = 0; i < GOLDEN_COUNT; i++) points.push_back(glm::vec2(GOLDEN_HEIGHTS[i].x, GOLDEN_HEIGHTS[i].z));
+
+	std::vector<float> heights(GOLDEN_COUNT);
+	sampler.SampleHeights(points.data(), heights.data(), GOLDEN_COUNT);
+	for (size_t i = 0; i < GOLDEN_COUNT; i++)
+	{
+		CHECK_NEAR(heights[i], GOLDEN_HEIGHTS[i].height, GOLDEN_TOLERANCE);
+		CHECK_NEAR(heights[i], sampler.SampleHeight(points[i].x, points[i].y), 1e-4f);
+	}
+}
+
+TEST(TerrainSampler_SampleHeightsHandlesTheRemainder)
+{
+	TerrainSampler sampler(MakeInfo());
+
+	// 7 points, 4 batched & 3 left over for the scalar loop
+	std::vector<glm::vec2> points;
+	for (size_t i = 0; i < 7; i++) points.push_back(glm::vec2(GOLDEN_HEIGHTS[i].x, GOLDEN_HEIGHTS[i].z));
+
+	std::vector<float> heights(points.size() + 1, -1.0f);
+	sampler.SampleHeights(points.data(), heights.data(), points.size());
+	for (size_t i = 0; i < points.size(); i++)
+	{
+		CHECK_NEAR(heights[i], GOLDEN_HEIGHTS[i].height, GOLDEN_TOLERANCE);
+	}
+	CHECK_EQUAL(heights.back(), -1.0f); // Nothing written past count
+}
+
+TEST(TerrainSampler_TilesShareEdgesWithTheirNeighbours)
+{
+	TerrainSampler sampler(MakeInfo(), 64.0f, 17);
+	const TerrainTile& left = sampler.GetTile(-1, 0);
+	const TerrainTile& right = sampler.GetTile(0, 0);
+
+	unsigned int resolution = right.resolution;
+	for (unsigned int z = 0; z < resolution; z++)
+	{
+		CHECK_EQUAL(left.heights[z * resolution + resolution - 1], right.heights[z * resolution]);
+	}
+
+	CHECK_NEAR(right.heights[0], GOLDEN_HEIGHTS[0].height, GOLDEN_TOLERANCE);
+}
+
+TEST(TerrainSampler_SetInfoDropsTilesOnlyWhenHeightsChange)
+{
+	TerrainGenerationInfo info = MakeInfo();
+	TerrainSampler sampler(info);
+	float before = sampler.SampleHeight(100.0f, 100.0f);
+
+	info.roughness = 0.9f; // Not used by the shader
+	sampler.SetInfo(info);
+	CHECK_EQUAL(sampler.GetGeneration(), 0u);
+
+	info.seed.x += 1.0f;
+	sampler.SetInfo(info);
+	CHECK_EQUAL(sampler.GetGeneration(), 1u);
+	CHECK(sampler.SampleHeight(100.0f, 100.0f) != before);
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cmath>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Just enough of a test framework for the CPU side of the engine. TEST() registers a function before main() runs, the CHECKs record failures & carry on
+namespace Test
+{
+	typedef void(*TestFunction)();
+
+	struct TestCase
+	{
+		const char* name;
+		TestFunction function;
+	};
+
+	std::vector<TestCase>& GetTests();
+	void Fail(const char* file, int line, const std::string& message);
+
+	struct Registrar
+	{
+		Registrar(const char* name, TestFunction function) { GetTests().push_back({ name, function }); }
+	};
+}
+
+#define TEST(name) static void name(); static Test::Registrar name##Registrar(#name, name); static void name()
+
+#define CHECK(condition) do { if (!(condition)) Test::Fail(__FILE__, __LINE__, #condition); } while (false)
+
+#define CHECK_EQUAL(a, b) do { if (!((a) == (b))) { std::ostringstream message; message << #a << " == " << #b << " (" << (a) << " vs " << (b) << ")"; Test::Fail(__FILE__, __LINE__, message.str()); } } while (false)
+
+#define CHECK_NEAR(a, b, tolerance) do { if (!(std::abs((a) - (b)) <= (tolerance))) { std::ostringstream message; message << #a << " ~= " << #b << " (" << (a) << " vs " << (b) << ", tolerance " << (tolerance) << ")"; Test::Fail(__FILE__, __LINE__, message.str()); } } while (false)
\ No newline at end of file
@@ -0,0 +1,44 @@
+#include "Test.h"
+
+#include <iostream>
+
+static unsigned int failures = 0;
+
+namespace Test
+{
+	std::vector<TestCase>& GetTests()
+	{
+		static std::vector<TestCase> tests; // Function static, the registrars run during static initialization in whatever order the files are linked
+		return tests;
+	}
+
+	void Fail(const char* file, int line, const std::string& message)
+	{
+		std::cout << "    " << file << "(" << line << "): " << message << std::endl;
+		failures++;
+	}
+}
+
+// Runs every test, or only the ones whose name contains the first argument. Returns the number of failed tests so it can gate a build
+int main(int argc, char** argv)
+{
+	std::string filter = argc > 1 ? argv[1] : "";
+
+	unsigned int run = 0;
+	unsigned int failed = 0;
+	for (const Test::TestCase& test : Test::GetTests())
+	{
+		if (!filter.empty() && std::string(test.name).find(filter) == std::string::npos) continue;
+
+		unsigned int failuresBefore = failures;
+		test.function();
+		run++;
+
+		bool passed = failures == failuresBefore;
+		if (!passed) failed++;
+		std::cout << (passed ? "[PASS] " : "[FAIL] ") << test.name << std::endl;
+	}
+
+	std::cout << run - failed << "/" << run << " tests passed" << std::endl;
+	return (int)failed;
+}
\ No newline at end of file
@@ -0,0 +1,183 @@
+#include "Test.h"
+#include "VertexCompression.h"
+
+#include <algorithm>
+#include <random>
+
+static const unsigned int SAMPLE_COUNT = 20000;
+
+TEST(VertexCompression_PositionRoundTrip)
+{
+	std::mt19937 rng(1);
+	std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+	// Includes an almost flat axis, the error scales with the bounds on each axis separately
+	glm::vec3 boundsMin(-3.0f, -0.5f, 2.0f);
+	glm::vec3 boundsMax(5.0f, 4.0f, 2.001f);
+	glm::vec3 extent = boundsMax - boundsMin;
+	glm::vec3 tolerance = extent * (0.5f / 65535.0f) + glm::vec3(1e-6f); // Half a UNORM16 step, plus float rounding
+
+	glm::vec3 maxError(0.0f);
+	for (unsigned int i = 0; i < SAMPLE_COUNT; i++)
+	{
+		glm::vec3 position = boundsMin + glm::vec3(unit(rng), unit(rng), unit(rng)) * extent;
+		if (i == 0) position = boundsMin;
+		if (i == 1) position = boundsMax;
+
+		uint16_t encoded[4];
+		VertexCompressionUtils::EncodePosition(position, boundsMin, boundsMax, encoded);
+		CHECK_EQUAL(encoded[3], 0);
+		maxError = glm::max(maxError, glm::abs(VertexCompressionUtils::DecodePosition(encoded, boundsMin, boundsMax) - position));
+	}
+
+	for (int axis = 0; axis < 3; axis++) CHECK(maxError[axis] <= tolerance[axis]);
+
+	// A flat submesh keeps its one value instead of dividing by 0
+	uint16_t encoded[4];
+	VertexCompressionUtils::EncodePosition(glm::vec3(1.0f, 2.0f, 3.0f), glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(4.0f, 2.0f, 4.0f), encoded);
+	glm::vec3 decoded = VertexCompressionUtils::DecodePosition(encoded, glm::vec3(0.0f, 2.0f, 0.0f), glm::vec3(4.0f, 2.0f, 4.0f));
+	CHECK_EQUAL(decoded.y, 2.0f);
+}
+
+TEST(VertexCompression_NormalRoundTrip)
+{
+	std::mt19937 rng(2);
+	std::uniform_real_distribution<float> signedUnit(-1.0f, 1.0f);
+
+	std::vector<glm::vec3> normals =
+	{
+		glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f), glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f),
+		glm::normalize(glm::vec3(1.0f, 1.0f, -1.0f)), glm::normalize(glm::vec3(-1.0f, -1.0f, -0.0001f)) // Folded corners & the fold's edge
+	};
+	while (normals.size() < SAMPLE_COUNT)
+	{
+		glm::vec3 normal(signedUnit(rng), signedUnit(rng), signedUnit(rng));
+		if (glm::length(normal) > 0.01f) normals.push_back(glm::normalize(normal));
+	}
+
+	float maxAngle = 0.0f;
+	for (const glm::vec3& normal : normals)
+	{
+		int16_t encoded[2];
+		VertexCompressionUtils::EncodeNormal(normal, encoded);
+		glm::vec3 decoded = VertexCompressionUtils::DecodeNormal(encoded);
+
+		CHECK_NEAR(glm::length(decoded), 1.0f, 1e-5f);
+		maxAngle = std::max(maxAngle, 2.0f * std::asin(std::min(glm::length(decoded - normal) * 0.5f, 1.0f))); // acos of a dot product this close to 1 is too imprecise in floats
+	}
+	CHECK(maxAngle <= glm::radians(0.01f));
+
+	// A zero normal comes back as +Z rather than NaNs
+	int16_t encoded[2];
+	VertexCompressionUtils::EncodeNormal(glm::vec3(0.0f), encoded);
+	glm::vec3 decoded = VertexCompressionUtils::DecodeNormal(encoded);
+	CHECK_NEAR(decoded.z, 1.0f, 1e-6f);
+}
+
+TEST(VertexCompression_TexCoordRoundTrip)
+{
+	std::mt19937 rng(3);
+	std::uniform_real_distribution<float> texCoordRange(-4.0f, 4.0f); // Tiled UVs go outside [0, 1]
+
+	for (unsigned int i = 0; i < SAMPLE_COUNT; i++)
+	{
+		glm::vec2 texCoord(texCoordRange(rng), texCoordRange(rng));
+		uint16_t encoded[2];
+		VertexCompressionUtils::EncodeTexCoord(texCoord, encoded);
+		glm::vec2 decoded = VertexCompressionUtils::DecodeTexCoord(encoded);
+
+		// Half floats keep 11 significant bits, rounding is off by at most half the last one. Below 2^-14 the step stops shrinking
+		for (int axis = 0; axis < 2; axis++) CHECK(std::abs(decoded[axis] - texCoord[axis]) <= std::max(std::abs(texCoord[axis]), 6.104e-5f) / 2048.0f);
+	}
+
+	// Texel centres of power of two textures up to 1024 wide come back exactly
+	for (unsigned int texel = 0; texel < 1024; texel++)
+	{
+		float u = (texel + 0.5f) / 1024.0f;
+		uint16_t encoded[2];
+		VertexCompressionUtils::EncodeTexCoord(glm::vec2(u, 1.0f - u), encoded);
+		CHECK_EQUAL(VertexCompressionUtils::DecodeTexCoord(encoded).x, u);
+	}
+}
+
+TEST(VertexCompression_BoneWeightRoundTrip)
+{
+	std::mt19937 rng(4);
+	std::uniform_real_distribution<float> weightRange(0.0f, 1.0f);
+	std::uniform_int_distribution<int> boneRange(0, (int)VertexCompressionUtils::MAX_BONE_ID);
+	std::uniform_int_distribution<int> influenceRange(1, MAX_BONE_INFLUENCE);
+
+	for (unsigned int i = 0; i < SAMPLE_COUNT; i++)
+	{
+		float boneIDs[MAX_BONE_INFLUENCE];
+		float boneWeights[MAX_BONE_INFLUENCE];
+		int influences = influenceRange(rng);
+		float totalWeight = 0.0f;
+		for (int j = 0; j < (int)MAX_BONE_INFLUENCE; j++)
+		{
+			boneIDs[j] = j < influences ? (float)boneRange(rng) : -1.0f;
+			boneWeights[j] = j < influences ? weightRange(rng) + 0.001f : 0.0f; // Not normalized, the encoder does that
+			totalWeight += boneWeights[j];
+		}
+
+		uint8_t encodedIDs[MAX_BONE_INFLUENCE];
+		uint8_t encodedWeights[MAX_BONE_INFLUENCE];
+		CHECK(VertexCompressionUtils::EncodeBones(boneIDs, boneWeights, encodedIDs, encodedWeights));
+
+		// Each weight is rounded to the nearest 255th, then the rounding errors of the others are added onto the largest one
+		int sum = 0;
+		for (int j = 0; j < (int)MAX_BONE_INFLUENCE; j++)
+		{
+			sum += encodedWeights[j];
+			CHECK(std::abs(VertexCompressionUtils::DecodeBoneWeight(encodedWeights[j]) - boneWeights[j] / totalWeight) <= MAX_BONE_INFLUENCE * 0.5f / 255.0f + 1e-6f);
+			if (j < influences && encodedWeights[j] > 0) CHECK_EQUAL((float)encodedIDs[j], boneIDs[j]);
+		}
+		CHECK_EQUAL(sum, 255); // Skinned positions stay a convex blend of the bone transforms
+	}
+}
+
+TEST(VertexCompression_BonesThatDontFit)
+{
+	float boneIDs[MAX_BONE_INFLUENCE] = { 300.0f, 2.0f, -1.0f, -1.0f };
+	float boneWeights[MAX_BONE_INFLUENCE] = { 0.5f, 0.5f, 0.0f, 0.0f };
+	uint8_t encodedIDs[MAX_BONE_INFLUENCE];
+	uint8_t encodedWeights[MAX_BONE_INFLUENCE];
+
+	CHECK(!VertexCompressionUtils::EncodeBones(boneIDs, boneWeights, encodedIDs, encodedWeights));
+	CHECK_EQUAL(encodedWeights[0], 0); // Dropped, the rest is renormalized
+	CHECK_EQUAL(encodedIDs[1], 2);
+	CHECK_EQUAL(encodedWeights[1], 255);
+
+	// A vertex without bones has no weight at all
+	float noIDs[MAX_BONE_INFLUENCE] = { -1.0f, -1.0f, -1.0f, -1.0f };
+	float noWeights[MAX_BONE_INFLUENCE] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	CHECK(VertexCompressionUtils::EncodeBones(noIDs, noWeights, encodedIDs, encodedWeights));
+	CHECK_EQUAL(encodedWeights[0] + encodedWeights[1] + encodedWeights[2] + encodedWeights[3], 0);
+}
+
+TEST(VertexCompression_CompressAnimatedVertex)
+{
+	AnimatedVertex vertex;
+	vertex.position = glm::vec3(0.25f, 1.5f, -0.75f);
+	vertex.normal = glm::normalize(glm::vec3(0.2f, -0.9f, 0.4f));
+	vertex.texCoord = glm::vec2(0.375f, 0.8125f);
+	float boneIDs[MAX_BONE_INFLUENCE] = { 7.0f, 12.0f, -1.0f, -1.0f };
+	float boneWeights[MAX_BONE_INFLUENCE] = { 0.75f, 0.25f, 0.0f, 0.0f };
+	std::copy(boneIDs, boneIDs + MAX_BONE_INFLUENCE, vertex.boneIDs);
+	std::copy(boneWeights, boneWeights + MAX_BONE_INFLUENCE, vertex.boneWeights);
+
+	glm::vec3 boundsMin(-1.0f, 0.0f, -1.0f);
+	glm::vec3 boundsMax(1.0f, 2.0f, 1.0f);
+	bool bonesFit = false;
+	CompressedAnimatedVertex compressed = VertexCompressionUtils::Compress(vertex, boundsMin, boundsMax, &bonesFit);
+
+	CHECK(bonesFit);
+	CHECK(glm::length(VertexCompressionUtils::DecodePosition(compressed.position, boundsMin, boundsMax) - vertex.position) <= 2.0f / 65535.0f);
+	CHECK(glm::dot(VertexCompressionUtils::DecodeNormal(compressed.normal), vertex.normal) > 0.9999f);
+	CHECK(VertexCompressionUtils::DecodeTexCoord(compressed.texCoord) == vertex.texCoord);
+	CHECK_EQUAL(compressed.boneIDs[0], 7);
+	CHECK_EQUAL(compressed.boneIDs[1], 12);
+	CHECK_EQUAL(compressed.boneWeights[0], 191);
+	CHECK_EQUAL(compressed.boneWeights[1], 64);
+}
\ No newline at end of file